@@ -34,6 +34,13 @@ template <typename T>
 Vector<T> smallestEigenvectorSquare(SparseMatrix<T>& energyMatrix, SparseMatrix<T>& massMatrix,
                                     size_t nIterations = 50);
 
+// As above, with an existing solver for the energy matrix, e.g. a factorization kept for repeated queries
+template <typename T>
+class LinearSolver;
+template <typename T>
+Vector<T> smallestEigenvectorSquare(LinearSolver<T>& energySolver, SparseMatrix<T>& massMatrix,
+                                    size_t nIterations = 50);
+
 // Mass matrix must be positive definite
 template <typename T>
 Vector<T> largestEigenvector(SparseMatrix<T>& energyMatrix, SparseMatrix<T>& massMatrix, size_t nIterations = 50);
@@ -68,6 +75,11 @@ public:
   // Solve for a particular right hand side, and return in an existing vector objects
   virtual void solve(Vector<T>& x, const Vector<T>& rhs) = 0;
 
+  // Solve for many right hand sides at once (one per column). The default solves column-by-column; solvers which can
+  // do better override it.
+  virtual void solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs);
+  DenseMatrix<T> solveMultiple(const DenseMatrix<T>& rhs);
+
 protected:
   size_t nRows, nCols;
 };
@@ -109,8 +121,17 @@ public:
   void solve(Vector<T>& x, const Vector<T>& rhs) override;
   Vector<T> solve(const Vector<T>& rhs) override;
 
+  // Solve for many right hand sides at once (one per column), reusing the factorization
+  void solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs) override;
+  DenseMatrix<T> solveMultiple(const DenseMatrix<T>& rhs);
+
+  // Factor a new matrix in place of the old one. If it has the same sparsity pattern, the symbolic analysis (ordering,
+  // etc) is reused and only the numerical factorization is recomputed. Returns true if the analysis was reused.
+  bool refactor(SparseMatrix<T>& mat);
+
 protected:
   std::unique_ptr<PSDSolverInternals<T>> internals;
+  void factor(SparseMatrix<T>& mat, bool reuseAnalysis);
 };
 
 template <typename T>
@@ -126,6 +147,10 @@ public:
   void solve(Vector<T>& x, const Vector<T>& rhs) override;
   Vector<T> solve(const Vector<T>& rhs) override;
 
+  // Solve for many right hand sides at once (one per column), reusing the factorization
+  void solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs) override;
+  DenseMatrix<T> solveMultiple(const DenseMatrix<T>& rhs);
+
 protected:
   // Implementation-specific quantities
   std::unique_ptr<SquareSolverInternals<T>> internals;
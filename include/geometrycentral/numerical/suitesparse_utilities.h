@@ -65,4 +65,12 @@ cholmod_dense* toCholmod(const Eigen::Matrix<T, Eigen::Dynamic, 1>& v, CholmodCo
 template <typename T>
 void toEigen(cholmod_dense* cVec, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, 1>& xOut);
 
+// Convert a dense matrix (e.g. one column per right-hand side)
+template <typename T>
+cholmod_dense* toCholmod(const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& A, CholmodContext& context);
+
+// Convert a dense matrix
+template <typename T>
+void toEigen(cholmod_dense* cMat, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+
 } // namespace geometrycentral
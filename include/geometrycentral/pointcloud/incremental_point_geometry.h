@@ -0,0 +1,84 @@
+#pragma once
+
+#include "geometrycentral/pointcloud/point_cloud.h"
+#include "geometrycentral/utilities/vector3.h"
+#include "geometrycentral/utilities/voxel_hash_grid.h"
+
+#include <memory>
+#include <vector>
+
+// Maintain k-nearest neighborhoods and normals on a point cloud which changes over time. Points are indexed in a
+// VoxelHashGrid, and each insertion, removal, or move recomputes only the neighborhoods which it could have changed,
+// rather than the whole cloud as PointPositionGeometry::refreshQuantities() would.
+
+namespace geometrycentral {
+namespace pointcloud {
+
+class IncrementalPointGeometry {
+public:
+  // If voxelSize <= 0, it is estimated from the typical neighborhood radius of the initial points (which then must not
+  // be empty).
+  IncrementalPointGeometry(PointCloud& cloud, const PointData<Vector3>& positions, unsigned int kNeighborSize = 30,
+                           double voxelSize = -1.);
+  ~IncrementalPointGeometry();
+
+  // == Members
+  PointCloud& cloud;
+  const unsigned int kNeighborSize;
+
+  // These are kept up to date by the modification routines below; do not modify them directly.
+  PointData<Vector3> positions;
+  PointData<std::vector<Point>> neighbors; // the (up to) k nearest other points, sorted by increasing distance
+  PointData<Vector3> normals;              // unoriented, computed via PCA as in PointPositionGeometry
+
+  // == Modification
+  // Each of these updates the cloud, positions, neighbors, and normals together. Removals leave the cloud
+  // uncompressed; it is fine to call cloud.compress() at any time afterwards.
+  Point insertPoint(Vector3 pos);
+  std::vector<Point> insertPoints(const std::vector<Vector3>& newPositions);
+  void removePoint(Point p);
+  void removePoints(const std::vector<Point>& pointsToRemove);
+  void movePoint(Point p, Vector3 newPos);
+
+  // Number of points whose neighborhood was recomputed by the most recent modification
+  size_t nUpdatedLastTime = 0;
+
+  const VoxelHashGrid& spatialIndex() const { return grid; }
+
+  // Hide copy and move constructors
+  IncrementalPointGeometry(const IncrementalPointGeometry& other) = delete;
+  IncrementalPointGeometry& operator=(const IncrementalPointGeometry& other) = delete;
+
+private:
+  // Distance to the k'th nearest neighbor, or infinity for points with fewer than k neighbors. A change at q can only
+  // affect the neighborhood of p if |p - q| <= neighborRadius[p].
+  PointData<double> neighborRadius;
+  size_t nShortNeighborhoods = 0; // points with infinite radius
+
+  // Reverse index for finding the points whose neighborhoods contain q. A point with a finite radius is stored in
+  // radiusLevels[L], a grid with voxel size grid.voxelSize() * 2^L, for the smallest L whose voxel size is at least its
+  // radius. Within each level, only the voxels adjacent to q need to be searched, so one sparse or outlying point with
+  // a huge radius does not make every search large.
+  std::vector<std::unique_ptr<VoxelHashGrid>> radiusLevels;
+  size_t radiusLevel(double rad) const;
+
+  VoxelHashGrid grid; // keyed by point index
+
+  // Marks on points which need to be updated
+  std::vector<char> isAffected;
+  std::vector<Point> affected;
+  void markAffected(Point p);
+  void markAffectedBy(Vector3 q); // all points whose neighborhood would change by adding/removing a point at q
+  void updateAffected();
+
+  void recordRadius(Point p, double rad);
+  void forgetRadius(Point p);
+
+  // Keep neighbor handles and the grid valid when the cloud is compressed
+  std::list<std::function<void(const std::vector<size_t>&)>>::iterator permuteCallbackIt;
+  std::list<std::function<void()>>::iterator deleteCallbackIt;
+  bool cloudDeleted = false;
+};
+
+} // namespace pointcloud
+} // namespace geometrycentral
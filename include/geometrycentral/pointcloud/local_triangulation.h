@@ -13,6 +13,19 @@ namespace pointcloud {
 PointData<std::vector<std::array<Point, 3>>> buildLocalTriangulations(PointCloud& cloud, PointPositionGeometry& geom,
                                                                       bool withDegeneracyHeuristic = true);
 
+// Local triangulations for all points, stored flat. The triangles of the point with index i are
+// triangles[triangleStart[i]], ..., triangles[triangleStart[i+1]-1]; each holds point indices, with the center point
+// first.
+struct LocalTriangulationResult {
+  std::vector<size_t> triangleStart; // size nPoints+1
+  std::vector<std::array<size_t, 3>> triangles;
+};
+
+// Same as buildLocalTriangulations(), but processes neighborhoods in parallel and returns the flat representation
+// directly. Requires a compressed cloud.
+LocalTriangulationResult buildLocalTriangulationsFlat(PointCloud& cloud, PointPositionGeometry& geom,
+                                                      bool withDegeneracyHeuristic = true);
+
 // Convert a local neighbor indexed list to global indices
 PointData<std::vector<std::array<size_t, 3>>>
 handleToInds(PointCloud& cloud, const PointData<std::vector<std::array<Point, 3>>>& handleResult);
@@ -3,30 +3,138 @@
 #include "geometrycentral/pointcloud/point_cloud.h"
 #include "geometrycentral/utilities/vector3.h"
 
+#include <type_traits>
+#include <vector>
+
 namespace geometrycentral {
 namespace pointcloud {
 
+// A contiguous range of per-neighbor values for one point, viewed in place in some flat storage.
+// Converts to a std::vector<> if a private copy is needed.
+template <typename T>
+class NeighborSpan {
+public:
+  NeighborSpan(T* begin_, size_t size_) : ptr(begin_), count(size_) {}
+
+  size_t size() const { return count; }
+  T& operator[](size_t j) const { return ptr[j]; }
+  T* begin() const { return ptr; }
+  T* end() const { return ptr + count; }
+
+  operator std::vector<typename std::remove_const<T>::type>() const { return {begin(), end()}; }
+
+private:
+  T* ptr;
+  size_t count;
+};
+
+// The neighbors of one point, viewed in place in the flat storage of a Neighborhoods object
+class NeighborList {
+public:
+  NeighborList(PointCloud& cloud_, const size_t* indices_, const double* distancesSq_, size_t size_)
+      : cloud(&cloud_), indices(indices_), distancesSq(distancesSq_), count(size_) {}
+
+  size_t size() const { return count; }
+  Point operator[](size_t j) const { return cloud->point(indices[j]); }
+  size_t index(size_t j) const { return indices[j]; }                  // index of the j'th neighbor
+  double distanceSquared(size_t j) const { return distancesSq[j]; } // squared distance to the j'th neighbor
+
+  operator std::vector<Point>() const;
+
+  class iterator {
+  public:
+    iterator(PointCloud* cloud_, const size_t* ptr_) : cloud(cloud_), ptr(ptr_) {}
+    Point operator*() const { return cloud->point(*ptr); }
+    iterator& operator++() {
+      ptr++;
+      return *this;
+    }
+    bool operator==(const iterator& other) const { return ptr == other.ptr; }
+    bool operator!=(const iterator& other) const { return ptr != other.ptr; }
+
+  private:
+    PointCloud* cloud;
+    const size_t* ptr;
+  };
+  iterator begin() const { return iterator(cloud, indices); }
+  iterator end() const { return iterator(cloud, indices + count); }
+
+private:
+  PointCloud* cloud;
+  const size_t* indices;
+  const double* distancesSq;
+  size_t count;
+};
+
 // Represents a set of neighborhoods for a point cloud. Immutable after construction.
 //
-// TODO upgrade this to be much cleverer and use a flat representation w/ custom iterators and containers.
-//
+// Neighbor lists are stored flat, in compressed-row form, so a cloud costs a few contiguous arrays rather than one heap
+// allocation per point.
 class Neighborhoods {
 public:
   // == Constructors
   Neighborhoods(PointCloud& cloud, const PointData<Vector3>& positions, unsigned int nNeighbors);
   // TODO constructor for fixed-ball neighborhood
 
+  // (the accessor below points back in to this object)
+  Neighborhoods(const Neighborhoods& other) = delete;
+  Neighborhoods& operator=(const Neighborhoods& other) = delete;
+
   // == Members
   PointCloud& cloud;
 
-  PointData<std::vector<Point>> neighbors;
+  // The neighbors of the point with index i are neighborIndices[neighborStart[i]], ...,
+  // neighborIndices[neighborStart[i+1]-1], sorted by increasing distance, with squared distances alongside.
+  std::vector<size_t> neighborStart; // size nPoints+1
+  std::vector<size_t> neighborIndices;
+  std::vector<double> neighborDistancesSq;
+
+  // Access the neighbors of a point as neighbors[p][j], much like a PointData<> of lists
+  class Accessor {
+  public:
+    Accessor(const Neighborhoods& parent_) : parent(parent_) {}
+    NeighborList operator[](Point p) const { return (*this)[p.getIndex()]; }
+    NeighborList operator[](size_t iP) const {
+      size_t start = parent.neighborStart[iP];
+      return NeighborList(parent.cloud, parent.neighborIndices.data() + start, parent.neighborDistancesSq.data() + start,
+                          parent.neighborStart[iP + 1] - start);
+    }
+
+  private:
+    const Neighborhoods& parent;
+  };
+  Accessor neighbors{*this};
 
   // == Functions
 
-protected:
-  // TODO
-  // PointData<size_t> listIndEnd;
-  // std::vector<size_t> flatNeighborList;
+  size_t nNeighbors(Point p) const { return neighborStart[p.getIndex() + 1] - neighborStart[p.getIndex()]; }
+};
+
+// Values stored per (point, neighbor) pair, in a single flat array laid out like the neighbor lists of a Neighborhoods
+// object. data[p][j] holds the value for the j'th neighbor of p.
+template <typename T>
+class NeighborData {
+public:
+  NeighborData() {}
+  NeighborData(const Neighborhoods& neighborhoods, T initVal = T())
+      : start(neighborhoods.neighborStart), values(neighborhoods.neighborIndices.size(), initVal) {}
+
+  NeighborSpan<T> operator[](Point p) { return (*this)[p.getIndex()]; }
+  NeighborSpan<const T> operator[](Point p) const { return (*this)[p.getIndex()]; }
+  NeighborSpan<T> operator[](size_t iP) { return NeighborSpan<T>(values.data() + start[iP], start[iP + 1] - start[iP]); }
+  NeighborSpan<const T> operator[](size_t iP) const {
+    return NeighborSpan<const T>(values.data() + start[iP], start[iP + 1] - start[iP]);
+  }
+
+  size_t size() const { return start.empty() ? 0 : start.size() - 1; } // number of points
+  void clear() {
+    start.clear();
+    values.clear();
+  }
+
+  // Raw flat storage
+  std::vector<size_t> start;
+  std::vector<T> values;
 };
 
 
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "geometrycentral/pointcloud/point_cloud.h"
+#include "geometrycentral/pointcloud/point_position_geometry.h"
+#include "geometrycentral/utilities/vector3.h"
+
+// Consistently orient the unoriented PCA normals of a point cloud, by propagating signs along a minimum spanning tree
+// of the k-nearest-neighbor graph (Hoppe et al. 1992, "Surface Reconstruction from Unorganized Points").
+
+namespace geometrycentral {
+namespace pointcloud {
+
+// Returns a copy of geom.normals with signs chosen so that neighboring normals agree. The tree is weighted by
+// 1 - |n_i . n_j|, so signs are propagated across nearly-parallel pairs first. In each connected component, the point
+// furthest along `referenceDir` gets a normal pointing along `referenceDir`; for a closed surface this makes the
+// normals point outward. Undefined normals are left as-is.
+PointData<Vector3> orientNormals(PointPositionGeometry& geom, Vector3 referenceDir = Vector3{0., 0., 1.});
+
+// As above, orienting the given normals (which need not be geom.normals) in place.
+void orientNormals(PointPositionGeometry& geom, PointData<Vector3>& normals,
+                   Vector3 referenceDir = Vector3{0., 0., 1.});
+
+} // namespace pointcloud
+} // namespace geometrycentral
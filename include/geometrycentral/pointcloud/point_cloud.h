@@ -59,6 +59,11 @@ public:
 
   // == Mutation routines
 
+  // Add a new point to the cloud. Containers (PointData<>, etc) will be expanded to hold it, with their default value.
+  Point insertPoint();
+
+  // Remove a point from the cloud in constant time. The cloud will no longer be compressed.
+  void removePoint(Point p);
 
   // == Callbacks that will be invoked on mutation to keep containers/iterators/etc valid.
 
@@ -125,8 +130,6 @@ protected:
   PointCloud(PointCloud&& other) = delete;
   PointCloud& operator=(PointCloud&& other) = delete;
 
-  // TODO although the skeleton is here, inserting/deleting points has not actually been fleshed out and tested.
-
   // Used to resize the cloud. Expands and shifts vectors as necessary.
   Point getNewPoint();
 
@@ -35,11 +35,28 @@ public:
   // Compute the logarithmic map from a source point
   PointData<Vector2> computeLogMap(const Point& sourcePoint);
 
+  // === Batched queries
+  // Unlike the multi-source versions above, these give a separate result for each source. The linear systems for a
+  // block of sources are solved together against the same factorizations, which is much faster than querying the
+  // sources one at a time.
+  std::vector<PointData<double>> computeDistanceBatch(const std::vector<Point>& sourcePoints);
+  std::vector<PointData<Vector2>> transportTangentVectorBatch(const std::vector<std::tuple<Point, Vector2>>& sources);
+  std::vector<PointData<Vector2>> computeLogMapBatch(const std::vector<Point>& sourcePoints);
+
+  // === Updating
+
+  // Call after moving the points (updating geom.positions and calling geom.refreshQuantities()). Rebuilds the
+  // operators; when their sparsity is unchanged (e.g. the points moved only slightly), the existing symbolic
+  // factorizations are reused. Returns true if every factorization was reused.
+  bool updateGeometry();
+
   // === Options and parameters
 
   const double tCoef; // the time parameter used for heat flow, measured as time = tCoef * mean_edge_length^2
                       // default: 1.0
 
+  size_t batchBlockSize = 32; // number of sources solved together in batched queries
+
 private:
   // === Members
 
@@ -49,15 +66,17 @@ private:
 
   // Parameters
   double shortTime; // the actual time used for heat flow computed from tCoef
+  void computeShortTime();
 
   // Populate solvers lazily as needed
   void ensureHaveHeatDistanceWorker();
   void ensureHaveVectorHeatSolver();
-
-  // Lazy strategy: bootstrap off the mesh version of the solver for distance solves on the tufted mesh
-  std::unique_ptr<surface::HeatMethodDistanceSolver> heatDistanceWorker;
+  SparseMatrix<double> buildVectorHeatOperator();
 
   // Solvers
+  // (distance runs the mesh heat method on the tufted triangulation, whose heat solver is also used for scalar
+  // interpolation)
+  std::unique_ptr<surface::HeatMethodDistanceSolver> heatDistanceWorker;
   std::unique_ptr<PositiveDefiniteSolver<double>> vectorHeatSolver;
 };
 
@@ -3,9 +3,23 @@
 #include "geometrycentral/pointcloud/point_cloud.h"
 #include "geometrycentral/pointcloud/point_position_geometry.h"
 
+#include <map>
+
 namespace geometrycentral {
 namespace pointcloud {
 
+// Supported file types:
+//   - "ply": ascii or binary. Binary vertex records without list properties are decoded in parallel.
+//   - "obj": only vertex (and vertex normal) lines are read
+//   - "gcpc": a simple native binary format; a short header naming the per-point fields, then one record of
+//     little-endian doubles per point
+
+// Per-point data stored in a file alongside the positions
+struct PointCloudAttributes {
+  PointData<Vector3> normals;                       // empty if absent. From/to properties "nx", "ny", "nz"
+  std::map<std::string, PointData<double>> scalars; // any other scalar per-point properties, by name
+};
+
 // === Readers ===
 
 // Read from a file by name. Type can be optionally inferred from filename.
@@ -16,6 +30,12 @@ std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>>
 std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud(std::istream& in,
                                                                                                std::string type);
 
+// Same as above, but also read normals and any other scalar properties of the points
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>, PointCloudAttributes>
+readPointCloudWithAttributes(std::string filename, std::string type = "");
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>, PointCloudAttributes>
+readPointCloudWithAttributes(std::istream& in, std::string type);
+
 
 // === Writers ===
 
@@ -25,5 +45,87 @@ void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::st
 // Same as above, to to an ostream. Must specify type.
 void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::ostream& out, std::string type);
 
+// Same as above, but also write attributes. Binary formats store everything as doubles. The "obj" type supports normals
+// but not scalars.
+void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, const PointCloudAttributes& attributes,
+                     std::string filename, std::string type = "");
+void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, const PointCloudAttributes& attributes,
+                     std::ostream& out, std::string type);
+
+// Writes a cloud incrementally, a chunk of points at a time, so it never needs to be held in memory all at once. The
+// number of points must be known up front.
+class PointCloudWriter {
+public:
+  PointCloudWriter(std::string filename, size_t nPoints, bool withNormals = false,
+                   std::vector<std::string> scalarNames = {}, std::string type = "");
+  PointCloudWriter(std::ostream& out, std::string type, size_t nPoints, bool withNormals = false,
+                   std::vector<std::string> scalarNames = {});
+  ~PointCloudWriter();
+
+  // Append a chunk of points. Normals must be given iff withNormals, and scalars[i] holds the values of the i'th scalar.
+  void write(const std::vector<Vector3>& positions, const std::vector<Vector3>& normals = {},
+             const std::vector<std::vector<double>>& scalars = {});
+
+  // Flush, and check that exactly nPoints were written. The destructor also closes the writer, but does not report
+  // errors.
+  void close();
+
+private:
+  // "PImpl" idiom
+  class WriterImpl;
+  std::unique_ptr<WriterImpl> impl;
+};
+
+
+// === Streaming ===
+
+// A source of point positions which is read sequentially in chunks, possibly over several passes. Used to process
+// clouds which are too large to hold in memory at once (see tiled_point_cloud.h).
+class PointStream {
+public:
+  virtual ~PointStream() {}
+
+  // Return to the first point
+  virtual void rewind() = 0;
+
+  // Read up to maxCount further points, replacing the contents of `buffer`. Returns false once no points remain.
+  virtual bool read(std::vector<Vector3>& buffer, size_t maxCount) = 0;
+
+  // Total number of points in the stream, if known in advance (otherwise INVALID_IND)
+  virtual size_t size() const { return INVALID_IND; }
+};
+
+// Streams points from an array in memory, mainly for testing. Holds its own copy of the points (move the array in to
+// avoid copying).
+class VectorPointStream : public PointStream {
+public:
+  VectorPointStream(std::vector<Vector3> points);
+
+  void rewind() override;
+  bool read(std::vector<Vector3>& buffer, size_t maxCount) override;
+  size_t size() const override;
+
+private:
+  std::vector<Vector3> points;
+  size_t nextInd = 0;
+};
+
+// Streams the vertex positions of a .ply file without loading the whole file. Supports ascii and binary (either
+// endianness) files, with any scalar type for x/y/z.
+class PLYPointStream : public PointStream {
+public:
+  PLYPointStream(std::string filename);
+  ~PLYPointStream();
+
+  void rewind() override;
+  bool read(std::vector<Vector3>& buffer, size_t maxCount) override;
+  size_t size() const override;
+
+private:
+  // "PImpl" idiom
+  class PLYStreamImpl;
+  std::unique_ptr<PLYStreamImpl> impl;
+};
+
 } // namespace pointcloud
 } // namespace geometrycentral
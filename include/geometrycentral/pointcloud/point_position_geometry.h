@@ -48,8 +48,6 @@ public:
 
   // === Quantities
 
-  // TODO switch all the neighborhood stuff to a flat representation w/ containers rather than ested vectors
-
   // Point indices
   PointData<size_t> pointIndices;
   void requirePointIndices();
@@ -71,13 +69,13 @@ public:
   void unrequireTangentBasis();
 
   // Neighborhood tangent coordinates
-  PointData<std::vector<Vector2>> tangentCoordinates;
+  NeighborData<Vector2> tangentCoordinates;
   void requireTangentCoordinates();
   void unrequireTangentCoordinates();
 
   // Rotations to align tangent space
   // tangentTransport[i][j] holds the rotation which maps a vector in the tangent space of i to that of j.
-  PointData<std::vector<Vector2>> tangentTransport;
+  NeighborData<Vector2> tangentTransport;
   void requireTangentTransport();
   void unrequireTangentTransport();
 
@@ -129,10 +127,10 @@ protected:
   DependentQuantityD<PointData<std::array<Vector3, 2>>> tangentBasisQ;
   virtual void computeTangentBasis();
 
-  DependentQuantityD<PointData<std::vector<Vector2>>> tangentCoordinatesQ;
+  DependentQuantityD<NeighborData<Vector2>> tangentCoordinatesQ;
   virtual void computeTangentCoordinates();
 
-  DependentQuantityD<PointData<std::vector<Vector2>>> tangentTransportQ;
+  DependentQuantityD<NeighborData<Vector2>> tangentTransportQ;
   virtual void computeTangentTransport();
 
   std::pair<std::unique_ptr<surface::SurfaceMesh>*, std::unique_ptr<surface::EdgeLengthGeometry>*> tuftedTriPair;
@@ -163,6 +161,10 @@ protected:
   std::tuple<Vector2, bool> transportBetweenOriented(Point pSource, Point pTarget);
 };
 
+// Unoriented normal at a point from the positions of its neighbors, via PCA: the direction in which the neighbors vary
+// least about the point. Solves the 3x3 symmetric eigenproblem in closed form.
+Vector3 estimateNormal(Vector3 center, const Vector3* neighborPositions, size_t nNeighbors);
+
 
 } // namespace pointcloud
 } // namespace geometrycentral
@@ -5,14 +5,54 @@
 #include "geometrycentral/surface/embedded_geometry_interface.h"
 #include "geometrycentral/surface/surface_point.h"
 
+#include <cstdint>
 #include <tuple>
 
 namespace geometrycentral {
 namespace pointcloud {
 
+// Sample nPts points uniformly from the surface. The first version is seeded randomly; the second is deterministic for
+// a given seed, regardless of the number of threads.
 std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<surface::SurfacePoint>>
 uniformlySamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, size_t nPts);
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<surface::SurfacePoint>>
+uniformlySamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, size_t nPts,
+                               uint64_t seed);
+
+// Blue-noise sampling: points on the surface no closer than minDistance to each other (in 3D), by dart throwing
+// against a set of uniform candidate samples. More candidates give a denser, more even result. Deterministic for a given
+// seed, regardless of the number of threads. Throws if minDistance is so small that more than 2^28 candidates would be
+// needed.
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<surface::SurfacePoint>>
+poissonDiskSamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom,
+                                 double minDistance, uint64_t seed = 0, double candidatesPerDiskArea = 8.);
+
+// Draws uniform samples from a triangle mesh, for generating many samples efficiently. The i'th sample of the sequence
+// depends only on the seed and i, so samples can be generated in parallel, in chunks, and reproducibly.
+class SurfaceSampler {
+public:
+  // The mesh (but not the geometry) must outlive the sampler
+  SurfaceSampler(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, uint64_t seed = 0);
+
+  // Write samples [first, first + count) of the sequence to the buffers, which must hold count entries. Either buffer
+  // may be null.
+  void sample(size_t first, size_t count, Vector3* positions, surface::SurfacePoint* sources) const;
+
+  // Fill the containers with samples [first, first + nPoints) of the sequence. The cloud must be compressed.
+  void sample(PointData<Vector3>& positions, PointData<surface::SurfacePoint>& sources, size_t first = 0) const;
+
+  const uint64_t seed;
+  double totalArea() const { return areaSum; }
+
+private:
+  std::vector<surface::Face> faces;
+  std::vector<std::array<Vector3, 3>> faceVertexPositions;
+  double areaSum = 0.;
 
+  // Walker alias table over faces, with probability proportional to area
+  std::vector<double> aliasProb;
+  std::vector<size_t> aliasInd;
+};
 
-}
+} // namespace pointcloud
 } // namespace geometrycentral
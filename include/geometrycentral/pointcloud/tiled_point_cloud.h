@@ -0,0 +1,79 @@
+#pragma once
+
+#include "geometrycentral/pointcloud/point_cloud_io.h"
+#include "geometrycentral/utilities/vector3.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+// Process point clouds which are too large to hold in memory, by partitioning space in to a grid of cubical tiles.
+// Each tile is loaded along with a halo of nearby points from the surrounding tiles, per-point quantities are computed
+// on the tile, and the results for the tile's own points are handed back to the caller. Points are read from a
+// PointStream in several sequential passes, so only the tiles currently being processed are held in memory.
+
+namespace geometrycentral {
+namespace pointcloud {
+
+struct TiledProcessingOptions {
+  double tileSize = -1.;                // edge length of the cubical tiles. If <= 0, chosen from targetPointsPerTile
+  size_t targetPointsPerTile = 1000000; // (assuming roughly uniform density)
+  double haloWidth = -1.;               // overlap loaded around each tile. If <= 0, 10% of the tile size
+  unsigned int kNeighborSize = 30;      // as in PointPositionGeometry
+  size_t maxPointsInMemory = 50000000;  // bound on the tile + halo points loaded at once (a single larger tile still
+                                        // gets loaded alone)
+  size_t readChunkSize = 1 << 16;       // points per read from the stream
+};
+
+// Results for the points which lie in one tile
+struct PointCloudTile {
+  size_t index;                      // index of the tile in the grid, in x-major order
+  std::array<size_t, 3> gridIndex;   // {i,j,k} tile coordinates
+  Vector3 boxMin, boxMax;            // bounds of the tile, excluding the halo
+  std::vector<size_t> pointIndices;  // index of each point in the stream
+  std::vector<Vector3> positions;
+  std::vector<Vector3> normals;      // unoriented, computed via PCA as in PointPositionGeometry
+  std::vector<std::array<Vector3, 2>> tangentBasis;
+
+  // Neighbors of the i'th point (as stream indices), sorted by distance, are
+  // neighborIndices[neighborStart[i]], ..., neighborIndices[neighborStart[i+1]-1]
+  std::vector<size_t> neighborStart;
+  std::vector<size_t> neighborIndices;
+
+  // Number of points whose neighborhood reaches past the halo, so some true neighbors may be missing. Increase the halo
+  // width if this is nonzero. Points in tiles too sparse to compute a neighborhood at all are also counted, and get
+  // no neighbors and an undefined normal.
+  size_t nInexactNeighborhoods = 0;
+};
+
+struct TiledProcessingStats {
+  size_t nPoints = 0;
+  size_t nTiles = 0;          // non-empty tiles
+  size_t nPasses = 0;         // passes over the stream, including the initial bounding-box and counting passes
+  size_t maxTilePoints = 0;   // largest tile, including its halo
+  size_t nInexactNeighborhoods = 0;
+  double tileSize = 0.;
+  double haloWidth = 0.;
+};
+
+// Compute normals, tangent bases, and neighborhoods tile-by-tile, calling `callback` once for each non-empty tile on the
+// calling thread. Tiles within a pass are processed in parallel (see parallel.h).
+TiledProcessingStats processPointCloudTiled(PointStream& stream, const std::function<void(PointCloudTile&)>& callback,
+                                            TiledProcessingOptions options = TiledProcessingOptions());
+
+// Per-point results for a whole cloud, indexed like the stream, stitched together from the tiles
+struct TiledGeometryResult {
+  std::vector<Vector3> normals;
+  std::vector<std::array<Vector3, 2>> tangentBasis;
+  std::vector<size_t> neighborStart; // compressed-row layout, as in Neighborhoods
+  std::vector<size_t> neighborIndices;
+  TiledProcessingStats stats;
+};
+
+// Same as above, but gathers the results in memory. Useful when the per-point results fit in memory, even though the
+// full neighborhood structures for the whole cloud would not.
+TiledGeometryResult computeGeometryTiled(PointStream& stream,
+                                         TiledProcessingOptions options = TiledProcessingOptions());
+
+} // namespace pointcloud
+} // namespace geometrycentral
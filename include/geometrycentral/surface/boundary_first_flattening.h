@@ -5,6 +5,9 @@
 #include "geometrycentral/surface/intrinsic_geometry_interface.h"
 #include "geometrycentral/surface/manifold_surface_mesh.h"
 
+#include <tuple>
+#include <vector>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -14,6 +17,12 @@ VertexData<Vector2> parameterizeBFFfromScaleFactors(ManifoldSurfaceMesh& mesh, I
 VertexData<Vector2> parameterizeBFFfromExteriorAngles(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geo,
                                                       const VertexData<double>& exteriorAngles);
 
+// Flatten every connected component of the mesh, each of which must be a topological disk (e.g. the charts of a mesh
+// cut with cutAlongEdges()). Charts are flattened independently and in parallel, each in its own coordinates. Also
+// returns the chart of each vertex; charts are numbered in order of their first vertex.
+std::tuple<VertexData<Vector2>, VertexData<size_t>> parameterizeBFFCharts(ManifoldSurfaceMesh& mesh,
+                                                                          IntrinsicGeometryInterface& geo);
+
 class BFF {
 public:
   BFF(ManifoldSurfaceMesh& mesh_, IntrinsicGeometryInterface& geo_);
@@ -23,9 +32,19 @@ public:
   VertexData<Vector2> flattenFromExteriorAngles(const VertexData<double>& kBdy);
   VertexData<Vector2> flattenFromBoth(const Vector<double>& uBdy, const Vector<double>& kBdy);
 
+  // Flatten with many boundary conditions at once; the linear solves for all of them are blocked together
+  std::vector<VertexData<Vector2>> flattenFromScaleFactors(const std::vector<VertexData<double>>& uBdys);
+  std::vector<VertexData<Vector2>> flattenFromExteriorAngles(const std::vector<VertexData<double>>& kBdys);
+  std::vector<VertexData<Vector2>> flattenFromBothMultiple(const DenseMatrix<double>& uBdys,
+                                                           const DenseMatrix<double>& kBdys);
+
   Vector<double> dirichletToNeumann(const Vector<double>& uBdy);
   Vector<double> neumannToDirichlet(const Vector<double>& kBdy);
 
+  // One boundary condition per column
+  DenseMatrix<double> dirichletToNeumannMultiple(const DenseMatrix<double>& uBdys);
+  DenseMatrix<double> neumannToDirichletMultiple(const DenseMatrix<double>& kBdys);
+
   std::array<Vector<double>, 2> computeBoundaryPositions(const Vector<double>& uBdy, const Vector<double>& kBdy);
 
 protected:
@@ -46,6 +65,9 @@ protected:
   BlockDecompositionResult<double> Ldecomp;
 
   void ensureHaveLSolver();
+  DenseMatrix<double> boundaryValues(const std::vector<VertexData<double>>& data);
+  VertexData<Vector2> assemble(const Vector<double>& boundaryX, const Vector<double>& boundaryY,
+                               const Vector<double>& interiorX, const Vector<double>& interiorY);
 };
 
 } // namespace surface
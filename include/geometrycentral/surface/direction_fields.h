@@ -1,9 +1,15 @@
 #pragma once
 
+#include "geometrycentral/numerical/linear_solvers.h"
 #include "geometrycentral/surface/intrinsic_geometry_interface.h"
 #include "geometrycentral/surface/extrinsic_geometry_interface.h"
 #include "geometrycentral/surface/embedded_geometry_interface.h"
 
+#include <complex>
+#include <map>
+#include <memory>
+#include <vector>
+
 
 namespace geometrycentral {
 namespace surface {
@@ -27,6 +33,44 @@ VertexData<Vector2> computeCurvatureAlignedVertexDirectionField(ExtrinsicGeometr
 
 FaceData<Vector2> computeCurvatureAlignedFaceDirectionField(EmbeddedGeometryInterface& geometry, int nSym = 2);
 
+// Computes many direction fields on the same surface. The connection Laplacian for each symmetry order is assembled and
+// factored on first use, then kept, and alignment problems with several guidance fields are solved together, with one
+// right-hand side per field.
+//
+// Fields use the same representation and energies as the functions above: each value is the nSym'th power of any one
+// of the nSym directions.
+class DirectionFieldSolver {
+public:
+  DirectionFieldSolver(IntrinsicGeometryInterface& geometry);
+  ~DirectionFieldSolver();
+
+  VertexData<Vector2> smoothestVertexField(int nSym = 1);
+  FaceData<Vector2> smoothestFaceField(int nSym = 1);
+  VertexData<Vector2> smoothestBoundaryAlignedVertexField(int nSym = 1);
+  FaceData<Vector2> smoothestBoundaryAlignedFaceField(int nSym = 1);
+
+  // Smooth fields pulled towards guidance fields, one result per guidance field. Longer guidance vectors pull harder,
+  // and zero vectors leave the field free. With principal curvature directions as guidance, these are the
+  // curvature-aligned fields above.
+  std::vector<VertexData<Vector2>> alignedVertexFields(const std::vector<VertexData<Vector2>>& guidance, int nSym = 1);
+  std::vector<FaceData<Vector2>> alignedFaceFields(const std::vector<FaceData<Vector2>>& guidance, int nSym = 1);
+
+private:
+  IntrinsicGeometryInterface& geometry;
+
+  struct Operator {
+    SparseMatrix<std::complex<double>> energy;
+    std::unique_ptr<PositiveDefiniteSolver<std::complex<double>>> solver;
+  };
+  SparseMatrix<std::complex<double>> vertexMass, faceMass;
+  std::map<int, Operator> vertexOperators, faceOperators;
+
+  Operator& vertexOperator(int nSym);
+  Operator& faceOperator(int nSym);
+  DenseMatrix<std::complex<double>> solveAligned(Operator& op, const SparseMatrix<std::complex<double>>& mass,
+                                                 const DenseMatrix<std::complex<double>>& guidance);
+};
+
 
 // Find singularities in direction fields
 FaceData<int> computeFaceIndex(IntrinsicGeometryInterface& geometry, const VertexData<Vector2>& directionField,
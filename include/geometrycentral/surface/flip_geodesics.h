@@ -251,5 +251,23 @@ public:
   void purgeStaleQueueEntries(); // stop too many stale entries from accumulating
 };
 
+
+// === Batch straightening
+
+// Straighten many independent paths in parallel.
+//
+// Unlike building one FlipEdgeNetwork from all of the paths, each path here is straightened in isolation, as if it were
+// the only path on the surface, so paths never block or layer against each other. Each worker thread owns a single
+// copy of the intrinsic triangulation and rewinds its flips after every path, so memory scales with the number of
+// threads rather than the number of paths (see setNumThreads() in utilities/parallel.h).
+//
+// Input paths are sequences of halfedges on `mesh`, as for the FlipEdgeNetwork constructor. Returns each straightened
+// path as a polyline on `mesh`, in the same order as the input (empty input paths give empty polylines).
+std::vector<std::vector<SurfacePoint>> straightenPathsInParallel(ManifoldSurfaceMesh& mesh,
+                                                                 IntrinsicGeometryInterface& geom,
+                                                                 const std::vector<std::vector<Halfedge>>& paths,
+                                                                 size_t maxIterations = INVALID_IND,
+                                                                 double maxRelativeLengthDecrease = 0.);
+
 } // namespace surface
 } // namespace geometrycentral
@@ -46,6 +46,15 @@ public:
   // (returns WITHOUT performing constant shift to 0)
   Vector<double> computeDistanceRHS(const Vector<double>& rhs);
 
+  // As above, for each column of `rhs`. All columns are solved against the same factorizations, and the rest of the
+  // pipeline runs over the columns in parallel (see parallel.h).
+  DenseMatrix<double> computeDistanceRHSMultiple(const DenseMatrix<double>& rhs);
+
+  // Call after the geometry changes: either pass the same geometry after refreshQuantities(), or a new geometry on a
+  // mesh with the same vertices. Rebuilds the operators, reusing the symbolic factorizations when their sparsity is
+  // unchanged. Returns true if every factorization was reused.
+  bool updateGeometry(IntrinsicGeometryInterface& newGeom);
+
   // === Options and parameters
 
   const double tCoef; // the time parameter used for heat flow, measured as time = tCoef * mean_edge_length^2
@@ -55,9 +64,9 @@ public:
 private:
   // === Members
 
-  // Input mesh and geometry
-  SurfaceMesh& mesh;
-  IntrinsicGeometryInterface& geom;
+  // Input mesh and geometry (pointers, since updateGeometry() may replace them)
+  SurfaceMesh* mesh;
+  IntrinsicGeometryInterface* geom;
 
   // Tufted cover mesh & geometry (these will only be popualted if useRobustLaplacian = true)
   std::unique_ptr<SurfaceMesh> tuftedMesh;
@@ -72,6 +81,10 @@ private:
 
   // Helpers
 
+  // Build (or refactor) the heat and Poisson solvers for the current geometry. Returns true if both reused their
+  // symbolic factorizations.
+  bool buildOperators();
+
   // Return either the input mesh/geometry, or the tufted mesh/geometry, based on whether useRobustLaplacian=true
   SurfaceMesh& getMesh();
   IntrinsicGeometryInterface& getGeom();
@@ -26,6 +26,17 @@ namespace surface {
 // See the SIGGRAPH 2021 Course "Geometry Processing with Intrinsic Triangulations" by Nicholas Sharp, Mark Gillespie,
 // and Keenan Crane for an introduction to these techniques.
 
+// Counters reported by delaunayRefine()
+struct DelaunayRefineStats {
+  size_t nFlips = 0;
+  size_t nInsertions = 0;
+  size_t nRemovals = 0;       // previously-inserted vertices deleted near split edges
+  double elapsedSeconds = 0.; // wall-clock time for the whole refinement
+
+  double flipsPerSecond() const;
+  double insertionsPerSecond() const;
+};
+
 class IntrinsicTriangulation : public EdgeLengthGeometry {
 
 public:
@@ -144,21 +155,26 @@ public:
   // Flips edges in the intrinsic triangulation until is satisfies the intrinsic Delaunay criterion
   void flipToDelaunay();
 
+  // Same as flipToDelaunay(), but tests the Delaunay criterion in parallel, flipping in rounds over batches of edges
+  // which share no triangles
+  void flipToDelaunayParallel();
+
   // Perform intrinsic Delaunay refinement the intrinsic triangulation until it simultaneously:
   //   - satisfies the intrinsic Delaunay criterion
   //   - has no angles smaller than `angleThreshDegrees` (values > 30 degrees may not terminate)
   //   - has no triangles larger than `circumradiusThresh`
   // Terminates no matter what after maxInsertions insertions (infinite by default)
-  void delaunayRefine(double angleThreshDegrees = 25.,
-                      double circumradiusThresh = std::numeric_limits<double>::infinity(),
-                      size_t maxInsertions = INVALID_IND);
+  DelaunayRefineStats delaunayRefine(double angleThreshDegrees = 25.,
+                                     double circumradiusThresh = std::numeric_limits<double>::infinity(),
+                                     size_t maxInsertions = INVALID_IND);
 
 
   // General version of intrinsic Delaunay refinement, taking a function which will be called
   // to determine if a triangle should be refined.
   // Will return only when all triangles pass this function, or maxInsertions is exceeded, so
   // be sure to chose arguments such that the function terminates.
-  void delaunayRefine(const std::function<bool(Face)>& shouldRefine, size_t maxInsertions = INVALID_IND);
+  DelaunayRefineStats delaunayRefine(const std::function<bool(Face)>& shouldRefine,
+                                     size_t maxInsertions = INVALID_IND);
 
 
   // ======================================================
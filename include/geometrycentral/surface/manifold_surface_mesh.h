@@ -106,6 +106,12 @@ protected:
 
 
   friend class RichSurfaceMeshData;
+
+  // subdivide() derives refined connectivity directly, and builds the mesh from its arrays (in subdivide.cpp)
+  friend std::unique_ptr<ManifoldSurfaceMesh>
+  subdivisionMeshFromArrays(const std::vector<size_t>& heNext, const std::vector<size_t>& heVertex,
+                            const std::vector<size_t>& heFace, const std::vector<size_t>& vHalfedge,
+                            const std::vector<size_t>& fHalfedge, size_t nBoundaryLoops);
 };
 
 } // namespace surface
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "geometrycentral/surface/manifold_surface_mesh.h"
+#include "geometrycentral/surface/vertex_position_geometry.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Process large meshes a piece at a time, by partitioning the faces in to connected tiles. Each tile is extracted as a
+// standalone mesh along with a halo of the surrounding faces, so per-element quantities which only look at nearby
+// elements (normals, curvatures, Laplacian smoothing, ...) can be computed on the tile exactly as they would be on the
+// whole mesh. Results for the elements each tile owns are stitched back in to global MeshData.
+//
+// Tiles only hold their own faces and halo, so geometry quantities, operators, and factorizations built on a tile are
+// bounded by the tile size, and tiles can be processed in parallel, written out with the usual mesh IO, or sent
+// elsewhere. The connectivity of the whole mesh is needed to build the tiling.
+
+namespace geometrycentral {
+namespace surface {
+
+struct MeshTilingOptions {
+  size_t targetFacesPerTile = 100000; // tiles are grown to this many faces (some may be smaller)
+  size_t haloRings = 1;               // rings of faces around each tile included as halo (at least 1)
+};
+
+// One tile, with its halo, as a standalone mesh. The local mesh is compressed, and local element i corresponds to
+// global element parentVertex[i], etc. (as indices in the global mesh).
+//
+// Where the halo touches a global vertex along several separate fans of faces, the vertex is split in to one local
+// vertex per fan (as if the mesh were cut along the edge of the halo), so that the tile is always manifold. Owned
+// vertices are never split.
+struct MeshTile {
+  size_t index;
+  std::unique_ptr<ManifoldSurfaceMesh> mesh;
+  std::unique_ptr<VertexPositionGeometry> geometry;
+
+  VertexData<size_t> parentVertex;
+  EdgeData<size_t> parentEdge;
+  FaceData<size_t> parentFace;
+
+  // Is this tile the owner of the element? Each element of the global mesh is owned by exactly one tile. A tile's
+  // owned elements have all of their elements within haloRings rings present in the tile, as in the global mesh.
+  VertexData<char> ownsVertex;
+  EdgeData<char> ownsEdge;
+  FaceData<char> ownsFace;
+};
+
+class MeshTiling {
+
+public:
+  // Grow tiles over the faces of the mesh
+  MeshTiling(ManifoldSurfaceMesh& mesh, MeshTilingOptions options = MeshTilingOptions());
+
+  // Use an existing partition, with faces assigned to tiles 0, ..., (max value). Tiles need not be connected.
+  MeshTiling(ManifoldSurfaceMesh& mesh, const FaceData<size_t>& faceTile,
+             MeshTilingOptions options = MeshTilingOptions());
+
+  ManifoldSurfaceMesh& mesh;
+  const MeshTilingOptions options;
+
+  size_t nTiles() const { return tileFaces.size(); }
+
+  // The tile which owns each element. Faces are owned by the tile they belong to; vertices and edges by the adjacent
+  // face with the smallest tile index.
+  FaceData<size_t> faceTile;
+  EdgeData<size_t> edgeTile;
+  VertexData<size_t> vertexTile;
+
+  // Faces owned by each tile
+  std::vector<std::vector<Face>> tileFaces;
+
+  // Build a tile and its halo, with positions from geom
+  MeshTile extractTile(size_t iTile, VertexPositionGeometry& geom) const;
+
+  // Extract every tile and call f on it. Tiles are extracted and processed in parallel (see parallel.h), so f may be
+  // called concurrently from several threads. Each tile is freed once f returns, so only one tile per thread is held
+  // in memory at a time.
+  void forEachTile(VertexPositionGeometry& geom, const std::function<void(MeshTile&)>& f) const;
+
+  // Copy the values at the tile's owned elements in to global data on the tiling's mesh. Different tiles write
+  // different elements, so tiles may be stitched concurrently.
+  template <typename T>
+  void stitch(const MeshTile& tile, const VertexData<T>& tileData, VertexData<T>& globalData) const;
+  template <typename T>
+  void stitch(const MeshTile& tile, const EdgeData<T>& tileData, EdgeData<T>& globalData) const;
+  template <typename T>
+  void stitch(const MeshTile& tile, const FaceData<T>& tileData, FaceData<T>& globalData) const;
+
+  // Evaluate a per-tile kernel on every tile, and stitch the results in to global data
+  template <typename T>
+  VertexData<T> computeVertexData(VertexPositionGeometry& geom,
+                                  const std::function<VertexData<T>(MeshTile&)>& kernel) const;
+  template <typename T>
+  EdgeData<T> computeEdgeData(VertexPositionGeometry& geom, const std::function<EdgeData<T>(MeshTile&)>& kernel) const;
+  template <typename T>
+  FaceData<T> computeFaceData(VertexPositionGeometry& geom, const std::function<FaceData<T>(MeshTile&)>& kernel) const;
+
+private:
+  void assignOwners();
+};
+
+} // namespace surface
+} // namespace geometrycentral
+
+#include "geometrycentral/surface/mesh_tiling.ipp"
@@ -0,0 +1,52 @@
+#pragma once
+
+namespace geometrycentral {
+namespace surface {
+
+template <typename T>
+void MeshTiling::stitch(const MeshTile& tile, const VertexData<T>& tileData, VertexData<T>& globalData) const {
+  for (Vertex v : tile.mesh->vertices()) {
+    if (tile.ownsVertex[v]) globalData[mesh.vertex(tile.parentVertex[v])] = tileData[v];
+  }
+}
+
+template <typename T>
+void MeshTiling::stitch(const MeshTile& tile, const EdgeData<T>& tileData, EdgeData<T>& globalData) const {
+  for (Edge e : tile.mesh->edges()) {
+    if (tile.ownsEdge[e]) globalData[mesh.edge(tile.parentEdge[e])] = tileData[e];
+  }
+}
+
+template <typename T>
+void MeshTiling::stitch(const MeshTile& tile, const FaceData<T>& tileData, FaceData<T>& globalData) const {
+  for (Face f : tile.mesh->faces()) {
+    if (tile.ownsFace[f]) globalData[mesh.face(tile.parentFace[f])] = tileData[f];
+  }
+}
+
+template <typename T>
+VertexData<T> MeshTiling::computeVertexData(VertexPositionGeometry& geom,
+                                            const std::function<VertexData<T>(MeshTile&)>& kernel) const {
+  VertexData<T> result(mesh);
+  forEachTile(geom, [&](MeshTile& tile) { stitch(tile, kernel(tile), result); });
+  return result;
+}
+
+template <typename T>
+EdgeData<T> MeshTiling::computeEdgeData(VertexPositionGeometry& geom,
+                                        const std::function<EdgeData<T>(MeshTile&)>& kernel) const {
+  EdgeData<T> result(mesh);
+  forEachTile(geom, [&](MeshTile& tile) { stitch(tile, kernel(tile), result); });
+  return result;
+}
+
+template <typename T>
+FaceData<T> MeshTiling::computeFaceData(VertexPositionGeometry& geom,
+                                        const std::function<FaceData<T>(MeshTile&)>& kernel) const {
+  FaceData<T> result(mesh);
+  forEachTile(geom, [&](MeshTile& tile) { stitch(tile, kernel(tile), result); });
+  return result;
+}
+
+} // namespace surface
+} // namespace geometrycentral
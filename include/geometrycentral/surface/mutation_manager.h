@@ -154,11 +154,11 @@ public:
 
   // Improve mesh quality by alternating between perturbing vertices in their tangent plane, and splitting/collapsing
   // poorly-sized edges.
-  // void isotopicRemesh();
+  // (see remesh() in remeshing.h, which takes a MutationManager)
 
   // Simplify the the mesh by performing edge collapses to minimize error in the sense of the quadric error metric.
   // see [Garland & Heckbert 1997] "Surface Simplification Using Quadric Error Metrics"
-  // void quadricErrorSimplify(size_t nTargetVerts);
+  // (see quadricErrorSimplify() in quadric_error_simplification.h, which takes a MutationManager)
 
   // Split edges in the mesh until all edges satisfy the Delaunay criterion
   // see e.g. [Liu+ 2015] "Efficient Construction and Simplification of Delaunay Meshes"
@@ -4,6 +4,9 @@
 #include "geometrycentral/surface/intrinsic_geometry_interface.h"
 #include "geometrycentral/surface/manifold_surface_mesh.h"
 
+#include <functional>
+#include <vector>
+
 
 namespace geometrycentral {
 namespace surface {
@@ -13,8 +16,27 @@ namespace surface {
   // Paramerize a disk-like surface (without introducing any cuts or cones)
   VertexData<Vector2> parameterizeDisk(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geometry);
   
-  // Paramerize a surface with the specified cut (which must render the surface a disk)
-  // TODO not implemented
-  CornerData<Vector2> parameterize(SurfaceMesh& mesh, IntrinsicGeometryInterface& geometry, const EdgeData<char>& cut);
+  // Paramerize a surface with the specified cut, which must cut it into one or more disks (charts). Charts are
+  // parameterized independently and in parallel, each in its own coordinates. Values are per-corner, since vertices
+  // along the cut get one position on each side.
+  CornerData<Vector2> parameterize(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geometry,
+                                   const EdgeData<char>& cut);
+
+  // === Charts
+
+  // The connected components of a mesh. Each chart lists its vertices and faces in the order of the mesh.
+  struct SurfaceCharts {
+    VertexData<size_t> chart; // index of the chart of each vertex
+    std::vector<std::vector<Vertex>> vertices;
+    std::vector<std::vector<Face>> faces;
+  };
+  SurfaceCharts findCharts(ManifoldSurfaceMesh& mesh);
+
+  // Parameterize each chart on a mesh of its own, with the given edge lengths, in parallel (see parallel.h).
+  // `parameterizeChart` is called with the mesh of one chart, whose vertices and faces are in the order of the chart's,
+  // and must be safe to call concurrently.
+  VertexData<Vector2> parameterizeCharts(
+      ManifoldSurfaceMesh& mesh, const SurfaceCharts& charts, const EdgeData<double>& edgeLengths,
+      const std::function<VertexData<Vector2>(ManifoldSurfaceMesh&, IntrinsicGeometryInterface&)>& parameterizeChart);
 
 }}
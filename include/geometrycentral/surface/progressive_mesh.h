@@ -0,0 +1,194 @@
+#pragma once
+
+#include "geometrycentral/surface/manifold_surface_mesh.h"
+#include "geometrycentral/surface/mutation_manager.h"
+#include "geometrycentral/surface/quadric_error_simplification.h"
+#include "geometrycentral/surface/vertex_position_geometry.h"
+
+#include <array>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+// Progressive meshes, in the sense of [Hoppe 1996] "Progressive Meshes". A sequence of edge collapses is recorded as
+// a coarse base mesh plus a list of vertex splits which undo the collapses one at a time. Replaying the splits forward
+// or backward reaches any level of detail without re-running simplification, and the splits can be streamed to a
+// reader incrementally.
+//
+// Replay works on an indexed face set, not a halfedge mesh: vertex i of the progressive mesh is introduced by split
+// (i - nBaseVertices()), and the faces introduced by each split are numbered after all of the faces before it. Call
+// extractMesh() to build a mesh of the current level.
+
+namespace geometrycentral {
+namespace surface {
+
+// One vertex split, which refines the mesh by one vertex. Coarsening by the corresponding edge collapse uses the same
+// record. Corners are identified by 3 * face + (index of the corner in the face).
+struct VertexSplitRecord {
+  size_t splitVertex;                          // the existing vertex which is split
+  std::vector<std::array<size_t, 3>> newFaces; // 1 or 2, numbered consecutively after the existing faces
+  std::vector<size_t> movedCorners;            // corners which move from splitVertex to the new vertex
+  Vector3 splitVertexPosition;                 // positions after the split
+  Vector3 newVertexPosition;                   //
+  Vector3 collapsedVertexPosition;             // position of splitVertex before the split
+  std::vector<double> vertexValues;  // attribute values at splitVertex after, the new vertex, and splitVertex before
+  std::vector<size_t> fineCorners;   // corners around the two vertices after the split...
+  std::vector<double> fineValues;    // ...and their attribute values, in corner-major order
+  std::vector<size_t> coarseCorners; // corners around splitVertex before the split...
+  std::vector<double> coarseValues;  // ...and their attribute values
+};
+
+class ProgressiveMesh {
+public:
+  ProgressiveMesh(size_t nVertexAttributes = 0, size_t nCornerAttributes = 0);
+
+  // == Sizes
+  size_t nBaseVertices() const { return basePositions.size(); }
+  size_t nBaseFaces() const { return baseFaces.size(); }
+  size_t nSplits() const { return splits.size(); }
+  size_t nVertexAttributes() const { return nVertexAttributes_; }
+  size_t nCornerAttributes() const { return nCornerAttributes_; }
+
+  // Number of vertices and faces at the current level
+  size_t nVertices() const { return nBaseVertices() + currentLevel; }
+  size_t nFaces() const { return nActiveFaces; }
+
+  // == Level of detail
+  // The level is the number of splits applied to the base mesh; level nSplits() is the original mesh.
+  size_t level() const { return currentLevel; }
+  void setLevel(size_t newLevel); // clamped to [0, nSplits()]
+  void setVertexCount(size_t nVerts);
+  bool refine();  // apply the next split, returns false at the finest level
+  bool coarsen(); // undo the last split, returns false at the base level
+
+  // == Current level
+  Vector3 position(size_t v) const { return currentPositions[v]; }
+  std::array<size_t, 3> face(size_t f) const { return currentFaces[f]; }
+  double vertexValue(size_t v, size_t channel) const { return currentVertexValues[v * nVertexAttributes_ + channel]; }
+  double cornerValue(size_t corner, size_t channel) const {
+    return currentCornerValues[corner * nCornerAttributes_ + channel];
+  }
+
+  // Build a mesh of the current level. Vertex i of the mesh is vertex i of the progressive mesh, and face i is face i.
+  std::tuple<std::unique_ptr<ManifoldSurfaceMesh>, std::unique_ptr<VertexPositionGeometry>> extractMesh() const;
+
+  // Attribute values on a mesh returned by extractMesh() at the current level
+  VertexData<double> vertexAttribute(ManifoldSurfaceMesh& extracted, size_t channel) const;
+  CornerData<double> cornerAttribute(ManifoldSurfaceMesh& extracted, size_t channel) const;
+
+  // == Records
+  const VertexSplitRecord& split(size_t i) const { return splits[i]; }
+  void appendSplit(const VertexSplitRecord& record);
+
+  // == Serialization
+  // A little-endian binary stream, with 32-bit indices. The base mesh and blocks of splits can be written separately,
+  // so a reader can start from the base mesh and refine as more splits arrive.
+  void write(std::ostream& out) const; // the base mesh plus all splits
+  static ProgressiveMesh read(std::istream& in);
+
+  void writeBase(std::ostream& out) const;
+  void writeSplits(std::ostream& out, size_t first, size_t count) const;
+  static ProgressiveMesh readBase(std::istream& in);
+  size_t readSplits(std::istream& in); // appends a block written by writeSplits(), returns the number read
+
+private:
+  friend class ProgressiveMeshRecorder;
+
+  size_t nVertexAttributes_, nCornerAttributes_;
+
+  // Base mesh
+  std::vector<Vector3> basePositions;
+  std::vector<double> baseVertexValues;
+  std::vector<std::array<size_t, 3>> baseFaces;
+  std::vector<double> baseCornerValues;
+
+  std::vector<VertexSplitRecord> splits;
+  std::vector<size_t> splitFirstFace; // index of the first face introduced by each split
+
+  // Current state
+  size_t currentLevel = 0;
+  size_t nActiveFaces = 0;
+  std::vector<Vector3> currentPositions;
+  std::vector<std::array<size_t, 3>> currentFaces;
+  std::vector<double> currentVertexValues;
+  std::vector<double> currentCornerValues;
+
+  void setBase(const std::vector<Vector3>& positions, const std::vector<double>& vertexValues,
+               const std::vector<std::array<size_t, 3>>& faces, const std::vector<double>& cornerValues);
+  void applySplit(size_t i);
+  void undoSplit(size_t i);
+};
+
+// Records every edge collapse performed through a MutationManager, from construction until finish(), then returns
+// the progressive mesh whose base is the mesh at that point. Only collapses may be performed while recording; other
+// mutations through the manager throw.
+//
+// Attribute values are recorded at the vertex and corners of each collapse after all of the manager's callbacks have
+// run, so a policy registered on the same manager to update the attributes (e.g. to interpolate them with tCollapse) is
+// carried into the records. Attributes which are not updated just keep the values of the surviving elements.
+//
+// The recorder must be finished or destroyed before the MutationManager is.
+class ProgressiveMeshRecorder {
+public:
+  ProgressiveMeshRecorder(MutationManager& mm, const std::vector<VertexData<double>*>& vertexAttributes = {},
+                          const std::vector<CornerData<double>*>& cornerAttributes = {});
+  ~ProgressiveMeshRecorder();
+
+  // Stop recording. The mesh may have been compressed since recording began.
+  ProgressiveMesh finish();
+
+  size_t nCollapses() const { return events.size() + (pendingDone ? 1 : 0); }
+
+  // Hide copy and move constructors
+  ProgressiveMeshRecorder(const ProgressiveMeshRecorder& other) = delete;
+  ProgressiveMeshRecorder& operator=(const ProgressiveMeshRecorder& other) = delete;
+
+private:
+  class Policy;
+
+  MutationManager& mm;
+  ManifoldSurfaceMesh& mesh;
+  VertexPositionGeometry& geom;
+  std::vector<VertexData<double>*> vertexAttributes;
+  std::vector<CornerData<double>*> cornerAttributes;
+  MutationPolicyHandle policyHandle;
+  bool finished = false;
+  size_t nVertexIds;
+
+  // Elements are identified by their index when recording began, which survives compression
+  VertexData<size_t> vertexId;
+  FaceData<size_t> faceId;
+  std::vector<std::array<size_t, 3>> faceVerts; // by face id
+
+  // A collapse, in terms of ids; becomes a VertexSplitRecord
+  struct Event {
+    size_t survivor, removed;
+    std::vector<size_t> removedFaces;
+    VertexSplitRecord record;
+  };
+  std::vector<Event> events;
+
+  // The collapse in progress. Its coarse values are read at the start of the next collapse (or in finish()), after
+  // the other callbacks have updated them.
+  bool pending = false;
+  bool pendingDone = false;
+  Event pendingEvent;
+  Vertex pendingSurvivor;
+  std::vector<Face> pendingFaces;
+
+  void beforeCollapse(Edge e);
+  void afterCollapse(Vertex v);
+  void finalizePending();
+
+  void readCorners(Face f, std::vector<size_t>& corners, std::vector<double>& values) const;
+  void readVertex(Vertex v, std::vector<double>& values) const;
+};
+
+// Simplify the mesh in place as quadricErrorSimplify() does, recording the collapses. The simplified mesh is the base
+// of the returned progressive mesh. By default, simplifies as far as possible.
+ProgressiveMesh buildProgressiveMesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                                     const QuadricSimplifyOptions& options = QuadricSimplifyOptions());
+
+} // namespace surface
+} // namespace geometrycentral
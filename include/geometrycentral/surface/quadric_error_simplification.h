@@ -6,7 +6,7 @@
 
 #include "geometrycentral/utilities/elementary_geometry.h"
 
-#include <queue>
+#include <limits>
 
 namespace geometrycentral {
 namespace surface {
@@ -18,6 +18,10 @@ public:
   double cost(const Eigen::Vector3d& v);
   Eigen::Vector3d optimalPoint();
 
+  // The optimal point if it is well-defined, and otherwise the best of the two given points and their midpoint (e.g.
+  // for a collapse within a flat region, where the optimum is not unique)
+  Eigen::Vector3d optimalPoint(const Eigen::Vector3d& p1, const Eigen::Vector3d& p2);
+
   Quadric operator+=(const Quadric& Q);
 
 protected:
@@ -30,8 +34,34 @@ protected:
 
 Quadric operator+(const Quadric& Q1, const Quadric& Q2);
 
+// Simplify the mesh by collapsing edges in order of their quadric error, until the stopping criteria below are met or
+// no more edges can be collapsed. The mesh is compressed afterwards.
+// see [Garland & Heckbert 1997] "Surface Simplification Using Quadric Error Metrics"
+struct QuadricSimplifyOptions {
+  double tol = std::numeric_limits<double>::infinity(); // never perform a collapse with more error than this
+  size_t targetFaceCount = 0; // stop once the mesh has at most this many faces
+  double targetRatio = 0.;    // stop once the mesh has at most this fraction of its original faces
+
+  // Rather than collapsing the single cheapest edge at a time, collapse the cheapest edges in rounds. Each round takes
+  // a maximal set of non-conflicting collapses (with disjoint neighborhoods) from among the cheapest remaining edges.
+  // Much faster on large meshes, at the cost of a slightly less greedy ordering. Results do not depend on the number
+  // of threads.
+  bool parallel = false;
+
+  // Optional safeguards. All are off by default, which gives plain quadric simplification.
+  double boundaryWeight = 0.;  // weight of planes through boundary edges, perpendicular to their faces, which keep
+                               // boundaries in shape (e.g. 100)
+  bool checkTopology = false;  // skip collapses which fail the link condition or would pinch two boundaries together,
+                               // and never go below 4 faces
+  bool preventFoldOver = false; // skip collapses which would flip the normal of a remaining face
+};
+
 void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol = 0.05);
 void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol, MutationManager& mm);
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                          const QuadricSimplifyOptions& options);
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                          const QuadricSimplifyOptions& options, MutationManager& mm);
 
 } // namespace surface
 } // namespace geometrycentral
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "geometrycentral/surface/manifold_surface_mesh.h"
+#include "geometrycentral/surface/mutation_manager.h"
+#include "geometrycentral/surface/vertex_position_geometry.h"
+
+#include <limits>
+
+namespace geometrycentral {
+namespace surface {
+
+// Isotropic remeshing, in the style of [Botsch & Kobbelt 2004] "A Remeshing Approach to Multiresolution Modeling".
+// Each iteration splits edges longer than 4/3 of the target length, collapses edges shorter than 4/5 of it, flips
+// edges to bring vertex degrees closer to 6 (4 on the boundary), and relaxes vertices within their tangent planes.
+// Relaxed vertices are projected back onto the closest point of the input surface.
+//
+// Feature edges (those with a sharp dihedral angle) and boundary edges are preserved: they are only split or collapsed
+// along their own length, and their vertices only slide along them, projected onto the input feature lines. Vertices
+// where feature lines meet or turn sharply do not move.
+//
+// Collapses and flips are gathered and checked in parallel, then applied in batches of operations whose neighborhoods
+// do not overlap, found within spatial cells. Results do not depend on the number of threads.
+
+enum class RemeshBoundaryCondition { Fixed, Tangential };
+
+struct RemeshOptions {
+  double targetEdgeLength = -1; // if <= 0, use the mean edge length of the input
+  size_t maxIterations = 10;
+
+  // If > 0, the target length shrinks where the surface curves, to L / (1 + curvatureAdaptation * L * kappa) for the
+  // largest principal curvature kappa, but never below minRelativeLength * L.
+  double curvatureAdaptation = 0.;
+  double minRelativeLength = 0.05;
+
+  // Interior edges whose dihedral angle is larger than this (in radians) are features. Disabled by default.
+  double featureAngle = std::numeric_limits<double>::infinity();
+
+  // Fixed: boundary vertices and edges are left as-is. Tangential: they are remeshed along the boundary.
+  RemeshBoundaryCondition boundaryCondition = RemeshBoundaryCondition::Tangential;
+};
+
+// Remesh a triangle mesh in place. The mesh is compressed afterwards.
+void remesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, const RemeshOptions& options = RemeshOptions());
+void remesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, const RemeshOptions& options, MutationManager& mm);
+
+} // namespace surface
+} // namespace geometrycentral
@@ -16,5 +16,12 @@ enum class FlipType { Euclidean = 0, Hyperbolic };
 size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType flipType = FlipType::Euclidean,
                       double delaunayEPS = 1e-6);
 
+// Same as flipToDelaunay(), but runs in rounds: the Delaunay condition and the flipped edge lengths are evaluated in
+// parallel over batches of edges which share no triangles. Also yields an intrinsic Delaunay triangulation, though
+// the flip sequence (and so the result, for cocircular configurations) may differ from the serial version. Returns the
+// number of flips.
+size_t flipToDelaunayParallel(SurfaceMesh& mesh, EdgeData<double>& edgeLengths,
+                              FlipType flipType = FlipType::Euclidean, double delaunayEPS = 1e-6);
+
 } // namespace surface
 } // namespace geometrycentral
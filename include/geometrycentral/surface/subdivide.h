@@ -4,6 +4,9 @@
 #include "geometrycentral/surface/mutation_manager.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
 
+#include <memory>
+#include <tuple>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -15,5 +18,25 @@ void catmullClarkSubdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& ge
 void loopSubdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo);
 void loopSubdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, MutationManager& mm);
 
+// Out-of-place subdivision. The refined connectivity follows arithmetically from the input, since every face maps to
+// a fixed set of children, so several levels are computed without building intermediate meshes, and positions are
+// evaluated with stencils in parallel.
+//
+// At each level, vertices are numbered as the previous level's vertices, then one per edge, then (for Linear and
+// CatmullClark) one per face. Linear and CatmullClark produce quad meshes; Loop requires a triangle mesh.
+//
+// Boundary edges and crease edges are sharp: they are subdivided as cubic B-spline curves, following [Hoppe et al.
+// 1994] "Piecewise Smooth Surface Reconstruction". Vertices on more than two sharp edges are corners, and do not move.
+enum class SubdivisionScheme { Linear, CatmullClark, Loop };
+
+struct SubdivisionOptions {
+  size_t levels = 1;
+  EdgeData<char> creases; // sharp edges of the input mesh, or empty for none
+};
+
+std::tuple<std::unique_ptr<ManifoldSurfaceMesh>, std::unique_ptr<VertexPositionGeometry>>
+subdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, SubdivisionScheme scheme,
+          const SubdivisionOptions& options = SubdivisionOptions());
+
 } // namespace surface
 } // namespace geometrycentral
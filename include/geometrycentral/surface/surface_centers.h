@@ -4,6 +4,8 @@
 #include "geometrycentral/surface/vector_heat_method.h"
 #include "geometrycentral/surface/manifold_surface_mesh.h"
 
+#include <vector>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -17,5 +19,19 @@ SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& g
 SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, VectorHeatMethodSolver& solver,
                         const VertexData<double>& distribution, int p = 2);
 
+// Find centers of many point sets or distributions at once. Equivalent to calling findCenter() on each in order, but
+// the log maps for all of them are computed in blocks against one solver, and the sums and geodesic steps for
+// different distributions run in parallel.
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      const std::vector<std::vector<Vertex>>& vertexPts, int p = 2);
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      VectorHeatMethodSolver& solver,
+                                      const std::vector<std::vector<Vertex>>& vertexPts, int p = 2);
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      const std::vector<VertexData<double>>& distributions, int p = 2);
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      VectorHeatMethodSolver& solver,
+                                      const std::vector<VertexData<double>>& distributions, int p = 2);
+
 } // namespace surface
 } // namespace geometrycentral
@@ -44,6 +44,57 @@ TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, Face startFa
                                   Vector3 traceBaryVec, const TraceOptions& traceOptions = defaultTraceOptions);
 
 
+// Results from tracing many geodesics at once. Entry i corresponds to the i'th input trace.
+struct TraceGeodesicBatchResult {
+  std::vector<SurfacePoint> endPoints;
+  std::vector<Vector2> endingDirs;
+  std::vector<char> hitBoundary;
+
+  // Only populated if TraceOptions::includePath was set. Paths are stored in compressed (CSR) form: the points of the
+  // i'th path are pathPoints[pathStart[i]] through pathPoints[pathStart[i+1] - 1].
+  std::vector<size_t> pathStart;
+  std::vector<SurfacePoint> pathPoints;
+};
+
+// Traces many geodesics against a fixed geometry.
+//
+// On construction, everything tracing reads is copied from the geometry in to flat arrays, including a precomputed
+// per-face transform from cartesian to barycentric vectors. After that the tracer never touches the geometry object,
+// so traces may be run concurrently from any number of threads. Results agree with traceGeodesic() up to floating
+// point roundoff. The mesh must not be modified while the tracer is in use.
+class GeodesicTracer {
+
+public:
+  GeodesicTracer(IntrinsicGeometryInterface& geom);
+
+  // Trace a single geodesic, as in traceGeodesic()
+  TraceGeodesicResult trace(SurfacePoint startP, Vector2 traceVec,
+                            const TraceOptions& traceOptions = defaultTraceOptions) const;
+
+  // Trace startPoints.size() geodesics in parallel, from startPoints[i] along traceVecs[i]
+  TraceGeodesicBatchResult traceBatch(const std::vector<SurfacePoint>& startPoints,
+                                      const std::vector<Vector2>& traceVecs,
+                                      const TraceOptions& traceOptions = defaultTraceOptions) const;
+
+  SurfaceMesh& mesh;
+
+  // === Flat geometry data, indexed by element index
+
+  struct FaceLayout {
+    std::array<Vector2, 3> vertexCoords;   // vertex positions in the face's tangent space (the first is the origin)
+    std::array<double, 6> cartesianToBary; // row-major 3x2 map from tangent vectors to barycentric displacements
+  };
+  std::vector<FaceLayout> faceLayout;
+  std::vector<Vector2> halfedgeVectorsInFace;
+  std::vector<Vector2> halfedgeVectorsInVertex;
+  std::vector<double> vertexAngleSums;
+
+private:
+  void traceInto(SurfacePoint startP, Vector2 traceVec, const TraceOptions& traceOptions,
+                 TraceGeodesicResult& result) const;
+};
+
+
 // For a trace which was expected to end very near targetVertex, try to clean up the end of the path to end directly at
 // targetVertex
 // TODO currently DOES NOT fix up traceResult.endingDir, so that field is invalid after calling
@@ -33,6 +33,11 @@ public:
   std::unique_ptr<SquareSolver<double>> AtoB_L2_Solver;
   std::unique_ptr<SquareSolver<double>> BtoA_L2_Solver;
 
+  // Combined right-hand side operators P_B^T M P_A (resp. P_A^T M P_B), built along with the solvers on the first L2
+  // transfer in each direction, so later transfers cost one sparse product and one solve.
+  SparseMatrix<double> AtoB_L2_RHS;
+  SparseMatrix<double> BtoA_L2_RHS;
+
 
   // Methods
 
@@ -40,6 +45,15 @@ public:
   VertexData<double> transferAtoB(const VertexData<double>& valuesOnA, TransferMethod method);
   VertexData<double> transferBtoA(const VertexData<double>& valuesOnB, TransferMethod method);
 
+  // Batched: transfer many signals at once. Each column of the matrix is one channel, with one row per vertex; L2
+  // transfer performs a single multi-RHS solve for all channels.
+  DenseMatrix<double> transferAtoB(const DenseMatrix<double>& valuesOnA, TransferMethod method);
+  DenseMatrix<double> transferBtoA(const DenseMatrix<double>& valuesOnB, TransferMethod method);
+  VertexData<Vector2> transferAtoB(const VertexData<Vector2>& valuesOnA, TransferMethod method);
+  VertexData<Vector2> transferBtoA(const VertexData<Vector2>& valuesOnB, TransferMethod method);
+  VertexData<Vector3> transferAtoB(const VertexData<Vector3>& valuesOnA, TransferMethod method);
+  VertexData<Vector3> transferBtoA(const VertexData<Vector3>& valuesOnB, TransferMethod method);
+
   // Low-level
   VertexData<double> transferAtoB_Pointwise(const VertexData<double>& valuesOnA);
   VertexData<double> transferAtoB_L2(const VertexData<double>& valuesOnA);
@@ -47,9 +61,19 @@ public:
   VertexData<double> transferBtoA_Pointwise(const VertexData<double>& valuesOnB);
   VertexData<double> transferBtoA_L2(const VertexData<double>& valuesOnB);
 
+  DenseMatrix<double> transferAtoB_Pointwise(const DenseMatrix<double>& valuesOnA);
+  DenseMatrix<double> transferAtoB_L2(const DenseMatrix<double>& valuesOnA);
+
+  DenseMatrix<double> transferBtoA_Pointwise(const DenseMatrix<double>& valuesOnB);
+  DenseMatrix<double> transferBtoA_L2(const DenseMatrix<double>& valuesOnB);
+
   // Prepare data
   std::pair<SparseMatrix<double>, SparseMatrix<double>> constructAtoBMatrices() const;
   std::pair<SparseMatrix<double>, SparseMatrix<double>> constructBtoAMatrices() const;
+
+private:
+  void ensureAtoB_L2();
+  void ensureBtoA_L2();
 };
 
 
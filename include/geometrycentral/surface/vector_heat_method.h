@@ -41,10 +41,31 @@ public:
   VertexData<Vector2> computeLogMap(const Vertex& sourceVert, double vertexDistanceShift = 0.);
   VertexData<Vector2> computeLogMap(const SurfacePoint& sourceP);
 
+  // === Batched queries
+  // These answer many queries at once, solving blocks of right hand sides together against the cached factorizations.
+  // Results are dense matrices with a row for each vertex (ordered by geom.vertexIndices) and a column for each query;
+  // tangent vectors are stored as complex numbers, as in vectorDiffuse().
+
+  // Extend several scalar fields sharing the same source points. sourceValues has a row for each source point and a
+  // column for each field.
+  DenseMatrix<double> extendScalarBatch(const std::vector<SurfacePoint>& sourcePoints,
+                                        const DenseMatrix<double>& sourceValues);
+
+  // Transport each source vector separately, as in transportTangentVector()
+  DenseMatrix<std::complex<double>>
+  transportTangentVectorBatch(const std::vector<std::tuple<SurfacePoint, Vector2>>& sources);
+
+  // The logarithmic map from each source
+  DenseMatrix<std::complex<double>> computeLogMapBatch(const std::vector<Vertex>& sourceVerts,
+                                                       double vertexDistanceShift = 0.);
+  DenseMatrix<std::complex<double>> computeLogMapBatch(const std::vector<SurfacePoint>& sourcePoints);
+
   // === Options and parameters
   const double tCoef; // the time parameter used for heat flow, measured as time = tCoef * mean_edge_length^2
                       // default: 1.0
 
+  size_t batchBlockSize = 32; // number of right hand sides solved together in batched queries
+
   // === Low-level queries
   VertexData<double> scalarDiffuse(const VertexData<double>& rhs); // call scalarHeatSolver on rhs
   VertexData<std::complex<double>>
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <vector>
 #include <array>
+#include <atomic>
 
 
 namespace geometrycentral {
@@ -22,9 +23,22 @@ public:
 
   virtual ~DependentQuantity(){};
 
+  // The require count is atomic so that concurrent require()/unrequire() calls on an already-computed quantity (as
+  // happen when parallel routines share a geometry object) are safe. Computing a quantity is never thread-safe.
+  DependentQuantity(const DependentQuantity& other)
+      : evaluateFunc(other.evaluateFunc), computed(other.computed), requireCount(other.requireCount.load()),
+        clearable(other.clearable) {}
+  DependentQuantity& operator=(const DependentQuantity& other) {
+    evaluateFunc = other.evaluateFunc;
+    computed = other.computed;
+    requireCount = other.requireCount.load();
+    clearable = other.clearable;
+    return *this;
+  }
+
   std::function<void()> evaluateFunc;
   bool computed = false;
-  int requireCount = 0;
+  std::atomic<int> requireCount{0};
   bool clearable = true; // if false, clearing does nothing
 
   // Compute the quantity, if we don't have it already
@@ -25,9 +25,9 @@ inline void DependentQuantity::require() {
 }
 
 inline void DependentQuantity::unrequire() {
-  requireCount--;
+  int newCount = --requireCount;
 
-  if (requireCount < 0) {
+  if (newCount < 0) {
     throw std::logic_error("Quantity was unrequire()'d more than than it was require()'d");
     requireCount = 0;
   }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace geometrycentral {
+
+// A binary heap over integer keys, which supports updating or removing the priority of any key in O(log n). Unlike
+// std::priority_queue, each key appears at most once, so there are never stale entries to skip.
+//
+// Keys are arbitrary size_t values (usually element indices); memory is proportional to the largest key seen. As with
+// std::priority_queue, the default comparison puts the *largest* priority on top.
+template <typename P, typename Compare = std::less<P>>
+class IndexedHeap {
+public:
+  IndexedHeap(Compare comp_ = Compare());
+
+  bool empty() const;
+  size_t size() const;
+  void clear();
+
+  // Is the key currently in the heap?
+  bool contains(size_t key) const;
+
+  // Insert a key, or change its priority if it is already present
+  void push(size_t key, const P& priority);
+
+  // Remove a key if it is present (does nothing otherwise)
+  void remove(size_t key);
+
+  // The top key and its priority. Heap must be nonempty.
+  size_t topKey() const;
+  const P& topPriority() const;
+
+  // Priority of a key which is in the heap
+  const P& priority(size_t key) const;
+
+  // Remove the top key and return it
+  size_t pop();
+
+private:
+  struct Entry {
+    size_t key;
+    P priority;
+  };
+  std::vector<Entry> entries;
+  std::vector<size_t> position; // index in entries, or NOT_PRESENT
+  Compare comp;
+
+  static const size_t NOT_PRESENT = static_cast<size_t>(-1);
+
+  void swapEntries(size_t i, size_t j);
+  void siftUp(size_t i);
+  void siftDown(size_t i);
+};
+
+} // namespace geometrycentral
+
+#include "geometrycentral/utilities/indexed_heap.ipp"
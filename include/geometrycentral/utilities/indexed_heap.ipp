@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace geometrycentral {
+
+template <typename P, typename Compare>
+const size_t IndexedHeap<P, Compare>::NOT_PRESENT;
+
+template <typename P, typename Compare>
+IndexedHeap<P, Compare>::IndexedHeap(Compare comp_) : comp(comp_) {}
+
+template <typename P, typename Compare>
+bool IndexedHeap<P, Compare>::empty() const {
+  return entries.empty();
+}
+
+template <typename P, typename Compare>
+size_t IndexedHeap<P, Compare>::size() const {
+  return entries.size();
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::clear() {
+  for (const Entry& e : entries) {
+    position[e.key] = NOT_PRESENT;
+  }
+  entries.clear();
+}
+
+template <typename P, typename Compare>
+bool IndexedHeap<P, Compare>::contains(size_t key) const {
+  return key < position.size() && position[key] != NOT_PRESENT;
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::push(size_t key, const P& priority) {
+  if (key >= position.size()) {
+    position.resize(std::max(key + 1, 2 * position.size()), NOT_PRESENT);
+  }
+
+  size_t i = position[key];
+  if (i == NOT_PRESENT) {
+    position[key] = entries.size();
+    entries.push_back(Entry{key, priority});
+    siftUp(entries.size() - 1);
+    return;
+  }
+
+  // Update in place, then restore the heap property in whichever direction it was violated
+  bool raised = comp(entries[i].priority, priority);
+  entries[i].priority = priority;
+  if (raised) {
+    siftUp(i);
+  } else {
+    siftDown(i);
+  }
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::remove(size_t key) {
+  if (!contains(key)) return;
+
+  size_t i = position[key];
+  size_t last = entries.size() - 1;
+  if (i != last) {
+    swapEntries(i, last);
+  }
+  position[key] = NOT_PRESENT;
+  entries.pop_back();
+
+  if (i < entries.size()) {
+    // The moved entry may need to go either up or down; if it moves up, whatever replaces it at i is already valid
+    siftUp(i);
+    siftDown(i);
+  }
+}
+
+template <typename P, typename Compare>
+size_t IndexedHeap<P, Compare>::topKey() const {
+  if (entries.empty()) throw std::runtime_error("IndexedHeap: top of empty heap");
+  return entries.front().key;
+}
+
+template <typename P, typename Compare>
+const P& IndexedHeap<P, Compare>::topPriority() const {
+  if (entries.empty()) throw std::runtime_error("IndexedHeap: top of empty heap");
+  return entries.front().priority;
+}
+
+template <typename P, typename Compare>
+const P& IndexedHeap<P, Compare>::priority(size_t key) const {
+  if (!contains(key)) throw std::runtime_error("IndexedHeap: key is not in heap");
+  return entries[position[key]].priority;
+}
+
+template <typename P, typename Compare>
+size_t IndexedHeap<P, Compare>::pop() {
+  size_t key = topKey();
+  remove(key);
+  return key;
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::swapEntries(size_t i, size_t j) {
+  std::swap(entries[i], entries[j]);
+  position[entries[i].key] = i;
+  position[entries[j].key] = j;
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::siftUp(size_t i) {
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!comp(entries[parent].priority, entries[i].priority)) break;
+    swapEntries(i, parent);
+    i = parent;
+  }
+}
+
+template <typename P, typename Compare>
+void IndexedHeap<P, Compare>::siftDown(size_t i) {
+  size_t n = entries.size();
+  while (true) {
+    size_t best = i;
+    size_t left = 2 * i + 1;
+    size_t right = left + 1;
+    if (left < n && comp(entries[best].priority, entries[left].priority)) best = left;
+    if (right < n && comp(entries[best].priority, entries[right].priority)) best = right;
+    if (best == i) break;
+    swapEntries(i, best);
+    i = best;
+  }
+}
+
+} // namespace geometrycentral
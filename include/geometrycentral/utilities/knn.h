@@ -8,10 +8,22 @@
 
 namespace geometrycentral {
 
+// Flat (CSR) storage for the results of a batch of neighbor queries. The neighbors of query i are
+// indices[offsets[i]], ..., indices[offsets[i+1]-1], sorted by increasing distance, with the matching squared
+// distances in distancesSq. Passing the same object to repeated queries reuses its storage.
+struct NeighborQueryResult {
+  std::vector<size_t> offsets; // size nQueries+1
+  std::vector<size_t> indices;
+  std::vector<double> distancesSq;
+
+  size_t nQueries() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+  size_t nNeighbors(size_t iQuery) const { return offsets[iQuery + 1] - offsets[iQuery]; }
+};
 
 class NearestNeighborFinder {
 public:
   NearestNeighborFinder(const std::vector<Vector3>& points);
+  NearestNeighborFinder(std::vector<Vector3>&& points); // takes the points without copying
   ~NearestNeighborFinder();
 
   // Return the indices of points in the input set
@@ -24,6 +36,18 @@ public:
   // to pass to nanoflann
   std::vector<size_t> radiusSearch(Vector3 query, double rad);
 
+  // == Batch queries
+  // These run in parallel over the queries (see parallel.h), and write into caller-provided flat storage.
+
+  // The k nearest neighbors of every input point (excluding the point itself), with a fixed stride of k
+  void kNearestNeighborsAll(size_t k, NeighborQueryResult& result);
+
+  // The k nearest input points to each query, with a fixed stride of k
+  void kNearest(const std::vector<Vector3>& queries, size_t k, NeighborQueryResult& result);
+
+  // All input points within distance `rad` of each query
+  void radiusSearch(const std::vector<Vector3>& queries, double rad, NeighborQueryResult& result);
+
 private:
   // "PImpl" idiom
   class KNNImpl;
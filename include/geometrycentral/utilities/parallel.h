@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+// Minimal helpers for data-parallel loops, built directly on std::thread.
+//
+// All parallel routines in geometry-central go through parallelFor(), so setNumThreads() controls the parallelism of
+// the whole library. Calls to parallelFor() from inside a running parallelFor() execute serially on the calling
+// thread, so nesting parallel routines never oversubscribes the machine.
+
+namespace geometrycentral {
+
+// Set the number of threads used by parallel routines. 0 (the default) means one thread per hardware core, as reported
+// by std::thread::hardware_concurrency(). 1 disables threading entirely.
+void setNumThreads(size_t n);
+
+// The number of threads which will be used by parallel routines (always >= 1)
+size_t getNumThreads();
+
+// Calls func(i) for each i in [begin, end), distributing the indices over worker threads in contiguous blocks of
+// grainSize. func must be safe to call concurrently for distinct indices. If any call throws, the first exception is
+// rethrown on the calling thread after all workers have stopped.
+template <typename F>
+void parallelFor(size_t begin, size_t end, F&& func, size_t grainSize = 1);
+
+// Like parallelFor(), but calls func(iThread, i), where iThread in [0, nThreads) identifies the worker. Useful for
+// indexing per-thread scratch storage, which is never shared between concurrent calls. Size that storage with the same
+// nThreads passed here (usually a single getNumThreads() call), so a concurrent setNumThreads() cannot change the
+// thread count between allocating the scratch and running the loop.
+template <typename F>
+void parallelForWithThreadIndex(size_t begin, size_t end, size_t nThreads, F&& func, size_t grainSize = 1);
+
+namespace detail {
+// True on threads which are currently executing the body of a parallelFor()
+bool& inParallelRegion();
+} // namespace detail
+
+} // namespace geometrycentral
+
+#include "geometrycentral/utilities/parallel.ipp"
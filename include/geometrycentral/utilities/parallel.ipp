@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace geometrycentral {
+
+template <typename F>
+void parallelForWithThreadIndex(size_t begin, size_t end, size_t nThreads, F&& func, size_t grainSize) {
+  if (end <= begin) return;
+  if (grainSize == 0) grainSize = 1;
+
+  size_t nBlocks = (end - begin + grainSize - 1) / grainSize;
+  nThreads = std::min(nThreads, nBlocks);
+
+  // Serial fallback: nothing to gain, or we are already inside a parallel region
+  if (nThreads <= 1 || detail::inParallelRegion()) {
+    for (size_t i = begin; i < end; i++) {
+      func(static_cast<size_t>(0), i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> nextBlock{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr firstException;
+  std::mutex exceptionMutex;
+
+  auto worker = [&](size_t iThread) {
+    bool& inRegion = detail::inParallelRegion();
+    bool wasInRegion = inRegion;
+    inRegion = true;
+    try {
+      while (!failed) {
+        size_t iBlock = nextBlock++;
+        if (iBlock >= nBlocks) break;
+        size_t blockStart = begin + iBlock * grainSize;
+        size_t blockEnd = std::min(end, blockStart + grainSize);
+        for (size_t i = blockStart; i < blockEnd; i++) {
+          func(iThread, i);
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(exceptionMutex);
+      if (!firstException) firstException = std::current_exception();
+      failed = true;
+    }
+    inRegion = wasInRegion;
+  };
+
+  // The calling thread participates as worker 0
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads - 1);
+  for (size_t iThread = 1; iThread < nThreads; iThread++) {
+    threads.emplace_back(worker, iThread);
+  }
+  worker(0);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  if (firstException) {
+    std::rethrow_exception(firstException);
+  }
+}
+
+template <typename F>
+void parallelFor(size_t begin, size_t end, F&& func, size_t grainSize) {
+  parallelForWithThreadIndex(
+      begin, end, getNumThreads(), [&](size_t iThread, size_t i) { func(i); }, grainSize);
+}
+
+} // namespace geometrycentral
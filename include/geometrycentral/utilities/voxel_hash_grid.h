@@ -0,0 +1,107 @@
+#pragma once
+
+#include "geometrycentral/utilities/utilities.h"
+#include "geometrycentral/utilities/vector3.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace geometrycentral {
+
+// Integer coordinates of a cubical voxel, and a hash for them
+typedef std::array<int64_t, 3> VoxelKey;
+struct VoxelKeyHash {
+  size_t operator()(const VoxelKey& key) const {
+    // large primes, as in the usual spatial hashing schemes
+    return static_cast<size_t>(static_cast<uint64_t>(key[0]) * 73856093u ^ static_cast<uint64_t>(key[1]) * 19349663u ^
+                               static_cast<uint64_t>(key[2]) * 83492791u);
+  }
+};
+
+// The voxel of the given size which contains p
+VoxelKey voxelKeyOf(Vector3 p, double voxelSize);
+
+// A fixed bucketing of points in to voxels, for one-shot spatial partitioning of work where the updates and queries of
+// VoxelHashGrid below are not needed. Occupied voxels are numbered in order of their first point.
+class VoxelBuckets {
+public:
+  VoxelBuckets(const std::vector<Vector3>& points, double voxelSize);
+
+  size_t size() const { return keys.size(); }
+
+  // The index of the voxel with the given key, or INVALID_IND if it holds no points
+  size_t find(const VoxelKey& key) const;
+
+  std::vector<VoxelKey> keys;               // key of each occupied voxel
+  std::vector<std::vector<size_t>> members; // points in each voxel, in increasing order
+
+private:
+  std::unordered_map<VoxelKey, size_t, VoxelKeyHash> index;
+};
+
+// A dynamic spatial index over points identified by integer ids, which buckets them in a hashed grid of cubical
+// voxels. Unlike NearestNeighborFinder, points can be inserted, moved, and removed in constant time, so the index can
+// be kept up to date as a cloud changes. Queries are efficient when the voxel size is comparable to the typical
+// neighborhood radius.
+//
+// Queries are const, and may run concurrently with each other (but not with modifications).
+class VoxelHashGrid {
+public:
+  VoxelHashGrid(double voxelSize);
+
+  // == Modification
+  // Ids need not be dense, but storage is proportional to the largest id.
+  void insert(size_t id, Vector3 pos);
+  void remove(size_t id);
+  void move(size_t id, Vector3 newPos);
+  void clear();
+
+  bool contains(size_t id) const;
+  Vector3 position(size_t id) const { return positions[id]; }
+  size_t size() const { return count; }
+  double voxelSize() const { return cellSize; }
+
+  // == Queries
+
+  // The (up to) k nearest points to the query, sorted by increasing distance. The point `excludeId`, if any, is
+  // skipped.
+  void kNearest(Vector3 query, size_t k, std::vector<size_t>& indices, std::vector<double>& distancesSq,
+                size_t excludeId = INVALID_IND) const;
+  std::vector<size_t> kNearest(Vector3 query, size_t k, size_t excludeId = INVALID_IND) const;
+
+  // All points within distance `rad` of the query, in no particular order
+  void radiusSearch(Vector3 query, double rad, std::vector<size_t>& indices) const;
+  std::vector<size_t> radiusSearch(Vector3 query, double rad) const;
+
+private:
+  VoxelKey keyOf(Vector3 p) const { return voxelKeyOf(p, cellSize); }
+
+  // Shell radii around the given voxel before and beyond which there are no occupied voxels
+  int64_t shellStart(const VoxelKey& center) const;
+  int64_t shellBound(const VoxelKey& center) const;
+
+  // Visit each point in the voxels at Chebyshev distance exactly r from `center`, calling f(id)
+  template <typename F>
+  void forEachInShell(const VoxelKey& center, int64_t r, F&& f) const;
+
+  // Same, but for all voxels at distance >= r, by scanning the occupied voxels. Cheaper than visiting the remaining
+  // shells once they hold more voxels than are occupied in total, as happens far from the bulk of the points.
+  template <typename F>
+  void forEachBeyondShell(const VoxelKey& center, int64_t r, F&& f) const;
+  bool shellIsLarge(int64_t r) const;
+
+  double cellSize;
+  std::unordered_map<VoxelKey, std::vector<size_t>, VoxelKeyHash> voxels;
+
+  // Per-id data
+  std::vector<Vector3> positions;
+  std::vector<size_t> slotInVoxel; // index in the voxel's list, or INVALID_IND if absent
+  size_t count = 0;
+
+  // Bounds of all voxels which have ever been occupied, which limit the search
+  VoxelKey minKey, maxKey;
+};
+
+} // namespace geometrycentral
@@ -136,15 +136,21 @@ Vector<T> smallestEigenvectorSquare(SparseMatrix<T>& energyMatrix, SparseMatrix<
 
   // TODO could implement a faster variant in the suitesparse case; as-is this does a copy-convert each iteration
 
-  size_t N = energyMatrix.rows();
   SquareSolver<T> solver(energyMatrix);
+  return smallestEigenvectorSquare(solver, massMatrix, nIterations);
+}
+
+template <typename T>
+Vector<T> smallestEigenvectorSquare(LinearSolver<T>& energySolver, SparseMatrix<T>& massMatrix, size_t nIterations) {
+
+  size_t N = massMatrix.rows();
 
   Vector<T> u = Vector<T>::Random(N);
   Vector<T> x = u;
   for (size_t iIter = 0; iIter < nIterations; iIter++) {
 
     // Solve
-    solver.solve(x, massMatrix * u);
+    energySolver.solve(x, massMatrix * u);
 
     // Re-normalize
     normalize(x, massMatrix);
@@ -220,6 +226,13 @@ template Vector<float> smallestEigenvectorSquare(SparseMatrix<float>& energyMatr
 template Vector<std::complex<double>> smallestEigenvectorSquare(SparseMatrix<std::complex<double>>& energyMatrix,
                                                                 SparseMatrix<std::complex<double>>& massMatrix,
                                                                 size_t nIterations);
+template Vector<double> smallestEigenvectorSquare(LinearSolver<double>& energySolver, SparseMatrix<double>& massMatrix,
+                                                  size_t nIterations);
+template Vector<float> smallestEigenvectorSquare(LinearSolver<float>& energySolver, SparseMatrix<float>& massMatrix,
+                                                 size_t nIterations);
+template Vector<std::complex<double>> smallestEigenvectorSquare(LinearSolver<std::complex<double>>& energySolver,
+                                                                SparseMatrix<std::complex<double>>& massMatrix,
+                                                                size_t nIterations);
 
 template Vector<double> largestEigenvector(SparseMatrix<double>& energyMatrix, SparseMatrix<double>& massMatrix,
                                            size_t nIterations);
@@ -6,6 +6,23 @@
 
 namespace geometrycentral {
 
+template <typename T>
+void LinearSolver<T>::solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs) {
+  x.resize(nCols, rhs.cols());
+  Vector<T> col;
+  for (Eigen::Index j = 0; j < rhs.cols(); j++) {
+    solve(col, rhs.col(j));
+    x.col(j) = col;
+  }
+}
+
+template <typename T>
+DenseMatrix<T> LinearSolver<T>::solveMultiple(const DenseMatrix<T>& rhs) {
+  DenseMatrix<T> out;
+  solveMultiple(out, rhs);
+  return out;
+}
+
 template class LinearSolver<double>;
 template class LinearSolver<float>;
 template class LinearSolver<std::complex<double>>;
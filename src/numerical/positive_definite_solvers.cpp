@@ -2,6 +2,8 @@
 
 #include "geometrycentral/numerical/linear_algebra_utilities.h"
 
+#include <algorithm>
+
 #ifdef GC_HAVE_SUITESPARSE
 #include "geometrycentral/numerical/suitesparse_utilities.h"
 #endif
@@ -17,6 +19,9 @@ struct PSDSolverInternals {
 #else
   Eigen::SimplicialLDLT<SparseMatrix<T>> solver;
 #endif
+
+  // Sparsity pattern of the factored matrix
+  std::vector<typename SparseMatrix<T>::StorageIndex> outerPattern, innerPattern;
 };
 
 template <typename T>
@@ -35,13 +40,30 @@ PositiveDefiniteSolver<T>::~PositiveDefiniteSolver() {
 template <typename T>
 PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
     : LinearSolver<T>(mat), internals(new PSDSolverInternals<T>()) {
+  factor(mat, false);
+}
 
+template <typename T>
+bool PositiveDefiniteSolver<T>::refactor(SparseMatrix<T>& mat) {
+  mat.makeCompressed();
+  bool samePattern = (size_t)mat.rows() == this->nRows && (size_t)mat.cols() == this->nCols &&
+                     mat.nonZeros() == (Eigen::Index)internals->innerPattern.size() &&
+                     std::equal(internals->outerPattern.begin(), internals->outerPattern.end(), mat.outerIndexPtr()) &&
+                     std::equal(internals->innerPattern.begin(), internals->innerPattern.end(), mat.innerIndexPtr());
+
+  this->nRows = mat.rows();
+  this->nCols = mat.cols();
+  factor(mat, samePattern);
+  return samePattern;
+}
+
+template <typename T>
+void PositiveDefiniteSolver<T>::factor(SparseMatrix<T>& mat, bool reuseAnalysis) {
 
   // Check some sanity
   if (this->nRows != this->nCols) {
     throw std::logic_error("Matrix must be square");
   }
-  size_t N = this->nRows;
 #ifndef GC_NLINALG_DEBUG
   checkFinite(mat);
   checkHermitian(mat);
@@ -49,6 +71,12 @@ PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
 
   mat.makeCompressed();
 
+  // Remember the pattern, to detect whether a later refactor() can reuse the analysis
+  if (!reuseAnalysis) {
+    internals->outerPattern.assign(mat.outerIndexPtr(), mat.outerIndexPtr() + mat.outerSize() + 1);
+    internals->innerPattern.assign(mat.innerIndexPtr(), mat.innerIndexPtr() + mat.nonZeros());
+  }
+
   // Suitesparse version
 #ifdef GC_HAVE_SUITESPARSE
 
@@ -59,9 +87,14 @@ PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
   internals->cMat = toCholmod(mat, internals->context, SType::SYMMETRIC);
 
   // Factor
-  internals->context.setSimplicial(); // must use simplicial for LDLt
-  internals->context.setLDL();        // ensure we get an LDLt internals->factorization
-  internals->factorization = cholmod_l_analyze(internals->cMat, internals->context);
+  if (!reuseAnalysis) {
+    if (internals->factorization != nullptr) {
+      cholmod_l_free_factor(&internals->factorization, internals->context);
+    }
+    internals->context.setSimplicial(); // must use simplicial for LDLt
+    internals->context.setLDL();        // ensure we get an LDLt internals->factorization
+    internals->factorization = cholmod_l_analyze(internals->cMat, internals->context);
+  }
   bool success = (bool)cholmod_l_factorize(internals->cMat, internals->factorization, internals->context);
 
   if(!success) {
@@ -71,17 +104,19 @@ PositiveDefiniteSolver<T>::PositiveDefiniteSolver(SparseMatrix<T>& mat)
     throw std::runtime_error("matrix is not positive definite");
   }
 
-  
-
   // Eigen version
 #else
-  internals->solver.compute(mat);
+  if (reuseAnalysis) {
+    internals->solver.factorize(mat);
+  } else {
+    internals->solver.compute(mat);
+  }
   if (internals->solver.info() != Eigen::Success) {
     std::cerr << "Solver internals->factorization error: " << internals->solver.info() << std::endl;
     throw std::invalid_argument("Solver internals->factorization failed");
   }
 #endif
-};
+}
 
 template <typename T>
 Vector<T> PositiveDefiniteSolver<T>::solve(const Vector<T>& rhs) {
@@ -131,6 +166,52 @@ void PositiveDefiniteSolver<T>::solve(Vector<T>& x, const Vector<T>& rhs) {
 #endif
 }
 
+template <typename T>
+DenseMatrix<T> PositiveDefiniteSolver<T>::solveMultiple(const DenseMatrix<T>& rhs) {
+  DenseMatrix<T> out;
+  solveMultiple(out, rhs);
+  return out;
+}
+
+template <typename T>
+void PositiveDefiniteSolver<T>::solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs) {
+
+  size_t N = this->nRows;
+
+  // Check some sanity
+  if ((size_t)rhs.rows() != N) {
+    throw std::logic_error("Matrix is not the right height");
+  }
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(rhs);
+#endif
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // Convert input to suitesparse format
+  cholmod_dense* inMat = toCholmod(rhs, internals->context);
+
+  // Solve for all columns at once
+  cholmod_dense* outMat = cholmod_l_solve(CHOLMOD_A, internals->factorization, inMat, internals->context);
+
+  // Convert back
+  toEigen(outMat, internals->context, x);
+
+  // Free
+  cholmod_l_free_dense(&outMat, internals->context);
+  cholmod_l_free_dense(&inMat, internals->context);
+
+  // Eigen version
+#else
+  x = internals->solver.solve(rhs);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solve failed");
+  }
+#endif
+}
+
 template <typename T>
 Vector<T> solvePositiveDefinite(SparseMatrix<T>& A, const Vector<T>& rhs) {
   PositiveDefiniteSolver<T> s(A);
@@ -186,6 +186,42 @@ void SquareSolver<T>::solve(Vector<T>& x, const Vector<T>& rhs) {
 #endif
 }
 
+template <typename T>
+DenseMatrix<T> SquareSolver<T>::solveMultiple(const DenseMatrix<T>& rhs) {
+  DenseMatrix<T> out;
+  solveMultiple(out, rhs);
+  return out;
+}
+
+template <typename T>
+void SquareSolver<T>::solveMultiple(DenseMatrix<T>& x, const DenseMatrix<T>& rhs) {
+
+  size_t N = this->nRows;
+
+  // Check some sanity
+  if ((size_t)rhs.rows() != N) {
+    throw std::logic_error("Matrix is not the right height");
+  }
+
+  // Suitesparse version
+#ifdef GC_HAVE_SUITESPARSE
+
+  // UMFPACK solves one right-hand side at a time, so this is just the default column-by-column solve
+  LinearSolver<T>::solveMultiple(x, rhs);
+
+  // Eigen version
+#else
+#ifndef GC_NLINALG_DEBUG
+  checkFinite(rhs);
+#endif
+  x = internals->solver.solve(rhs);
+  if (internals->solver.info() != Eigen::Success) {
+    std::cerr << "Solver error: " << internals->solver.info() << std::endl;
+    throw std::invalid_argument("Solve failed");
+  }
+#endif
+}
+
 template <typename T>
 Vector<T> solveSquare(SparseMatrix<T>& A, const Vector<T>& rhs) {
   SquareSolver<T> s(A);
@@ -188,6 +188,62 @@ cholmod_dense* toCholmod(const Eigen::Matrix<std::complex<double>, Eigen::Dynami
 
   return cVec;
 }
+
+// Double-valued dense matrix
+template <>
+cholmod_dense* toCholmod(const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& A, CholmodContext& context) {
+
+  size_t N = A.rows();
+  size_t M = A.cols();
+
+  cholmod_dense* cMat = cholmod_l_allocate_dense(N, M, N, CHOLMOD_REAL, context);
+  double* cMatD = (double*)cMat->x;
+  for (size_t j = 0; j < M; j++) {
+    for (size_t i = 0; i < N; i++) {
+      cMatD[i + j * N] = A(i, j);
+    }
+  }
+
+  return cMat;
+}
+
+// Float-valued dense matrix
+template <>
+cholmod_dense* toCholmod(const Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& A, CholmodContext& context) {
+
+  size_t N = A.rows();
+  size_t M = A.cols();
+
+  cholmod_dense* cMat = cholmod_l_allocate_dense(N, M, N, CHOLMOD_REAL, context);
+  double* cMatD = (double*)cMat->x;
+  for (size_t j = 0; j < M; j++) {
+    for (size_t i = 0; i < N; i++) {
+      cMatD[i + j * N] = A(i, j);
+    }
+  }
+
+  return cMat;
+}
+
+// Complex-valued dense matrix
+template <>
+cholmod_dense* toCholmod(const Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic>& A,
+                         CholmodContext& context) {
+
+  size_t N = A.rows();
+  size_t M = A.cols();
+
+  cholmod_dense* cMat = cholmod_l_allocate_dense(N, M, N, CHOLMOD_COMPLEX, context);
+  std::complex<double>* cMatC = (std::complex<double>*)cMat->x;
+  for (size_t j = 0; j < M; j++) {
+    for (size_t i = 0; i < N; i++) {
+      cMatC[i + j * N] = A(i, j);
+    }
+  }
+
+  return cMat;
+}
+
 // Convert a vector
 template <typename T>
 void toEigen(cholmod_dense* cVec, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, 1>& xOut) {
@@ -214,5 +270,33 @@ template void toEigen(cholmod_dense* cVec, CholmodContext& context, Eigen::Matri
 template void toEigen(cholmod_dense* cVec, CholmodContext& context,
                       Eigen::Matrix<std::complex<double>, Eigen::Dynamic, 1>& xOut);
 
+// Convert a dense matrix
+template <typename T>
+void toEigen(cholmod_dense* cMat, CholmodContext& context, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& xOut) {
+
+  size_t N = cMat->nrow;
+  size_t M = cMat->ncol;
+  size_t lda = cMat->d;
+
+  // Ensure output is large enough
+  xOut = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>(N, M);
+
+  // Type wizardry, as above
+  typedef typename std::conditional<std::is_same<T, float>::value, double, T>::type SCALAR_TYPE;
+
+  SCALAR_TYPE* cMatS = (SCALAR_TYPE*)cMat->x;
+  for (size_t j = 0; j < M; j++) {
+    for (size_t i = 0; i < N; i++) {
+      xOut(i, j) = cMatS[i + j * lda];
+    }
+  }
+}
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+template void toEigen(cholmod_dense* cMat, CholmodContext& context,
+                      Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic>& xOut);
+
 } // namespace geometrycentral
 #endif
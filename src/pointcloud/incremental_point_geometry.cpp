@@ -0,0 +1,286 @@
+#include "geometrycentral/pointcloud/incremental_point_geometry.h"
+
+#include "geometrycentral/pointcloud/point_position_geometry.h"
+#include "geometrycentral/utilities/knn.h"
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace geometrycentral {
+namespace pointcloud {
+
+namespace {
+
+// Median distance to the k'th neighbor, over a sample of the points
+double estimateVoxelSize(PointCloud& cloud, const PointData<Vector3>& positions, unsigned int k, double voxelSize) {
+  if (voxelSize > 0.) return voxelSize;
+  if (cloud.nPoints() == 0) {
+    throw std::runtime_error("cannot estimate a voxel size for an empty cloud, pass one explicitly");
+  }
+
+  std::vector<Vector3> pointPos;
+  pointPos.reserve(cloud.nPoints());
+  for (Point p : cloud.points()) {
+    pointPos.push_back(positions[p]);
+  }
+  NearestNeighborFinder finder(pointPos);
+
+  size_t nSample = std::min<size_t>(pointPos.size(), 1000);
+  size_t stride = pointPos.size() / nSample;
+  std::vector<double> radii;
+  for (size_t iS = 0; iS < nSample; iS++) {
+    size_t i = iS * stride;
+    std::vector<size_t> neigh = finder.kNearestNeighbors(i, k);
+    if (neigh.empty()) continue;
+    radii.push_back(norm(pointPos[neigh.back()] - pointPos[i]));
+  }
+  if (radii.empty()) return 1.;
+
+  std::nth_element(radii.begin(), radii.begin() + radii.size() / 2, radii.end());
+  double median = radii[radii.size() / 2];
+  return median > 0. ? median : 1.;
+}
+
+} // namespace
+
+IncrementalPointGeometry::IncrementalPointGeometry(PointCloud& cloud_, const PointData<Vector3>& positions_,
+                                                   unsigned int kNeighborSize_, double voxelSize)
+    : cloud(cloud_), kNeighborSize(kNeighborSize_), positions(positions_), neighbors(cloud_), normals(cloud_),
+      neighborRadius(cloud_, -1.), grid(estimateVoxelSize(cloud_, positions_, kNeighborSize_, voxelSize)) {
+
+  for (Point p : cloud.points()) {
+    grid.insert(p.getIndex(), positions[p]);
+    markAffected(p);
+  }
+  updateAffected();
+
+  // Point handles in the neighbor lists and ids in the grid must follow the new indexing
+  std::function<void(const std::vector<size_t>&)> permuteFunc = [this](const std::vector<size_t>& perm) {
+    size_t oldSize = 0;
+    for (size_t oldInd : perm) {
+      if (oldInd != INVALID_IND) oldSize = std::max(oldSize, oldInd + 1);
+    }
+    std::vector<size_t> oldToNew(oldSize, INVALID_IND);
+    for (size_t i = 0; i < perm.size(); i++) {
+      if (perm[i] != INVALID_IND) oldToNew[perm[i]] = i;
+    }
+
+    grid.clear();
+    for (std::unique_ptr<VoxelHashGrid>& level : radiusLevels) {
+      if (level) level->clear();
+    }
+    for (Point p : cloud.points()) {
+      for (Point& n : neighbors[p]) {
+        n = Point(&cloud, oldToNew[n.getIndex()]);
+      }
+      grid.insert(p.getIndex(), positions[p]);
+      double rad = neighborRadius[p];
+      if (rad >= 0. && !std::isinf(rad)) radiusLevels[radiusLevel(rad)]->insert(p.getIndex(), positions[p]);
+    }
+    isAffected.clear();
+  };
+  std::function<void()> deleteFunc = [this]() { cloudDeleted = true; };
+
+  permuteCallbackIt = cloud.pointPermuteCallbackList.insert(cloud.pointPermuteCallbackList.end(), permuteFunc);
+  deleteCallbackIt = cloud.meshDeleteCallbackList.insert(cloud.meshDeleteCallbackList.end(), deleteFunc);
+}
+
+IncrementalPointGeometry::~IncrementalPointGeometry() {
+  if (cloudDeleted) return;
+  cloud.pointPermuteCallbackList.erase(permuteCallbackIt);
+  cloud.meshDeleteCallbackList.erase(deleteCallbackIt);
+}
+
+Point IncrementalPointGeometry::insertPoint(Vector3 pos) { return insertPoints({pos})[0]; }
+
+std::vector<Point> IncrementalPointGeometry::insertPoints(const std::vector<Vector3>& newPositions) {
+
+  // Find affected points before adding any of the new ones, so the old radii are used
+  for (Vector3 pos : newPositions) {
+    markAffectedBy(pos);
+  }
+
+  std::vector<Point> newPoints;
+  newPoints.reserve(newPositions.size());
+  for (Vector3 pos : newPositions) {
+    Point p = cloud.insertPoint();
+    positions[p] = pos;
+    grid.insert(p.getIndex(), pos);
+    markAffected(p);
+    newPoints.push_back(p);
+  }
+
+  updateAffected();
+  return newPoints;
+}
+
+void IncrementalPointGeometry::removePoint(Point p) { removePoints({p}); }
+
+void IncrementalPointGeometry::removePoints(const std::vector<Point>& pointsToRemove) {
+
+  // Validate first, so a bad input doesn't leave things half-updated
+  std::vector<size_t> inds;
+  for (Point p : pointsToRemove) {
+    if (!grid.contains(p.getIndex())) throw std::runtime_error("tried to remove a point which is not in the cloud");
+    inds.push_back(p.getIndex());
+  }
+  std::sort(inds.begin(), inds.end());
+  if (std::adjacent_find(inds.begin(), inds.end()) != inds.end()) {
+    throw std::runtime_error("tried to remove the same point twice");
+  }
+
+  for (Point p : pointsToRemove) {
+    markAffectedBy(positions[p]);
+  }
+
+  for (Point p : pointsToRemove) {
+    grid.remove(p.getIndex());
+    forgetRadius(p);
+    neighbors[p].clear();
+    cloud.removePoint(p);
+  }
+
+  updateAffected();
+}
+
+void IncrementalPointGeometry::movePoint(Point p, Vector3 newPos) {
+  if (!grid.contains(p.getIndex())) throw std::runtime_error("tried to move a point which is not in the cloud");
+
+  // Neighborhoods which contained the point at its old location, or will contain it at the new one
+  markAffectedBy(positions[p]);
+  markAffectedBy(newPos);
+  markAffected(p);
+
+  positions[p] = newPos;
+  grid.move(p.getIndex(), newPos);
+
+  updateAffected();
+}
+
+void IncrementalPointGeometry::markAffected(Point p) {
+  size_t i = p.getIndex();
+  if (i >= isAffected.size()) {
+    isAffected.resize(std::max(i + 1, cloud.nPointsCapacity()), false);
+  }
+  if (isAffected[i]) return;
+  isAffected[i] = true;
+  affected.push_back(p);
+}
+
+void IncrementalPointGeometry::markAffectedBy(Vector3 q) {
+
+  // A point with fewer than k neighbors has every other point as a neighbor, so it is always affected. This only
+  // happens when the whole cloud has <= k points.
+  if (nShortNeighborhoods > 0) {
+    for (Point p : cloud.points()) {
+      markAffected(p);
+    }
+    return;
+  }
+
+  // At level L every radius is at most the voxel size, so only points within one voxel size of q can be affected
+  std::vector<size_t> candidates;
+  for (const std::unique_ptr<VoxelHashGrid>& level : radiusLevels) {
+    if (!level || level->size() == 0) continue;
+    level->radiusSearch(q, level->voxelSize(), candidates);
+    for (size_t i : candidates) {
+      Point p(&cloud, i);
+      if (norm(positions[p] - q) <= neighborRadius[p]) markAffected(p);
+    }
+  }
+}
+
+void IncrementalPointGeometry::updateAffected() {
+
+  // Removed points may have been marked before they were removed
+  affected.erase(std::remove_if(affected.begin(), affected.end(),
+                                [&](Point p) {
+                                  if (grid.contains(p.getIndex())) return false;
+                                  isAffected[p.getIndex()] = false;
+                                  return true;
+                                }),
+                 affected.end());
+
+  size_t nThreads = getNumThreads();
+  std::vector<std::vector<size_t>> scratchInds(nThreads);
+  std::vector<std::vector<double>> scratchDistSq(nThreads);
+  std::vector<std::vector<Vector3>> scratchPositions(nThreads);
+  std::vector<double> newRadius(affected.size());
+
+  parallelForWithThreadIndex(0, affected.size(), nThreads, [&](size_t iThread, size_t iA) {
+    Point p = affected[iA];
+    std::vector<size_t>& inds = scratchInds[iThread];
+    std::vector<double>& distSq = scratchDistSq[iThread];
+    grid.kNearest(positions[p], kNeighborSize, inds, distSq, p.getIndex());
+
+    std::vector<Point>& neigh = neighbors[p];
+    neigh.clear();
+    for (size_t i : inds) {
+      neigh.emplace_back(&cloud, i);
+    }
+    newRadius[iA] = inds.size() < kNeighborSize ? std::numeric_limits<double>::infinity() : std::sqrt(distSq.back());
+
+    // PCA normal
+    size_t nNeigh = neigh.size();
+    if (nNeigh < 3) {
+      normals[p] = Vector3::undefined();
+      return;
+    }
+    std::vector<Vector3>& neighPos = scratchPositions[iThread];
+    neighPos.resize(nNeigh);
+    for (size_t iN = 0; iN < nNeigh; iN++) {
+      neighPos[iN] = positions[neigh[iN]];
+    }
+    normals[p] = estimateNormal(positions[p], neighPos.data(), nNeigh);
+  });
+
+  for (size_t iA = 0; iA < affected.size(); iA++) {
+    Point p = affected[iA];
+    forgetRadius(p);
+    recordRadius(p, newRadius[iA]);
+    isAffected[p.getIndex()] = false;
+  }
+
+  nUpdatedLastTime = affected.size();
+  affected.clear();
+}
+
+size_t IncrementalPointGeometry::radiusLevel(double rad) const {
+  size_t L = 0;
+  double levelSize = grid.voxelSize();
+  while (levelSize < rad) {
+    levelSize *= 2.;
+    L++;
+  }
+  return L;
+}
+
+void IncrementalPointGeometry::recordRadius(Point p, double rad) {
+  neighborRadius[p] = rad;
+  if (std::isinf(rad)) {
+    nShortNeighborhoods++;
+    return;
+  }
+
+  size_t L = radiusLevel(rad);
+  if (L >= radiusLevels.size()) radiusLevels.resize(L + 1);
+  if (!radiusLevels[L]) radiusLevels[L].reset(new VoxelHashGrid(std::ldexp(grid.voxelSize(), static_cast<int>(L))));
+  radiusLevels[L]->insert(p.getIndex(), positions[p]);
+}
+
+void IncrementalPointGeometry::forgetRadius(Point p) {
+  double rad = neighborRadius[p];
+  if (rad < 0.) return; // never recorded
+  if (std::isinf(rad)) {
+    nShortNeighborhoods--;
+  } else {
+    radiusLevels[radiusLevel(rad)]->remove(p.getIndex());
+  }
+  neighborRadius[p] = -1.;
+}
+
+} // namespace pointcloud
+} // namespace geometrycentral
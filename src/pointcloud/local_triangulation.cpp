@@ -2,14 +2,28 @@
 
 
 #include "geometrycentral/utilities/elementary_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
+
+#include <atomic>
 
 
 namespace geometrycentral {
 namespace pointcloud {
 
-PointData<std::vector<std::array<Point, 3>>> buildLocalTriangulations(PointCloud& cloud, PointPositionGeometry& geom,
-                                                                      bool withDegeneracyHeuristic) {
+namespace {
 
+// Reusable per-thread buffers for triangulateNeighborhood()
+struct LocalTriangulationScratch {
+  std::vector<Vector2> perturbPoints;
+  std::vector<size_t> sortInds;
+  std::vector<double> pointAngles;
+};
+
+// Construct the triangles touching the center point in the local planar Delaunay triangulation of one neighborhood.
+// Triangles are written as pairs of local neighbor indices {prev, next} to `out`, which must have room for one entry
+// per neighbor. Returns the number of triangles, or INVALID_IND if the neighborhood is hopelessly degenerate.
+size_t triangulateNeighborhood(NeighborSpan<const Vector2> coords, bool withDegeneracyHeuristic,
+                               LocalTriangulationScratch& scratch, std::array<size_t, 2>* out) {
 
   // NOTE: This is not robust if the entire neighbohood is coincident (or very nearly coincident) with the centerpoint.
   // Though in that case, the generating normals will probably also have issues.
@@ -17,192 +31,266 @@ PointData<std::vector<std::array<Point, 3>>> buildLocalTriangulations(PointCloud
   // An innocent numerical parameter used for the degeneracy heuristic
   const double DEGENERATE_THRESH = 1e-7; // in units of relative length
 
-  geom.requireNeighbors();
-  geom.requireTangentCoordinates();
-
-  PointData<std::vector<std::array<Point, 3>>> result(cloud);
-
-  for (Point p : cloud.points()) {
-    size_t nNeigh = geom.neighbors->neighbors[p].size();
-
+  size_t nNeigh = coords.size();
 
-    double lenScale = 0;
-    { // Compute a lengthscale for the neighborhood as the radius of the most distant point
-      double lenScale2 = 0;
-      for (size_t iNeigh = 0; iNeigh < nNeigh; iNeigh++) {
-        Vector2 neighPt = geom.tangentCoordinates[p][iNeigh];
-        double dist2 = norm2(neighPt);
-        lenScale2 = std::fmax(lenScale2, dist2);
-      }
-      lenScale = std::sqrt(lenScale2);
+  double lenScale = 0;
+  { // Compute a lengthscale for the neighborhood as the radius of the most distant point
+    double lenScale2 = 0;
+    for (size_t iNeigh = 0; iNeigh < nNeigh; iNeigh++) {
+      Vector2 neighPt = coords[iNeigh];
+      double dist2 = norm2(neighPt);
+      lenScale2 = std::fmax(lenScale2, dist2);
     }
+    lenScale = std::sqrt(lenScale2);
+  }
 
-    // Something is hopelessly degenerate, don't even bother trying. No triangles for this point.
-    if (!std::isfinite(lenScale) || lenScale <= 0) {
-      std::cerr << "skipping degenerate neighborhood" << std::endl;
-      continue;
-    }
+  // Something is hopelessly degenerate, don't even bother trying. No triangles for this point.
+  if (!std::isfinite(lenScale) || lenScale <= 0) {
+    return INVALID_IND;
+  }
 
-    // Local copies of points
-    std::vector<Vector2> perturbPoints = geom.tangentCoordinates[p];
+  // Local copies of points
+  std::vector<Vector2>& perturbPoints = scratch.perturbPoints;
+  perturbPoints.assign(coords.begin(), coords.end());
 
 
-    if (withDegeneracyHeuristic) {
+  if (withDegeneracyHeuristic) {
 
-      { // Perturb points which are extremely close to the source
-        for (size_t iNeigh = 0; iNeigh < nNeigh; iNeigh++) {
-          Vector2& neighPt = perturbPoints[iNeigh];
-          double dist = norm(neighPt);
-          if (dist < lenScale * DEGENERATE_THRESH) { // need to perturb
-            Vector2 dir = normalize(neighPt);
-            if (!isfinite(dir)) { // even direction is degenerate :(
-              // pick a direction from index
-              double thetaDir = (2. * M_PI * iNeigh) / nNeigh;
-              dir = Vector2::fromAngle(thetaDir);
-            }
+    { // Perturb points which are extremely close to the source
+      for (size_t iNeigh = 0; iNeigh < nNeigh; iNeigh++) {
+        Vector2& neighPt = perturbPoints[iNeigh];
+        double dist = norm(neighPt);
+        if (dist < lenScale * DEGENERATE_THRESH) { // need to perturb
+          Vector2 dir = normalize(neighPt);
+          if (!isfinite(dir)) { // even direction is degenerate :(
+            // pick a direction from index
+            double thetaDir = (2. * M_PI * iNeigh) / nNeigh;
+            dir = Vector2::fromAngle(thetaDir);
+          }
 
-            // Set the distance from the origin for the pertubed point. Including the index avoids creating many
-            // co-circular points; no need to stress the Delaunay triangulation unnessecarily.
-            double len = (1. + static_cast<double>(iNeigh) / nNeigh) * lenScale * DEGENERATE_THRESH * 10;
+          // Set the distance from the origin for the pertubed point. Including the index avoids creating many
+          // co-circular points; no need to stress the Delaunay triangulation unnessecarily.
+          double len = (1. + static_cast<double>(iNeigh) / nNeigh) * lenScale * DEGENERATE_THRESH * 10;
 
-            neighPt = len * dir; // update the point
-          }
+          neighPt = len * dir; // update the point
         }
       }
     }
+  }
 
-    std::vector<size_t> sortInds;
-    { // = Angularly sort the points CCW, such that the closest point comes first
+  std::vector<size_t>& sortInds = scratch.sortInds;
+  sortInds.clear();
+  { // = Angularly sort the points CCW, such that the closest point comes first
 
-      // sentinel value for below
-      double BAD_ANGLE = -777;
+    // sentinel value for below
+    double BAD_ANGLE = -777;
 
-      std::vector<double> pointAngles;
-      for (size_t i = 0; i < nNeigh; i++) {
-        double angle = arg(unit(perturbPoints[i]));
-        if (!std::isfinite(angle)) {
-          angle = BAD_ANGLE;
-        }
-        sortInds.push_back(i);
-        pointAngles.push_back(angle);
+    std::vector<double>& pointAngles = scratch.pointAngles;
+    pointAngles.clear();
+    for (size_t i = 0; i < nNeigh; i++) {
+      double angle = arg(unit(perturbPoints[i]));
+      if (!std::isfinite(angle)) {
+        angle = BAD_ANGLE;
       }
+      sortInds.push_back(i);
+      pointAngles.push_back(angle);
+    }
 
-      // Angular sort
-      std::sort(sortInds.begin(), sortInds.end(),
-                [&](const size_t& a, const size_t& b) -> bool { return pointAngles[a] < pointAngles[b]; });
+    // Angular sort
+    std::sort(sortInds.begin(), sortInds.end(),
+              [&](const size_t& a, const size_t& b) -> bool { return pointAngles[a] < pointAngles[b]; });
 
-      // Immediately skip any invalid indices in the search below, by detecting sentinels from above
-      for (size_t i = 0; i < nNeigh; i++) {
-        if (pointAngles[sortInds[i]] == BAD_ANGLE) {
-          sortInds[i] = INVALID_IND;
-        }
+    // Immediately skip any invalid indices in the search below, by detecting sentinels from above
+    for (size_t i = 0; i < nNeigh; i++) {
+      if (pointAngles[sortInds[i]] == BAD_ANGLE) {
+        sortInds[i] = INVALID_IND;
       }
     }
+  }
 
 
-    // == Find the local Delaunay triangulation
-    // Strategy: we start with an angularly-sorted list of points around the center point. The output we seek is a
-    // subset of this list, which corresponds to the 1-ring of the center vertex in the local Delaunay triangulation. We
-    // will repeatedly remove points from the sorted list (marking them as removed with INVALID_IND) if the diamond they
-    // form is not Delaunay. Note that is is also necessary to handle the case where all points lie in some half-space,
-    // there is an absent triangle between some pair of points.
-    // NOTE: Doing this with while(changed) {} loop as below is vulnerable to N^2 behavior on e.g. a spiral
-    // configuration. But that seems sufficiently unlikely in practice. Could be remedied with a queue.
-
-    auto isBoundary = [&](size_t localIndA, size_t localIndB) {
-      Vector2 pA = perturbPoints[localIndA];
-      Vector2 pB = perturbPoints[localIndB];
-
-      return cross(pA, pB) <= 0.;
-    };
-
-    // The main loop, discarding (aka flipping) until we have the Delaunay triagulation
-    bool anyChanged = true;
-    size_t N = sortInds.size();
-
-    while (anyChanged) {
-      anyChanged = false;
-      for (size_t iMiddle = 0; iMiddle < N; iMiddle++) {
-        if (sortInds[iMiddle] == INVALID_IND) continue; // skip unused indices
-
-        // Find the previous and next indices
-        size_t iPrev = iMiddle;
-        do {
-          iPrev = (iPrev + N - 1) % N;
-        } while (sortInds[iPrev] == INVALID_IND);
-        size_t iNext = iMiddle;
-        do {
-          iNext = (iNext + 1) % N;
-        } while (sortInds[iNext] == INVALID_IND);
-
-        // Indices in to the local neighbor list
-        size_t prev = sortInds[iPrev];
-        size_t curr = sortInds[iMiddle];
-        size_t next = sortInds[iNext];
-
-        // Degenerate cases
-        if (curr == prev || curr == next || prev == next) continue;
-
-        // For any colllinear points, keep only the closest
-        if (withDegeneracyHeuristic) {
-          double lenPrev = norm(perturbPoints[prev]);
-          double lenCurr = norm(perturbPoints[curr]);
-          double lenNext = norm(perturbPoints[next]);
-
-          bool collinearPrev =
-              std::abs(cross(perturbPoints[curr], perturbPoints[prev])) < (lenPrev * lenCurr) * DEGENERATE_THRESH &&
-              dot(perturbPoints[curr], perturbPoints[prev]) > 0;
-          bool collinearNext =
-              std::abs(cross(perturbPoints[curr], perturbPoints[next])) < (lenNext * lenCurr) * DEGENERATE_THRESH &&
-              dot(perturbPoints[curr], perturbPoints[next]) > 0;
-
-          if ((collinearNext && lenCurr > lenNext) || (collinearPrev && lenCurr > lenPrev)) {
-            sortInds[iMiddle] = INVALID_IND;
-            anyChanged = true;
-            continue;
-          }
-        }
+  // == Find the local Delaunay triangulation
+  // Strategy: we start with an angularly-sorted list of points around the center point. The output we seek is a
+  // subset of this list, which corresponds to the 1-ring of the center vertex in the local Delaunay triangulation. We
+  // will repeatedly remove points from the sorted list (marking them as removed with INVALID_IND) if the diamond they
+  // form is not Delaunay. Note that is is also necessary to handle the case where all points lie in some half-space,
+  // there is an absent triangle between some pair of points.
+  // NOTE: Doing this with while(changed) {} loop as below is vulnerable to N^2 behavior on e.g. a spiral
+  // configuration. But that seems sufficiently unlikely in practice. Could be remedied with a queue.
 
-        // If either of the triangles is empty (aka actually the boundary), skip this
-        if (isBoundary(prev, curr) || isBoundary(curr, next)) continue;
+  auto isBoundary = [&](size_t localIndA, size_t localIndB) {
+    Vector2 pA = perturbPoints[localIndA];
+    Vector2 pB = perturbPoints[localIndB];
 
-        // Test if the triangles should be merged
-        if (!inCircleTest(Vector2{0., 0.}, perturbPoints[prev], perturbPoints[next], perturbPoints[curr])) {
-          sortInds[iMiddle] = INVALID_IND;
-          anyChanged = true;
-        }
-      }
-    }
+    return cross(pA, pB) <= 0.;
+  };
 
-    // Emit the actual triangles
-    std::vector<std::array<Point, 3>>& thisPointTriangles = result[p];
-    for (size_t iPrev = 0; iPrev < N; iPrev++) {
-      if (sortInds[iPrev] == INVALID_IND) continue; // skip unused indices
+  // The main loop, discarding (aka flipping) until we have the Delaunay triagulation
+  bool anyChanged = true;
+  size_t N = sortInds.size();
+
+  while (anyChanged) {
+    anyChanged = false;
+    for (size_t iMiddle = 0; iMiddle < N; iMiddle++) {
+      if (sortInds[iMiddle] == INVALID_IND) continue; // skip unused indices
 
-      size_t iNext = iPrev;
+      // Find the previous and next indices
+      size_t iPrev = iMiddle;
+      do {
+        iPrev = (iPrev + N - 1) % N;
+      } while (sortInds[iPrev] == INVALID_IND);
+      size_t iNext = iMiddle;
       do {
         iNext = (iNext + 1) % N;
       } while (sortInds[iNext] == INVALID_IND);
 
-      if (iPrev == iNext) continue;
-
       // Indices in to the local neighbor list
       size_t prev = sortInds[iPrev];
+      size_t curr = sortInds[iMiddle];
       size_t next = sortInds[iNext];
 
-      if (!isBoundary(prev, next)) {
-        thisPointTriangles.push_back(
-            std::array<Point, 3>{p, geom.neighbors->neighbors[p][prev], geom.neighbors->neighbors[p][next]});
+      // Degenerate cases
+      if (curr == prev || curr == next || prev == next) continue;
+
+      // For any colllinear points, keep only the closest
+      if (withDegeneracyHeuristic) {
+        double lenPrev = norm(perturbPoints[prev]);
+        double lenCurr = norm(perturbPoints[curr]);
+        double lenNext = norm(perturbPoints[next]);
+
+        bool collinearPrev =
+            std::abs(cross(perturbPoints[curr], perturbPoints[prev])) < (lenPrev * lenCurr) * DEGENERATE_THRESH &&
+            dot(perturbPoints[curr], perturbPoints[prev]) > 0;
+        bool collinearNext =
+            std::abs(cross(perturbPoints[curr], perturbPoints[next])) < (lenNext * lenCurr) * DEGENERATE_THRESH &&
+            dot(perturbPoints[curr], perturbPoints[next]) > 0;
+
+        if ((collinearNext && lenCurr > lenNext) || (collinearPrev && lenCurr > lenPrev)) {
+          sortInds[iMiddle] = INVALID_IND;
+          anyChanged = true;
+          continue;
+        }
+      }
+
+      // If either of the triangles is empty (aka actually the boundary), skip this
+      if (isBoundary(prev, curr) || isBoundary(curr, next)) continue;
+
+      // Test if the triangles should be merged
+      if (!inCircleTest(Vector2{0., 0.}, perturbPoints[prev], perturbPoints[next], perturbPoints[curr])) {
+        sortInds[iMiddle] = INVALID_IND;
+        anyChanged = true;
       }
     }
   }
 
+  // Emit the actual triangles
+  size_t nTri = 0;
+  for (size_t iPrev = 0; iPrev < N; iPrev++) {
+    if (sortInds[iPrev] == INVALID_IND) continue; // skip unused indices
+
+    size_t iNext = iPrev;
+    do {
+      iNext = (iNext + 1) % N;
+    } while (sortInds[iNext] == INVALID_IND);
+
+    if (iPrev == iNext) continue;
+
+    // Indices in to the local neighbor list
+    size_t prev = sortInds[iPrev];
+    size_t next = sortInds[iNext];
+
+    if (!isBoundary(prev, next)) {
+      out[nTri] = std::array<size_t, 2>{prev, next};
+      nTri++;
+    }
+  }
+
+  return nTri;
+}
+
+} // namespace
+
+LocalTriangulationResult buildLocalTriangulationsFlat(PointCloud& cloud, PointPositionGeometry& geom,
+                                                      bool withDegeneracyHeuristic) {
+
+  GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
+
+  geom.requireNeighbors();
+  geom.requireTangentCoordinates();
+
+  const Neighborhoods& neighborhoods = *geom.neighbors;
+  const NeighborData<Vector2>& tangentCoordinates = geom.tangentCoordinates;
+  size_t nPoints = cloud.nPoints();
+
+  // Each point gets at most one triangle per neighbor, so triangulate in parallel in to preallocated slots laid out
+  // like the neighbor lists, then compact.
+  std::vector<std::array<size_t, 2>> slots(neighborhoods.neighborIndices.size());
+  std::vector<size_t> slotCounts(nPoints, 0);
+  size_t nThreads = getNumThreads();
+  std::vector<LocalTriangulationScratch> scratch(nThreads);
+  std::atomic<size_t> nDegenerate{0};
+
+  parallelForWithThreadIndex(
+      0, nPoints, nThreads,
+      [&](size_t iThread, size_t iP) {
+        std::array<size_t, 2>* out = slots.data() + neighborhoods.neighborStart[iP];
+        size_t nTri = triangulateNeighborhood(tangentCoordinates[iP], withDegeneracyHeuristic, scratch[iThread], out);
+        if (nTri == INVALID_IND) {
+          nDegenerate++;
+          nTri = 0;
+        }
+        slotCounts[iP] = nTri;
+      },
+      64);
+
+  if (nDegenerate > 0) {
+    std::cerr << "skipping " << nDegenerate << " degenerate neighborhood(s)" << std::endl;
+  }
+
+  LocalTriangulationResult result;
+  result.triangleStart.resize(nPoints + 1);
+  result.triangleStart[0] = 0;
+  for (size_t iP = 0; iP < nPoints; iP++) {
+    result.triangleStart[iP + 1] = result.triangleStart[iP] + slotCounts[iP];
+  }
+  result.triangles.resize(result.triangleStart.back());
+
+  parallelFor(
+      0, nPoints,
+      [&](size_t iP) {
+        NeighborList neigh = neighborhoods.neighbors[iP];
+        const std::array<size_t, 2>* in = slots.data() + neighborhoods.neighborStart[iP];
+        std::array<size_t, 3>* out = result.triangles.data() + result.triangleStart[iP];
+        for (size_t iT = 0; iT < slotCounts[iP]; iT++) {
+          out[iT] = std::array<size_t, 3>{iP, neigh.index(in[iT][0]), neigh.index(in[iT][1])};
+        }
+      },
+      256);
+
   geom.unrequireNeighbors();
   geom.unrequireTangentCoordinates();
 
   return result;
 }
 
+PointData<std::vector<std::array<Point, 3>>> buildLocalTriangulations(PointCloud& cloud, PointPositionGeometry& geom,
+                                                                      bool withDegeneracyHeuristic) {
+
+  LocalTriangulationResult flatResult = buildLocalTriangulationsFlat(cloud, geom, withDegeneracyHeuristic);
+
+  PointData<std::vector<std::array<Point, 3>>> result(cloud);
+  for (Point p : cloud.points()) {
+    size_t iP = p.getIndex();
+    std::vector<std::array<Point, 3>>& thisPointTriangles = result[p];
+    for (size_t iT = flatResult.triangleStart[iP]; iT < flatResult.triangleStart[iP + 1]; iT++) {
+      const std::array<size_t, 3>& tri = flatResult.triangles[iT];
+      thisPointTriangles.push_back(std::array<Point, 3>{cloud.point(tri[0]), cloud.point(tri[1]), cloud.point(tri[2])});
+    }
+  }
+
+  return result;
+}
+
 PointData<std::vector<std::array<size_t, 3>>>
 handleToInds(PointCloud& cloud, const PointData<std::vector<std::array<Point, 3>>>& localResult) {
 
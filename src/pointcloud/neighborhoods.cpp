@@ -6,8 +6,17 @@
 namespace geometrycentral {
 namespace pointcloud {
 
+NeighborList::operator std::vector<Point>() const {
+  std::vector<Point> result;
+  result.reserve(count);
+  for (size_t j = 0; j < count; j++) {
+    result.push_back((*this)[j]);
+  }
+  return result;
+}
+
 Neighborhoods::Neighborhoods(PointCloud& cloud_, const PointData<Vector3>& positions, unsigned int nNeighbors)
-    : cloud(cloud_), neighbors(cloud)
+    : cloud(cloud_)
 
 {
   GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
@@ -18,15 +27,13 @@ Neighborhoods::Neighborhoods(PointCloud& cloud_, const PointData<Vector3>& posit
     pointVec.push_back(positions[p]);
   }
 
-  // Find neighbors
-  NearestNeighborFinder knn(pointVec);
-  for (Point p : cloud.points()) {
-    neighbors[p].resize(nNeighbors);
-    std::vector<size_t> neighInd = knn.kNearestNeighbors(p.getIndex(), nNeighbors);
-    for(size_t j = 0; j < neighInd.size(); j++) {
-      neighbors[p][j] = cloud.point(neighInd[j]);
-    }
-  }
+  // Find neighbors, writing directly in to our flat storage
+  NearestNeighborFinder knn(std::move(pointVec));
+  NeighborQueryResult result;
+  knn.kNearestNeighborsAll(nNeighbors, result);
+  neighborStart = std::move(result.offsets);
+  neighborIndices = std::move(result.indices);
+  neighborDistancesSq = std::move(result.distancesSq);
 }
 
 } // namespace pointcloud
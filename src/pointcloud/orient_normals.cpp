@@ -0,0 +1,96 @@
+#include "geometrycentral/pointcloud/orient_normals.h"
+
+#include "geometrycentral/utilities/disjoint_sets.h"
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace geometrycentral {
+namespace pointcloud {
+
+PointData<Vector3> orientNormals(PointPositionGeometry& geom, Vector3 referenceDir) {
+  geom.requireNormals();
+  PointData<Vector3> normals = geom.normals;
+  orientNormals(geom, normals, referenceDir);
+  return normals;
+}
+
+void orientNormals(PointPositionGeometry& geom, PointData<Vector3>& normals, Vector3 referenceDir) {
+  PointCloud& cloud = geom.cloud;
+  GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
+  geom.requireNeighbors();
+  const Neighborhoods& neigh = *geom.neighbors;
+  size_t nPts = cloud.nPoints();
+
+  auto isValid = [&](size_t i) { return std::isfinite(normals[i].x); };
+
+  // Weight each (directed) kNN edge; each undirected edge appears at least once, which is all Kruskal needs
+  size_t nEdges = neigh.neighborIndices.size();
+  std::vector<std::tuple<double, size_t, size_t>> edges(nEdges);
+  parallelFor(
+      0, nPts,
+      [&](size_t iP) {
+        for (size_t iE = neigh.neighborStart[iP]; iE < neigh.neighborStart[iP + 1]; iE++) {
+          size_t iN = neigh.neighborIndices[iE];
+          double w = std::numeric_limits<double>::infinity();
+          if (isValid(iP) && isValid(iN)) w = 1. - std::abs(dot(normals[iP], normals[iN]));
+          edges[iE] = std::make_tuple(w, std::min(iP, iN), std::max(iP, iN));
+        }
+      },
+      1024);
+  std::sort(edges.begin(), edges.end());
+
+  // Kruskal
+  DisjointSets dj(nPts);
+  std::vector<std::vector<size_t>> treeNeighbors(nPts);
+  size_t nConnected = 1;
+  for (const std::tuple<double, size_t, size_t>& edge : edges) {
+    double w;
+    size_t iA, iB;
+    std::tie(w, iA, iB) = edge;
+    if (std::isinf(w)) break; // the rest touch undefined normals
+    if (dj.find(iA) == dj.find(iB)) continue;
+
+    dj.merge(iA, iB);
+    treeNeighbors[iA].push_back(iB);
+    treeNeighbors[iB].push_back(iA);
+    nConnected++;
+    if (nConnected == nPts) break;
+  }
+
+  // Root each component at its extreme point along the reference direction
+  std::vector<size_t> rootOf(nPts + 1, INVALID_IND);
+  for (size_t iP = 0; iP < nPts; iP++) {
+    if (!isValid(iP)) continue;
+    size_t& root = rootOf[dj.find(iP)];
+    if (root == INVALID_IND || dot(geom.positions[iP], referenceDir) > dot(geom.positions[root], referenceDir)) {
+      root = iP;
+    }
+  }
+
+  // Propagate signs outward from the roots
+  std::vector<char> visited(nPts, false);
+  std::vector<size_t> toVisit;
+  for (size_t root : rootOf) {
+    if (root == INVALID_IND) continue;
+    if (dot(normals[root], referenceDir) < 0.) normals[root] *= -1.;
+    visited[root] = true;
+    toVisit.push_back(root);
+    while (!toVisit.empty()) {
+      size_t iP = toVisit.back();
+      toVisit.pop_back();
+      for (size_t iN : treeNeighbors[iP]) {
+        if (visited[iN]) continue;
+        if (dot(normals[iP], normals[iN]) < 0.) normals[iN] *= -1.;
+        visited[iN] = true;
+        toVisit.push_back(iN);
+      }
+    }
+  }
+}
+
+} // namespace pointcloud
+} // namespace geometrycentral
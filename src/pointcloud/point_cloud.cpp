@@ -23,7 +23,11 @@ PointCloud::PointCloud(size_t nPts) {
   isCompressedFlag = true;
 }
 
-PointCloud::~PointCloud() {}
+PointCloud::~PointCloud() {
+  for (auto& f : meshDeleteCallbackList) {
+    f();
+  }
+}
 
 
 // ==========================================================
@@ -91,6 +95,13 @@ void PointCloud::validateConnectivity() {
 }
 
 
+Point PointCloud::insertPoint() { return getNewPoint(); }
+
+void PointCloud::removePoint(Point p) {
+  if (pointIsDead(p.getIndex())) throw std::runtime_error("tried to remove a point which is not in the cloud");
+  deleteElement(p);
+}
+
 Point PointCloud::getNewPoint() {
 
   // The boring case, when no resize is needed
@@ -99,7 +110,7 @@ Point PointCloud::getNewPoint() {
   }
   // The intesting case, where vectors resize
   else {
-    size_t newCapacity = nPointsCapacityCount * 2;
+    size_t newCapacity = std::max<size_t>(1, nPointsCapacityCount * 2);
 
     // Resize internal arrays
     pointValid.resize(newCapacity);
@@ -1,5 +1,9 @@
 #include "geometrycentral/pointcloud/point_cloud_heat_solver.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+
 
 namespace geometrycentral {
 namespace pointcloud {
@@ -13,14 +17,16 @@ PointCloudHeatSolver::PointCloudHeatSolver(PointCloud& cloud_, PointPositionGeom
 
   geom.requireNeighbors();
   geom.requireTuftedTriangulation();
-  geom.tuftedGeom->requireEdgeLengths();
   geom.requireTangentCoordinates();
-  geom.requireNeighbors();
   // geom.tuftedGeom->requireCotanLaplacian();
   // geom.requireLaplacian();
 
+  computeShortTime();
+}
 
+void PointCloudHeatSolver::computeShortTime() {
   // Compute a timescale
+  geom.tuftedGeom->requireEdgeLengths();
   double meanEdgeLength = 0.;
   for (surface::Edge e : geom.tuftedMesh->edges()) {
     meanEdgeLength += geom.tuftedGeom->edgeLengths[e];
@@ -29,31 +35,50 @@ PointCloudHeatSolver::PointCloudHeatSolver(PointCloud& cloud_, PointPositionGeom
   shortTime = tCoef * meanEdgeLength * meanEdgeLength;
 }
 
+SparseMatrix<double> PointCloudHeatSolver::buildVectorHeatOperator() {
+  geom.requireConnectionLaplacian();
+  geom.tuftedGeom->requireVertexLumpedMassMatrix();
+
+  SparseMatrix<double>& Lconn = geom.connectionLaplacian;
+  SparseMatrix<double>& massMat = geom.tuftedGeom->vertexLumpedMassMatrix;
+  SparseMatrix<double> vectorOp = complexToReal(massMat.cast<std::complex<double>>().eval()) + shortTime * Lconn;
+
+  geom.tuftedGeom->unrequireVertexLumpedMassMatrix();
+  geom.unrequireConnectionLaplacian();
+  return vectorOp;
+}
+
 void PointCloudHeatSolver::ensureHaveHeatDistanceWorker() {
   if (heatDistanceWorker != nullptr) return;
 
-  heatDistanceWorker.reset(new surface::HeatMethodDistanceSolver(*geom.tuftedGeom, tCoef));
+  // (we already have the tufted IDT)
+  heatDistanceWorker.reset(new surface::HeatMethodDistanceSolver(*geom.tuftedGeom, tCoef, false));
 }
 
 void PointCloudHeatSolver::ensureHaveVectorHeatSolver() {
   if (vectorHeatSolver != nullptr) return;
 
-  geom.requireConnectionLaplacian();
-  geom.tuftedGeom->requireVertexLumpedMassMatrix();
-
-  heatDistanceWorker.reset(
-      new surface::HeatMethodDistanceSolver(*geom.tuftedGeom, tCoef, false)); // we already have the tufted IDT
-
-  SparseMatrix<double>& Lconn = geom.connectionLaplacian;
-  SparseMatrix<double>& massMat = geom.tuftedGeom->vertexLumpedMassMatrix;
-
-  // Build the operator
-  SparseMatrix<double> vectorOp = complexToReal(massMat.cast<std::complex<double>>().eval()) + shortTime * Lconn;
-
   // Note: since tufted Laplacian is always Delaunay, the connection Laplacian is SPD, and we can use Cholesky
+  SparseMatrix<double> vectorOp = buildVectorHeatOperator();
   vectorHeatSolver.reset(new PositiveDefiniteSolver<double>(vectorOp));
+}
 
-  geom.unrequireConnectionLaplacian();
+bool PointCloudHeatSolver::updateGeometry() {
+  GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
+
+  computeShortTime();
+
+  // Only rebuild the solvers which have been used so far. Evaluate every refactor(), even after one fails.
+  bool reusedAll = true;
+  // The tufted triangulation is rebuilt on refresh, so the worker moves to the new one
+  if (heatDistanceWorker != nullptr) {
+    reusedAll &= heatDistanceWorker->updateGeometry(*geom.tuftedGeom);
+  }
+  if (vectorHeatSolver != nullptr) {
+    SparseMatrix<double> vectorOp = buildVectorHeatOperator();
+    reusedAll &= vectorHeatSolver->refactor(vectorOp);
+  }
+  return reusedAll;
 }
 
 // === Heat method for distance
@@ -63,6 +88,7 @@ PointData<double> PointCloudHeatSolver::computeDistance(const Point& sourcePoint
   return computeDistance(v);
 }
 PointData<double> PointCloudHeatSolver::computeDistance(const std::vector<Point>& sourcePoints) {
+  GC_SAFETY_ASSERT(sourcePoints.size() != 0, "must have at least one source");
   ensureHaveHeatDistanceWorker();
 
   std::vector<surface::Vertex> sourceVerts;
@@ -72,26 +98,53 @@ PointData<double> PointCloudHeatSolver::computeDistance(const std::vector<Point>
   return PointData<double>(cloud, heatDistanceWorker->computeDistance(sourceVerts).raw());
 }
 
-PointData<double> PointCloudHeatSolver::extendScalars(const std::vector<std::tuple<Point, double>>& sources) {
+std::vector<PointData<double>> PointCloudHeatSolver::computeDistanceBatch(const std::vector<Point>& sourcePoints) {
   ensureHaveHeatDistanceWorker();
 
+  size_t N = cloud.nPoints();
+  std::vector<PointData<double>> results;
+  for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+    results.emplace_back(cloud);
+  }
+
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < sourcePoints.size(); blockStart += blockSize) {
+    size_t B = std::min(blockSize, sourcePoints.size() - blockStart);
+
+    DenseMatrix<double> rhs = DenseMatrix<double>::Zero(N, B);
+    for (size_t b = 0; b < B; b++) {
+      rhs(sourcePoints[blockStart + b].getIndex(), b) = 1.;
+    }
+    DenseMatrix<double> dist = heatDistanceWorker->computeDistanceRHSMultiple(rhs);
+
+    parallelFor(0, B, [&](size_t b) {
+      double shift = dist(sourcePoints[blockStart + b].getIndex(), b);
+      PointData<double>& result = results[blockStart + b];
+      for (size_t i = 0; i < N; i++) {
+        result[i] = dist(i, b) - shift;
+      }
+    });
+  }
+
+  return results;
+}
+
+PointData<double> PointCloudHeatSolver::extendScalars(const std::vector<std::tuple<Point, double>>& sources) {
   GC_SAFETY_ASSERT(sources.size() != 0, "must have at least one source");
 
-  ensureHaveVectorHeatSolver();
+  ensureHaveHeatDistanceWorker();
 
   size_t N = cloud.nPoints();
-  Vector<double> rhsVals = Vector<double>::Zero(N);
-  Vector<double> rhsOnes = Vector<double>::Zero(N);
+  DenseMatrix<double> rhs = DenseMatrix<double>::Zero(N, 2); // values, ones
   for (size_t i = 0; i < sources.size(); i++) {
     size_t ind = std::get<0>(sources[i]).getIndex();
     double val = std::get<1>(sources[i]);
-    rhsOnes(ind) = 1.;
-    rhsVals(ind) = val;
+    rhs(ind, 0) = val;
+    rhs(ind, 1) = 1.;
   }
 
-  Vector<double> interpVals = heatDistanceWorker->heatSolver->solve(rhsVals);
-  Vector<double> interpOnes = heatDistanceWorker->heatSolver->solve(rhsOnes);
-  Vector<double> resultArr = (interpVals.array() / interpOnes.array());
+  DenseMatrix<double> interp = heatDistanceWorker->heatSolver->solveMultiple(rhs);
+  Vector<double> resultArr = (interp.col(0).array() / interp.col(1).array());
 
   PointData<double> result(cloud, resultArr);
   return result;
@@ -151,19 +204,17 @@ PointCloudHeatSolver::transportTangentVectors(const std::vector<std::tuple<Point
     // Interpolate magnitudes
     ensureHaveHeatDistanceWorker();
 
-    Vector<double> rhsNorm = Vector<double>::Zero(N);
-    Vector<double> rhsOnes = Vector<double>::Zero(N);
+    DenseMatrix<double> rhs = DenseMatrix<double>::Zero(N, 2); // norms, ones
     for (size_t i = 0; i < sources.size(); i++) {
       size_t ind = std::get<0>(sources[i]).getIndex();
       Vector2 vec = std::get<1>(sources[i]);
-      rhsOnes(ind) = 1.;
-      rhsNorm(ind) = norm(vec);
+      rhs(ind, 0) = norm(vec);
+      rhs(ind, 1) = 1.;
     }
 
-    Vector<double> interpNorm = heatDistanceWorker->heatSolver->solve(rhsNorm);
-    Vector<double> interpOnes = heatDistanceWorker->heatSolver->solve(rhsOnes);
+    DenseMatrix<double> interp = heatDistanceWorker->heatSolver->solveMultiple(rhs);
 
-    dirInterp = dirInterp.array() * (interpNorm.array() / interpOnes.array());
+    dirInterp = dirInterp.array() * (interp.col(0).array() / interp.col(1).array());
   }
 
 
@@ -176,10 +227,47 @@ PointCloudHeatSolver::transportTangentVectors(const std::vector<std::tuple<Point
   return result;
 }
 
+std::vector<PointData<Vector2>>
+PointCloudHeatSolver::transportTangentVectorBatch(const std::vector<std::tuple<Point, Vector2>>& sources) {
+  ensureHaveVectorHeatSolver();
+
+  size_t N = cloud.nPoints();
+  std::vector<PointData<Vector2>> results;
+  for (size_t iS = 0; iS < sources.size(); iS++) {
+    results.emplace_back(cloud);
+  }
+
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < sources.size(); blockStart += blockSize) {
+    size_t B = std::min(blockSize, sources.size() - blockStart);
+
+    // Packed real right hand sides, as in complexToReal()
+    DenseMatrix<double> rhs = DenseMatrix<double>::Zero(2 * N, B);
+    for (size_t b = 0; b < B; b++) {
+      size_t ind = std::get<0>(sources[blockStart + b]).getIndex();
+      Vector2 vec = std::get<1>(sources[blockStart + b]);
+      rhs(2 * ind, b) = vec.x;
+      rhs(2 * ind + 1, b) = vec.y;
+    }
+    DenseMatrix<double> dirInterpPacked = vectorHeatSolver->solveMultiple(rhs);
+
+    // With a single source, the magnitude is just that of the source vector
+    parallelFor(0, B, [&](size_t b) {
+      double sourceNorm = norm(std::get<1>(sources[blockStart + b]));
+      PointData<Vector2>& result = results[blockStart + b];
+      for (size_t i = 0; i < N; i++) {
+        Vector2 val{dirInterpPacked(2 * i, b), dirInterpPacked(2 * i + 1, b)};
+        result[i] = normalizeCutoff(val) * sourceNorm;
+      }
+    });
+  }
+
+  return results;
+}
+
 // Compute the logarithmic map from a source point
 PointData<Vector2> PointCloudHeatSolver::computeLogMap(const Point& sourcePoint) {
   ensureHaveHeatDistanceWorker();
-  ensureHaveVectorHeatSolver();
   geom.requireTangentTransport();
 
   size_t N = cloud.nPoints();
@@ -187,38 +275,12 @@ PointData<Vector2> PointCloudHeatSolver::computeLogMap(const Point& sourcePoint)
 
   { // == Get the direction component from transport of outward vectors
 
-    /* Transport angle strategy
-    Vector<std::complex<double>> rhsHorizontal = Vector<std::complex<double>>::Zero(N);
-    Vector<std::complex<double>> rhsOutward = Vector<std::complex<double>>::Zero(N);
-
-    rhsHorizontal[sourcePoint.getIndex()] = 1.;
-
-    std::vector<Point>& neighbors = geom.neighbors->neighbors[sourcePoint];
-    for (size_t iN = 0; iN < neighbors.size(); iN++) {
-      Point neigh = neighbors[iN];
-      Vector2 neighOutward = geom.tangentCoordinates[sourcePoint][iN];
-      Vector2 outward = geom.tangentTransport[sourcePoint][iN] * neighOutward;
-      if(geom.tangentTransportOrientFlip[sourcePoint][iN]) {
-        outward = outward.conj();
-      }
-      rhsOutward[neigh.getIndex()] = outward;
-    }
-
-    // Transport
-    Vector<std::complex<double>> dirHorizontal = realToComplex(vectorHeatSolver->solve(complexToReal(rhsHorizontal)));
-    Vector<std::complex<double>> dirOutward = realToComplex(vectorHeatSolver->solve(complexToReal(rhsOutward)));
-
-    // Store directional component of logmap
-    for (size_t i = 0; i < N; i++) {
-      logmapResult[i] = normalizeCutoff(Vector2::fromComplex(dirOutward(i) / dirHorizontal(i)));
-    }
-    */
-
-    // Unit circle strategy
+    // Unit circle strategy (see the Vector Heat Method paper for an alternative, transporting the outward and
+    // horizontal directions with the vector heat operator)
     Vector<double> rhsX = Vector<double>::Zero(N);
     Vector<double> rhsY = Vector<double>::Zero(N);
 
-    std::vector<Point>& neighbors = geom.neighbors->neighbors[sourcePoint];
+    NeighborList neighbors = geom.neighbors->neighbors[sourcePoint];
     for (size_t iN = 0; iN < neighbors.size(); iN++) {
       Point neigh = neighbors[iN];
       Vector2 neighOutward = geom.tangentCoordinates[sourcePoint][iN];
@@ -250,5 +312,52 @@ PointData<Vector2> PointCloudHeatSolver::computeLogMap(const Point& sourcePoint)
   return logmapResult;
 }
 
+std::vector<PointData<Vector2>> PointCloudHeatSolver::computeLogMapBatch(const std::vector<Point>& sourcePoints) {
+  ensureHaveHeatDistanceWorker();
+  geom.requireTangentTransport();
+
+  size_t N = cloud.nPoints();
+  std::vector<PointData<Vector2>> results;
+  for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+    results.emplace_back(cloud);
+  }
+
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < sourcePoints.size(); blockStart += blockSize) {
+    size_t B = std::min(blockSize, sourcePoints.size() - blockStart);
+
+    // == Direction component, as in computeLogMap(). Columns are:
+    //   [0, B): x-component of the unit circle around the source
+    //   [B, 2B): y-component
+    DenseMatrix<double> dirRHS = DenseMatrix<double>::Zero(N, 2 * B);
+    DenseMatrix<double> distRHS = DenseMatrix<double>::Zero(N, B);
+    for (size_t b = 0; b < B; b++) {
+      Point sourcePoint = sourcePoints[blockStart + b];
+      NeighborList neighbors = geom.neighbors->neighbors[sourcePoint];
+      for (size_t iN = 0; iN < neighbors.size(); iN++) {
+        Vector2 neighOutward = geom.tangentCoordinates[sourcePoint][iN];
+        dirRHS(neighbors.index(iN), b) = neighOutward.x;
+        dirRHS(neighbors.index(iN), B + b) = neighOutward.y;
+      }
+      distRHS(sourcePoint.getIndex(), b) = 1.;
+    }
+    DenseMatrix<double> dir = heatDistanceWorker->heatSolver->solveMultiple(dirRHS);
+
+    // == Magnitude component, as the distance
+    DenseMatrix<double> dist = heatDistanceWorker->computeDistanceRHSMultiple(distRHS);
+
+    parallelFor(0, B, [&](size_t b) {
+      double shift = dist(sourcePoints[blockStart + b].getIndex(), b);
+      PointData<Vector2>& result = results[blockStart + b];
+      for (size_t i = 0; i < N; i++) {
+        result[i] = normalize(Vector2{dir(i, b), dir(i, B + b)}) * (dist(i, b) - shift);
+      }
+    });
+  }
+
+  geom.unrequireTangentTransport();
+  return results;
+}
+
 } // namespace pointcloud
 } // namespace geometrycentral
@@ -1,7 +1,15 @@
 #include "geometrycentral/pointcloud/point_cloud_io.h"
 
-#include "geometrycentral/surface/simple_polygon_mesh.h"
+#include "geometrycentral/utilities/parallel.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 
 #include "happly.h"
 
@@ -11,7 +19,7 @@ namespace pointcloud {
 // Anonymous helpers
 namespace {
 
-std::vector<std::string> supportedPointCloudTypes = {"obj", "ply"};
+std::vector<std::string> supportedPointCloudTypes = {"obj", "ply", "gcpc"};
 
 std::string typeFromFilename(std::string filename) {
 
@@ -41,45 +49,541 @@ std::string typeFromFilename(std::string filename) {
 
 } // namespace
 
+namespace {
+
+// Minimal description of a .ply header, enough to locate and decode the vertex element. happly always loads the whole
+// file and converts each property separately, so binary vertex records and PLYPointStream use this instead; everything
+// else goes through happly.
+
+enum class PLYFormat { ASCII, BinaryLittleEndian, BinaryBigEndian };
+enum class PLYType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+struct PLYProperty {
+  std::string name;
+  PLYType type;
+  bool isList = false;
+  PLYType countType;
+};
+
+struct PLYElement {
+  std::string name;
+  size_t count;
+  std::vector<PLYProperty> properties;
+};
+
+struct PLYHeader {
+  PLYFormat format;
+  std::vector<PLYElement> elements;
+};
+
+PLYType parsePLYType(const std::string& name) {
+  if (name == "char" || name == "int8") return PLYType::Int8;
+  if (name == "uchar" || name == "uint8") return PLYType::UInt8;
+  if (name == "short" || name == "int16") return PLYType::Int16;
+  if (name == "ushort" || name == "uint16") return PLYType::UInt16;
+  if (name == "int" || name == "int32") return PLYType::Int32;
+  if (name == "uint" || name == "uint32") return PLYType::UInt32;
+  if (name == "float" || name == "float32") return PLYType::Float32;
+  if (name == "double" || name == "float64") return PLYType::Float64;
+  throw std::runtime_error("unrecognized .ply property type " + name);
+}
+
+size_t plyTypeSize(PLYType type) {
+  switch (type) {
+  case PLYType::Int8:
+  case PLYType::UInt8:
+    return 1;
+  case PLYType::Int16:
+  case PLYType::UInt16:
+    return 2;
+  case PLYType::Int32:
+  case PLYType::UInt32:
+  case PLYType::Float32:
+    return 4;
+  case PLYType::Float64:
+    return 8;
+  }
+  return 0; // unreachable
+}
+
+// Decode a binary value stored at `ptr`, which holds plyTypeSize(type) bytes in file order
+double decodePLYValue(const char* ptr, PLYType type, bool swapBytes) {
+  char bytes[8];
+  size_t size = plyTypeSize(type);
+  if (swapBytes) {
+    for (size_t i = 0; i < size; i++) bytes[i] = ptr[size - 1 - i];
+  } else {
+    std::memcpy(bytes, ptr, size);
+  }
+
+  switch (type) {
+  case PLYType::Int8: {
+    int8_t v;
+    std::memcpy(&v, bytes, 1);
+    return v;
+  }
+  case PLYType::UInt8: {
+    uint8_t v;
+    std::memcpy(&v, bytes, 1);
+    return v;
+  }
+  case PLYType::Int16: {
+    int16_t v;
+    std::memcpy(&v, bytes, 2);
+    return v;
+  }
+  case PLYType::UInt16: {
+    uint16_t v;
+    std::memcpy(&v, bytes, 2);
+    return v;
+  }
+  case PLYType::Int32: {
+    int32_t v;
+    std::memcpy(&v, bytes, 4);
+    return v;
+  }
+  case PLYType::UInt32: {
+    uint32_t v;
+    std::memcpy(&v, bytes, 4);
+    return v;
+  }
+  case PLYType::Float32: {
+    float v;
+    std::memcpy(&v, bytes, 4);
+    return v;
+  }
+  case PLYType::Float64: {
+    double v;
+    std::memcpy(&v, bytes, 8);
+    return v;
+  }
+  }
+  return 0.; // unreachable
+}
+
+bool hostIsLittleEndian() {
+  uint16_t test = 1;
+  char first;
+  std::memcpy(&first, &test, 1);
+  return first == 1;
+}
+
+// Parse the header, leaving the stream positioned at the start of the data. If `headerText` is given, the raw header
+// lines are stored there.
+PLYHeader readPLYHeader(std::istream& in, std::string* headerText = nullptr) {
+  PLYHeader header;
+
+  std::string line;
+  std::getline(in, line);
+  if (line.substr(0, 3) != "ply") throw std::runtime_error("not a .ply file");
+  if (headerText) *headerText = line + "\n";
+
+  bool haveFormat = false;
+  while (std::getline(in, line)) {
+    if (headerText) *headerText += line + "\n";
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    std::istringstream tokens(line);
+    std::string keyword;
+    tokens >> keyword;
+
+    if (keyword == "format") {
+      std::string format;
+      tokens >> format;
+      if (format == "ascii") {
+        header.format = PLYFormat::ASCII;
+      } else if (format == "binary_little_endian") {
+        header.format = PLYFormat::BinaryLittleEndian;
+      } else if (format == "binary_big_endian") {
+        header.format = PLYFormat::BinaryBigEndian;
+      } else {
+        throw std::runtime_error("unrecognized .ply format " + format);
+      }
+      haveFormat = true;
+    } else if (keyword == "element") {
+      PLYElement elem;
+      tokens >> elem.name >> elem.count;
+      header.elements.push_back(elem);
+    } else if (keyword == "property") {
+      if (header.elements.empty()) throw std::runtime_error(".ply property declared before any element");
+      PLYProperty prop;
+      std::string typeName;
+      tokens >> typeName;
+      if (typeName == "list") {
+        std::string countTypeName;
+        prop.isList = true;
+        tokens >> countTypeName >> typeName;
+        prop.countType = parsePLYType(countTypeName);
+      }
+      prop.type = parsePLYType(typeName);
+      tokens >> prop.name;
+      header.elements.back().properties.push_back(prop);
+    } else if (keyword == "end_header") {
+      if (!haveFormat) throw std::runtime_error(".ply header has no format line");
+      return header;
+    }
+    // (comments, obj_info, etc are ignored)
+  }
+
+  throw std::runtime_error(".ply header has no end_header line");
+}
+
+// Read one item of an element, storing the value of each scalar property in `values` (list properties are skipped,
+// and get NaN)
+void readPLYItem(std::istream& in, const PLYElement& elem, PLYFormat format, bool swapBytes,
+                 std::vector<double>& values) {
+  values.resize(elem.properties.size());
+  char bytes[8];
+  for (size_t iProp = 0; iProp < elem.properties.size(); iProp++) {
+    const PLYProperty& prop = elem.properties[iProp];
+    if (format == PLYFormat::ASCII) {
+      if (prop.isList) {
+        double count, dummy;
+        in >> count;
+        for (size_t i = 0; i < static_cast<size_t>(count); i++) in >> dummy;
+        values[iProp] = std::numeric_limits<double>::quiet_NaN();
+      } else {
+        in >> values[iProp];
+      }
+    } else {
+      if (prop.isList) {
+        in.read(bytes, plyTypeSize(prop.countType));
+        size_t count = static_cast<size_t>(decodePLYValue(bytes, prop.countType, swapBytes));
+        in.ignore(count * plyTypeSize(prop.type));
+        values[iProp] = std::numeric_limits<double>::quiet_NaN();
+      } else {
+        in.read(bytes, plyTypeSize(prop.type));
+        values[iProp] = decodePLYValue(bytes, prop.type, swapBytes);
+      }
+    }
+  }
+  if (!in) throw std::runtime_error(".ply file ended unexpectedly");
+}
+
+// Skip all elements preceding the one with the given name, and return its index in the header
+size_t skipToPLYElement(std::istream& in, const PLYHeader& header, std::string name) {
+  size_t iTarget = INVALID_IND;
+  for (size_t iE = 0; iE < header.elements.size(); iE++) {
+    if (header.elements[iE].name == name) {
+      iTarget = iE;
+      break;
+    }
+  }
+  if (iTarget == INVALID_IND) throw std::runtime_error(".ply file has no " + name + " element");
+
+  bool swapBytes = (header.format == PLYFormat::BinaryLittleEndian) != hostIsLittleEndian();
+  std::vector<double> values;
+  for (size_t iE = 0; iE < iTarget; iE++) {
+    for (size_t i = 0; i < header.elements[iE].count; i++) {
+      readPLYItem(in, header.elements[iE], header.format, swapBytes, values);
+    }
+  }
+  return iTarget;
+}
+
+// Write a value as 8 little-endian bytes
+void encodeDoubleLE(double val, char* out) {
+  std::memcpy(out, &val, 8);
+  if (!hostIsLittleEndian()) std::reverse(out, out + 8);
+}
+
+// The native binary format: a short header listing the per-point fields, followed by one record of little-endian
+// doubles per point
+//   "GCPC" | uint32 version | uint64 nPoints | uint32 nFields | nFields x (uint32 nameLength | name chars)
+const char gcpcMagic[4] = {'G', 'C', 'P', 'C'};
+const uint32_t gcpcVersion = 1;
+
+template <typename T>
+void writeLE(std::ostream& out, T val) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &val, sizeof(T));
+  if (!hostIsLittleEndian()) std::reverse(bytes, bytes + sizeof(T));
+  out.write(bytes, sizeof(T));
+}
+
+template <typename T>
+T readLE(std::istream& in) {
+  char bytes[sizeof(T)];
+  in.read(bytes, sizeof(T));
+  if (!in) throw std::runtime_error("point cloud file ended unexpectedly");
+  if (!hostIsLittleEndian()) std::reverse(bytes, bytes + sizeof(T));
+  T val;
+  std::memcpy(&val, bytes, sizeof(T));
+  return val;
+}
+
+} // namespace
+
 // === Readers ===
 
 // Particular per-filetype readers called by the general versions below
 namespace {
 
-std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud_obj(std::istream& in) {
-  // Bootstrap off the mesh reader
-  surface::SimplePolygonMesh mesh(in, "obj");
+typedef std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>, PointCloudAttributes>
+    CloudWithAttributes;
+
+// Where to store one field of each record: the value for point i goes to the double at (base + i * stride)
+struct FieldTarget {
+  char* base = nullptr;
+  size_t stride = 0;
+};
+
+// Create a cloud with N points, along with its attributes, and find where each named field of the input should be
+// stored. Fields x/y/z become positions, nx/ny/nz become normals, and anything else becomes a scalar attribute. Fields
+// with an empty name are ignored.
+CloudWithAttributes allocateCloud(size_t N, const std::vector<std::string>& fieldNames,
+                                  std::vector<FieldTarget>& targets) {
 
-  std::unique_ptr<PointCloud> cloud(new PointCloud(mesh.nVertices()));
+  std::unique_ptr<PointCloud> cloud(new PointCloud(N));
   std::unique_ptr<PointPositionGeometry> geom(new PointPositionGeometry(*cloud));
-  for (size_t i = 0; i < mesh.nVertices(); i++) {
-    geom->positions[i] = mesh.vertexCoordinates[i];
+  PointCloudAttributes attributes;
+
+  auto findField = [&](std::string name) {
+    return std::find(fieldNames.begin(), fieldNames.end(), name) != fieldNames.end();
+  };
+  for (std::string name : {"x", "y", "z"}) {
+    if (!findField(name)) throw std::runtime_error("point cloud file has no " + name + " coordinate");
+  }
+  bool hasNormals = findField("nx") && findField("ny") && findField("nz");
+  if (hasNormals) {
+    attributes.normals = PointData<Vector3>(*cloud);
   }
 
-  return std::make_tuple(std::move(cloud), std::move(geom));
+  // (create all the storage first, then take pointers in to it)
+  for (const std::string& name : fieldNames) {
+    if (name == "") continue; // (unused field)
+    if (name == "x" || name == "y" || name == "z") continue;
+    if (hasNormals && (name == "nx" || name == "ny" || name == "nz")) continue;
+    attributes.scalars[name] = PointData<double>(*cloud);
+  }
+
+  targets.assign(fieldNames.size(), FieldTarget());
+  if (N == 0) return CloudWithAttributes{std::move(cloud), std::move(geom), std::move(attributes)};
+  for (size_t iF = 0; iF < fieldNames.size(); iF++) {
+    const std::string& name = fieldNames[iF];
+    FieldTarget& target = targets[iF];
+    for (int j = 0; j < 3; j++) {
+      if (name == std::string(1, "xyz"[j])) {
+        target.base = reinterpret_cast<char*>(&geom->positions[0][j]);
+        target.stride = sizeof(Vector3);
+      }
+      if (hasNormals && name == "n" + std::string(1, "xyz"[j])) {
+        target.base = reinterpret_cast<char*>(&attributes.normals[0][j]);
+        target.stride = sizeof(Vector3);
+      }
+    }
+    if (target.base == nullptr && attributes.scalars.find(name) != attributes.scalars.end()) {
+      target.base = reinterpret_cast<char*>(&attributes.scalars[name][0]);
+      target.stride = sizeof(double);
+    }
+  }
+
+  return CloudWithAttributes{std::move(cloud), std::move(geom), std::move(attributes)};
 }
 
-std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud_ply(std::istream& in) {
-  happly::PLYData plyIn(in);
+// Read N fixed-size binary records, decoding them in to the targets in parallel, one large chunk at a time
+void readBinaryRecords(std::istream& in, size_t N, const std::vector<PLYType>& types, bool swapBytes,
+                       const std::vector<FieldTarget>& targets) {
+
+  std::vector<size_t> offsets(types.size());
+  size_t recordSize = 0;
+  for (size_t iF = 0; iF < types.size(); iF++) {
+    offsets[iF] = recordSize;
+    recordSize += plyTypeSize(types[iF]);
+  }
+  if (recordSize == 0) return;
+
+  size_t chunkRecords = std::max<size_t>(1, (size_t(1) << 24) / recordSize);
+  std::vector<char> bytes;
+  for (size_t start = 0; start < N; start += chunkRecords) {
+    size_t n = std::min(chunkRecords, N - start);
+    bytes.resize(n * recordSize);
+    in.read(bytes.data(), bytes.size());
+    if (!in) throw std::runtime_error("point cloud file ended unexpectedly");
+
+    parallelFor(
+        0, n,
+        [&](size_t i) {
+          const char* record = bytes.data() + i * recordSize;
+          for (size_t iF = 0; iF < types.size(); iF++) {
+            const FieldTarget& target = targets[iF];
+            if (target.base == nullptr) continue;
+            double val = decodePLYValue(record + offsets[iF], types[iF], swapBytes);
+            std::memcpy(target.base + (start + i) * target.stride, &val, sizeof(double));
+          }
+        },
+        4096);
+  }
+}
 
-  std::vector<std::array<double, 3>> vPos = plyIn.getVertexPositions();
-  size_t N = vPos.size();
+CloudWithAttributes readPointCloud_obj(std::istream& in) {
+  // Only vertex positions and normals matter, so scan for just those lines rather than parsing a whole mesh
+  std::vector<Vector3> positions;
+  std::vector<Vector3> normals;
+  std::string line;
+  while (std::getline(in, line)) {
+    const char* ptr = line.c_str();
+    while (*ptr == ' ' || *ptr == '\t') ptr++;
+    if (ptr[0] != 'v') continue;
+
+    std::vector<Vector3>* target;
+    if (ptr[1] == ' ' || ptr[1] == '\t') {
+      target = &positions;
+      ptr += 1;
+    } else if (ptr[1] == 'n' && (ptr[2] == ' ' || ptr[2] == '\t')) {
+      target = &normals;
+      ptr += 2;
+    } else {
+      continue;
+    }
 
-  std::unique_ptr<PointCloud> cloud(new PointCloud(N));
-  std::unique_ptr<PointPositionGeometry> geom(new PointPositionGeometry(*cloud));
-  for (size_t i = 0; i < N; i++) {
+    Vector3 v;
     for (int j = 0; j < 3; j++) {
-      geom->positions[i][j] = vPos[i][j];
+      char* end;
+      v[j] = std::strtod(ptr, &end);
+      if (end == ptr) throw std::runtime_error("could not parse .obj line: " + line);
+      ptr = end;
     }
+    target->push_back(v);
   }
 
-  return std::make_tuple(std::move(cloud), std::move(geom));
+  size_t N = positions.size();
+  bool hasNormals = normals.size() == N && N > 0;
+  std::vector<std::string> fieldNames = {"x", "y", "z"};
+  if (hasNormals) fieldNames.insert(fieldNames.end(), {"nx", "ny", "nz"});
+
+  std::vector<FieldTarget> targets;
+  CloudWithAttributes result = allocateCloud(N, fieldNames, targets);
+  PointPositionGeometry& geom = *std::get<1>(result);
+  PointCloudAttributes& attributes = std::get<2>(result);
+  for (size_t i = 0; i < N; i++) {
+    geom.positions[i] = positions[i];
+    if (hasNormals) attributes.normals[i] = normals[i];
+  }
+
+  return result;
+}
+
+// happly only converts between property types of the same kind (signed, unsigned, or floating point), so try each in
+// turn. Returns false for list properties.
+bool getPLYScalarProperty(happly::Element& elem, std::string name, std::vector<double>& values) {
+  try {
+    values = elem.getProperty<double>(name);
+    return true;
+  } catch (const std::runtime_error&) {
+  }
+  try {
+    std::vector<int32_t> intValues = elem.getProperty<int32_t>(name);
+    values.assign(intValues.begin(), intValues.end());
+    return true;
+  } catch (const std::runtime_error&) {
+  }
+  try {
+    std::vector<uint32_t> uintValues = elem.getProperty<uint32_t>(name);
+    values.assign(uintValues.begin(), uintValues.end());
+    return true;
+  } catch (const std::runtime_error&) {
+  }
+  return false;
+}
+
+// Read through happly, which handles any layout, but loads the whole file
+CloudWithAttributes readPointCloud_plyHapply(std::istream& in) {
+  happly::PLYData plyIn(in);
+  happly::Element& vertexElem = plyIn.getElement("vertex");
+
+  // Gather the scalar properties; list properties are ignored
+  std::vector<std::string> fieldNames;
+  std::vector<std::vector<double>> fieldValues;
+  for (const std::string& name : vertexElem.getPropertyNames()) {
+    std::vector<double> values;
+    if (!getPLYScalarProperty(vertexElem, name, values)) continue;
+    fieldNames.push_back(name);
+    fieldValues.push_back(std::move(values));
+  }
+
+  size_t N = vertexElem.count;
+  std::vector<FieldTarget> targets;
+  CloudWithAttributes result = allocateCloud(N, fieldNames, targets);
+  for (size_t iF = 0; iF < fieldNames.size(); iF++) {
+    const FieldTarget& target = targets[iF];
+    if (target.base == nullptr) continue;
+    for (size_t i = 0; i < N; i++) {
+      std::memcpy(target.base + i * target.stride, &fieldValues[iF][i], sizeof(double));
+    }
+  }
+
+  return result;
+}
+
+CloudWithAttributes readPointCloud_ply(std::istream& in) {
+
+  // Keep a copy of the header text, in case we need to hand the file to happly after all
+  std::string headerText;
+  PLYHeader header = readPLYHeader(in, &headerText);
+
+  // Binary vertex records of fixed size are decoded directly, in parallel chunks
+  const PLYElement* vertexElem = nullptr;
+  for (const PLYElement& elem : header.elements) {
+    if (elem.name == "vertex") vertexElem = &elem;
+  }
+  bool fixedSize = vertexElem != nullptr;
+  if (vertexElem != nullptr) {
+    for (const PLYProperty& prop : vertexElem->properties) {
+      if (prop.isList) fixedSize = false;
+    }
+  }
+  if (header.format != PLYFormat::ASCII && fixedSize) {
+    skipToPLYElement(in, header, "vertex");
+
+    std::vector<std::string> fieldNames;
+    std::vector<PLYType> types;
+    for (const PLYProperty& prop : vertexElem->properties) {
+      fieldNames.push_back(prop.name);
+      types.push_back(prop.type);
+    }
+
+    std::vector<FieldTarget> targets;
+    CloudWithAttributes result = allocateCloud(vertexElem->count, fieldNames, targets);
+    bool swapBytes = (header.format == PLYFormat::BinaryLittleEndian) != hostIsLittleEndian();
+    readBinaryRecords(in, vertexElem->count, types, swapBytes, targets);
+    return result;
+  }
+
+  // Anything else (ascii files, vertices with list properties) goes through happly
+  std::stringstream fullFile;
+  fullFile << headerText;
+  if (in.peek() != std::char_traits<char>::eof()) fullFile << in.rdbuf();
+  return readPointCloud_plyHapply(fullFile);
+}
+
+CloudWithAttributes readPointCloud_gcpc(std::istream& in) {
+  char magic[4];
+  in.read(magic, 4);
+  if (!in || std::memcmp(magic, gcpcMagic, 4) != 0) throw std::runtime_error("not a .gcpc point cloud file");
+  uint32_t version = readLE<uint32_t>(in);
+  if (version != gcpcVersion) throw std::runtime_error("unsupported .gcpc version " + std::to_string(version));
+
+  size_t N = readLE<uint64_t>(in);
+  uint32_t nFields = readLE<uint32_t>(in);
+  std::vector<std::string> fieldNames(nFields);
+  for (std::string& name : fieldNames) {
+    uint32_t len = readLE<uint32_t>(in);
+    name.resize(len);
+    in.read(&name[0], len);
+  }
+
+  std::vector<FieldTarget> targets;
+  CloudWithAttributes result = allocateCloud(N, fieldNames, targets);
+  std::vector<PLYType> types(nFields, PLYType::Float64);
+  readBinaryRecords(in, N, types, !hostIsLittleEndian(), targets);
+
+  return result;
 }
 
 } // namespace
 
-std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud(std::string filename,
-                                                                                               std::string type) {
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>, PointCloudAttributes>
+readPointCloudWithAttributes(std::string filename, std::string type) {
 
   // Attempt to detect filename
   bool typeGiven = type != "";
@@ -95,59 +599,223 @@ std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>>
   std::ifstream inStream(filename, std::ios::binary);
   if (!inStream) throw std::runtime_error("couldn't open file " + filename);
 
-  return readPointCloud(inStream, type);
+  return readPointCloudWithAttributes(inStream, type);
 }
 
-std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud(std::istream& in,
-                                                                                               std::string type) {
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>, PointCloudAttributes>
+readPointCloudWithAttributes(std::istream& in, std::string type) {
 
   if (type == "obj") {
     return readPointCloud_obj(in);
   } else if (type == "ply") {
     return readPointCloud_ply(in);
+  } else if (type == "gcpc") {
+    return readPointCloud_gcpc(in);
   } else {
     throw std::runtime_error("Did not recognize point cloud file type " + type);
   }
 
-  return std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>>{nullptr,
-                                                                                         nullptr}; // unreachable
+  return CloudWithAttributes{nullptr, nullptr, PointCloudAttributes()}; // unreachable
+}
+
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud(std::string filename,
+                                                                                               std::string type) {
+  std::unique_ptr<PointCloud> cloud;
+  std::unique_ptr<PointPositionGeometry> geom;
+  PointCloudAttributes attributes;
+  std::tie(cloud, geom, attributes) = readPointCloudWithAttributes(filename, type);
+  return std::make_tuple(std::move(cloud), std::move(geom));
+}
+
+std::tuple<std::unique_ptr<PointCloud>, std::unique_ptr<PointPositionGeometry>> readPointCloud(std::istream& in,
+                                                                                               std::string type) {
+  std::unique_ptr<PointCloud> cloud;
+  std::unique_ptr<PointPositionGeometry> geom;
+  PointCloudAttributes attributes;
+  std::tie(cloud, geom, attributes) = readPointCloudWithAttributes(in, type);
+  return std::make_tuple(std::move(cloud), std::move(geom));
 }
 
 // === Writers ===
 
-// Particular per-filetype writers called by the general versions below
-namespace {
+class PointCloudWriter::WriterImpl {
+public:
+  WriterImpl(std::ostream& out_, std::string type_, size_t nPoints_, bool withNormals_,
+             std::vector<std::string> scalarNames_)
+      : out(out_), type(type_), nPoints(nPoints_), withNormals(withNormals_), scalarNames(scalarNames_) {
+
+    fieldNames = {"x", "y", "z"};
+    if (withNormals) fieldNames.insert(fieldNames.end(), {"nx", "ny", "nz"});
+    fieldNames.insert(fieldNames.end(), scalarNames.begin(), scalarNames.end());
+
+    if (type == "ply") {
+      out << "ply\n";
+      out << "format binary_little_endian 1.0\n";
+      out << "element vertex " << nPoints << "\n";
+      for (const std::string& name : fieldNames) {
+        out << "property double " << name << "\n";
+      }
+      out << "end_header\n";
+    } else if (type == "gcpc") {
+      out.write(gcpcMagic, 4);
+      writeLE<uint32_t>(out, gcpcVersion);
+      writeLE<uint64_t>(out, nPoints);
+      writeLE<uint32_t>(out, static_cast<uint32_t>(fieldNames.size()));
+      for (const std::string& name : fieldNames) {
+        writeLE<uint32_t>(out, static_cast<uint32_t>(name.size()));
+        out.write(name.data(), name.size());
+      }
+    } else if (type == "obj") {
+      if (!scalarNames.empty()) throw std::runtime_error("cannot write scalar attributes to .obj");
+      // Make sure we write out at full precision
+      out << std::setprecision(std::numeric_limits<double>::max_digits10);
+    } else {
+      throw std::runtime_error("Did not recognize point cloud file type " + type);
+    }
+  }
+
+  void write(const std::vector<Vector3>& positions, const std::vector<Vector3>& normals,
+             const std::vector<std::vector<double>>& scalars) {
+    size_t n = positions.size();
+    if (nWritten + n > nPoints) throw std::runtime_error("wrote more points than declared");
+    if (withNormals && normals.size() != n) throw std::runtime_error("need exactly one normal per point");
+    if (scalars.size() != scalarNames.size()) throw std::runtime_error("need one array per scalar attribute");
+    for (const std::vector<double>& vals : scalars) {
+      if (vals.size() != n) throw std::runtime_error("need exactly one scalar value per point");
+    }
 
-void writePointCloud_obj(PointCloud& cloud, PointPositionGeometry& geometry, std::ostream& out) {
-  // Just bootstrap off the mesh version
-  surface::SimplePolygonMesh mesh;
-  mesh.vertexCoordinates.resize(cloud.nPoints());
-  for (size_t i = 0; i < cloud.nPoints(); i++) {
-    mesh.vertexCoordinates[i] = geometry.positions[i];
+    if (type == "obj") {
+      for (size_t i = 0; i < n; i++) {
+        out << "v " << positions[i].x << " " << positions[i].y << " " << positions[i].z << "\n";
+        if (withNormals) out << "vn " << normals[i].x << " " << normals[i].y << " " << normals[i].z << "\n";
+      }
+    } else {
+      // Encode records in parallel, then write them all at once
+      size_t nFields = fieldNames.size();
+      size_t recordSize = 8 * nFields;
+      bytes.resize(n * recordSize);
+      parallelFor(
+          0, n,
+          [&](size_t i) {
+            char* record = bytes.data() + i * recordSize;
+            for (int j = 0; j < 3; j++) {
+              encodeDoubleLE(positions[i][j], record + 8 * j);
+            }
+            size_t iField = 3;
+            if (withNormals) {
+              for (int j = 0; j < 3; j++) {
+                encodeDoubleLE(normals[i][j], record + 8 * (3 + j));
+              }
+              iField = 6;
+            }
+            for (size_t iS = 0; iS < scalars.size(); iS++) {
+              encodeDoubleLE(scalars[iS][i], record + 8 * (iField + iS));
+            }
+          },
+          4096);
+      out.write(bytes.data(), bytes.size());
+    }
+
+    nWritten += n;
+  }
+
+  void close() {
+    if (closed) return;
+    closed = true;
+    out.flush();
+    if (nWritten != nPoints) {
+      throw std::runtime_error("point cloud writer declared " + std::to_string(nPoints) + " points, but " +
+                               std::to_string(nWritten) + " were written");
+    }
+    if (!out) throw std::runtime_error("error writing point cloud");
   }
 
-  mesh.writeMesh(out, "obj");
+  std::unique_ptr<std::ofstream> fileOut; // if we opened the file ourselves
+
+private:
+  std::ostream& out;
+  std::string type;
+  size_t nPoints;
+  bool withNormals;
+  std::vector<std::string> scalarNames;
+  std::vector<std::string> fieldNames;
+  size_t nWritten = 0;
+  bool closed = false;
+  std::vector<char> bytes;
+};
+
+PointCloudWriter::PointCloudWriter(std::string filename, size_t nPoints, bool withNormals,
+                                   std::vector<std::string> scalarNames, std::string type) {
+  if (type == "") type = typeFromFilename(filename);
+
+  // (always binary, see note in readPointCloudWithAttributes())
+  std::unique_ptr<std::ofstream> fileOut(new std::ofstream(filename, std::ios::binary));
+  if (!*fileOut) throw std::runtime_error("couldn't open file " + filename);
+  impl.reset(new WriterImpl(*fileOut, type, nPoints, withNormals, scalarNames));
+  impl->fileOut = std::move(fileOut);
 }
 
-void writePointCloud_ply(PointCloud& cloud, PointPositionGeometry& geometry, std::ostream& out) {
-  // Copy to a std vector
-  std::vector<std::array<double, 3>> vertexPos;
-  vertexPos.resize(cloud.nPoints());
-  for (size_t i = 0; i < cloud.nPoints(); i++) {
-    for (int j = 0; j < 3; j++) {
-      vertexPos[i][j] = geometry.positions[i][j];
-    }
+PointCloudWriter::PointCloudWriter(std::ostream& out, std::string type, size_t nPoints, bool withNormals,
+                                   std::vector<std::string> scalarNames) {
+  impl.reset(new WriterImpl(out, type, nPoints, withNormals, scalarNames));
+}
+
+PointCloudWriter::~PointCloudWriter() {
+  try {
+    impl->close();
+  } catch (...) {
+    // errors are only reported by an explicit call to close()
   }
+}
 
-  happly::PLYData plyOut;
-  plyOut.addVertexPositions(vertexPos);
-  plyOut.write(out, happly::DataFormat::Binary);
+void PointCloudWriter::write(const std::vector<Vector3>& positions, const std::vector<Vector3>& normals,
+                             const std::vector<std::vector<double>>& scalars) {
+  impl->write(positions, normals, scalars);
 }
 
+void PointCloudWriter::close() { impl->close(); }
 
-} // namespace
+void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, const PointCloudAttributes& attributes,
+                     std::ostream& out, std::string type) {
 
-void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::string filename, std::string type) {
+  GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
+
+  bool withNormals = attributes.normals.size() > 0;
+  std::vector<std::string> scalarNames;
+  for (const auto& entry : attributes.scalars) {
+    scalarNames.push_back(entry.first);
+  }
+
+  PointCloudWriter writer(out, type, cloud.nPoints(), withNormals, scalarNames);
+
+  // Feed the writer in chunks, so we never hold a second copy of the whole cloud
+  const size_t chunkSize = 1 << 16;
+  std::vector<Vector3> positions, normals;
+  std::vector<std::vector<double>> scalars(scalarNames.size());
+  for (size_t start = 0; start < cloud.nPoints(); start += chunkSize) {
+    size_t end = std::min(start + chunkSize, cloud.nPoints());
+    positions.clear();
+    normals.clear();
+    for (std::vector<double>& vals : scalars) vals.clear();
+    for (size_t i = start; i < end; i++) {
+      positions.push_back(geometry.positions[i]);
+      if (withNormals) normals.push_back(attributes.normals[i]);
+    }
+    size_t iS = 0;
+    for (const auto& entry : attributes.scalars) {
+      for (size_t i = start; i < end; i++) {
+        scalars[iS].push_back(entry.second[i]);
+      }
+      iS++;
+    }
+    writer.write(positions, normals, scalars);
+  }
+
+  writer.close();
+}
+
+void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, const PointCloudAttributes& attributes,
+                     std::string filename, std::string type) {
 
   // Attempt to detect filename
   bool typeGiven = type != "";
@@ -163,19 +831,122 @@ void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::st
   std::ofstream outStream(filename, std::ios::binary);
   if (!outStream) throw std::runtime_error("couldn't open file " + filename);
 
-  return writePointCloud(cloud, geometry, outStream, type);
+  writePointCloud(cloud, geometry, attributes, outStream, type);
+}
+
+void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::string filename, std::string type) {
+  writePointCloud(cloud, geometry, PointCloudAttributes(), filename, type);
 }
 
 void writePointCloud(PointCloud& cloud, PointPositionGeometry& geometry, std::ostream& out, std::string type) {
+  writePointCloud(cloud, geometry, PointCloudAttributes(), out, type);
+}
 
-  if (type == "obj") {
-    return writePointCloud_obj(cloud, geometry, out);
-  } else if (type == "ply") {
-    return writePointCloud_ply(cloud, geometry, out);
-  } else {
-    throw std::runtime_error("Did not recognize point cloud file type " + type);
-  }
+// === Streaming ===
+
+VectorPointStream::VectorPointStream(std::vector<Vector3> points_) : points(std::move(points_)) {}
+
+void VectorPointStream::rewind() { nextInd = 0; }
+
+bool VectorPointStream::read(std::vector<Vector3>& buffer, size_t maxCount) {
+  size_t n = std::min(maxCount, points.size() - nextInd);
+  buffer.assign(points.begin() + nextInd, points.begin() + nextInd + n);
+  nextInd += n;
+  return n > 0;
 }
 
+size_t VectorPointStream::size() const { return points.size(); }
+
+class PLYPointStream::PLYStreamImpl {
+public:
+  PLYStreamImpl(std::string filename) : in(filename, std::ios::binary) {
+    if (!in) throw std::runtime_error("couldn't open file " + filename);
+
+    PLYHeader header = readPLYHeader(in);
+    format = header.format;
+    swapBytes = (format == PLYFormat::BinaryLittleEndian) != hostIsLittleEndian();
+
+    // Skip any elements which precede the vertices
+    size_t iVertexElem = skipToPLYElement(in, header, "vertex");
+    dataStart = in.tellg();
+
+    // Locate the coordinates within each vertex record
+    vertexElem = header.elements[iVertexElem];
+    nPoints = vertexElem.count;
+    recordSize = 0;
+    for (size_t iProp = 0; iProp < vertexElem.properties.size(); iProp++) {
+      const PLYProperty& prop = vertexElem.properties[iProp];
+      if (prop.isList) throw std::runtime_error("streaming .ply vertices with list properties is not supported");
+      for (int j = 0; j < 3; j++) {
+        if (prop.name == std::string(1, "xyz"[j])) {
+          coordProperty[j] = iProp;
+          coordOffset[j] = recordSize;
+          coordType[j] = prop.type;
+        }
+      }
+      recordSize += plyTypeSize(prop.type);
+    }
+    for (int j = 0; j < 3; j++) {
+      if (coordProperty[j] == INVALID_IND) throw std::runtime_error(".ply vertices must have x, y and z properties");
+    }
+  }
+
+  void rewind() {
+    in.clear();
+    in.seekg(dataStart);
+    nRead = 0;
+  }
+
+  bool read(std::vector<Vector3>& buffer, size_t maxCount) {
+    size_t n = std::min(maxCount, nPoints - nRead);
+    buffer.resize(n);
+    if (n == 0) return false;
+
+    if (format == PLYFormat::ASCII) {
+      for (size_t i = 0; i < n; i++) {
+        readPLYItem(in, vertexElem, format, swapBytes, values);
+        for (int j = 0; j < 3; j++) {
+          buffer[i][j] = values[coordProperty[j]];
+        }
+      }
+    } else {
+      bytes.resize(n * recordSize);
+      in.read(bytes.data(), bytes.size());
+      for (size_t i = 0; i < n; i++) {
+        const char* record = bytes.data() + i * recordSize;
+        for (int j = 0; j < 3; j++) {
+          buffer[i][j] = decodePLYValue(record + coordOffset[j], coordType[j], swapBytes);
+        }
+      }
+    }
+    if (!in) throw std::runtime_error(".ply file ended unexpectedly");
+
+    nRead += n;
+    return true;
+  }
+
+  size_t nPoints;
+
+private:
+  std::ifstream in;
+  std::streampos dataStart;
+  PLYFormat format;
+  bool swapBytes;
+  PLYElement vertexElem;
+  size_t recordSize;
+  std::vector<double> values;
+  std::array<size_t, 3> coordProperty{{INVALID_IND, INVALID_IND, INVALID_IND}};
+  std::array<size_t, 3> coordOffset;
+  std::array<PLYType, 3> coordType;
+  size_t nRead = 0;
+  std::vector<char> bytes;
+};
+
+PLYPointStream::PLYPointStream(std::string filename) { impl.reset(new PLYStreamImpl(filename)); }
+PLYPointStream::~PLYPointStream() = default;
+void PLYPointStream::rewind() { impl->rewind(); }
+bool PLYPointStream::read(std::vector<Vector3>& buffer, size_t maxCount) { return impl->read(buffer, maxCount); }
+size_t PLYPointStream::size() const { return impl->nPoints; }
+
 } // namespace pointcloud
 } // namespace geometrycentral
@@ -6,6 +6,7 @@
 #include "geometrycentral/surface/surface_mesh_factories.h"
 #include "geometrycentral/surface/tufted_laplacian.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
 
 namespace geometrycentral {
 namespace pointcloud {
@@ -74,26 +75,20 @@ void PointPositionGeometry::computeNormals() {
 
   normals = PointData<Vector3>(cloud);
 
-  for (Point p : cloud.points()) {
-    size_t nNeigh = neighbors->neighbors[p].size();
-    Vector3 center = positions[p];
-    Eigen::MatrixXd localMat(3, nNeigh);
-
-    for (size_t iN = 0; iN < nNeigh; iN++) {
-      Vector3 neighPos = positions[neighbors->neighbors[p][iN]] - center;
-      localMat(0, iN) = neighPos.x;
-      localMat(1, iN) = neighPos.y;
-      localMat(2, iN) = neighPos.z;
-    }
-
-    // Smallest singular vector is best normal
-    Eigen::JacobiSVD<Eigen::MatrixXd> svd(localMat, Eigen::ComputeThinU);
-    Eigen::Vector3d bestNormal = svd.matrixU().col(2);
-
-    Vector3 N{bestNormal(0), bestNormal(1), bestNormal(2)};
-    N = unit(N);
-    normals[p] = N;
-  }
+  size_t nThreads = getNumThreads();
+  std::vector<std::vector<Vector3>> neighPositions(nThreads);
+  parallelForWithThreadIndex(
+      0, cloud.nPoints(), nThreads,
+      [&](size_t iThread, size_t iP) {
+        NeighborList neigh = neighbors->neighbors[iP];
+        std::vector<Vector3>& neighPos = neighPositions[iThread];
+        neighPos.resize(neigh.size());
+        for (size_t iN = 0; iN < neigh.size(); iN++) {
+          neighPos[iN] = positions[neigh.index(iN)];
+        }
+        normals[iP] = estimateNormal(positions[iP], neighPos.data(), neighPos.size());
+      },
+      256);
 }
 void PointPositionGeometry::requireNormals() { normalsQ.require(); }
 void PointPositionGeometry::unrequireNormals() { normalsQ.unrequire(); }
@@ -116,23 +111,27 @@ void PointPositionGeometry::computeTangentCoordinates() {
   tangentBasisQ.ensureHave();
   normalsQ.ensureHave();
 
-  tangentCoordinates = PointData<std::vector<Vector2>>(cloud);
-  for (Point p : cloud.points()) {
-    size_t nNeigh = neighbors->neighbors[p].size();
-    tangentCoordinates[p].resize(nNeigh);
-    Vector3 center = positions[p];
-    Vector3 normal = normals[p];
-    Vector3 basisX = tangentBasis[p][0];
-    Vector3 basisY = tangentBasis[p][1];
-
-    for (size_t iN = 0; iN < nNeigh; iN++) {
-      Vector3 vec = positions[neighbors->neighbors[p][iN]] - center;
-      vec = vec.removeComponent(normal);
-
-      Vector2 coord{dot(basisX, vec), dot(basisY, vec)};
-      tangentCoordinates[p][iN] = coord;
-    }
-  }
+  tangentCoordinates = NeighborData<Vector2>(*neighbors);
+  parallelFor(
+      0, cloud.nPoints(),
+      [&](size_t iP) {
+        NeighborList neigh = neighbors->neighbors[iP];
+        NeighborSpan<Vector2> coords = tangentCoordinates[iP];
+        size_t nNeigh = neigh.size();
+        Vector3 center = positions[iP];
+        Vector3 normal = normals[iP];
+        Vector3 basisX = tangentBasis[iP][0];
+        Vector3 basisY = tangentBasis[iP][1];
+
+        for (size_t iN = 0; iN < nNeigh; iN++) {
+          Vector3 vec = positions[neigh.index(iN)] - center;
+          vec = vec.removeComponent(normal);
+
+          Vector2 coord{dot(basisX, vec), dot(basisY, vec)};
+          coords[iN] = coord;
+        }
+      },
+      256);
 }
 void PointPositionGeometry::requireTangentCoordinates() { tangentCoordinatesQ.require(); }
 void PointPositionGeometry::unrequireTangentCoordinates() { tangentCoordinatesQ.unrequire(); }
@@ -143,13 +142,12 @@ void PointPositionGeometry::computeTangentTransport() {
   normalsQ.ensureHave();
   tangentBasisQ.ensureHave();
 
-  tangentTransport = PointData<std::vector<Vector2>>(cloud);
+  tangentTransport = NeighborData<Vector2>(*neighbors);
   for (Point p : cloud.points()) {
-    size_t nNeigh = neighbors->neighbors[p].size();
-    tangentTransport[p].resize(nNeigh);
-    for (size_t iN = 0; iN < nNeigh; iN++) {
-      Point pN = neighbors->neighbors[p][iN];
-      tangentTransport[p][iN] = transportBetween(p, pN);
+    NeighborList neigh = neighbors->neighbors[p];
+    NeighborSpan<Vector2> trans = tangentTransport[p];
+    for (size_t iN = 0; iN < neigh.size(); iN++) {
+      trans[iN] = transportBetween(p, neigh[iN]);
     }
   }
 }
@@ -163,10 +161,17 @@ void PointPositionGeometry::computeTuftedTriangulation() {
 
   using namespace surface;
 
-  PointData<std::vector<std::array<Point, 3>>> localTriPoint = buildLocalTriangulations(cloud, *this, true);
+  LocalTriangulationResult localTri = buildLocalTriangulationsFlat(cloud, *this, true);
 
   // == Make a mesh
-  std::vector<std::vector<size_t>> allTris = handleToFlatInds(cloud, localTriPoint);
+  std::vector<std::vector<size_t>> allTris(localTri.triangles.size());
+  parallelFor(
+      0, allTris.size(),
+      [&](size_t iT) {
+        const std::array<size_t, 3>& tri = localTri.triangles[iT];
+        allTris[iT] = {tri[0], tri[1], tri[2]};
+      },
+      1024);
   std::vector<Vector3> posRaw(cloud.nPoints());
   for (size_t iP = 0; iP < posRaw.size(); iP++) {
     posRaw[iP] = positions[iP];
@@ -184,7 +189,7 @@ void PointPositionGeometry::computeTuftedTriangulation() {
   // Build the cover
   buildIntrinsicTuftedCover(*tuftedMesh, tuftedEdgeLengths);
 
-  flipToDelaunay(*tuftedMesh, tuftedEdgeLengths);
+  flipToDelaunayParallel(*tuftedMesh, tuftedEdgeLengths);
 
   // Create the geometry object
   tuftedGeom.reset(new EdgeLengthGeometry(*tuftedMesh, tuftedEdgeLengths));
@@ -199,6 +204,7 @@ void PointPositionGeometry::unrequireTuftedTriangulation() { tuftedTriangulation
 void PointPositionGeometry::computeLaplacian() {
   tuftedTriangulationQ.ensureHave();
 
+  // (the cotan Laplacian of the tufted triangulation is assembled in parallel)
   tuftedGeom->requireCotanLaplacian();
   laplacian = tuftedGeom->cotanLaplacian;
 
@@ -275,7 +281,7 @@ void PointPositionGeometry::computeGradient() {
   for (Point p : cloud.points()) {
     size_t iPt = pointIndices[p];
 
-    std::vector<Point>& neigh = neighbors->neighbors[p];
+    NeighborList neigh = neighbors->neighbors[p];
 
     // Build a local linear system describing the gradient
     size_t nNeigh = neigh.size();
@@ -370,5 +376,23 @@ std::tuple<Vector2, bool> PointPositionGeometry::transportBetweenOriented(Point
   return std::make_tuple(sourceXInTarget, inverted);
 }
 
+Vector3 estimateNormal(Vector3 center, const Vector3* neighborPositions, size_t nNeighbors) {
+
+  // Second moment of the neighbors about the point
+  Eigen::Matrix3d moment = Eigen::Matrix3d::Zero();
+  for (size_t iN = 0; iN < nNeighbors; iN++) {
+    Vector3 d = neighborPositions[iN] - center;
+    Eigen::Vector3d dE(d.x, d.y, d.z);
+    moment += dE * dE.transpose();
+  }
+
+  // Eigenvector of the smallest eigenvalue is the best normal (eigenvalues are sorted increasing)
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+  solver.computeDirect(moment);
+  Eigen::Vector3d bestNormal = solver.eigenvectors().col(0);
+
+  return unit(Vector3{bestNormal(0), bestNormal(1), bestNormal(2)});
+}
+
 } // namespace pointcloud
 } // namespace geometrycentral
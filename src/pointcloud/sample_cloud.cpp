@@ -1,6 +1,12 @@
 #include "geometrycentral/pointcloud/sample_cloud.h"
 
+#include "geometrycentral/utilities/parallel.h"
+#include "geometrycentral/utilities/voxel_hash_grid.h"
+
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <stdexcept>
 
 
 namespace geometrycentral {
@@ -10,62 +16,225 @@ using surface::SurfacePoint;
 
 namespace pointcloud {
 
+namespace {
+
+// Counter-based random numbers: a SplitMix64 stream, started from a hash of (seed, sample index)
+struct SampleRNG {
+  uint64_t state;
+
+  SampleRNG(uint64_t seed, uint64_t counter) : state(seed) {
+    state = next() ^ counter;
+    next();
+  }
+
+  uint64_t next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  // uniform in [0, 1)
+  double unit() { return (next() >> 11) * (1. / 9007199254740992.); }
+};
+
 std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<SurfacePoint>>
-uniformlySamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, size_t nPts) {
+sampleWith(const SurfaceSampler& sampler, size_t nPts) {
+  std::unique_ptr<PointCloud> cloud(new PointCloud(nPts));
+  PointData<Vector3> pos(*cloud);
+  PointData<SurfacePoint> cloudSources(*cloud);
+  sampler.sample(pos, cloudSources);
+  return std::make_tuple(std::move(cloud), pos, cloudSources);
+}
+
+} // namespace
 
+SurfaceSampler::SurfaceSampler(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, uint64_t seed_)
+    : seed(seed_) {
 
   geom.requireVertexPositions();
   geom.requireFaceAreas();
 
-  // Random number generator
-  // if we ever want to seed, do it here
-  std::random_device rd;
-  std::mt19937 gen(rd());
-
-  // Create a sampler to pick points from faces
-  // (uniformly in the geometric sense)
   std::vector<double> areas;
-  std::vector<Face> faces;
   areas.reserve(mesh.nFaces());
   faces.reserve(mesh.nFaces());
+  faceVertexPositions.reserve(mesh.nFaces());
   for (Face f : mesh.faces()) {
     GC_SAFETY_ASSERT(f.isTriangle(), "can only sample point cloud from triangular mesh");
-    areas.push_back(geom.faceAreas[f]);
     faces.push_back(f);
+    surface::Halfedge he = f.halfedge();
+    faceVertexPositions.push_back({{geom.vertexPositions[he.vertex()], geom.vertexPositions[he.next().vertex()],
+                                    geom.vertexPositions[he.next().next().vertex()]}});
+    areas.push_back(geom.faceAreas[f]);
+    areaSum += geom.faceAreas[f];
   }
-  std::discrete_distribution<size_t> faceDist(areas.begin(), areas.end());
 
-  // Create a real-valued sampler, which we will use for barycentric coordinates within faces
-  std::uniform_real_distribution<double> realDist(0., 1.);
+  geom.unrequireVertexPositions();
+  geom.unrequireFaceAreas();
 
-  // Store results here
-  std::unique_ptr<PointCloud> cloud(new PointCloud(nPts));
-  PointData<Vector3> pos(*cloud);
-  PointData<SurfacePoint> cloudSources(*cloud);
+  if (!(areaSum > 0.)) throw std::runtime_error("cannot sample from a mesh with zero area");
+
+  // Build the alias table (Vose's method)
+  size_t nF = faces.size();
+  aliasProb.resize(nF);
+  aliasInd.resize(nF);
+  std::vector<size_t> small, large;
+  std::vector<double> scaled(nF);
+  for (size_t i = 0; i < nF; i++) {
+    scaled[i] = areas[i] * nF / areaSum;
+    (scaled[i] < 1. ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    size_t s = small.back();
+    small.pop_back();
+    size_t l = large.back();
+    aliasProb[s] = scaled[s];
+    aliasInd[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if (scaled[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // (leftovers are 1 up to roundoff)
+  for (size_t i : large) {
+    aliasProb[i] = 1.;
+    aliasInd[i] = i;
+  }
+  for (size_t i : small) {
+    aliasProb[i] = 1.;
+    aliasInd[i] = i;
+  }
+}
 
-  // Sample
-  for (size_t iSample = 0; iSample < nPts; iSample++) {
-    Point p = cloud->point(iSample);
+void SurfaceSampler::sample(size_t first, size_t count, Vector3* positions, SurfacePoint* sources) const {
+  size_t nF = faces.size();
+
+  parallelFor(
+      0, count,
+      [&](size_t i) {
+        SampleRNG rng(seed, first + i);
+
+        // Pick a face
+        size_t iF = std::min(static_cast<size_t>(rng.unit() * nF), nF - 1);
+        if (rng.unit() >= aliasProb[iF]) iF = aliasInd[iF];
+
+        // Pick barycentric coordinates within the face
+        double r1 = std::sqrt(rng.unit());
+        double r2 = rng.unit();
+        Vector3 bary{1. - r1, r1 * (1. - r2), r1 * r2};
+
+        if (positions != nullptr) {
+          const std::array<Vector3, 3>& vPos = faceVertexPositions[iF];
+          positions[i] = bary.x * vPos[0] + bary.y * vPos[1] + bary.z * vPos[2];
+        }
+        if (sources != nullptr) {
+          sources[i] = SurfacePoint(faces[iF], bary);
+        }
+      },
+      4096);
+}
 
-    // Pick a face
-    size_t iF = faceDist(gen);
-    Face f = faces[iF];
+void SurfaceSampler::sample(PointData<Vector3>& positions, PointData<SurfacePoint>& sources, size_t first) const {
+  PointCloud& cloud = *positions.getMesh();
+  GC_SAFETY_ASSERT(cloud.isCompressed(), "cloud must be compressed");
+  sample(first, cloud.nPoints(), positions.raw().data(), sources.raw().data());
+}
 
-    // Pick barycentric coordinates within the face
-    double r1 = realDist(gen);
-    double r2 = realDist(gen);
-    SurfacePoint surfP(f, Vector3{1. - std::sqrt(r1), std::sqrt(r1) * (1. - r2), std::sqrt(r1) * r2});
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<SurfacePoint>>
+uniformlySamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, size_t nPts) {
+  std::random_device rd;
+  uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+  return uniformlySamplePointsOnSurface(mesh, geom, nPts, seed);
+}
 
-    // Interpolate to get the position of the sampled point
-    Vector3 newPos = surfP.interpolate(geom.vertexPositions);
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<SurfacePoint>>
+uniformlySamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom, size_t nPts,
+                               uint64_t seed) {
+  SurfaceSampler sampler(mesh, geom, seed);
+  return sampleWith(sampler, nPts);
+}
 
-    pos[p] = newPos;
-    cloudSources[p] = surfP;
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>, PointData<SurfacePoint>>
+poissonDiskSamplePointsOnSurface(surface::SurfaceMesh& mesh, surface::EmbeddedGeometryInterface& geom,
+                                 double minDistance, uint64_t seed, double candidatesPerDiskArea) {
+  if (!(minDistance > 0.)) throw std::runtime_error("minimum distance must be positive");
+
+  SurfaceSampler sampler(mesh, geom, seed);
+
+  // Candidates
+  // (a tiny minDistance would need unboundedly many; refuse rather than trying to allocate them)
+  const double maxCandidates = static_cast<double>(size_t(1) << 28);
+  double nCandidatesD = std::ceil(candidatesPerDiskArea * sampler.totalArea() / (PI * minDistance * minDistance));
+  if (!(nCandidatesD <= maxCandidates)) {
+    throw std::runtime_error("minimum distance is too small for this surface: would need " +
+                             std::to_string(nCandidatesD) + " candidate samples");
+  }
+  size_t nCandidates = static_cast<size_t>(std::max(1., nCandidatesD));
+  std::vector<Vector3> candPos(nCandidates);
+  std::vector<SurfacePoint> candSources(nCandidates);
+  sampler.sample(0, nCandidates, candPos.data(), candSources.data());
+
+  // Bucket the candidates in voxels of width minDistance, so conflicts only happen between neighboring cells
+  VoxelBuckets cells(candPos, minDistance);
+  std::vector<std::vector<size_t>> cellAccepted(cells.size());
+
+  // Group the cells in to 8 phases by the parity of their coordinates. Cells in the same phase are never neighbors, so
+  // each phase can be processed in parallel. The result does not depend on the number of threads.
+  std::array<std::vector<size_t>, 8> phaseCells;
+  for (size_t iC = 0; iC < cells.size(); iC++) {
+    const VoxelKey& key = cells.keys[iC];
+    phaseCells[(key[0] & 1) | ((key[1] & 1) << 1) | ((key[2] & 1) << 2)].push_back(iC);
+  }
+  std::vector<std::array<size_t, 27>> neighborCells(cells.size());
+  parallelFor(0, cells.size(), [&](size_t iC) {
+    const VoxelKey& key = cells.keys[iC];
+    int n = 0;
+    for (int64_t di = -1; di <= 1; di++) {
+      for (int64_t dj = -1; dj <= 1; dj++) {
+        for (int64_t dk = -1; dk <= 1; dk++) {
+          neighborCells[iC][n++] = cells.find(VoxelKey{{key[0] + di, key[1] + dj, key[2] + dk}});
+        }
+      }
+    }
+  });
+
+  // Dart throwing: accept each candidate in turn unless it is too close to an already-accepted point
+  double minDist2 = minDistance * minDistance;
+  for (const std::vector<size_t>& phase : phaseCells) {
+    parallelFor(0, phase.size(), [&](size_t iP) {
+      size_t iC = phase[iP];
+      for (size_t iCand : cells.members[iC]) {
+        bool conflict = false;
+        for (size_t iN : neighborCells[iC]) {
+          if (iN == INVALID_IND) continue;
+          for (size_t iOther : cellAccepted[iN]) {
+            if (norm2(candPos[iOther] - candPos[iCand]) < minDist2) {
+              conflict = true;
+              break;
+            }
+          }
+          if (conflict) break;
+        }
+        if (!conflict) cellAccepted[iC].push_back(iCand);
+      }
+    });
   }
 
+  // Gather, in candidate order
+  std::vector<size_t> accepted;
+  for (const std::vector<size_t>& cellPoints : cellAccepted) {
+    accepted.insert(accepted.end(), cellPoints.begin(), cellPoints.end());
+  }
+  std::sort(accepted.begin(), accepted.end());
 
-  geom.unrequireVertexPositions();
-  geom.unrequireFaceAreas();
+  std::unique_ptr<PointCloud> cloud(new PointCloud(accepted.size()));
+  PointData<Vector3> pos(*cloud);
+  PointData<SurfacePoint> cloudSources(*cloud);
+  for (size_t i = 0; i < accepted.size(); i++) {
+    pos[i] = candPos[accepted[i]];
+    cloudSources[i] = candSources[accepted[i]];
+  }
 
   return std::make_tuple(std::move(cloud), pos, cloudSources);
 }
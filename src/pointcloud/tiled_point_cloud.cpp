@@ -0,0 +1,349 @@
+#include "geometrycentral/pointcloud/tiled_point_cloud.h"
+
+#include "geometrycentral/pointcloud/point_position_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace geometrycentral {
+namespace pointcloud {
+
+namespace {
+
+// A regular grid of cubical tiles covering a bounding box
+struct TileGrid {
+  Vector3 origin;
+  double size;
+  std::array<size_t, 3> dims;
+
+  // Grid coordinate along axis j, clamped to the grid
+  size_t coord(double x, int j) const {
+    double c = std::floor((x - origin[j]) / size);
+    if (!(c > 0.)) return 0;
+    return std::min(static_cast<size_t>(c), dims[j] - 1);
+  }
+
+  size_t index(size_t i, size_t j, size_t k) const { return (i * dims[1] + j) * dims[2] + k; }
+  size_t tileOf(Vector3 p) const { return index(coord(p.x, 0), coord(p.y, 1), coord(p.z, 2)); }
+
+  std::array<size_t, 3> gridIndex(size_t iTile) const {
+    return std::array<size_t, 3>{{iTile / (dims[1] * dims[2]), (iTile / dims[2]) % dims[1], iTile % dims[2]}};
+  }
+
+  // Call f(iTile) for each tile whose box, expanded by `halo`, contains p (including the tile which contains p)
+  template <typename F>
+  void forEachTileNear(Vector3 p, double halo, F&& f) const {
+    std::array<size_t, 3> lo, hi;
+    for (int j = 0; j < 3; j++) {
+      lo[j] = coord(p[j] - halo, j);
+      hi[j] = coord(p[j] + halo, j);
+    }
+    for (size_t i = lo[0]; i <= hi[0]; i++) {
+      for (size_t j = lo[1]; j <= hi[1]; j++) {
+        for (size_t k = lo[2]; k <= hi[2]; k++) {
+          f(index(i, j, k));
+        }
+      }
+    }
+  }
+};
+
+// Pick the largest tile size which yields at least nTarget tiles over the given extents
+double chooseTileSize(Vector3 extent, size_t nTarget) {
+  double maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+  if (nTarget <= 1 || maxExtent <= 0.) return maxExtent * (1. + 1e-6) + 1e-12;
+
+  auto countTiles = [&](double s) {
+    double count = 1.;
+    for (int j = 0; j < 3; j++) {
+      count *= std::max(1., std::ceil(extent[j] / s));
+    }
+    return count;
+  };
+
+  // Bisect in log space; lo always gives enough tiles, hi never does
+  double lo = maxExtent / (nTarget + 1);
+  double hi = maxExtent * (1. + 1e-6);
+  for (int iter = 0; iter < 64; iter++) {
+    double mid = std::sqrt(lo * hi);
+    if (countTiles(mid) >= nTarget) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// The points loaded for one tile, including its halo
+struct LoadedTile {
+  size_t iTile;
+  std::vector<size_t> pointIndices;
+  std::vector<Vector3> positions;
+  std::vector<char> isCore;
+};
+
+void processTile(const TileGrid& grid, double halo, unsigned int kNeighborSize, LoadedTile& loaded,
+                 PointCloudTile& out) {
+
+  out.index = loaded.iTile;
+  out.gridIndex = grid.gridIndex(loaded.iTile);
+  for (int j = 0; j < 3; j++) {
+    out.boxMin[j] = grid.origin[j] + out.gridIndex[j] * grid.size;
+    out.boxMax[j] = out.boxMin[j] + grid.size;
+  }
+
+  size_t nLocal = loaded.positions.size();
+  size_t nCore = 0;
+  for (char c : loaded.isCore) nCore += c;
+  out.pointIndices.reserve(nCore);
+  out.positions.reserve(nCore);
+  out.normals.reserve(nCore);
+  out.tangentBasis.reserve(nCore);
+  out.neighborStart.reserve(nCore + 1);
+  out.neighborStart.push_back(0);
+  out.nInexactNeighborhoods = 0;
+
+  // Too few points to fit normals; emit the points with no neighbors
+  size_t k = std::min<size_t>(kNeighborSize, nLocal == 0 ? 0 : nLocal - 1);
+  if (k < 3) {
+    for (size_t i = 0; i < nLocal; i++) {
+      if (!loaded.isCore[i]) continue;
+      out.pointIndices.push_back(loaded.pointIndices[i]);
+      out.positions.push_back(loaded.positions[i]);
+      out.normals.push_back(Vector3::undefined());
+      out.tangentBasis.push_back(std::array<Vector3, 2>{{Vector3::undefined(), Vector3::undefined()}});
+      out.neighborStart.push_back(0);
+      out.nInexactNeighborhoods++;
+    }
+    return;
+  }
+
+  PointCloud cloud(nLocal);
+  PointData<Vector3> positions(cloud);
+  for (size_t i = 0; i < nLocal; i++) {
+    positions[i] = loaded.positions[i];
+  }
+  PointPositionGeometry geom(cloud, positions);
+  geom.kNeighborSize = k;
+  geom.requireNeighbors();
+  geom.requireNormals();
+  geom.requireTangentBasis();
+
+  // A neighborhood is exact if the ball it spans stays within the loaded region. The faces of the grid itself never
+  // cut off any points, so they don't count.
+  auto distToHaloEdge = [&](Vector3 p) {
+    double dist = std::numeric_limits<double>::infinity();
+    for (int j = 0; j < 3; j++) {
+      if (out.gridIndex[j] > 0) dist = std::min(dist, p[j] - out.boxMin[j]);
+      if (out.gridIndex[j] + 1 < grid.dims[j]) dist = std::min(dist, out.boxMax[j] - p[j]);
+    }
+    return dist + halo;
+  };
+
+  for (size_t i = 0; i < nLocal; i++) {
+    if (!loaded.isCore[i]) continue;
+    out.pointIndices.push_back(loaded.pointIndices[i]);
+    out.positions.push_back(loaded.positions[i]);
+    out.normals.push_back(geom.normals[i]);
+    out.tangentBasis.push_back(geom.tangentBasis[i]);
+
+    NeighborList neigh = geom.neighbors->neighbors[i];
+    for (size_t iN = 0; iN < neigh.size(); iN++) {
+      out.neighborIndices.push_back(loaded.pointIndices[neigh.index(iN)]);
+    }
+    out.neighborStart.push_back(out.neighborIndices.size());
+
+    if (neigh.size() > 0 && std::sqrt(neigh.distanceSquared(neigh.size() - 1)) > distToHaloEdge(loaded.positions[i])) {
+      out.nInexactNeighborhoods++;
+    }
+  }
+}
+
+} // namespace
+
+TiledProcessingStats processPointCloudTiled(PointStream& stream, const std::function<void(PointCloudTile&)>& callback,
+                                            TiledProcessingOptions options) {
+
+  TiledProcessingStats stats;
+  std::vector<Vector3> buffer;
+
+  // == Pass 1: bounding box
+  Vector3 bboxMin = Vector3::constant(std::numeric_limits<double>::infinity());
+  Vector3 bboxMax = -bboxMin;
+  stream.rewind();
+  stats.nPasses++;
+  while (stream.read(buffer, options.readChunkSize)) {
+    for (Vector3 p : buffer) {
+      bboxMin = componentwiseMin(bboxMin, p);
+      bboxMax = componentwiseMax(bboxMax, p);
+    }
+    stats.nPoints += buffer.size();
+  }
+  if (stats.nPoints == 0) return stats;
+
+  // == Set up the grid
+  TileGrid grid;
+  grid.origin = bboxMin;
+  Vector3 extent = bboxMax - bboxMin;
+  if (options.tileSize > 0.) {
+    grid.size = options.tileSize;
+  } else {
+    size_t nTarget = (stats.nPoints + options.targetPointsPerTile - 1) / std::max<size_t>(options.targetPointsPerTile, 1);
+    grid.size = chooseTileSize(extent, nTarget);
+  }
+  double nGridTiles = 1.;
+  for (int j = 0; j < 3; j++) {
+    grid.dims[j] = std::max<size_t>(1, static_cast<size_t>(std::ceil(extent[j] / grid.size)));
+    nGridTiles *= grid.dims[j];
+  }
+  if (nGridTiles > static_cast<double>(size_t(1) << 48)) { // (tile indices must not overflow)
+    throw std::runtime_error("tile size is too small for the extent of the point cloud");
+  }
+  double halo = options.haloWidth > 0. ? options.haloWidth : 0.1 * grid.size;
+  stats.tileSize = grid.size;
+  stats.haloWidth = halo;
+
+  // == Pass 2: count the points loaded for each tile
+  // (the grid may be mostly empty, so counts are only stored for the tiles which are actually touched)
+  std::unordered_map<size_t, size_t> coreCount;
+  std::unordered_map<size_t, size_t> loadCount;
+  stream.rewind();
+  stats.nPasses++;
+  while (stream.read(buffer, options.readChunkSize)) {
+    for (Vector3 p : buffer) {
+      coreCount[grid.tileOf(p)]++;
+      grid.forEachTileNear(p, halo, [&](size_t iTile) { loadCount[iTile]++; });
+    }
+  }
+
+  std::vector<size_t> activeTiles;
+  for (const auto& entry : coreCount) {
+    activeTiles.push_back(entry.first);
+    stats.maxTilePoints = std::max(stats.maxTilePoints, loadCount[entry.first]);
+  }
+  std::sort(activeTiles.begin(), activeTiles.end());
+  stats.nTiles = activeTiles.size();
+
+  // == Remaining passes: load as many tiles as fit in memory, process them, and hand them off
+  std::unordered_map<size_t, size_t> waveSlot; // tile --> its index in the current wave
+  size_t iNextTile = 0;
+  while (iNextTile < activeTiles.size()) {
+
+    // Choose the tiles for this pass
+    std::vector<LoadedTile> wave;
+    size_t waveLoad = 0;
+    while (iNextTile < activeTiles.size()) {
+      size_t iTile = activeTiles[iNextTile];
+      size_t nLoad = loadCount[iTile];
+      if (!wave.empty() && waveLoad + nLoad > options.maxPointsInMemory) break;
+      waveSlot[iTile] = wave.size();
+      wave.emplace_back();
+      wave.back().iTile = iTile;
+      wave.back().pointIndices.reserve(nLoad);
+      wave.back().positions.reserve(nLoad);
+      wave.back().isCore.reserve(nLoad);
+      waveLoad += nLoad;
+      iNextTile++;
+    }
+
+    // Load their points
+    stream.rewind();
+    stats.nPasses++;
+    size_t iPoint = 0;
+    while (stream.read(buffer, options.readChunkSize)) {
+      for (Vector3 p : buffer) {
+        size_t iHome = grid.tileOf(p);
+        grid.forEachTileNear(p, halo, [&](size_t iTile) {
+          auto slotIt = waveSlot.find(iTile);
+          if (slotIt == waveSlot.end()) return;
+          LoadedTile& loaded = wave[slotIt->second];
+          loaded.pointIndices.push_back(iPoint);
+          loaded.positions.push_back(p);
+          loaded.isCore.push_back(iTile == iHome);
+        });
+        iPoint++;
+      }
+    }
+
+    // Process them in parallel
+    std::vector<PointCloudTile> results(wave.size());
+    parallelFor(0, wave.size(), [&](size_t iSlot) {
+      processTile(grid, halo, options.kNeighborSize, wave[iSlot], results[iSlot]);
+      wave[iSlot] = LoadedTile(); // free the input as soon as we're done with it
+    });
+
+    waveSlot.clear();
+    for (PointCloudTile& tile : results) {
+      stats.nInexactNeighborhoods += tile.nInexactNeighborhoods;
+      callback(tile);
+    }
+  }
+
+  return stats;
+}
+
+TiledGeometryResult computeGeometryTiled(PointStream& stream, TiledProcessingOptions options) {
+
+  TiledGeometryResult result;
+
+  // Gather with a fixed stride, then compact (tiles may have fewer neighbors than requested)
+  std::vector<size_t> neighborCount;
+  std::vector<size_t> neighborsStrided;
+  size_t stride = options.kNeighborSize;
+
+  auto gather = [&](PointCloudTile& tile) {
+    for (size_t i = 0; i < tile.pointIndices.size(); i++) {
+      size_t iP = tile.pointIndices[i];
+      if (iP >= result.normals.size()) {
+        size_t newSize = std::max(iP + 1, 2 * result.normals.size());
+        result.normals.resize(newSize);
+        result.tangentBasis.resize(newSize);
+        neighborCount.resize(newSize, 0);
+        neighborsStrided.resize(newSize * stride);
+      }
+      result.normals[iP] = tile.normals[i];
+      result.tangentBasis[iP] = tile.tangentBasis[i];
+      size_t nNeigh = tile.neighborStart[i + 1] - tile.neighborStart[i];
+      neighborCount[iP] = nNeigh;
+      std::copy(tile.neighborIndices.begin() + tile.neighborStart[i], tile.neighborIndices.begin() + tile.neighborStart[i + 1],
+                neighborsStrided.begin() + iP * stride);
+    }
+  };
+
+  // Preallocate if the size is known up front
+  size_t sizeHint = stream.size();
+  if (sizeHint != INVALID_IND) {
+    result.normals.resize(sizeHint);
+    result.tangentBasis.resize(sizeHint);
+    neighborCount.resize(sizeHint, 0);
+    neighborsStrided.resize(sizeHint * stride);
+  }
+
+  result.stats = processPointCloudTiled(stream, gather, options);
+
+  size_t N = result.stats.nPoints;
+  result.normals.resize(N);
+  result.tangentBasis.resize(N);
+  result.neighborStart.resize(N + 1);
+  result.neighborStart[0] = 0;
+  for (size_t iP = 0; iP < N; iP++) {
+    result.neighborStart[iP + 1] = result.neighborStart[iP] + neighborCount[iP];
+  }
+  result.neighborIndices.resize(result.neighborStart[N]);
+  parallelFor(
+      0, N,
+      [&](size_t iP) {
+        std::copy(neighborsStrided.begin() + iP * stride, neighborsStrided.begin() + iP * stride + neighborCount[iP],
+                  result.neighborIndices.begin() + result.neighborStart[iP]);
+      },
+      1024);
+
+  return result;
+}
+
+} // namespace pointcloud
+} // namespace geometrycentral
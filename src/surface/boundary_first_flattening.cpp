@@ -1,5 +1,7 @@
 #include "geometrycentral/surface/boundary_first_flattening.h"
 
+#include "geometrycentral/surface/parameterize.h"
+
 namespace geometrycentral {
 namespace surface {
 
@@ -20,6 +22,41 @@ VertexData<Vector2> parameterizeBFFfromExteriorAngles(ManifoldSurfaceMesh& mesh,
   return bff.flattenFromExteriorAngles(exteriorAngles);
 }
 
+std::tuple<VertexData<Vector2>, VertexData<size_t>> parameterizeBFFCharts(ManifoldSurfaceMesh& mesh,
+                                                                          IntrinsicGeometryInterface& geo) {
+
+  SurfaceCharts charts = findCharts(mesh);
+  size_t nCharts = charts.vertices.size();
+
+  std::vector<long long int> chartEuler(nCharts, 0);
+  for (size_t c = 0; c < nCharts; c++) {
+    chartEuler[c] = static_cast<long long int>(charts.vertices[c].size()) + charts.faces[c].size();
+  }
+  for (Edge e : mesh.edges()) {
+    chartEuler[charts.chart[e.halfedge().vertex()]]--;
+  }
+  std::vector<size_t> chartLoops(nCharts, 0);
+  for (BoundaryLoop b : mesh.boundaryLoops()) {
+    chartLoops[charts.chart[b.halfedge().vertex()]]++;
+  }
+  for (size_t c = 0; c < nCharts; c++) {
+    if (chartEuler[c] != 1 || chartLoops[c] != 1) {
+      throw std::runtime_error("Input to BFF must be a topological disk, but chart " + std::to_string(c) + " is not");
+    }
+  }
+
+  // Each chart is flattened on its own mesh, with the input edge lengths
+  geo.requireEdgeLengths();
+  auto flattenChart = [](ManifoldSurfaceMesh& chartMesh, IntrinsicGeometryInterface& chartGeo) {
+    BFF bff(chartMesh, chartGeo);
+    return bff.flatten();
+  };
+  VertexData<Vector2> parm = parameterizeCharts(mesh, charts, geo.edgeLengths, flattenChart);
+  geo.unrequireEdgeLengths();
+
+  return std::make_tuple(parm, charts.chart);
+}
+
 BFF::BFF(ManifoldSurfaceMesh& mesh_, IntrinsicGeometryInterface& geo_) : mesh(mesh_), geo(geo_) {
 
   GC_SAFETY_ASSERT(mesh.eulerCharacteristic() == 2 && mesh.nBoundaryLoops() == 1,
@@ -111,9 +148,53 @@ VertexData<Vector2> BFF::flattenFromBoth(const Vector<double>& uBdy, const Vecto
   Vector<double> boundaryX, boundaryY;
   std::tie(boundaryX, boundaryY) = tuple_cat(computeBoundaryPositions(uBdy, kBdy));
 
-  Vector<double> interiorX = Liisolver->solve(-Lib * boundaryX);
-  Vector<double> interiorY = Liisolver->solve(-Lib * boundaryY);
+  // Extend x and y harmonically with one blocked solve
+  DenseMatrix<double> boundaryXY(nBoundary, 2);
+  boundaryXY.col(0) = boundaryX;
+  boundaryXY.col(1) = boundaryY;
+  DenseMatrix<double> interiorXY = Liisolver->solveMultiple(DenseMatrix<double>(-Lib * boundaryXY));
+
+  return assemble(boundaryX, boundaryY, interiorXY.col(0), interiorXY.col(1));
+}
 
+std::vector<VertexData<Vector2>> BFF::flattenFromScaleFactors(const std::vector<VertexData<double>>& uData) {
+  DenseMatrix<double> uBdys = boundaryValues(uData);
+  return flattenFromBothMultiple(uBdys, dirichletToNeumannMultiple(uBdys));
+}
+
+std::vector<VertexData<Vector2>> BFF::flattenFromExteriorAngles(const std::vector<VertexData<double>>& kData) {
+  DenseMatrix<double> kBdys = boundaryValues(kData);
+  for (Eigen::Index j = 0; j < kBdys.cols(); j++) {
+    GC_SAFETY_ASSERT(abs(kBdys.col(j).sum() - 2 * M_PI) < 1e-3,
+                     "BFF error: target exterior angles must sum to 2 pi, but the input sums to " +
+                         std::to_string(kBdys.col(j).sum()));
+  }
+  return flattenFromBothMultiple(neumannToDirichletMultiple(kBdys), kBdys);
+}
+
+std::vector<VertexData<Vector2>> BFF::flattenFromBothMultiple(const DenseMatrix<double>& uBdys,
+                                                              const DenseMatrix<double>& kBdys) {
+  size_t nFlat = uBdys.cols();
+
+  // Boundary curves are cheap, but all of the harmonic extensions share one blocked solve
+  DenseMatrix<double> boundaryXY(nBoundary, 2 * nFlat);
+  for (size_t j = 0; j < nFlat; j++) {
+    std::array<Vector<double>, 2> bdy = computeBoundaryPositions(uBdys.col(j), kBdys.col(j));
+    boundaryXY.col(2 * j) = bdy[0];
+    boundaryXY.col(2 * j + 1) = bdy[1];
+  }
+  DenseMatrix<double> interiorXY = Liisolver->solveMultiple(DenseMatrix<double>(-Lib * boundaryXY));
+
+  std::vector<VertexData<Vector2>> parms;
+  for (size_t j = 0; j < nFlat; j++) {
+    parms.push_back(assemble(boundaryXY.col(2 * j), boundaryXY.col(2 * j + 1), interiorXY.col(2 * j),
+                             interiorXY.col(2 * j + 1)));
+  }
+  return parms;
+}
+
+VertexData<Vector2> BFF::assemble(const Vector<double>& boundaryX, const Vector<double>& boundaryY,
+                                  const Vector<double>& interiorX, const Vector<double>& interiorY) {
   VertexData<Vector2> parm(mesh);
   for (Vertex v : mesh.vertices()) {
     if (v.isBoundary()) {
@@ -132,6 +213,13 @@ Vector<double> BFF::dirichletToNeumann(const Vector<double>& uBdy) {
   return Omegab - (Lib.transpose() * Liisolver->solve(Omegai - Lib * uBdy)) - Lbb * uBdy;
 }
 
+DenseMatrix<double> BFF::dirichletToNeumannMultiple(const DenseMatrix<double>& uBdys) {
+  DenseMatrix<double> rhs = (-Lib * uBdys).colwise() + Omegai;
+  DenseMatrix<double> kBdys = -(Lib.transpose() * Liisolver->solveMultiple(rhs)) - Lbb * uBdys;
+  kBdys.colwise() += Omegab;
+  return kBdys;
+}
+
 Vector<double> BFF::neumannToDirichlet(const Vector<double>& kBdy) {
   // Convert Neumann data to Dirichlet data by solving the Poisson equation and reading off values
   ensureHaveLSolver();
@@ -144,6 +232,34 @@ Vector<double> BFF::neumannToDirichlet(const Vector<double>& kBdy) {
   return uBdy;
 }
 
+DenseMatrix<double> BFF::neumannToDirichletMultiple(const DenseMatrix<double>& kBdys) {
+  ensureHaveLSolver();
+  size_t nFlat = kBdys.cols();
+  DenseMatrix<double> rhs(nVertices, nFlat);
+  for (size_t j = 0; j < nFlat; j++) {
+    rhs.col(j) = reassembleVector(Ldecomp, Omegai, Vector<double>(Omegab - kBdys.col(j)));
+  }
+  DenseMatrix<double> fullSolutions = -Lsolver->solveMultiple(rhs);
+
+  DenseMatrix<double> uBdys(nBoundary, nFlat);
+  for (size_t j = 0; j < nFlat; j++) {
+    Vector<double> uBdy, ignore;
+    decomposeVector(Ldecomp, Vector<double>(fullSolutions.col(j)), ignore, uBdy);
+    uBdys.col(j) = uBdy.array() - uBdy.mean(); // Ensure that u has mean 0
+  }
+  return uBdys;
+}
+
+DenseMatrix<double> BFF::boundaryValues(const std::vector<VertexData<double>>& data) {
+  DenseMatrix<double> bdy(nBoundary, data.size());
+  for (size_t j = 0; j < data.size(); j++) {
+    Vector<double> values, ignore;
+    decomposeVector(Ldecomp, data[j].toVector(), ignore, values);
+    bdy.col(j) = values;
+  }
+  return bdy;
+}
+
 std::array<Vector<double>, 2> BFF::computeBoundaryPositions(const Vector<double>& uBdy, const Vector<double>& kBdy) {
 
   auto src = [](Edge e) { return e.halfedge().vertex(); };
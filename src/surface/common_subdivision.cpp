@@ -1,5 +1,9 @@
 #include "geometrycentral/surface/common_subdivision.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
+#include <unordered_map>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -392,11 +396,11 @@ void CommonSubdivision::constructMeshData(std::vector<std::vector<size_t>>& face
   // size_t nV, nE, nF;
   // std::tie(nV, nE, nF) = elementCounts();
 
-  // Id of subdivision points in the parents list
-  // TODO: if CommonSubdivisionPoint was hashable, we could just plug it
-  // into the hashmap
-  std::map<CommonSubdivisionPoint*, size_t> subdivisionPointsId;
-  // parents_out.reserve(nE + meshB.nVertices());
+  // Id of subdivision points in the parents list. Pointers are resolved to dense ids once, up front; everything below
+  // works only with ids, which lets the per-edge and per-face work run in parallel.
+  std::unordered_map<const CommonSubdivisionPoint*, size_t> subdivisionPointsId;
+  subdivisionPointsId.reserve(subdivisionPoints.size());
+  parents_out.reserve(subdivisionPoints.size());
 
   for (CommonSubdivisionPoint& p : subdivisionPoints) {
     if (p.intersectionType != CSIntersectionType::EDGE_PARALLEL) {
@@ -404,132 +408,169 @@ void CommonSubdivision::constructMeshData(std::vector<std::vector<size_t>>& face
       parents_out.push_back(&p);
     }
   }
+  auto pointId = [&](const CommonSubdivisionPoint* p) {
+    auto it = subdivisionPointsId.find(p);
+    if (it == subdivisionPointsId.end()) {
+      throw std::runtime_error("edge endpoint is not a common subdivision vertex");
+    }
+    return it->second;
+  };
 
   // Store the vertex id of each crossing along this edge
   // Considers its source vertex as the first crossing and its destination
   // vertex as the final crossing
   EdgeData<std::vector<size_t>> crossingVtxIds(meshB);
-
+  std::vector<Edge> edgesB;
+  edgesB.reserve(meshB.nEdges());
   for (Edge eB : meshB.edges()) {
-    // crossingVtxIds[eB].reserve(intersectionsB(eB) + 2);
-
-    // Source
-    crossingVtxIds[eB].push_back(subdivisionPointsId[pointsAlongB[eB][0]]);
-
-    // Middle points
-    for (size_t iC = 1; iC + 1 < pointsAlongB[eB].size(); ++iC) {
-      if (pointsAlongB[eB][iC]->intersectionType != CSIntersectionType::EDGE_PARALLEL) {
-        crossingVtxIds[eB].push_back(subdivisionPointsId[pointsAlongB[eB][iC]]);
-      }
-      if (pointsAlongB[eB][iC]->intersectionType == CSIntersectionType::VERTEX_VERTEX) {
-        throw std::runtime_error("encountered vertex intersection in the middle of an "
-                                 "edge");
-      }
-    }
-
-    // Dst
-    crossingVtxIds[eB].push_back(subdivisionPointsId[pointsAlongB[eB][pointsAlongB[eB].size() - 1]]);
+    edgesB.push_back(eB);
   }
 
-
-  // faces.reserve(nF);
-  // Loop over faces of mesh B and cut along edges of mesh A which cross
-  // sourceFaceB_out.reserve(nF);
-
-  bool complained = false;
-  for (Face f : meshB.faces()) {
-    Halfedge ij = f.halfedge();
-    Halfedge jk = ij.next();
-    Halfedge ki = jk.next();
-
-    // Get list of crossings along each halfedge
-    std::vector<size_t> pij = crossingVtxIds[ij.edge()];
-    if (ij != ij.edge().halfedge()) std::reverse(std::begin(pij), std::end(pij));
-    std::vector<size_t> pjk = crossingVtxIds[jk.edge()];
-    if (jk != jk.edge().halfedge()) std::reverse(std::begin(pjk), std::end(pjk));
-    std::vector<size_t> pki = crossingVtxIds[ki.edge()];
-    if (ki != ki.edge().halfedge()) std::reverse(std::begin(pki), std::end(pki));
-
-    std::vector<std::vector<size_t>> newFaces = sliceFace(pij, pjk, pki);
-
-    for (const auto& newF : newFaces) {
-      // GC_SAFETY_ASSERT(newF.size() > 2,
-      //                  "No bigons allowed in common subdivision.");
-      if (newF.size() <= 2) {
-        if (!complained) {
-          complained = true;
-          std::cerr << "Error: degree-2 face in common refinement" << std::endl;
+  parallelFor(
+      0, edgesB.size(),
+      [&](size_t iE) {
+        Edge eB = edgesB[iE];
+        const std::vector<CommonSubdivisionPoint*>& points = pointsAlongB[eB];
+        std::vector<size_t>& ids = crossingVtxIds[eB];
+        ids.reserve(points.size());
+
+        // Source
+        ids.push_back(pointId(points[0]));
+
+        // Middle points
+        for (size_t iC = 1; iC + 1 < points.size(); ++iC) {
+          if (points[iC]->intersectionType != CSIntersectionType::EDGE_PARALLEL) {
+            ids.push_back(pointId(points[iC]));
+          }
+          if (points[iC]->intersectionType == CSIntersectionType::VERTEX_VERTEX) {
+            throw std::runtime_error("encountered vertex intersection in the middle of an "
+                                     "edge");
+          }
         }
-        continue;
-      }
 
-      faces_out.push_back(newF);
-      sourceFaceB_out.push_back(f);
-
-      // Reconstruct the source faces on A. This uses a search around the nearby faces, which is not necessarily an
-      // ideal strategy, but should work fine. ONEDAY we might want to to track some extra data about the intersections
-      // to immediately recover this relationship.
-
-      // Pick a point, which we will loop over all the neighbors of to identify the shared face.
-      // Prefer a face/edge point, because they have 1/2 neighbors to test, vs. a vertex which has many.
-      SurfacePoint pSearch;
-      std::vector<SurfacePoint> pOthers;
-      pOthers.resize(newF.size() - 1);
-      for (size_t i = 0; i < newF.size(); i++) {
-        SurfacePoint p = parents_out[newF[i]]->posA;
-        if (i == 0) {
-          pSearch = p;
-        } else {
-          pOthers[i - 1] = p;
-        }
+        // Dst
+        ids.push_back(pointId(points[points.size() - 1]));
+      },
+      64);
 
-        if (pOthers.back().type == SurfacePointType::Edge && pSearch.type == SurfacePointType::Vertex) {
-          std::swap(pOthers.back(), pSearch);
-        }
-        if (pOthers.back().type == SurfacePointType::Face && pSearch.type != SurfacePointType::Face) {
-          std::swap(pOthers.back(), pSearch);
-        }
-      }
 
+  // Loop over faces of mesh B and cut along edges of mesh A which cross. Each face of B is sliced independently into
+  // its own buffers, which are concatenated in order afterwards, so the output is the same as a serial loop.
+  std::vector<Face> facesB;
+  facesB.reserve(meshB.nFaces());
+  for (Face f : meshB.faces()) {
+    facesB.push_back(f);
+  }
+  std::vector<std::vector<std::vector<size_t>>> slicedFaces(facesB.size());
+  std::vector<std::vector<Face>> slicedSourceFacesA(facesB.size());
+  std::vector<char> hadDegenerateFace(facesB.size(), false);
+
+  parallelFor(
+      0, facesB.size(),
+      [&](size_t iF) {
+        Face f = facesB[iF];
+        Halfedge ij = f.halfedge();
+        Halfedge jk = ij.next();
+        Halfedge ki = jk.next();
+
+        // Get list of crossings along each halfedge
+        std::vector<size_t> pij = crossingVtxIds[ij.edge()];
+        if (ij != ij.edge().halfedge()) std::reverse(std::begin(pij), std::end(pij));
+        std::vector<size_t> pjk = crossingVtxIds[jk.edge()];
+        if (jk != jk.edge().halfedge()) std::reverse(std::begin(pjk), std::end(pjk));
+        std::vector<size_t> pki = crossingVtxIds[ki.edge()];
+        if (ki != ki.edge().halfedge()) std::reverse(std::begin(pki), std::end(pki));
+
+        std::vector<std::vector<size_t>> newFaces = sliceFace(pij, pjk, pki);
+
+        for (auto& newF : newFaces) {
+          // GC_SAFETY_ASSERT(newF.size() > 2,
+          //                  "No bigons allowed in common subdivision.");
+          if (newF.size() <= 2) {
+            hadDegenerateFace[iF] = true;
+            continue;
+          }
+
+          // Reconstruct the source faces on A. This uses a search around the nearby faces, which is not necessarily
+          // an ideal strategy, but should work fine. ONEDAY we might want to to track some extra data about the
+          // intersections to immediately recover this relationship.
+
+          // Pick a point, which we will loop over all the neighbors of to identify the shared face.
+          // Prefer a face/edge point, because they have 1/2 neighbors to test, vs. a vertex which has many.
+          SurfacePoint pSearch;
+          std::vector<SurfacePoint> pOthers;
+          pOthers.resize(newF.size() - 1);
+          for (size_t i = 0; i < newF.size(); i++) {
+            SurfacePoint p = parents_out[newF[i]]->posA;
+            if (i == 0) {
+              pSearch = p;
+            } else {
+              pOthers[i - 1] = p;
+            }
+
+            if (pOthers.back().type == SurfacePointType::Edge && pSearch.type == SurfacePointType::Vertex) {
+              std::swap(pOthers.back(), pSearch);
+            }
+            if (pOthers.back().type == SurfacePointType::Face && pSearch.type != SurfacePointType::Face) {
+              std::swap(pOthers.back(), pSearch);
+            }
+          }
 
-      // Search over the neighboring faces to the point, looking for a shared face
-      Face sharedFace;
 
-      // Assemble a list of neighbors to test
-      std::vector<Face> testFaces;
-      switch (pSearch.type) {
-      case SurfacePointType::Vertex:
-        for (Face f : pSearch.vertex.adjacentFaces()) {
-          testFaces.push_back(f);
-        }
-        break;
-      case SurfacePointType::Edge:
-        testFaces.push_back(pSearch.edge.halfedge().face());
-        testFaces.push_back(pSearch.edge.halfedge().twin().face());
-        break;
-      case SurfacePointType::Face:
-        testFaces.push_back(pSearch.face);
-        break;
-      }
+          // Search over the neighboring faces to the point, looking for a shared face
+          Face sharedFace;
 
-      // Test the neibhbors to see if any works
-      for (Face f : testFaces) {
-        bool isGood = true;
-        SurfacePoint testPt(f, Vector3::zero());
-        for (SurfacePoint& pO : pOthers) {
-          if (!checkAdjacent(testPt, pO)) {
-            isGood = false;
+          // Assemble a list of neighbors to test
+          std::vector<Face> testFaces;
+          switch (pSearch.type) {
+          case SurfacePointType::Vertex:
+            for (Face f : pSearch.vertex.adjacentFaces()) {
+              testFaces.push_back(f);
+            }
+            break;
+          case SurfacePointType::Edge:
+            testFaces.push_back(pSearch.edge.halfedge().face());
+            testFaces.push_back(pSearch.edge.halfedge().twin().face());
+            break;
+          case SurfacePointType::Face:
+            testFaces.push_back(pSearch.face);
             break;
           }
+
+          // Test the neibhbors to see if any works
+          for (Face f : testFaces) {
+            bool isGood = true;
+            SurfacePoint testPt(f, Vector3::zero());
+            for (SurfacePoint& pO : pOthers) {
+              if (!checkAdjacent(testPt, pO)) {
+                isGood = false;
+                break;
+              }
+            }
+            if (isGood) {
+              sharedFace = f;
+              break;
+            }
+          }
+
+          GC_SAFETY_ASSERT(sharedFace != Face(), "could not identify source face on mesh A")
+          slicedFaces[iF].push_back(std::move(newF));
+          slicedSourceFacesA[iF].push_back(sharedFace);
         }
-        if (isGood) {
-          sharedFace = f;
-          break;
-        }
-      }
+      },
+      16);
 
-      GC_SAFETY_ASSERT(sharedFace != Face(), "could not identify source face on mesh A")
-      sourceFaceA_out.push_back(sharedFace);
+  // Gather the results
+  bool complained = false;
+  for (size_t iF = 0; iF < facesB.size(); iF++) {
+    if (hadDegenerateFace[iF] && !complained) {
+      complained = true;
+      std::cerr << "Error: degree-2 face in common refinement" << std::endl;
+    }
+    for (size_t iNew = 0; iNew < slicedFaces[iF].size(); iNew++) {
+      faces_out.push_back(std::move(slicedFaces[iF][iNew]));
+      sourceFaceB_out.push_back(facesB[iF]);
+      sourceFaceA_out.push_back(slicedSourceFacesA[iF][iNew]);
     }
   }
 }
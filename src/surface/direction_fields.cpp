@@ -100,6 +100,126 @@ SparseMatrix<std::complex<double>> computeFaceConnectionLaplacian(IntrinsicGeome
   return faceConnectionLaplacian;
 }
 
+// Boundary-aligned fields are fixed to the boundary normal at boundary vertices. Moves the fixed values to the
+// right-hand side, removing the corresponding entries from the energy matrix.
+Vector<std::complex<double>> eliminateVertexBoundary(IntrinsicGeometryInterface& geometry, int nSym,
+                                                     SparseMatrix<std::complex<double>>& energyMatrix,
+                                                     VertexData<std::complex<double>>& boundaryValues) {
+
+  SurfaceMesh& mesh = geometry.mesh;
+
+  geometry.requireVertexIndices();
+  geometry.requireHalfedgeVectorsInVertex();
+
+  // Compute the boundary values
+  boundaryValues = VertexData<std::complex<double>>(mesh);
+  for (Vertex v : mesh.vertices()) {
+    if (v.isBoundary()) {
+
+      // Find incoming and outgoing boundary vectors as tangent
+      Halfedge heBoundaryA = v.halfedge();
+      Halfedge heBoundaryB = heBoundaryA.twin().next();
+
+      Vector2 vecA = geometry.halfedgeVectorsInVertex[heBoundaryA];
+      Vector2 vecB = geometry.halfedgeVectorsInVertex[heBoundaryB];
+
+      Vector2 tangentV = unit(-vecA + vecB);
+      Vector2 normalV = tangentV.rotate90();
+
+      boundaryValues[v] = normalV.pow(nSym);
+    } else {
+      boundaryValues[v] = 0;
+    }
+  }
+
+  // Assemble right-hand side from these boundary values
+  Vector<std::complex<double>> b(mesh.nVertices());
+  b.setZero();
+
+  for (Vertex v : mesh.vertices()) {
+    if (!v.isBoundary()) {
+
+      for (Halfedge he : v.incomingHalfedges()) {
+        if (he.vertex().isBoundary()) {
+
+          size_t i = geometry.vertexIndices[v];
+          size_t j = geometry.vertexIndices[he.vertex()];
+
+          // move boundary terms to the right-hand side and remove the corresponding matrix entries
+          std::complex<double> Aij = energyMatrix.coeff(i, j);
+          energyMatrix.coeffRef(i, j) = 0;
+          std::complex<double> bVal = boundaryValues[he.vertex()];
+          b(i) += -Aij * bVal;
+        }
+      }
+    }
+  }
+
+  return b;
+}
+
+// Like above, for faces along the boundary
+Vector<std::complex<double>> eliminateFaceBoundary(IntrinsicGeometryInterface& geometry, int nSym,
+                                                   SparseMatrix<std::complex<double>>& energyMatrix,
+                                                   FaceData<bool>& isInterior,
+                                                   FaceData<std::complex<double>>& boundaryValues) {
+
+  SurfaceMesh& mesh = geometry.mesh;
+
+  geometry.requireFaceIndices();
+  geometry.requireHalfedgeVectorsInFace();
+
+  // Compute boundary values
+  isInterior = FaceData<bool>(mesh);
+  boundaryValues = FaceData<std::complex<double>>(mesh);
+  for (Face f : mesh.faces()) {
+    bool isBoundary = false;
+    for (Edge e : f.adjacentEdges()) {
+      isBoundary |= e.isBoundary();
+    }
+    isInterior[f] = !isBoundary;
+
+    if (isInterior[f]) {
+      boundaryValues[f] = 0;
+    } else {
+      Vector2 bC = Vector2::zero();
+      for (Halfedge he : f.adjacentHalfedges()) {
+        if (he.edge().isBoundary()) {
+          bC -= geometry.halfedgeVectorsInFace[he].rotate90(); // negate the vector to point outwards
+        }
+      }
+      bC = unit(bC);
+      boundaryValues[f] = bC.pow(nSym);
+    }
+  }
+
+  // Assemble right-hand side from these boundary values
+  Vector<std::complex<double>> b(mesh.nFaces());
+  b.setZero();
+
+  for (Face f : mesh.faces()) {
+    if (isInterior[f]) {
+
+      for (Halfedge he : f.adjacentHalfedges()) {
+        Face neighFace = he.twin().face();
+        if (!isInterior[neighFace]) {
+
+          size_t i = geometry.faceIndices[f];
+          size_t j = geometry.faceIndices[neighFace];
+
+          // move boundary terms to the right-hand side and remove the corresponding matrix entries
+          std::complex<double> Aij = energyMatrix.coeff(i, j);
+          energyMatrix.coeffRef(i, j) = 0;
+          std::complex<double> bVal = boundaryValues[neighFace];
+          b(i) += -Aij * bVal;
+        }
+      }
+    }
+  }
+
+  return b;
+}
+
 } // namespace
 
 VertexData<Vector2> computeSmoothestVertexDirectionField(IntrinsicGeometryInterface& geometry, int nSym) {
@@ -164,7 +284,6 @@ VertexData<Vector2> computeSmoothestBoundaryAlignedVertexDirectionField(Intrinsi
   }
 
   geometry.requireVertexGalerkinMassMatrix();
-  geometry.requireHalfedgeVectorsInVertex();
 
   // Mass matrix
   SparseMatrix<std::complex<double>> massMatrix = geometry.vertexGalerkinMassMatrix.cast<std::complex<double>>();
@@ -172,50 +291,9 @@ VertexData<Vector2> computeSmoothestBoundaryAlignedVertexDirectionField(Intrinsi
   // Energy matrix
   SparseMatrix<std::complex<double>> energyMatrix = computeVertexConnectionLaplacian(geometry, nSym);
 
-  // Compute the boundary values
-  VertexData<std::complex<double>> boundaryValues(mesh);
-  for (Vertex v : mesh.vertices()) {
-    if (v.isBoundary()) {
-
-      // Find incoming and outgoing boundary vectors as tangent
-      Halfedge heBoundaryA = v.halfedge();
-      Halfedge heBoundaryB = heBoundaryA.twin().next();
-
-      Vector2 vecA = geometry.halfedgeVectorsInVertex[heBoundaryA];
-      Vector2 vecB = geometry.halfedgeVectorsInVertex[heBoundaryB];
-
-      Vector2 tangentV = unit(-vecA + vecB);
-      Vector2 normalV = tangentV.rotate90();
-
-      boundaryValues[v] = normalV.pow(nSym);
-    } else {
-      boundaryValues[v] = 0;
-    }
-  }
-
-  // Assemble right-hand side from these boundary values
-  Vector<std::complex<double>> b(mesh.nVertices());
-  b.setZero();
-
-  for (Vertex v : mesh.vertices()) {
-    if (!v.isBoundary()) {
-
-      for (Halfedge he : v.incomingHalfedges()) {
-        Face neighFace = he.twin().face();
-        if (he.vertex().isBoundary()) {
-
-          size_t i = geometry.vertexIndices[v];
-          size_t j = geometry.vertexIndices[he.vertex()];
-
-          // move boundary terms to the right-hand side and remove the corresponding matrix entries
-          std::complex<double> Aij = energyMatrix.coeff(i, j);
-          energyMatrix.coeffRef(i, j) = 0;
-          std::complex<double> bVal = boundaryValues[he.vertex()];
-          b(i) += -Aij * bVal;
-        }
-      }
-    }
-  }
+  // Boundary values, moved to the right-hand side
+  VertexData<std::complex<double>> boundaryValues;
+  Vector<std::complex<double>> b = eliminateVertexBoundary(geometry, nSym, energyMatrix, boundaryValues);
 
   Eigen::SparseMatrix<std::complex<double>, Eigen::ColMajor> LHS = energyMatrix;
   Eigen::VectorXcd RHS = massMatrix * b;
@@ -244,7 +322,6 @@ FaceData<Vector2> computeSmoothestBoundaryAlignedFaceDirectionField(IntrinsicGeo
   }
 
   geometry.requireFaceGalerkinMassMatrix();
-  geometry.requireHalfedgeVectorsInFace();
 
   // Mass matrix
   SparseMatrix<std::complex<double>> massMatrix = geometry.faceGalerkinMassMatrix.cast<std::complex<double>>();
@@ -252,53 +329,10 @@ FaceData<Vector2> computeSmoothestBoundaryAlignedFaceDirectionField(IntrinsicGeo
   // Energy matrix
   SparseMatrix<std::complex<double>> energyMatrix = computeFaceConnectionLaplacian(geometry, nSym);
 
-  // Compute boundary values
-  FaceData<bool> isInterior(mesh);
-  FaceData<std::complex<double>> boundaryValues(mesh);
-  for (Face f : mesh.faces()) {
-    bool isBoundary = false;
-    for (Edge e : f.adjacentEdges()) {
-      isBoundary |= e.isBoundary();
-    }
-    isInterior[f] = !isBoundary;
-
-    if (isInterior[f]) {
-      boundaryValues[f] = 0;
-    } else {
-      Vector2 bC = Vector2::zero();
-      for (Halfedge he : f.adjacentHalfedges()) {
-        if (he.edge().isBoundary()) {
-          bC -= geometry.halfedgeVectorsInFace[he].rotate90(); // negate the vector to point outwards
-        }
-      }
-      bC = unit(bC);
-      boundaryValues[f] = bC.pow(nSym);
-    }
-  }
-
-  // Assemble right-hand side from these boundary values
-  Vector<std::complex<double>> b(mesh.nFaces());
-  b.setZero();
-
-  for (Face f : mesh.faces()) {
-    if (isInterior[f]) {
-
-      for (Halfedge he : f.adjacentHalfedges()) {
-        Face neighFace = he.twin().face();
-        if (!isInterior[neighFace]) {
-
-          size_t i = geometry.faceIndices[f];
-          size_t j = geometry.faceIndices[neighFace];
-
-          // move boundary terms to the right-hand side and remove the corresponding matrix entries
-          std::complex<double> Aij = energyMatrix.coeff(i, j);
-          energyMatrix.coeffRef(i, j) = 0;
-          std::complex<double> bVal = boundaryValues[neighFace];
-          b(i) += -Aij * bVal;
-        }
-      }
-    }
-  }
+  // Boundary values, moved to the right-hand side
+  FaceData<bool> isInterior;
+  FaceData<std::complex<double>> boundaryValues;
+  Vector<std::complex<double>> b = eliminateFaceBoundary(geometry, nSym, energyMatrix, isInterior, boundaryValues);
 
   Eigen::SparseMatrix<std::complex<double>, Eigen::ColMajor> LHS = energyMatrix;
   Eigen::VectorXcd RHS = massMatrix * b;
@@ -502,6 +536,170 @@ VertexData<int> computeVertexIndex(IntrinsicGeometryInterface& geometry, const F
 
   return indices;
 }
+
+DirectionFieldSolver::DirectionFieldSolver(IntrinsicGeometryInterface& geometry_) : geometry(geometry_) {
+  geometry.requireVertexIndices();
+  geometry.requireFaceIndices();
+}
+
+DirectionFieldSolver::~DirectionFieldSolver() {
+  geometry.unrequireVertexIndices();
+  geometry.unrequireFaceIndices();
+  if (vertexMass.size() != 0) geometry.unrequireVertexGalerkinMassMatrix();
+  if (faceMass.size() != 0) geometry.unrequireFaceGalerkinMassMatrix();
+}
+
+DirectionFieldSolver::Operator& DirectionFieldSolver::vertexOperator(int nSym) {
+  std::map<int, Operator>::iterator it = vertexOperators.find(nSym);
+  if (it != vertexOperators.end()) return it->second;
+
+  if (vertexMass.size() == 0) {
+    geometry.requireVertexGalerkinMassMatrix();
+    vertexMass = geometry.vertexGalerkinMassMatrix.cast<std::complex<double>>();
+  }
+  Operator& op = vertexOperators[nSym];
+  op.energy = computeVertexConnectionLaplacian(geometry, nSym);
+  op.solver.reset(new PositiveDefiniteSolver<std::complex<double>>(op.energy));
+  return op;
+}
+
+DirectionFieldSolver::Operator& DirectionFieldSolver::faceOperator(int nSym) {
+  std::map<int, Operator>::iterator it = faceOperators.find(nSym);
+  if (it != faceOperators.end()) return it->second;
+
+  if (faceMass.size() == 0) {
+    geometry.requireFaceGalerkinMassMatrix();
+    faceMass = geometry.faceGalerkinMassMatrix.cast<std::complex<double>>();
+  }
+  Operator& op = faceOperators[nSym];
+  op.energy = computeFaceConnectionLaplacian(geometry, nSym);
+  op.solver.reset(new PositiveDefiniteSolver<std::complex<double>>(op.energy));
+  return op;
+}
+
+DenseMatrix<std::complex<double>> DirectionFieldSolver::solveAligned(Operator& op,
+                                                                     const SparseMatrix<std::complex<double>>& mass,
+                                                                     const DenseMatrix<std::complex<double>>& guidance) {
+  DenseMatrix<std::complex<double>> rhs = mass * guidance;
+  return op.solver->solveMultiple(rhs);
+}
+
+VertexData<Vector2> DirectionFieldSolver::smoothestVertexField(int nSym) {
+  Operator& op = vertexOperator(nSym);
+  Vector<std::complex<double>> solution = smallestEigenvectorSquare(*op.solver, vertexMass);
+
+  VertexData<Vector2> toReturn(geometry.mesh);
+  for (Vertex v : geometry.mesh.vertices()) {
+    toReturn[v] = unit(Vector2::fromComplex(solution(geometry.vertexIndices[v])));
+  }
+  return toReturn;
+}
+
+FaceData<Vector2> DirectionFieldSolver::smoothestFaceField(int nSym) {
+  Operator& op = faceOperator(nSym);
+  Vector<std::complex<double>> solution = smallestEigenvectorSquare(*op.solver, faceMass);
+
+  FaceData<Vector2> toReturn(geometry.mesh);
+  for (Face f : geometry.mesh.faces()) {
+    toReturn[f] = unit(Vector2::fromComplex(solution(geometry.faceIndices[f])));
+  }
+  return toReturn;
+}
+
+// The boundary conditions change the matrix itself, so these do not reuse the factorization, only the assembly
+VertexData<Vector2> DirectionFieldSolver::smoothestBoundaryAlignedVertexField(int nSym) {
+  SurfaceMesh& mesh = geometry.mesh;
+  if (!mesh.hasBoundary()) {
+    throw std::logic_error("tried to compute smoothest boundary aligned direction field on a mesh without boundary");
+  }
+
+  Operator& op = vertexOperator(nSym);
+  SparseMatrix<std::complex<double>> energyMatrix = op.energy;
+  VertexData<std::complex<double>> boundaryValues;
+  Vector<std::complex<double>> b = eliminateVertexBoundary(geometry, nSym, energyMatrix, boundaryValues);
+  Vector<std::complex<double>> RHS = vertexMass * b;
+  Vector<std::complex<double>> solution = solveSquare(energyMatrix, RHS);
+
+  VertexData<Vector2> toReturn(mesh);
+  for (Vertex v : mesh.vertices()) {
+    if (v.isBoundary()) {
+      toReturn[v] = Vector2::fromComplex(boundaryValues[v]);
+    } else {
+      toReturn[v] = unit(Vector2::fromComplex(solution(geometry.vertexIndices[v])));
+    }
+  }
+  return toReturn;
+}
+
+FaceData<Vector2> DirectionFieldSolver::smoothestBoundaryAlignedFaceField(int nSym) {
+  SurfaceMesh& mesh = geometry.mesh;
+  if (!mesh.hasBoundary()) {
+    throw std::logic_error("tried to compute smoothest boundary aligned direction field on a mesh without boundary");
+  }
+
+  Operator& op = faceOperator(nSym);
+  SparseMatrix<std::complex<double>> energyMatrix = op.energy;
+  FaceData<bool> isInterior;
+  FaceData<std::complex<double>> boundaryValues;
+  Vector<std::complex<double>> b = eliminateFaceBoundary(geometry, nSym, energyMatrix, isInterior, boundaryValues);
+  Vector<std::complex<double>> RHS = faceMass * b;
+  Vector<std::complex<double>> solution = solveSquare(energyMatrix, RHS);
+
+  FaceData<Vector2> toReturn(mesh);
+  for (Face f : mesh.faces()) {
+    if (isInterior[f]) {
+      toReturn[f] = unit(Vector2::fromComplex(solution(geometry.faceIndices[f])));
+    } else {
+      toReturn[f] = Vector2::fromComplex(boundaryValues[f]);
+    }
+  }
+  return toReturn;
+}
+
+std::vector<VertexData<Vector2>> DirectionFieldSolver::alignedVertexFields(const std::vector<VertexData<Vector2>>& guidance,
+                                                                           int nSym) {
+  Operator& op = vertexOperator(nSym);
+  SurfaceMesh& mesh = geometry.mesh;
+
+  DenseMatrix<std::complex<double>> guidanceVecs(mesh.nVertices(), guidance.size());
+  for (size_t j = 0; j < guidance.size(); j++) {
+    for (Vertex v : mesh.vertices()) {
+      guidanceVecs(geometry.vertexIndices[v], j) = guidance[j][v];
+    }
+  }
+  DenseMatrix<std::complex<double>> solutions = solveAligned(op, vertexMass, guidanceVecs);
+
+  std::vector<VertexData<Vector2>> fields(guidance.size(), VertexData<Vector2>(mesh));
+  for (size_t j = 0; j < guidance.size(); j++) {
+    for (Vertex v : mesh.vertices()) {
+      fields[j][v] = unit(Vector2::fromComplex(solutions(geometry.vertexIndices[v], j)));
+    }
+  }
+  return fields;
+}
+
+std::vector<FaceData<Vector2>> DirectionFieldSolver::alignedFaceFields(const std::vector<FaceData<Vector2>>& guidance,
+                                                                       int nSym) {
+  Operator& op = faceOperator(nSym);
+  SurfaceMesh& mesh = geometry.mesh;
+
+  DenseMatrix<std::complex<double>> guidanceVecs(mesh.nFaces(), guidance.size());
+  for (size_t j = 0; j < guidance.size(); j++) {
+    for (Face f : mesh.faces()) {
+      guidanceVecs(geometry.faceIndices[f], j) = guidance[j][f];
+    }
+  }
+  DenseMatrix<std::complex<double>> solutions = solveAligned(op, faceMass, guidanceVecs);
+
+  std::vector<FaceData<Vector2>> fields(guidance.size(), FaceData<Vector2>(mesh));
+  for (size_t j = 0; j < guidance.size(); j++) {
+    for (Face f : mesh.faces()) {
+      fields[j][f] = unit(Vector2::fromComplex(solutions(geometry.faceIndices[f], j)));
+    }
+  }
+  return fields;
+}
+
 /*
 VertexData<Vector2> computeSmoothestBoundaryAlignedVertexDirectionField(IntrinsicGeometryInterface& geometry,
                                                                         int nSym) {
@@ -1,6 +1,7 @@
 #include "geometrycentral/surface/flip_geodesics.h"
 
 #include "geometrycentral/surface/mesh_graph_algorithms.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include "happly.h"
 
@@ -1829,5 +1830,45 @@ bool FlipPathSegment::operator<=(const FlipPathSegment& other) const {
   return std::make_tuple(path, id) <= std::make_tuple(other.path, other.id);
 }
 
+std::vector<std::vector<SurfacePoint>> straightenPathsInParallel(ManifoldSurfaceMesh& mesh,
+                                                                 IntrinsicGeometryInterface& geom,
+                                                                 const std::vector<std::vector<Halfedge>>& paths,
+                                                                 size_t maxIterations,
+                                                                 double maxRelativeLengthDecrease) {
+
+  std::vector<std::vector<SurfacePoint>> result(paths.size());
+  if (paths.empty()) return result;
+
+  // Construct one rewindable network per worker. This must happen serially, since it populates quantities on the
+  // shared input geometry; after this point the input geometry is only read.
+  size_t nWorkers = std::min(getNumThreads(), paths.size());
+  std::vector<std::unique_ptr<FlipEdgeNetwork>> workers;
+  for (size_t iW = 0; iW < nWorkers; iW++) {
+    workers.emplace_back(new FlipEdgeNetwork(mesh, geom, {}));
+    workers.back()->supportRewinding = true;
+  }
+
+  parallelForWithThreadIndex(0, paths.size(), nWorkers, [&](size_t iThread, size_t iPath) {
+    const std::vector<Halfedge>& hePath = paths[iPath];
+    if (hePath.empty()) return;
+
+    FlipEdgeNetwork& network = *workers[iThread];
+    network.reinitializePath({hePath});
+
+    // Vertices don't move under flips, so these are still the endpoints after shortening
+    Vertex firstVert = network.mesh.halfedge(hePath.front().getIndex()).vertex();
+    Vertex lastVert = network.mesh.halfedge(hePath.back().getIndex()).twin().vertex();
+
+    network.iterativeShorten(maxIterations, maxRelativeLengthDecrease);
+    result[iPath] = network.getPathPolyline().front();
+
+    // Unmark the endpoints so they don't constrain paths processed later by this worker
+    network.isMarkedVertex[firstVert] = false;
+    network.isMarkedVertex[lastVert] = false;
+  });
+
+  return result;
+}
+
 } // namespace surface
 } // namespace geometrycentral
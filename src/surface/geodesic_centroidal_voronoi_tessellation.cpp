@@ -1,5 +1,9 @@
 #include "geometrycentral/surface/geodesic_centroidal_voronoi_tessellation.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -35,19 +39,7 @@ VoronoiResult computeGeodesicCentroidalVoronoiTessellation(ManifoldSurfaceMesh&
   }
 
   VectorHeatMethodSolver vSolver(geom, options.tCoef);
-
-  auto computeRHS = [&](const std::vector<SurfacePoint>& points) -> VertexData<double> {
-    VertexData<double> rhs(mesh, 0);
-    for (const SurfacePoint& point : points) {
-      SurfacePoint facePoint = point.inSomeFace();
-      Halfedge he = facePoint.face.halfedge();
-
-      rhs[he.vertex()] += facePoint.faceCoords.x;
-      rhs[he.next().vertex()] += facePoint.faceCoords.y;
-      rhs[he.next().next().vertex()] += facePoint.faceCoords.z;
-    }
-    return rhs;
-  };
+  GeodesicTracer tracer(geom);
 
   // Set points to start
   std::vector<SurfacePoint> siteLocations = options.initialSites;
@@ -61,64 +53,72 @@ VoronoiResult computeGeodesicCentroidalVoronoiTessellation(ManifoldSurfaceMesh&
     }
   }
   size_t nSites = siteLocations.size();
+  size_t N = mesh.nVertices();
 
+  geom.requireVertexIndices();
   geom.requireVertexDualAreas();
+  Vector<double> dualAreas(N);
+  for (Vertex v : mesh.vertices()) {
+    dualAreas[geom.vertexIndices[v]] = geom.vertexDualAreas[v];
+  }
+
+  // The soft indicator of each site's cell is its diffused indicator divided by the sum of all of them, which is just
+  // a scalar extension of the values (0, ..., 1, ..., 0) from all of the sites.
+  auto computeDistributions = [&](const std::vector<SurfacePoint>& sites, size_t first, size_t count) {
+    DenseMatrix<double> values = DenseMatrix<double>::Zero(sites.size(), count);
+    for (size_t b = 0; b < count; b++) {
+      values(first + b, b) = 1.;
+    }
+    return vSolver.extendScalarBatch(sites, values);
+  };
 
   // == Iterations
+  // Sites are processed in blocks, so only a block's worth of distributions and log maps are stored at once.
+  size_t blockSize = std::max<size_t>(1, vSolver.batchBlockSize);
   for (size_t iIter = 0; iIter < options.iterations; iIter++) {
 
-    // Compute the normalizer distribution
-    VertexData<double> normRHS = computeRHS(siteLocations);
-    VertexData<double> normD = vSolver.scalarDiffuse(normRHS);
+    std::vector<SurfacePoint> newSiteLocations = siteLocations;
+    std::vector<double> siteEnergy(nSites, 0.);
 
-    double energy = 0;
-    std::vector<SurfacePoint> newSiteLocations;
+    for (size_t blockStart = 0; blockStart < nSites; blockStart += blockSize) {
+      size_t B = std::min(blockSize, nSites - blockStart);
 
-    for (size_t iSite = 0; iSite < nSites; iSite++) {
-      SurfacePoint site = siteLocations[iSite];
-
-      // === Compute the nearest distribution
-      VertexData<double> unitRHS = computeRHS({site});
-      VertexData<double> thisFracD = vSolver.scalarDiffuse(unitRHS);
-      for (Vertex v : mesh.vertices()) {
-        thisFracD[v] /= normD[v];
-      }
+      // === Compute the nearest distribution, weighted by area
+      DenseMatrix<double> weights = computeDistributions(siteLocations, blockStart, B);
+      weights.array().colwise() *= dualAreas.array();
 
+      std::vector<SurfacePoint> blockSites(newSiteLocations.begin() + blockStart,
+                                           newSiteLocations.begin() + blockStart + B);
+      std::vector<Vector2> steps(B);
       for (size_t iSubIter = 0; iSubIter < options.nSubIterations; iSubIter++) {
 
-        // === Compute the log map
-        VertexData<Vector2> logmap = vSolver.computeLogMap(site);
+        // === Compute the log maps
+        DenseMatrix<std::complex<double>> logmaps = vSolver.computeLogMapBatch(blockSites);
 
         // Evaluate energy and gradient contribution
-        Vector2 updateSum{0, 0};
-        double updateWSum = 0.0;
-
-        for (Vertex v : mesh.vertices()) {
-
-          double weight = thisFracD[v] * geom.vertexDualAreas[v];
-          Vector2 logVal = logmap[v];
-          double dist = logVal.norm();
-
-          updateSum += weight * logVal;
-          updateWSum += weight;
-
-          energy += dist * dist * weight;
-        }
-        updateSum /= updateWSum;
-        Vector2 update = updateSum / updateWSum;
+        parallelFor(0, B, [&](size_t b) {
+          double updateWSum = weights.col(b).sum();
+          std::complex<double> updateSum = (logmaps.col(b).array() * weights.col(b).array()).sum();
+          siteEnergy[blockStart + b] += (logmaps.col(b).array().abs2() * weights.col(b).array()).sum();
+          steps[b] = options.stepSize * Vector2::fromComplex(updateSum / updateWSum);
+        });
 
         // Take a step
-        TraceGeodesicResult traceResult = traceGeodesic(geom, site, options.stepSize * update);
-        site = traceResult.endPoint;
+        blockSites = tracer.traceBatch(blockSites, steps).endPoints;
       }
 
-      newSiteLocations.push_back(site);
+      std::copy(blockSites.begin(), blockSites.end(), newSiteLocations.begin() + blockStart);
     }
 
     siteLocations = newSiteLocations;
-    if (VORONOI_PRINT) std::cout << "Finished iteration " << iIter << "  energy " << energy << std::endl;
+    if (VORONOI_PRINT) {
+      double energy = 0.;
+      for (double e : siteEnergy) energy += e;
+      std::cout << "Finished iteration " << iIter << "  energy " << energy << std::endl;
+    }
   }
 
+  geom.unrequireVertexIndices();
   geom.unrequireVertexDualAreas();
 
   VoronoiResult result;
@@ -127,19 +127,17 @@ VoronoiResult computeGeodesicCentroidalVoronoiTessellation(ManifoldSurfaceMesh&
   if (options.computeDistributions) {
     result.hasDistributions = true;
 
-    // Compute the normalizer distribution
-    VertexData<double> normRHS = computeRHS(siteLocations);
-    VertexData<double> normD = vSolver.scalarDiffuse(normRHS);
-
-    for (size_t iSite = 0; iSite < nSites; iSite++) {
-      SurfacePoint site = siteLocations[iSite];
-
-      // === Compute the nearest distribution
-      VertexData<double> unitRHS = computeRHS({site});
-      VertexData<double> thisFracD = vSolver.scalarDiffuse(unitRHS);
-      for (Vertex v : mesh.vertices()) thisFracD[v] /= normD[v];
-      result.siteDistributions.push_back(thisFracD);
+    geom.requireVertexIndices();
+    for (size_t blockStart = 0; blockStart < nSites; blockStart += blockSize) {
+      size_t B = std::min(blockSize, nSites - blockStart);
+      DenseMatrix<double> distributions = computeDistributions(siteLocations, blockStart, B);
+      for (size_t b = 0; b < B; b++) {
+        VertexData<double> thisFracD(mesh);
+        for (Vertex v : mesh.vertices()) thisFracD[v] = distributions(geom.vertexIndices[v], b);
+        result.siteDistributions.push_back(thisFracD);
+      }
     }
+    geom.unrequireVertexIndices();
   }
 
   return result;
@@ -3,6 +3,7 @@
 #include "geometrycentral/surface/intrinsic_mollification.h"
 #include "geometrycentral/surface/simple_idt.h"
 #include "geometrycentral/surface/tufted_laplacian.h"
+#include "geometrycentral/utilities/parallel.h"
 
 
 namespace geometrycentral {
@@ -14,11 +15,22 @@ VertexData<double> heatMethodDistance(IntrinsicGeometryInterface& geom, Vertex v
 
 HeatMethodDistanceSolver::HeatMethodDistanceSolver(IntrinsicGeometryInterface& geom_, double tCoef_,
                                                    bool useRobustLaplacian_)
-    : tCoef(tCoef_), useRobustLaplacian(useRobustLaplacian_), mesh(geom_.mesh), geom(geom_) {
+    : tCoef(tCoef_), useRobustLaplacian(useRobustLaplacian_), mesh(&geom_.mesh), geom(&geom_) {
+  buildOperators();
+}
+
+bool HeatMethodDistanceSolver::updateGeometry(IntrinsicGeometryInterface& newGeom) {
+  GC_SAFETY_ASSERT(newGeom.mesh.nVertices() == mesh->nVertices(), "updated geometry must have the same vertices");
+  mesh = &newGeom.mesh;
+  geom = &newGeom;
+  return buildOperators();
+}
+
+bool HeatMethodDistanceSolver::buildOperators() {
 
   // === Build & factor the linear systems
   if (useRobustLaplacian) {
-    geom.requireEdgeLengths();
+    geom->requireEdgeLengths();
 
     // Build operators using robust Laplacian (see [Sharp & Crane. A Laplacian for Nonmanifold Triangle Meshes. SGP
     // 2020]) NOTE: we build explicitly here rather than just calling buildTuftedLaplacian() in order to use an
@@ -26,17 +38,19 @@ HeatMethodDistanceSolver::HeatMethodDistanceSolver(IntrinsicGeometryInterface& g
 
     // Create a copy of the mesh / geometry to operate on, and build the mollified (tufted if nonmanifold) cover
     EdgeData<double> tuftedEdgeLengths;
-    if (mesh.usesImplicitTwin()) {
-      tuftedMesh = mesh.copy();
-      tuftedEdgeLengths = geom.edgeLengths.reinterpretTo(*tuftedMesh);
+    tuftedIntrinsicGeom.reset();
+    if (mesh->usesImplicitTwin()) {
+      tuftedMesh = mesh->copy();
+      tuftedEdgeLengths = geom->edgeLengths.reinterpretTo(*tuftedMesh);
     } else {
-      tuftedMesh = mesh.copyToSurfaceMesh();
-      tuftedEdgeLengths = geom.edgeLengths.reinterpretTo(*tuftedMesh);
+      tuftedMesh = mesh->copyToSurfaceMesh();
+      tuftedEdgeLengths = geom->edgeLengths.reinterpretTo(*tuftedMesh);
       buildIntrinsicTuftedCover(*tuftedMesh, tuftedEdgeLengths);
     }
     mollifyIntrinsic(*tuftedMesh, tuftedEdgeLengths, 1e-5);
     size_t nFlips = flipToDelaunay(*tuftedMesh, tuftedEdgeLengths);
     tuftedIntrinsicGeom.reset(new EdgeLengthGeometry(*tuftedMesh, tuftedEdgeLengths));
+    geom->unrequireEdgeLengths();
   }
 
   // Compute mean edge length and set shortTime
@@ -59,23 +73,33 @@ HeatMethodDistanceSolver::HeatMethodDistanceSolver(IntrinsicGeometryInterface& g
 
   // Heat operator
   SparseMatrix<double> heatOp = M + shortTime * L;
-  heatSolver.reset(new PositiveDefiniteSolver<double>(heatOp));
 
   // Poisson solver
   // NOTE: In theory, it should not be necessary to shift the Laplacian: cotan-Laplace is always PSD. However, when the
   // matrix is only positive SEMIdefinite, some solvers may not work (ie Eigen's Cholesky solver doesn't work, but
   // Suitesparse does).
-  SparseMatrix<double> Ls = L + 1e-6 * identityMatrix<double>(mesh.nVertices());
-  poissonSolver.reset(new PositiveDefiniteSolver<double>(Ls));
+  SparseMatrix<double> Ls = L + 1e-6 * identityMatrix<double>(mesh->nVertices());
+
+  // Refactor existing solvers, reusing their symbolic analysis if possible. Evaluate both, even if the first fails.
+  bool reusedAll = false;
+  if (heatSolver != nullptr) {
+    reusedAll = heatSolver->refactor(heatOp);
+    reusedAll = poissonSolver->refactor(Ls) && reusedAll;
+  } else {
+    heatSolver.reset(new PositiveDefiniteSolver<double>(heatOp));
+    poissonSolver.reset(new PositiveDefiniteSolver<double>(Ls));
+  }
 
   getGeom().unrequireEdgeLengths();
   getGeom().unrequireCotanLaplacian();
   getGeom().unrequireVertexLumpedMassMatrix();
+
+  return reusedAll;
 }
 
-SurfaceMesh& HeatMethodDistanceSolver::getMesh() { return useRobustLaplacian ? *tuftedMesh : mesh; }
+SurfaceMesh& HeatMethodDistanceSolver::getMesh() { return useRobustLaplacian ? *tuftedMesh : *mesh; }
 IntrinsicGeometryInterface& HeatMethodDistanceSolver::getGeom() {
-  return useRobustLaplacian ? *tuftedIntrinsicGeom : geom;
+  return useRobustLaplacian ? *tuftedIntrinsicGeom : *geom;
 }
 
 VertexData<double> HeatMethodDistanceSolver::computeDistance(const Vertex& sourceVert) {
@@ -103,11 +127,11 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
   getGeom().requireEdgeLengths();
   getGeom().requireVertexIndices();
   getGeom().requireVertexDualAreas();
-  geom.requireEdgeLengths();
-  geom.requireVertexIndices();
+  geom->requireEdgeLengths();
+  geom->requireVertexIndices();
 
   // === Build RHS
-  VertexData<double> rhs(mesh, 0.);
+  VertexData<double> rhs(*mesh, 0.);
   for (const SurfacePoint& p : sourcePoints) {
     SurfacePoint faceP = p.inSomeFace();
 
@@ -141,8 +165,8 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
     SurfacePoint faceP = p.inSomeFace();
 
     Halfedge he0 = faceP.face.halfedge();
-    std::array<double, 3> edgeLengths{geom.edgeLengths[he0.edge()], geom.edgeLengths[he0.next().edge()],
-                                      geom.edgeLengths[he0.next().next().edge()]};
+    std::array<double, 3> edgeLengths{geom->edgeLengths[he0.edge()], geom->edgeLengths[he0.next().edge()],
+                                      geom->edgeLengths[he0.next().next().edge()]};
 
 
     int i = 0;
@@ -152,7 +176,7 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
       targetP[i] = 1.;
 
       double expectedDistAtVert = baryDist(faceP.faceCoords, targetP, edgeLengths);
-      double actDistAtVert = distVec[geom.vertexIndices[he.vertex()]];
+      double actDistAtVert = distVec[geom->vertexIndices[he.vertex()]];
 
       double w = faceP.faceCoords[i];
       distDiffAtSource += (actDistAtVert - expectedDistAtVert) * w;
@@ -171,13 +195,18 @@ VertexData<double> HeatMethodDistanceSolver::computeDistance(const std::vector<S
   getGeom().unrequireEdgeLengths();
   getGeom().unrequireVertexIndices();
   getGeom().unrequireVertexDualAreas();
-  geom.unrequireEdgeLengths();
-  geom.unrequireVertexIndices();
+  geom->unrequireEdgeLengths();
+  geom->unrequireVertexIndices();
 
-  return VertexData<double>(mesh, distVec);
+  return VertexData<double>(*mesh, distVec);
 }
 
 Vector<double> HeatMethodDistanceSolver::computeDistanceRHS(const Vector<double>& rhsVec) {
+  DenseMatrix<double> rhs = rhsVec;
+  return computeDistanceRHSMultiple(rhs).col(0);
+}
+
+DenseMatrix<double> HeatMethodDistanceSolver::computeDistanceRHSMultiple(const DenseMatrix<double>& rhs) {
   getGeom().requireHalfedgeCotanWeights();
   getGeom().requireHalfedgeVectorsInFace();
   getGeom().requireEdgeLengths();
@@ -185,29 +214,34 @@ Vector<double> HeatMethodDistanceSolver::computeDistanceRHS(const Vector<double>
   getGeom().requireVertexDualAreas();
 
   // === Solve heat
-  Vector<double> heatVec = heatSolver->solve(rhsVec);
+  DenseMatrix<double> heat = heatSolver->solveMultiple(rhs);
 
   // === Normalize in each face and evaluate divergence
-  Vector<double> divergenceVec = Vector<double>::Zero(mesh.nVertices());
-  for (Face f : getMesh().faces()) {
-
-    Vector2 gradUDir = Vector2::zero(); // warning, wrong magnitude because we don't care
-    for (Halfedge he : f.adjacentHalfedges()) {
-      Vector2 ePerp = getGeom().halfedgeVectorsInFace[he.next()].rotate90();
-      gradUDir += ePerp * heatVec(getGeom().vertexIndices[he.vertex()]);
-    }
-
-    gradUDir = gradUDir.normalizeCutoff();
-
-    for (Halfedge he : f.adjacentHalfedges()) {
-      double val = getGeom().halfedgeCotanWeights[he] * dot(getGeom().halfedgeVectorsInFace[he], gradUDir);
-      divergenceVec[getGeom().vertexIndices[he.tailVertex()]] += val;
-      divergenceVec[getGeom().vertexIndices[he.tipVertex()]] += -val;
+  // (columns are independent, so they are processed in parallel)
+  DenseMatrix<double> divergence = DenseMatrix<double>::Zero(mesh->nVertices(), rhs.cols());
+  parallelFor(0, static_cast<size_t>(rhs.cols()), [&](size_t iCol) {
+    auto heatVec = heat.col(iCol);
+    auto divergenceVec = divergence.col(iCol);
+    for (Face f : getMesh().faces()) {
+
+      Vector2 gradUDir = Vector2::zero(); // warning, wrong magnitude because we don't care
+      for (Halfedge he : f.adjacentHalfedges()) {
+        Vector2 ePerp = getGeom().halfedgeVectorsInFace[he.next()].rotate90();
+        gradUDir += ePerp * heatVec(getGeom().vertexIndices[he.vertex()]);
+      }
+
+      gradUDir = gradUDir.normalizeCutoff();
+
+      for (Halfedge he : f.adjacentHalfedges()) {
+        double val = getGeom().halfedgeCotanWeights[he] * dot(getGeom().halfedgeVectorsInFace[he], gradUDir);
+        divergenceVec(getGeom().vertexIndices[he.tailVertex()]) += val;
+        divergenceVec(getGeom().vertexIndices[he.tipVertex()]) += -val;
+      }
     }
-  }
+  });
 
   // === Integrate divergence to get distance
-  Vector<double> distVec = poissonSolver->solve(divergenceVec);
+  DenseMatrix<double> dist = poissonSolver->solveMultiple(divergence);
 
   getGeom().unrequireHalfedgeVectorsInFace();
   getGeom().unrequireHalfedgeCotanWeights();
@@ -215,7 +249,7 @@ Vector<double> HeatMethodDistanceSolver::computeDistanceRHS(const Vector<double>
   getGeom().unrequireVertexIndices();
   getGeom().unrequireVertexDualAreas();
 
-  return distVec;
+  return dist;
 }
 
 
@@ -1,5 +1,7 @@
 #include "geometrycentral/surface/intrinsic_geometry_interface.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
 //#include "geometrycentral/surface/discrete_operators.h"
 
 #include <fstream>
@@ -234,24 +236,34 @@ void IntrinsicGeometryInterface::computeEdgeCotanWeights() {
 
   edgeCotanWeights = EdgeData<double>(mesh, 0.);
 
+  // Each edge only writes its own weight, so edges are processed in parallel
+  std::vector<Edge> edges;
+  edges.reserve(mesh.nEdges());
   for (Edge e : mesh.edges()) {
-    // WARNING: Logic duplicated between cached and immediate version
-    double cotSum = 0.;
-    for (Halfedge he : e.adjacentInteriorHalfedges()) {
-      Halfedge heFirst = he;
-      double l_ij = edgeLengths[he.edge()];
-      he = he.next();
-      double l_jk = edgeLengths[he.edge()];
-      he = he.next();
-      double l_ki = edgeLengths[he.edge()];
-      he = he.next();
-      GC_SAFETY_ASSERT(he == heFirst, "faces mush be triangular");
-      double area = faceAreas[he.face()];
-      double cotValue = (-l_ij * l_ij + l_jk * l_jk + l_ki * l_ki) / (4. * area);
-      cotSum += cotValue / 2;
-    }
-    edgeCotanWeights[e] = cotSum;
+    edges.push_back(e);
   }
+  parallelFor(
+      0, edges.size(),
+      [&](size_t iE) {
+        Edge e = edges[iE];
+        // WARNING: Logic duplicated between cached and immediate version
+        double cotSum = 0.;
+        for (Halfedge he : e.adjacentInteriorHalfedges()) {
+          Halfedge heFirst = he;
+          double l_ij = edgeLengths[he.edge()];
+          he = he.next();
+          double l_jk = edgeLengths[he.edge()];
+          he = he.next();
+          double l_ki = edgeLengths[he.edge()];
+          he = he.next();
+          GC_SAFETY_ASSERT(he == heFirst, "faces mush be triangular");
+          double area = faceAreas[he.face()];
+          double cotValue = (-l_ij * l_ij + l_jk * l_jk + l_ki * l_ki) / (4. * area);
+          cotSum += cotValue / 2;
+        }
+        edgeCotanWeights[e] = cotSum;
+      },
+      256);
 }
 void IntrinsicGeometryInterface::requireEdgeCotanWeights() { edgeCotanWeightsQ.require(); }
 void IntrinsicGeometryInterface::unrequireEdgeCotanWeights() { edgeCotanWeightsQ.unrequire(); }
@@ -422,23 +434,33 @@ void IntrinsicGeometryInterface::computeCotanLaplacian() {
   edgeCotanWeightsQ.ensureHave();
 
   cotanLaplacian = Eigen::SparseMatrix<double>(mesh.nVertices(), mesh.nVertices());
-  std::vector<Eigen::Triplet<double>> tripletList;
 
+  // Each edge writes its four entries in to a preallocated slot, so edges are processed in parallel
+  std::vector<Edge> edges;
+  edges.reserve(mesh.nEdges());
   for (Edge e : mesh.edges()) {
-    Halfedge he = e.halfedge();
-    Vertex vTail = he.vertex();
-    Vertex vHead = he.next().vertex();
-
-    size_t iVHead = vertexIndices[vHead];
-    size_t iVTail = vertexIndices[vTail];
-
-    double weight = edgeCotanWeights[e];
-
-    tripletList.emplace_back(iVTail, iVTail, weight);
-    tripletList.emplace_back(iVHead, iVHead, weight);
-    tripletList.emplace_back(iVTail, iVHead, -weight);
-    tripletList.emplace_back(iVHead, iVTail, -weight);
+    edges.push_back(e);
   }
+  std::vector<Eigen::Triplet<double>> tripletList(4 * edges.size());
+  parallelFor(
+      0, edges.size(),
+      [&](size_t iE) {
+        Edge e = edges[iE];
+        Halfedge he = e.halfedge();
+        Vertex vTail = he.vertex();
+        Vertex vHead = he.next().vertex();
+
+        size_t iVHead = vertexIndices[vHead];
+        size_t iVTail = vertexIndices[vTail];
+
+        double weight = edgeCotanWeights[e];
+
+        tripletList[4 * iE + 0] = Eigen::Triplet<double>(iVTail, iVTail, weight);
+        tripletList[4 * iE + 1] = Eigen::Triplet<double>(iVHead, iVHead, weight);
+        tripletList[4 * iE + 2] = Eigen::Triplet<double>(iVTail, iVHead, -weight);
+        tripletList[4 * iE + 3] = Eigen::Triplet<double>(iVHead, iVTail, -weight);
+      },
+      256);
 
   cotanLaplacian.setFromTriplets(tripletList.begin(), tripletList.end());
 }
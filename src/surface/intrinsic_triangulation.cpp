@@ -4,7 +4,11 @@
 #include "geometrycentral/surface/mesh_graph_algorithms.h"
 #include "geometrycentral/surface/trace_geodesic.h"
 #include "geometrycentral/utilities/elementary_geometry.h"
+#include "geometrycentral/utilities/indexed_heap.h"
+#include "geometrycentral/utilities/parallel.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <queue>
 
@@ -367,8 +371,69 @@ void IntrinsicTriangulation::flipToDelaunay() {
   refreshQuantities();
 }
 
-void IntrinsicTriangulation::delaunayRefine(double angleThreshDegrees, double circumradiusThresh,
-                                            size_t maxInsertions) {
+void IntrinsicTriangulation::flipToDelaunayParallel() {
+
+  // Edges which might be non-Delaunay, deduplicated by stamping each edge with the round it was last queued in
+  std::vector<Edge> candidates;
+  EdgeData<size_t> queuedRound(mesh, 0);
+  for (Edge e : mesh.edges()) {
+    candidates.push_back(e);
+  }
+
+  std::vector<char> needsFlip;
+  std::vector<Edge> nextCandidates;
+  FaceData<size_t> claimedRound(mesh, 0);
+
+  size_t iRound = 0;
+  while (!candidates.empty()) {
+    iRound++;
+
+    // Test the Delaunay condition on all candidates concurrently (this only reads edge lengths)
+    needsFlip.assign(candidates.size(), false);
+    parallelFor(
+        0, candidates.size(), [&](size_t i) { needsFlip[i] = !isDelaunay(candidates[i]); }, 256);
+
+    // Flip a batch of non-Delaunay edges which share no triangles, so every test above is still valid when its flip
+    // is applied. The flips themselves are serial, since they update the correspondence data of the particular
+    // intrinsic triangulation. Conflicting edges are deferred to the next round.
+    nextCandidates.clear();
+    auto enqueue = [&](Edge e) {
+      if (queuedRound[e] != iRound) {
+        nextCandidates.push_back(e);
+        queuedRound[e] = iRound;
+      }
+    };
+    for (size_t i = 0; i < candidates.size(); i++) {
+      if (!needsFlip[i]) continue;
+      Edge e = candidates[i];
+      Face fA = e.halfedge().face();
+      Face fB = e.halfedge().twin().face();
+      if (claimedRound[fA] == iRound || claimedRound[fB] == iRound) {
+        enqueue(e);
+        continue;
+      }
+      claimedRound[fA] = iRound;
+      claimedRound[fB] = iRound;
+
+      if (!flipEdgeIfNotDelaunay(e)) continue;
+
+      // Add neighbors to queue, as they may need flipping now
+      Halfedge he = e.halfedge();
+      Halfedge heN = he.next();
+      Halfedge heTN = he.twin().next();
+      for (Edge nE : {heN.edge(), heN.next().edge(), heTN.edge(), heTN.next().edge()}) {
+        enqueue(nE);
+      }
+    }
+
+    std::swap(candidates, nextCandidates);
+  }
+
+  refreshQuantities();
+}
+
+DelaunayRefineStats IntrinsicTriangulation::delaunayRefine(double angleThreshDegrees, double circumradiusThresh,
+                                                          size_t maxInsertions) {
 
   // Relationship between angles and circumradius-to-edge
   double angleThreshRad = angleThreshDegrees * M_PI / 180.;
@@ -449,19 +514,21 @@ void IntrinsicTriangulation::delaunayRefine(double angleThreshDegrees, double ci
   };
 
   // Call the general version
-  delaunayRefine(needsCircumcenterRefinement, maxInsertions);
+  return delaunayRefine(needsCircumcenterRefinement, maxInsertions);
 }
 
 
-void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& shouldRefine, size_t maxInsertions) {
+DelaunayRefineStats IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& shouldRefine,
+                                                          size_t maxInsertions) {
+
+  auto startTime = std::chrono::steady_clock::now();
 
   // Manages a check at the bottom to avoid infinite-looping when numerical baddness happens
   int recheckCount = 0;
   const int MAX_RECHECK_COUNT = 5;
 
   // Track statistics
-  size_t nFlips = 0;
-  size_t nInsertions = 0;
+  DelaunayRefineStats stats;
 
   // Initialize queue of (possibly) non-delaunay edges
   std::deque<Edge> delaunayCheckQueue;
@@ -470,6 +537,12 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     delaunayCheckQueue.push_back(e);
     inDelaunayQueue[e] = true;
   }
+  auto enqueueEdge = [&](Edge e) {
+    if (!inDelaunayQueue[e]) {
+      delaunayCheckQueue.push_back(e);
+      inDelaunayQueue[e] = true;
+    }
+  };
 
 
   // Return a weight to use for sorting PQ. Usually sorts by biggest area, but also puts faces on boundary first with
@@ -481,42 +554,40 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     return faceArea(f);
   };
 
-  // Initialize queue of (possibly) circumradius-violating faces, processing the largest faces first (good heuristic)
-  typedef std::tuple<double, double, Face> AreaFace;
-  std::priority_queue<AreaFace, std::vector<AreaFace>, std::less<AreaFace>> circumradiusCheckQueue;
-  for (Face f : mesh.faces()) {
+  // Queue of circumradius-violating faces, processing the largest faces first (good heuristic). The heap is indexed by
+  // face, so whenever a face changes its entry is updated in place (or removed) rather than leaving a stale copy
+  // behind. Face indices are stable here, since the mesh is never compressed during refinement.
+  IndexedHeap<std::pair<double, double>> circumradiusCheckQueue;
+  auto updateFaceInQueue = [&](Face f) {
     if (shouldRefine(f)) {
-      circumradiusCheckQueue.push(std::make_tuple(areaWeight(f), faceArea(f), f));
+      circumradiusCheckQueue.push(f.getIndex(), std::make_pair(areaWeight(f), faceArea(f)));
+    } else {
+      circumradiusCheckQueue.remove(f.getIndex());
     }
+  };
+  for (Face f : mesh.faces()) {
+    updateFaceInQueue(f);
   }
 
   // Register a callback which checks the neighbors of an edge for further processing after a flip. It's useful to use a
   // callback, rather than just checking in the loop, because other internal subroutines might perform flips. In
   // particular, removeInsertedVertex() currently performs flips internally, which might trigger updates.
   auto checkNeighborsAfterFlip = [&](Edge e) {
-    // std::cout << "  flipped edge " << e << std::endl;
-    nFlips++;
+    stats.nFlips++;
 
-    // Add neighboring faces, which might violate circumradius constraint
-    std::vector<Face> neighFaces = {e.halfedge().face(), e.halfedge().twin().face()};
-    for (Face nF : neighFaces) {
-      if (shouldRefine(nF)) {
-        circumradiusCheckQueue.push(std::make_tuple(areaWeight(nF), faceArea(nF), nF));
-      }
-    }
+    // The two faces of a flipped edge are reused, so their queue entries must be refreshed
+    updateFaceInQueue(e.halfedge().face());
+    updateFaceInQueue(e.halfedge().twin().face());
 
     // Add neighbors to queue, as they may need flipping now
     Halfedge he = e.halfedge();
     Halfedge heN = he.next();
     Halfedge heT = he.twin();
     Halfedge heTN = heT.next();
-    std::vector<Edge> neighEdges = {heN.edge(), heN.next().edge(), heTN.edge(), heTN.next().edge()};
-    for (Edge nE : neighEdges) {
-      if (!inDelaunayQueue[nE]) {
-        delaunayCheckQueue.push_back(nE);
-        inDelaunayQueue[nE] = true;
-      }
-    }
+    enqueueEdge(heN.edge());
+    enqueueEdge(heN.next().edge());
+    enqueueEdge(heTN.edge());
+    enqueueEdge(heTN.next().edge());
   };
   auto flipCallbackHandle = edgeFlipCallbackList.insert(std::end(edgeFlipCallbackList), checkNeighborsAfterFlip);
 
@@ -540,6 +611,52 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     }
   };
 
+  // Scratch storage for the local Dijkstra searches below. Distances live in a dense array which grows with the mesh,
+  // and only the entries touched by a search are reset afterwards, so each search costs time and memory proportional
+  // to the size of the ball rather than the mesh (and nothing is allocated once the buffers are warm).
+  VertexData<double> searchDist(mesh, std::numeric_limits<double>::infinity());
+  VertexData<char> searchDone(mesh, false);
+  std::vector<Vertex> searchTouched;
+  std::vector<Vertex> searchResult;
+  using WeightedVertex = std::tuple<double, Vertex>;
+  std::vector<WeightedVertex> searchHeap;
+  auto verticesWithinDijkstraRadius = [&](Vertex source, double ballRad) {
+    searchResult.clear();
+    auto cmp = std::greater<WeightedVertex>();
+    searchHeap.clear();
+    searchHeap.emplace_back(0., source);
+    searchDist[source] = 0.;
+    searchTouched.push_back(source);
+
+    while (!searchHeap.empty()) {
+      std::pop_heap(searchHeap.begin(), searchHeap.end(), cmp);
+      double currDist = std::get<0>(searchHeap.back());
+      Vertex currVert = std::get<1>(searchHeap.back());
+      searchHeap.pop_back();
+
+      if (searchDone[currVert]) continue; // skips stale entries
+      searchDone[currVert] = true;
+      searchResult.push_back(currVert);
+
+      for (Edge e : currVert.adjacentEdges()) {
+        Vertex targetVert = e.otherVertex(currVert);
+        double targetDist = currDist + edgeLengths[e];
+        if (targetDist <= ballRad && targetDist < searchDist[targetVert]) {
+          if (searchDist[targetVert] == std::numeric_limits<double>::infinity()) searchTouched.push_back(targetVert);
+          searchDist[targetVert] = targetDist;
+          searchHeap.emplace_back(targetDist, targetVert);
+          std::push_heap(searchHeap.begin(), searchHeap.end(), cmp);
+        }
+      }
+    }
+
+    for (Vertex v : searchTouched) {
+      searchDist[v] = std::numeric_limits<double>::infinity();
+      searchDone[v] = false;
+    }
+    searchTouched.clear();
+  };
+
   // Register a callback, which will be invoked to delete previously-inserted vertices whenever refinment splits an edge
   auto deleteNearbyVertices = [&](Edge e, Halfedge he1, Halfedge he2) {
     // radius of the diametral ball
@@ -557,28 +674,25 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     // Intrinsic Triangulations Course, the underlying reference is Ge Xia 2013. "The Stretch Factor of the Delaunay
     // Triangulation Is Less than 1.998"). So instead, we delete all previously-inserted vertices within 2x the Dikstra
     // radius instead. This may delete some extra verts, but that does not effect convergence.
-    std::unordered_map<Vertex, double> nearbyVerts = vertexDijkstraDistanceWithinRadius(*this, newV, 2. * ballRad);
+    verticesWithinDijkstraRadius(newV, 2. * ballRad);
 
-    // remove inserted vertices
-    for (auto p : nearbyVerts) {
-      Vertex v = p.first;
+    // remove inserted vertices (copy the list, since removal may trigger further splits via callbacks)
+    std::vector<Vertex> nearbyVerts = searchResult;
+    for (Vertex v : nearbyVerts) {
+      if (v.isDead()) continue;
       if (v != newV && !isOnFixedEdge(v) && vertexLocations[v].type != SurfacePointType::Vertex) {
         Face fReplace = removeInsertedVertex(v);
 
         if (fReplace != Face()) {
+          stats.nRemovals++;
 
           // Add adjacent edges for Delaunay check
           for (Edge nE : fReplace.adjacentEdges()) {
-            if (!inDelaunayQueue[nE]) {
-              delaunayCheckQueue.push_back(nE);
-              inDelaunayQueue[nE] = true;
-            }
+            enqueueEdge(nE);
           }
 
           // Add face for refine check
-          if (shouldRefine(fReplace)) {
-            circumradiusCheckQueue.push(std::make_tuple(areaWeight(fReplace), faceArea(fReplace), fReplace));
-          }
+          updateFaceInQueue(fReplace);
         }
       }
     }
@@ -597,7 +711,7 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     // == Second, insert one circumcenter
 
     // If we've already inserted the max number of points, call it a day
-    if (maxInsertions != INVALID_IND && nInsertions == maxInsertions) {
+    if (maxInsertions != INVALID_IND && stats.nInsertions >= maxInsertions) {
       break;
     }
 
@@ -605,38 +719,24 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
     if (!circumradiusCheckQueue.empty()) {
 
       // Get the biggest face
-      Face f = std::get<2>(circumradiusCheckQueue.top());
-      double A = std::get<1>(circumradiusCheckQueue.top());
-      circumradiusCheckQueue.pop();
+      Face f = mesh.face(circumradiusCheckQueue.pop());
       if (f.isDead()) continue;
 
-      // Two things might have changed that would cause us to skip this entry:
-      //   -If the area has changed since this face was inserted in to the queue, skip it. Note that we don't need to
-      //    re-add it, because it must have been placed in the queue when its area was changed
-      //   - This face might have been flipped to no longer violate constraint
-      if (A == faceArea(f) && shouldRefine(f)) {
+      // This face might have been flipped to no longer violate constraint
+      if (shouldRefine(f)) {
 
         Vertex newVert = insertCircumcenter(f);
         if (newVert == Vertex()) {
           // vertex insertion failed (probably due to a tracing error)
           continue;
         }
-        nInsertions++;
+        stats.nInsertions++;
 
         // Mark everything in the 1-ring as possibly non-Delaunay and possibly violating the circumradius constraint
         for (Face nF : newVert.adjacentFaces()) {
-
-          // Check circumradius constraint
-          if (shouldRefine(nF)) {
-            circumradiusCheckQueue.push(std::make_tuple(areaWeight(nF), faceArea(nF), nF));
-          }
-
-          // Check delaunay constraint
+          updateFaceInQueue(nF);
           for (Edge nE : nF.adjacentEdges()) {
-            if (!inDelaunayQueue[nE]) {
-              delaunayCheckQueue.push_back(nE);
-              inDelaunayQueue[nE] = true;
-            }
+            enqueueEdge(nE);
           }
         }
       }
@@ -653,14 +753,13 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
       if (delaunayCheckQueue.empty() && circumradiusCheckQueue.empty()) {
         for (Face f : mesh.faces()) {
           if (shouldRefine(f)) {
-            circumradiusCheckQueue.push(std::make_tuple(areaWeight(f), faceArea(f), f));
+            updateFaceInQueue(f);
             anyFound = true;
           }
         }
         for (Edge e : mesh.edges()) {
           if (!isDelaunay(e)) {
-            delaunayCheckQueue.push_back(e);
-            inDelaunayQueue[e] = true;
+            enqueueEdge(e);
             anyFound = true;
           }
         }
@@ -678,6 +777,17 @@ void IntrinsicTriangulation::delaunayRefine(const std::function<bool(Face)>& sho
   refreshQuantities();
   edgeSplitCallbackList.erase(splitCallbackHandle);
   edgeFlipCallbackList.erase(flipCallbackHandle);
+
+  stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  return stats;
+}
+
+double DelaunayRefineStats::flipsPerSecond() const {
+  return elapsedSeconds > 0. ? nFlips / elapsedSeconds : 0.;
+}
+
+double DelaunayRefineStats::insertionsPerSecond() const {
+  return elapsedSeconds > 0. ? nInsertions / elapsedSeconds : 0.;
 }
 
 
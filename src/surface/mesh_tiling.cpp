@@ -0,0 +1,190 @@
+#include "geometrycentral/surface/mesh_tiling.h"
+
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace geometrycentral {
+namespace surface {
+
+MeshTiling::MeshTiling(ManifoldSurfaceMesh& mesh_, MeshTilingOptions options_)
+    : mesh(mesh_), options(options_), faceTile(mesh_, INVALID_IND) {
+
+  // Grow each tile breadth-first across edges from the first unassigned face. The tile's own face list doubles as the
+  // queue.
+  size_t target = std::max<size_t>(1, options.targetFacesPerTile);
+  for (Face seed : mesh.faces()) {
+    if (faceTile[seed] != INVALID_IND) continue;
+
+    size_t iTile = tileFaces.size();
+    tileFaces.emplace_back();
+    std::vector<Face>& faces = tileFaces.back();
+    faceTile[seed] = iTile;
+    faces.push_back(seed);
+
+    for (size_t iQ = 0; iQ < faces.size() && faces.size() < target; iQ++) {
+      for (Halfedge he : faces[iQ].adjacentHalfedges()) {
+        if (faces.size() >= target) break;
+        if (!he.twin().isInterior()) continue;
+        Face neigh = he.twin().face();
+        if (faceTile[neigh] != INVALID_IND) continue;
+        faceTile[neigh] = iTile;
+        faces.push_back(neigh);
+      }
+    }
+  }
+
+  assignOwners();
+}
+
+MeshTiling::MeshTiling(ManifoldSurfaceMesh& mesh_, const FaceData<size_t>& faceTile_, MeshTilingOptions options_)
+    : mesh(mesh_), options(options_), faceTile(faceTile_) {
+
+  for (Face f : mesh.faces()) {
+    size_t iTile = faceTile[f];
+    if (iTile == INVALID_IND) throw std::runtime_error("every face must be assigned to a tile");
+    if (iTile >= tileFaces.size()) tileFaces.resize(iTile + 1);
+    tileFaces[iTile].push_back(f);
+  }
+
+  assignOwners();
+}
+
+void MeshTiling::assignOwners() {
+  if (options.haloRings < 1) {
+    throw std::runtime_error("tiles need a halo of at least one ring");
+  }
+
+  edgeTile = EdgeData<size_t>(mesh, INVALID_IND);
+  for (Edge e : mesh.edges()) {
+    for (Halfedge he : e.adjacentHalfedges()) {
+      if (he.isInterior()) edgeTile[e] = std::min(edgeTile[e], faceTile[he.face()]);
+    }
+  }
+
+  vertexTile = VertexData<size_t>(mesh, INVALID_IND);
+  for (Vertex v : mesh.vertices()) {
+    for (Face f : v.adjacentFaces()) {
+      vertexTile[v] = std::min(vertexTile[v], faceTile[f]);
+    }
+  }
+}
+
+MeshTile MeshTiling::extractTile(size_t iTile, VertexPositionGeometry& geom) const {
+  if (iTile >= nTiles()) throw std::runtime_error("tile index out of range");
+
+  // == Gather the tile's faces, then the halo one ring at a time
+  std::vector<Face> faces = tileFaces[iTile];
+  std::unordered_set<size_t> inTile;
+  for (Face f : faces) inTile.insert(f.getIndex());
+
+  size_t ringStart = 0;
+  for (size_t iRing = 0; iRing < options.haloRings; iRing++) {
+    size_t ringEnd = faces.size();
+    for (size_t iF = ringStart; iF < ringEnd; iF++) {
+      for (Vertex v : faces[iF].adjacentVertices()) {
+        for (Face neigh : v.adjacentFaces()) {
+          if (inTile.insert(neigh.getIndex()).second) faces.push_back(neigh);
+        }
+      }
+    }
+    ringStart = ringEnd;
+  }
+
+  // == Local vertices
+  // Faces of the tile around a vertex may form several separate fans; each gets its own local vertex, so the tile
+  // is cut apart there rather than pinched. Local vertices are identified by the outgoing halfedges of their fans.
+  auto isInTile = [&](Halfedge he) { return he.isInterior() && inTile.count(he.face().getIndex()) > 0; };
+  std::unordered_map<size_t, size_t> heLocalVertex;
+  std::vector<size_t> parentVerts;
+  std::vector<Halfedge> ring;
+  for (Face f : faces) {
+    for (Halfedge he : f.adjacentHalfedges()) {
+      if (heLocalVertex.count(he.getIndex())) continue;
+
+      // Walk around the vertex, starting just after a gap if there is one
+      ring.clear();
+      for (Halfedge heOut : he.vertex().outgoingHalfedges()) ring.push_back(heOut);
+      size_t start = 0;
+      for (size_t i = 0; i < ring.size(); i++) {
+        if (!isInTile(ring[i])) {
+          start = i;
+          break;
+        }
+      }
+      size_t currLocal = INVALID_IND;
+      for (size_t k = 0; k < ring.size(); k++) {
+        Halfedge heOut = ring[(start + k) % ring.size()];
+        if (!isInTile(heOut)) {
+          currLocal = INVALID_IND;
+          continue;
+        }
+        if (currLocal == INVALID_IND) {
+          currLocal = parentVerts.size();
+          parentVerts.push_back(he.vertex().getIndex());
+        }
+        heLocalVertex[heOut.getIndex()] = currLocal;
+      }
+    }
+  }
+
+  // == Build the tile
+  std::vector<std::vector<size_t>> polygons(faces.size());
+  for (size_t iF = 0; iF < faces.size(); iF++) {
+    for (Halfedge he : faces[iF].adjacentHalfedges()) {
+      polygons[iF].push_back(heLocalVertex[he.getIndex()]);
+    }
+  }
+
+  MeshTile tile;
+  tile.index = iTile;
+  tile.mesh.reset(new ManifoldSurfaceMesh(polygons));
+  ManifoldSurfaceMesh& tileMesh = *tile.mesh;
+
+  tile.parentVertex = VertexData<size_t>(tileMesh);
+  tile.ownsVertex = VertexData<char>(tileMesh);
+  VertexData<Vector3> positions(tileMesh);
+  for (Vertex v : tileMesh.vertices()) {
+    Vertex parent = mesh.vertex(parentVerts[v.getIndex()]);
+    tile.parentVertex[v] = parent.getIndex();
+    tile.ownsVertex[v] = vertexTile[parent] == iTile;
+    positions[v] = geom.vertexPositions[parent];
+  }
+  tile.geometry.reset(new VertexPositionGeometry(tileMesh, positions));
+
+  tile.parentFace = FaceData<size_t>(tileMesh);
+  tile.ownsFace = FaceData<char>(tileMesh);
+  tile.parentEdge = EdgeData<size_t>(tileMesh);
+  tile.ownsEdge = EdgeData<char>(tileMesh);
+  for (Face f : tileMesh.faces()) {
+    Face parent = faces[f.getIndex()];
+    tile.parentFace[f] = parent.getIndex();
+    tile.ownsFace[f] = faceTile[parent] == iTile;
+
+    // Match edges by their tail vertex, which appears once in each face
+    for (Halfedge he : f.adjacentHalfedges()) {
+      size_t parentTail = tile.parentVertex[he.vertex()];
+      for (Halfedge parentHe : parent.adjacentHalfedges()) {
+        if (parentHe.vertex().getIndex() != parentTail) continue;
+        tile.parentEdge[he.edge()] = parentHe.edge().getIndex();
+        tile.ownsEdge[he.edge()] = edgeTile[parentHe.edge()] == iTile;
+        break;
+      }
+    }
+  }
+
+  return tile;
+}
+
+void MeshTiling::forEachTile(VertexPositionGeometry& geom, const std::function<void(MeshTile&)>& f) const {
+  parallelFor(0, nTiles(), [&](size_t iTile) {
+    MeshTile tile = extractTile(iTile, geom);
+    f(tile);
+  });
+}
+
+} // namespace surface
+} // namespace geometrycentral
@@ -2,8 +2,11 @@
 
 #include "geometrycentral/numerical/linear_solvers.h"
 #include "geometrycentral/surface/edge_length_geometry.h"
+#include "geometrycentral/surface/surgery.h"
 #include "geometrycentral/surface/uniformize.h"
+#include "geometrycentral/utilities/disjoint_sets.h"
 #include "geometrycentral/utilities/elementary_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include <algorithm>
 #include <queue>
@@ -120,5 +123,108 @@ VertexData<Vector2> parameterizeDisk(ManifoldSurfaceMesh& origMesh, IntrinsicGeo
   return coords.reinterpretTo(origMesh);
 }
 
+CornerData<Vector2> parameterize(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geometry,
+                                 const EdgeData<char>& cut) {
+
+  // Cut the mesh, and carry the edge lengths over. Edges of the cut mesh have an interior halfedge, which comes from
+  // the input mesh.
+  std::unique_ptr<ManifoldSurfaceMesh> cutMeshPtr;
+  HalfedgeData<Halfedge> parentHe;
+  bool anyCut = false;
+  for (Edge e : mesh.edges()) anyCut = anyCut || cut[e];
+  if (anyCut) {
+    std::tie(cutMeshPtr, parentHe) = cutAlongEdges(mesh, cut);
+  } else {
+    cutMeshPtr = mesh.copy();
+    parentHe = HalfedgeData<Halfedge>(*cutMeshPtr);
+    for (Halfedge he : cutMeshPtr->halfedges()) parentHe[he] = mesh.halfedge(he.getIndex());
+  }
+  ManifoldSurfaceMesh& cutMesh = *cutMeshPtr;
+  geometry.requireEdgeLengths();
+  EdgeData<double> cutLengths(cutMesh);
+  for (Edge e : cutMesh.edges()) {
+    cutLengths[e] = geometry.edgeLengths[parentHe[e.halfedge()].edge()];
+  }
+  geometry.unrequireEdgeLengths();
+
+  // Each chart is parameterized on its own mesh
+  VertexData<Vector2> cutCoords = parameterizeCharts(cutMesh, findCharts(cutMesh), cutLengths, parameterizeDisk);
+
+  CornerData<Vector2> coords(mesh);
+  for (Halfedge he : cutMesh.interiorHalfedges()) {
+    coords[parentHe[he].corner()] = cutCoords[he.vertex()];
+  }
+  return coords;
+}
+
+SurfaceCharts findCharts(ManifoldSurfaceMesh& mesh) {
+  VertexData<size_t> vInd = mesh.getVertexIndices();
+  DisjointSets components(mesh.nVertices());
+  for (Edge e : mesh.edges()) {
+    components.merge(vInd[e.halfedge().tailVertex()], vInd[e.halfedge().tipVertex()]);
+  }
+
+  SurfaceCharts charts;
+  charts.chart = VertexData<size_t>(mesh);
+  std::vector<size_t> rootChart(mesh.nVertices(), INVALID_IND);
+  for (Vertex v : mesh.vertices()) {
+    size_t& c = rootChart[components.find(vInd[v])];
+    if (c == INVALID_IND) {
+      c = charts.vertices.size();
+      charts.vertices.emplace_back();
+    }
+    charts.chart[v] = c;
+    charts.vertices[c].push_back(v);
+  }
+  charts.faces.resize(charts.vertices.size());
+  for (Face f : mesh.faces()) {
+    charts.faces[charts.chart[f.halfedge().vertex()]].push_back(f);
+  }
+  return charts;
+}
+
+VertexData<Vector2> parameterizeCharts(
+    ManifoldSurfaceMesh& mesh, const SurfaceCharts& charts, const EdgeData<double>& edgeLengths,
+    const std::function<VertexData<Vector2>(ManifoldSurfaceMesh&, IntrinsicGeometryInterface&)>& parameterizeChart) {
+
+  VertexData<size_t> vInd = mesh.getVertexIndices();
+  std::vector<size_t> localInd(mesh.nVertices());
+  for (const std::vector<Vertex>& chartVertices : charts.vertices) {
+    for (size_t i = 0; i < chartVertices.size(); i++) {
+      localInd[vInd[chartVertices[i]]] = i;
+    }
+  }
+
+  VertexData<Vector2> coords(mesh);
+  parallelFor(0, charts.vertices.size(), [&](size_t c) {
+    std::vector<std::vector<size_t>> polygons;
+    for (Face f : charts.faces[c]) {
+      std::vector<size_t> poly;
+      for (Vertex v : f.adjacentVertices()) {
+        poly.push_back(localInd[vInd[v]]);
+      }
+      polygons.push_back(poly);
+    }
+    ManifoldSurfaceMesh chartMesh(polygons);
+
+    // Faces and their halfedges are in the same order as in the input
+    EdgeData<double> chartLengths(chartMesh);
+    for (size_t iF = 0; iF < charts.faces[c].size(); iF++) {
+      Halfedge he = charts.faces[c][iF].halfedge();
+      for (Halfedge chartHe : chartMesh.face(iF).adjacentHalfedges()) {
+        chartLengths[chartHe.edge()] = edgeLengths[he.edge()];
+        he = he.next();
+      }
+    }
+    EdgeLengthGeometry chartGeom(chartMesh, chartLengths);
+
+    VertexData<Vector2> chartCoords = parameterizeChart(chartMesh, chartGeom);
+    for (size_t i = 0; i < charts.vertices[c].size(); i++) {
+      coords[charts.vertices[c][i]] = chartCoords[i];
+    }
+  });
+  return coords;
+}
+
 } // namespace surface
 } // namespace geometrycentral
@@ -0,0 +1,641 @@
+#include "geometrycentral/surface/progressive_mesh.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace geometrycentral {
+namespace surface {
+
+namespace {
+
+// Binary format:
+//   base:   "GCPM" | uint32 version | uint32 nVertexAttributes | uint32 nCornerAttributes | uint64 nVertices |
+//           uint64 nFaces | positions | vertex values | faces (uint32 x 3) | corner values
+//   splits: uint64 count | count x record (see writeSplits())
+const char gcpmMagic[4] = {'G', 'C', 'P', 'M'};
+const uint32_t gcpmVersion = 1;
+
+bool hostIsLittleEndian() {
+  uint16_t one = 1;
+  char byte;
+  std::memcpy(&byte, &one, 1);
+  return byte == 1;
+}
+
+template <typename T>
+void writeLE(std::ostream& out, T val) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &val, sizeof(T));
+  if (!hostIsLittleEndian()) std::reverse(bytes, bytes + sizeof(T));
+  out.write(bytes, sizeof(T));
+}
+
+template <typename T>
+T readLE(std::istream& in) {
+  char bytes[sizeof(T)];
+  in.read(bytes, sizeof(T));
+  if (!in) throw std::runtime_error("progressive mesh stream ended unexpectedly");
+  if (!hostIsLittleEndian()) std::reverse(bytes, bytes + sizeof(T));
+  T val;
+  std::memcpy(&val, bytes, sizeof(T));
+  return val;
+}
+
+void writeIndex(std::ostream& out, size_t i) {
+  if (i > std::numeric_limits<uint32_t>::max()) throw std::runtime_error("progressive mesh is too large to write");
+  writeLE<uint32_t>(out, static_cast<uint32_t>(i));
+}
+size_t readIndex(std::istream& in) { return readLE<uint32_t>(in); }
+
+void writeVector3(std::ostream& out, Vector3 v) {
+  writeLE<double>(out, v.x);
+  writeLE<double>(out, v.y);
+  writeLE<double>(out, v.z);
+}
+Vector3 readVector3(std::istream& in) {
+  Vector3 v;
+  v.x = readLE<double>(in);
+  v.y = readLE<double>(in);
+  v.z = readLE<double>(in);
+  return v;
+}
+
+void writeIndexList(std::ostream& out, const std::vector<size_t>& inds) {
+  writeIndex(out, inds.size());
+  for (size_t i : inds) writeIndex(out, i);
+}
+void readIndexList(std::istream& in, std::vector<size_t>& inds) {
+  inds.resize(readIndex(in));
+  for (size_t& i : inds) i = readIndex(in);
+}
+
+void writeValues(std::ostream& out, const std::vector<double>& vals) {
+  for (double v : vals) writeLE<double>(out, v);
+}
+void readValues(std::istream& in, std::vector<double>& vals, size_t count) {
+  vals.resize(count);
+  for (double& v : vals) v = readLE<double>(in);
+}
+
+VertexPositionGeometry& requireGeometry(MutationManager& mm) {
+  if (mm.geometry == nullptr) throw std::runtime_error("recording a progressive mesh requires a geometry");
+  return *mm.geometry;
+}
+
+} // namespace
+
+// ======================================================
+// ======== ProgressiveMesh
+// ======================================================
+
+ProgressiveMesh::ProgressiveMesh(size_t nVertexAttributes, size_t nCornerAttributes)
+    : nVertexAttributes_(nVertexAttributes), nCornerAttributes_(nCornerAttributes) {}
+
+void ProgressiveMesh::setBase(const std::vector<Vector3>& positions, const std::vector<double>& vertexValues,
+                              const std::vector<std::array<size_t, 3>>& faces,
+                              const std::vector<double>& cornerValues) {
+  if (vertexValues.size() != positions.size() * nVertexAttributes_ ||
+      cornerValues.size() != 3 * faces.size() * nCornerAttributes_) {
+    throw std::runtime_error("wrong number of attribute values for the base mesh");
+  }
+  for (const std::array<size_t, 3>& face : faces) {
+    for (size_t v : face) {
+      if (v >= positions.size()) throw std::runtime_error("base mesh face has an out of range vertex");
+    }
+  }
+
+  basePositions = positions;
+  baseVertexValues = vertexValues;
+  baseFaces = faces;
+  baseCornerValues = cornerValues;
+  splits.clear();
+  splitFirstFace.clear();
+
+  currentLevel = 0;
+  nActiveFaces = faces.size();
+  currentPositions = positions;
+  currentVertexValues = vertexValues;
+  currentFaces = faces;
+  currentCornerValues = cornerValues;
+}
+
+void ProgressiveMesh::appendSplit(const VertexSplitRecord& record) {
+  size_t nVertsBefore = nBaseVertices() + splits.size();
+  size_t nFacesBefore = currentFaces.size();
+  size_t nVA = nVertexAttributes_;
+  size_t nCA = nCornerAttributes_;
+
+  // Validate, so that replay never indexes out of range
+  if (record.splitVertex >= nVertsBefore) throw std::runtime_error("vertex split record has an invalid vertex");
+  if (record.newFaces.empty() || record.newFaces.size() > 2) {
+    throw std::runtime_error("vertex split record must introduce 1 or 2 faces");
+  }
+  for (const std::array<size_t, 3>& face : record.newFaces) {
+    for (size_t v : face) {
+      if (v > nVertsBefore) throw std::runtime_error("vertex split record has a face with an invalid vertex");
+    }
+  }
+  for (size_t c : record.movedCorners) {
+    if (c >= 3 * nFacesBefore) throw std::runtime_error("vertex split record has an invalid corner");
+  }
+  if (record.vertexValues.size() != 3 * nVA) {
+    throw std::runtime_error("vertex split record has the wrong number of vertex values");
+  }
+  size_t nFacesAfter = nFacesBefore + record.newFaces.size();
+  for (size_t c : record.fineCorners) {
+    if (c >= 3 * nFacesAfter) throw std::runtime_error("vertex split record has an invalid corner");
+  }
+  for (size_t c : record.coarseCorners) {
+    if (c >= 3 * nFacesBefore) throw std::runtime_error("vertex split record has an invalid corner");
+  }
+  if (record.fineValues.size() != record.fineCorners.size() * nCA ||
+      record.coarseValues.size() != record.coarseCorners.size() * nCA) {
+    throw std::runtime_error("vertex split record has the wrong number of corner values");
+  }
+
+  splitFirstFace.push_back(nFacesBefore);
+  splits.push_back(record);
+
+  // Space for the new elements, which become active when the split is applied
+  currentPositions.push_back(record.newVertexPosition);
+  currentVertexValues.resize(currentVertexValues.size() + nVA, 0.);
+  currentFaces.insert(currentFaces.end(), record.newFaces.begin(), record.newFaces.end());
+  currentCornerValues.resize(3 * currentFaces.size() * nCA, 0.);
+}
+
+void ProgressiveMesh::applySplit(size_t i) {
+  const VertexSplitRecord& r = splits[i];
+  size_t vs = r.splitVertex;
+  size_t vt = nBaseVertices() + i;
+  size_t nVA = nVertexAttributes_;
+  size_t nCA = nCornerAttributes_;
+
+  currentPositions[vs] = r.splitVertexPosition;
+  currentPositions[vt] = r.newVertexPosition;
+  for (size_t k = 0; k < nVA; k++) {
+    currentVertexValues[vs * nVA + k] = r.vertexValues[k];
+    currentVertexValues[vt * nVA + k] = r.vertexValues[nVA + k];
+  }
+
+  for (size_t c : r.movedCorners) {
+    currentFaces[c / 3][c % 3] = vt;
+  }
+  nActiveFaces = splitFirstFace[i] + r.newFaces.size();
+
+  for (size_t iC = 0; iC < r.fineCorners.size(); iC++) {
+    for (size_t k = 0; k < nCA; k++) {
+      currentCornerValues[r.fineCorners[iC] * nCA + k] = r.fineValues[iC * nCA + k];
+    }
+  }
+}
+
+void ProgressiveMesh::undoSplit(size_t i) {
+  const VertexSplitRecord& r = splits[i];
+  size_t vs = r.splitVertex;
+  size_t nVA = nVertexAttributes_;
+  size_t nCA = nCornerAttributes_;
+
+  currentPositions[vs] = r.collapsedVertexPosition;
+  for (size_t k = 0; k < nVA; k++) {
+    currentVertexValues[vs * nVA + k] = r.vertexValues[2 * nVA + k];
+  }
+
+  for (size_t c : r.movedCorners) {
+    currentFaces[c / 3][c % 3] = vs;
+  }
+  nActiveFaces = splitFirstFace[i];
+
+  for (size_t iC = 0; iC < r.coarseCorners.size(); iC++) {
+    for (size_t k = 0; k < nCA; k++) {
+      currentCornerValues[r.coarseCorners[iC] * nCA + k] = r.coarseValues[iC * nCA + k];
+    }
+  }
+}
+
+void ProgressiveMesh::setLevel(size_t newLevel) {
+  newLevel = std::min(newLevel, nSplits());
+  while (currentLevel < newLevel) {
+    applySplit(currentLevel);
+    currentLevel++;
+  }
+  while (currentLevel > newLevel) {
+    currentLevel--;
+    undoSplit(currentLevel);
+  }
+}
+
+void ProgressiveMesh::setVertexCount(size_t nVerts) {
+  setLevel(nVerts < nBaseVertices() ? 0 : nVerts - nBaseVertices());
+}
+
+bool ProgressiveMesh::refine() {
+  if (currentLevel == nSplits()) return false;
+  setLevel(currentLevel + 1);
+  return true;
+}
+
+bool ProgressiveMesh::coarsen() {
+  if (currentLevel == 0) return false;
+  setLevel(currentLevel - 1);
+  return true;
+}
+
+std::tuple<std::unique_ptr<ManifoldSurfaceMesh>, std::unique_ptr<VertexPositionGeometry>>
+ProgressiveMesh::extractMesh() const {
+  std::vector<std::vector<size_t>> polygons(nActiveFaces);
+  for (size_t iF = 0; iF < nActiveFaces; iF++) {
+    polygons[iF] = {currentFaces[iF][0], currentFaces[iF][1], currentFaces[iF][2]};
+  }
+  std::unique_ptr<ManifoldSurfaceMesh> mesh(new ManifoldSurfaceMesh(polygons));
+  if (mesh->nVertices() != nVertices()) throw std::runtime_error("progressive mesh has unreferenced vertices");
+
+  VertexData<Vector3> positions(*mesh);
+  for (size_t iV = 0; iV < nVertices(); iV++) {
+    positions[iV] = currentPositions[iV];
+  }
+  std::unique_ptr<VertexPositionGeometry> geom(new VertexPositionGeometry(*mesh, positions));
+
+  return std::make_tuple(std::move(mesh), std::move(geom));
+}
+
+VertexData<double> ProgressiveMesh::vertexAttribute(ManifoldSurfaceMesh& extracted, size_t channel) const {
+  if (channel >= nVertexAttributes_) throw std::runtime_error("vertex attribute channel out of range");
+  VertexData<double> data(extracted);
+  for (Vertex v : extracted.vertices()) {
+    data[v] = vertexValue(v.getIndex(), channel);
+  }
+  return data;
+}
+
+CornerData<double> ProgressiveMesh::cornerAttribute(ManifoldSurfaceMesh& extracted, size_t channel) const {
+  if (channel >= nCornerAttributes_) throw std::runtime_error("corner attribute channel out of range");
+  CornerData<double> data(extracted);
+  for (Face f : extracted.faces()) {
+    const std::array<size_t, 3>& face = currentFaces[f.getIndex()];
+    for (Corner c : f.adjacentCorners()) {
+      size_t j = std::find(face.begin(), face.end(), c.vertex().getIndex()) - face.begin();
+      data[c] = cornerValue(3 * f.getIndex() + j, channel);
+    }
+  }
+  return data;
+}
+
+void ProgressiveMesh::write(std::ostream& out) const {
+  writeBase(out);
+  writeSplits(out, 0, nSplits());
+}
+
+ProgressiveMesh ProgressiveMesh::read(std::istream& in) {
+  ProgressiveMesh pm = readBase(in);
+  pm.readSplits(in);
+  return pm;
+}
+
+void ProgressiveMesh::writeBase(std::ostream& out) const {
+  out.write(gcpmMagic, 4);
+  writeLE<uint32_t>(out, gcpmVersion);
+  writeLE<uint32_t>(out, static_cast<uint32_t>(nVertexAttributes_));
+  writeLE<uint32_t>(out, static_cast<uint32_t>(nCornerAttributes_));
+  writeLE<uint64_t>(out, nBaseVertices());
+  writeLE<uint64_t>(out, nBaseFaces());
+  for (Vector3 p : basePositions) writeVector3(out, p);
+  writeValues(out, baseVertexValues);
+  for (const std::array<size_t, 3>& face : baseFaces) {
+    for (size_t v : face) writeIndex(out, v);
+  }
+  writeValues(out, baseCornerValues);
+}
+
+// Each record is:
+//   uint32 splitVertex | uint32 nNewFaces | new faces (uint32 x 3) | moved corners (uint32 count, uint32s) |
+//   3 positions | 3 x nVertexAttributes values | if there are corner attributes: fine corners (uint32 count,
+//   uint32s) | their values | coarse corners | their values
+void ProgressiveMesh::writeSplits(std::ostream& out, size_t first, size_t count) const {
+  if (first > nSplits()) first = nSplits();
+  count = std::min(count, nSplits() - first);
+
+  writeLE<uint64_t>(out, count);
+  for (size_t i = first; i < first + count; i++) {
+    const VertexSplitRecord& r = splits[i];
+    writeIndex(out, r.splitVertex);
+    writeIndex(out, r.newFaces.size());
+    for (const std::array<size_t, 3>& face : r.newFaces) {
+      for (size_t v : face) writeIndex(out, v);
+    }
+    writeIndexList(out, r.movedCorners);
+    writeVector3(out, r.splitVertexPosition);
+    writeVector3(out, r.newVertexPosition);
+    writeVector3(out, r.collapsedVertexPosition);
+    writeValues(out, r.vertexValues);
+    if (nCornerAttributes_ > 0) {
+      writeIndexList(out, r.fineCorners);
+      writeValues(out, r.fineValues);
+      writeIndexList(out, r.coarseCorners);
+      writeValues(out, r.coarseValues);
+    }
+  }
+}
+
+ProgressiveMesh ProgressiveMesh::readBase(std::istream& in) {
+  char magic[4];
+  in.read(magic, 4);
+  if (!in || std::memcmp(magic, gcpmMagic, 4) != 0) throw std::runtime_error("not a progressive mesh stream");
+  uint32_t version = readLE<uint32_t>(in);
+  if (version != gcpmVersion) throw std::runtime_error("unsupported progressive mesh version " + std::to_string(version));
+
+  size_t nVA = readLE<uint32_t>(in);
+  size_t nCA = readLE<uint32_t>(in);
+  size_t nV = readLE<uint64_t>(in);
+  size_t nF = readLE<uint64_t>(in);
+
+  std::vector<Vector3> positions(nV);
+  for (Vector3& p : positions) p = readVector3(in);
+  std::vector<double> vertexValues;
+  readValues(in, vertexValues, nV * nVA);
+  std::vector<std::array<size_t, 3>> faces(nF);
+  for (std::array<size_t, 3>& face : faces) {
+    for (size_t& v : face) v = readIndex(in);
+  }
+  std::vector<double> cornerValues;
+  readValues(in, cornerValues, 3 * nF * nCA);
+
+  ProgressiveMesh pm(nVA, nCA);
+  pm.setBase(positions, vertexValues, faces, cornerValues);
+  return pm;
+}
+
+size_t ProgressiveMesh::readSplits(std::istream& in) {
+  size_t count = readLE<uint64_t>(in);
+  size_t nVA = nVertexAttributes_;
+  size_t nCA = nCornerAttributes_;
+
+  VertexSplitRecord r;
+  for (size_t i = 0; i < count; i++) {
+    r.splitVertex = readIndex(in);
+    r.newFaces.resize(readIndex(in));
+    if (r.newFaces.size() > 2) throw std::runtime_error("vertex split record must introduce 1 or 2 faces");
+    for (std::array<size_t, 3>& face : r.newFaces) {
+      for (size_t& v : face) v = readIndex(in);
+    }
+    readIndexList(in, r.movedCorners);
+    r.splitVertexPosition = readVector3(in);
+    r.newVertexPosition = readVector3(in);
+    r.collapsedVertexPosition = readVector3(in);
+    readValues(in, r.vertexValues, 3 * nVA);
+    if (nCA > 0) {
+      readIndexList(in, r.fineCorners);
+      readValues(in, r.fineValues, r.fineCorners.size() * nCA);
+      readIndexList(in, r.coarseCorners);
+      readValues(in, r.coarseValues, r.coarseCorners.size() * nCA);
+    }
+    appendSplit(r);
+  }
+  return count;
+}
+
+// ======================================================
+// ======== ProgressiveMeshRecorder
+// ======================================================
+
+class ProgressiveMeshRecorder::Policy : public EdgeCollapsePolicy,
+                                       public EdgeFlipPolicy,
+                                       public EdgeSplitPolicy,
+                                       public FaceSplitPolicy,
+                                       public VertexRepositionPolicy {
+public:
+  Policy(ProgressiveMeshRecorder& recorder_) : recorder(recorder_) {}
+
+  void beforeEdgeCollapse(const Edge& e, const double& tCollapse) override { recorder.beforeCollapse(e); }
+  void afterEdgeCollapse(const Vertex& v, const double& tCollapse) override { recorder.afterCollapse(v); }
+
+  void beforeEdgeFlip(const Edge& e) override { refuse(); }
+  void beforeEdgeSplit(const Edge& e, const double& tSplit) override { refuse(); }
+  void beforeFaceSplit(const Face& f, const std::vector<double>& bSplit) override { refuse(); }
+  void beforeVertexReposition(const Vertex& v, const Vector3& vec) override { refuse(); }
+
+private:
+  ProgressiveMeshRecorder& recorder;
+  void refuse() { throw std::runtime_error("only edge collapses can be performed while recording a progressive mesh"); }
+};
+
+ProgressiveMeshRecorder::ProgressiveMeshRecorder(MutationManager& mm_,
+                                                 const std::vector<VertexData<double>*>& vertexAttributes_,
+                                                 const std::vector<CornerData<double>*>& cornerAttributes_)
+    : mm(mm_), mesh(mm_.mesh), geom(requireGeometry(mm_)), vertexAttributes(vertexAttributes_),
+      cornerAttributes(cornerAttributes_), policyHandle(mm_.registerPolicy(new Policy(*this))), vertexId(mesh),
+      faceId(mesh) {
+
+  size_t iV = 0;
+  for (Vertex v : mesh.vertices()) {
+    vertexId[v] = iV++;
+  }
+  nVertexIds = iV;
+
+  for (Face f : mesh.faces()) {
+    if (f.degree() != 3) {
+      policyHandle.remove();
+      throw std::runtime_error("progressive meshes can only be recorded on triangle meshes");
+    }
+    faceId[f] = faceVerts.size();
+    Halfedge he = f.halfedge();
+    faceVerts.push_back({{vertexId[he.vertex()], vertexId[he.next().vertex()], vertexId[he.next().next().vertex()]}});
+  }
+}
+
+ProgressiveMeshRecorder::~ProgressiveMeshRecorder() {
+  if (!finished) policyHandle.remove();
+}
+
+void ProgressiveMeshRecorder::readVertex(Vertex v, std::vector<double>& values) const {
+  for (VertexData<double>* data : vertexAttributes) {
+    values.push_back((*data)[v]);
+  }
+}
+
+void ProgressiveMeshRecorder::readCorners(Face f, std::vector<size_t>& corners, std::vector<double>& values) const {
+  size_t fId = faceId[f];
+  for (size_t j = 0; j < 3; j++) {
+    corners.push_back(3 * fId + j);
+    for (Corner c : f.adjacentCorners()) {
+      if (vertexId[c.vertex()] != faceVerts[fId][j]) continue;
+      for (CornerData<double>* data : cornerAttributes) {
+        values.push_back((*data)[c]);
+      }
+    }
+  }
+}
+
+void ProgressiveMeshRecorder::beforeCollapse(Edge e) {
+  finalizePending();
+
+  Vertex v1 = e.halfedge().tailVertex();
+  Vertex v2 = e.halfedge().tipVertex();
+
+  // Until we know which vertex survives, record v1 as the survivor
+  pendingEvent = Event();
+  pendingEvent.survivor = vertexId[v1];
+  pendingEvent.removed = vertexId[v2];
+  VertexSplitRecord& r = pendingEvent.record;
+  r.splitVertexPosition = geom.vertexPositions[v1];
+  r.newVertexPosition = geom.vertexPositions[v2];
+  readVertex(v1, r.vertexValues);
+  readVertex(v2, r.vertexValues);
+
+  pendingFaces.clear();
+  for (Vertex v : {v1, v2}) {
+    for (Face f : v.adjacentFaces()) {
+      if (std::find(pendingFaces.begin(), pendingFaces.end(), f) == pendingFaces.end()) pendingFaces.push_back(f);
+    }
+  }
+  if (!cornerAttributes.empty()) {
+    for (Face f : pendingFaces) {
+      readCorners(f, r.fineCorners, r.fineValues);
+    }
+  }
+
+  pending = true;
+  pendingDone = false;
+}
+
+void ProgressiveMeshRecorder::afterCollapse(Vertex v) {
+  if (!pending) return;
+  Event& ev = pendingEvent;
+  VertexSplitRecord& r = ev.record;
+
+  if (vertexId[v] == ev.removed) {
+    std::swap(ev.survivor, ev.removed);
+    std::swap(r.splitVertexPosition, r.newVertexPosition);
+    std::swap_ranges(r.vertexValues.begin(), r.vertexValues.begin() + vertexAttributes.size(),
+                     r.vertexValues.begin() + vertexAttributes.size());
+  }
+
+  for (Face f : pendingFaces) {
+    size_t fId = faceId[f];
+    if (f.isDead()) {
+      ev.removedFaces.push_back(fId);
+      continue;
+    }
+    for (size_t j = 0; j < 3; j++) {
+      if (faceVerts[fId][j] == ev.removed) {
+        faceVerts[fId][j] = ev.survivor;
+        r.movedCorners.push_back(3 * fId + j);
+      }
+    }
+  }
+
+  pendingSurvivor = v;
+  pendingDone = true;
+}
+
+void ProgressiveMeshRecorder::finalizePending() {
+  if (!pending) return;
+  pending = false;
+  if (!pendingDone) return; // the collapse failed, and the mesh is unchanged
+  pendingDone = false;
+
+  Event& ev = pendingEvent;
+  VertexSplitRecord& r = ev.record;
+
+  // The mesh may have been compressed since the collapse
+  Vertex v = pendingSurvivor;
+  if (v.getIndex() >= mesh.nVerticesCapacity() || v.isDead() || vertexId[v] != ev.survivor) {
+    for (Vertex vOther : mesh.vertices()) {
+      if (vertexId[vOther] == ev.survivor) {
+        v = vOther;
+        break;
+      }
+    }
+  }
+
+  r.collapsedVertexPosition = geom.vertexPositions[v];
+  readVertex(v, r.vertexValues);
+  if (!cornerAttributes.empty()) {
+    for (Face f : v.adjacentFaces()) {
+      readCorners(f, r.coarseCorners, r.coarseValues);
+    }
+  }
+
+  events.push_back(std::move(pendingEvent));
+}
+
+ProgressiveMesh ProgressiveMeshRecorder::finish() {
+  if (finished) throw std::runtime_error("progressive mesh recorder was already finished");
+  finalizePending();
+  policyHandle.remove();
+  finished = true;
+
+  // Number the surviving elements first, in the order of the mesh, then those removed by the last collapse, etc
+  std::vector<size_t> vMap(nVertexIds, INVALID_IND);
+  std::vector<size_t> fMap(faceVerts.size(), INVALID_IND);
+  size_t nV = 0;
+  size_t nF = 0;
+
+  std::vector<Vector3> positions;
+  std::vector<double> vertexValues;
+  for (Vertex v : mesh.vertices()) {
+    vMap[vertexId[v]] = nV++;
+    positions.push_back(geom.vertexPositions[v]);
+    readVertex(v, vertexValues);
+  }
+  for (auto it = events.rbegin(); it != events.rend(); ++it) {
+    vMap[it->removed] = nV++;
+  }
+
+  std::vector<size_t> baseCorners;
+  std::vector<double> cornerValues;
+  for (Face f : mesh.faces()) {
+    fMap[faceId[f]] = nF++;
+    if (!cornerAttributes.empty()) readCorners(f, baseCorners, cornerValues);
+  }
+  for (auto it = events.rbegin(); it != events.rend(); ++it) {
+    for (size_t fId : it->removedFaces) {
+      fMap[fId] = nF++;
+    }
+  }
+
+  auto mapFace = [&](size_t fId) {
+    const std::array<size_t, 3>& face = faceVerts[fId];
+    return std::array<size_t, 3>{{vMap[face[0]], vMap[face[1]], vMap[face[2]]}};
+  };
+  auto mapCorners = [&](std::vector<size_t>& corners) {
+    for (size_t& c : corners) c = 3 * fMap[c / 3] + c % 3;
+  };
+
+  std::vector<std::array<size_t, 3>> faces;
+  for (Face f : mesh.faces()) {
+    faces.push_back(mapFace(faceId[f]));
+  }
+
+  ProgressiveMesh pm(vertexAttributes.size(), cornerAttributes.size());
+  pm.setBase(positions, vertexValues, faces, cornerValues);
+
+  for (auto it = events.rbegin(); it != events.rend(); ++it) {
+    VertexSplitRecord& r = it->record;
+    r.splitVertex = vMap[it->survivor];
+    for (size_t fId : it->removedFaces) {
+      r.newFaces.push_back(mapFace(fId));
+    }
+    mapCorners(r.movedCorners);
+    mapCorners(r.fineCorners);
+    mapCorners(r.coarseCorners);
+    pm.appendSplit(r);
+  }
+  events.clear();
+
+  return pm;
+}
+
+ProgressiveMesh buildProgressiveMesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                                     const QuadricSimplifyOptions& options) {
+  MutationManager mm(mesh, geo);
+  ProgressiveMeshRecorder recorder(mm);
+  quadricErrorSimplify(mesh, geo, options, mm);
+  return recorder.finish();
+}
+
+} // namespace surface
+} // namespace geometrycentral
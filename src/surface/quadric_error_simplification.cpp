@@ -1,5 +1,11 @@
 #include "geometrycentral/surface/quadric_error_simplification.h"
 
+#include "geometrycentral/utilities/indexed_heap.h"
+#include "geometrycentral/utilities/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -21,6 +27,23 @@ double Quadric::cost(const Eigen::Vector3d& v) { return v.dot(A * v) + 2 * b.dot
 
 Eigen::Vector3d Quadric::optimalPoint() { return -A.inverse() * b; }
 
+Eigen::Vector3d Quadric::optimalPoint(const Eigen::Vector3d& p1, const Eigen::Vector3d& p2) {
+  Eigen::FullPivLU<Eigen::Matrix3d> lu(A);
+  lu.setThreshold(1e-8);
+  if (lu.isInvertible()) return lu.solve(-b);
+
+  Eigen::Vector3d best = p1;
+  double bestCost = cost(p1);
+  for (const Eigen::Vector3d& p : {p2, Eigen::Vector3d(0.5 * (p1 + p2))}) {
+    double c = cost(p);
+    if (c < bestCost) {
+      best = p;
+      bestCost = c;
+    }
+  }
+  return best;
+}
+
 Quadric Quadric::operator+=(const Quadric& Q) {
   A += Q.A;
   b += Q.b;
@@ -31,84 +54,305 @@ Quadric Quadric::operator+=(const Quadric& Q) {
 
 Quadric operator+(const Quadric& Q1, const Quadric& Q2) { return Quadric(Q1.A + Q2.A, Q1.b + Q2.b, Q1.c + Q2.c); }
 
-void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol) {
-  MutationManager mm(mesh, geo);
-  quadricErrorSimplify(mesh, geo, tol, mm);
-}
+namespace {
 
-void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol, MutationManager& mm) {
-  auto toEigen = [](Vector3 v) -> Eigen::Vector3d {
-    Eigen::Vector3d ret;
-    ret << v.x, v.y, v.z;
-    return ret;
-  };
-  auto fromEigen = [](Eigen::Vector3d v) -> Vector3 { return Vector3{v(0), v(1), v(2)}; };
+Eigen::Vector3d toEigen(Vector3 v) { return Eigen::Vector3d(v.x, v.y, v.z); }
+Vector3 fromEigen(const Eigen::Vector3d& v) { return Vector3{v(0), v(1), v(2)}; }
+
+// State shared by the serial and parallel simplification loops
+class QuadricSimplifier {
+public:
+  QuadricSimplifier(ManifoldSurfaceMesh& mesh_, VertexPositionGeometry& geo_, const QuadricSimplifyOptions& options_,
+                    MutationManager& mm_)
+      : mesh(mesh_), geo(geo_), options(options_), mm(mm_), Q(mesh, Quadric()), edgeCost(mesh), edgePos(mesh) {
 
-  VertexData<Quadric> Q(mesh, Quadric());
+    geo.requireFaceNormals();
+    for (Face f : mesh.faces()) {
+      Eigen::Vector3d n = toEigen(geo.faceNormals[f]);
+      Eigen::Matrix3d M = n * n.transpose();
+      for (Vertex v : f.adjacentVertices()) {
+        Eigen::Vector3d q = toEigen(geo.inputVertexPositions[v]);
+        double d = -n.dot(q);
 
-  geo.requireFaceNormals();
+        Q[v] += Quadric(M, d * n, d * d);
+      }
+    }
 
-  for (Face f : mesh.faces()) {
-    Eigen::Vector3d n = toEigen(geo.faceNormals[f]);
-    Eigen::Matrix3d M = n * n.transpose();
-    for (Vertex v : f.adjacentVertices()) {
-      Eigen::Vector3d q = toEigen(geo.inputVertexPositions[v]);
-      double d = -n.dot(q);
+    // Optionally, boundary edges also get a heavily-weighted plane perpendicular to their face, so that boundaries keep
+    // their shape
+    if (options.boundaryWeight > 0.) {
+      const double w = options.boundaryWeight;
+      for (BoundaryLoop bl : mesh.boundaryLoops()) {
+        for (Halfedge he : bl.adjacentHalfedges()) {
+          Halfedge heInterior = he.twin();
+          Vector3 pTail = geo.inputVertexPositions[heInterior.tailVertex()];
+          Vector3 pTip = geo.inputVertexPositions[heInterior.tipVertex()];
+          Vector3 nPlane = cross(pTip - pTail, geo.faceNormals[heInterior.face()]);
+          if (norm(nPlane) == 0.) continue;
+          Eigen::Vector3d n = toEigen(unit(nPlane));
+          double d = -n.dot(toEigen(pTail));
+          Quadric Qb(w * n * n.transpose(), w * d * n, w * d * d);
+          Q[heInterior.tailVertex()] += Qb;
+          Q[heInterior.tipVertex()] += Qb;
+        }
+      }
+    }
+    geo.unrequireFaceNormals();
 
-      Q[v] += Quadric(M, d * n, d * d);
+    targetFaces = options.targetFaceCount;
+    if (options.targetRatio > 0.) {
+      double ratioFaces = std::ceil(options.targetRatio * mesh.nFaces());
+      targetFaces = std::max(targetFaces, static_cast<size_t>(ratioFaces));
     }
   }
 
-  using PotentialEdge = std::tuple<double, Edge>;
+  ManifoldSurfaceMesh& mesh;
+  VertexPositionGeometry& geo;
+  const QuadricSimplifyOptions& options;
+  MutationManager& mm;
 
-  auto cmp = [](const PotentialEdge& a, const PotentialEdge& b) -> bool { return std::get<0>(a) > std::get<0>(b); };
+  VertexData<Quadric> Q;
+  EdgeData<double> edgeCost;  // quadric error of collapsing each edge
+  EdgeData<Vector3> edgePos; // and the location of the resulting vertex
+  size_t targetFaces;
 
-  std::priority_queue<PotentialEdge, std::vector<PotentialEdge>, decltype(cmp)> edgesToCheck(cmp);
+  bool done() const { return mesh.nFaces() <= targetFaces; }
 
-  for (Edge e : mesh.edges()) {
-    Quadric Qe = Q[e.halfedge().tailVertex()] + Q[e.halfedge().tipVertex()];
-    Eigen::Vector3d q = Qe.optimalPoint();
-    double cost = Qe.cost(q);
-    edgesToCheck.push(std::make_tuple(cost, e));
+  // Update edgeCost and edgePos. Safe to call in parallel for distinct edges.
+  void evaluate(Edge e) {
+    Vertex v1 = e.halfedge().tailVertex();
+    Vertex v2 = e.halfedge().tipVertex();
+    Quadric Qe(Q[v1], Q[v2]);
+    Eigen::Vector3d q = Qe.optimalPoint(toEigen(geo.inputVertexPositions[v1]), toEigen(geo.inputVertexPositions[v2]));
+    edgeCost[e] = Qe.cost(q);
+    edgePos[e] = fromEigen(q);
   }
 
-  while (!edgesToCheck.empty()) {
-    PotentialEdge best = edgesToCheck.top();
-    edgesToCheck.pop();
+  void evaluateAll(const std::vector<Edge>& edges) {
+    parallelFor(0, edges.size(), [&](size_t i) { evaluate(edges[i]); }, 1024);
+  }
+
+  // Does the edge pass the safeguards enabled in the options? (The mesh still refuses collapses which it cannot
+  // perform.) Only reads the mesh, so may be called in parallel.
+  bool canCollapse(Edge e) const {
+    Vertex v1 = e.halfedge().tailVertex();
+    Vertex v2 = e.halfedge().tipVertex();
+
+    if (options.checkTopology) {
+      // Don't collapse the mesh down to nothing
+      if (mesh.nFaces() <= 4) return false;
+
+      // An interior edge between two boundary vertices would pinch the surface
+      if (!e.isBoundary() && v1.isBoundary() && v2.isBoundary()) return false;
+
+      // Link condition: the only common neighbors of the endpoints are the tips of the adjacent triangles
+      size_t nCommon = 0;
+      for (Vertex w1 : v1.adjacentVertices()) {
+        for (Vertex w2 : v2.adjacentVertices()) {
+          if (w1 == w2) nCommon++;
+        }
+      }
+      if (nCommon != (e.isBoundary() ? 1u : 2u)) return false;
+    }
+
+    if (!options.preventFoldOver) return true;
+
+    // Fold-over: no face which remains should flip its normal
+    Vector3 newPos = edgePos[e];
+    for (Vertex v : {v1, v2}) {
+      for (Halfedge he : v.outgoingHalfedges()) {
+        if (!he.isInterior()) continue;
+        Vertex vB = he.next().vertex();
+        Vertex vC = he.next().next().vertex();
+        if (vB == v1 || vB == v2 || vC == v1 || vC == v2) continue; // collapses away
+        Vector3 pA = geo.inputVertexPositions[v];
+        Vector3 pB = geo.inputVertexPositions[vB];
+        Vector3 pC = geo.inputVertexPositions[vC];
+        Vector3 nBefore = cross(pB - pA, pC - pA);
+        Vector3 nAfter = cross(pB - newPos, pC - newPos);
+        if (dot(nBefore, nAfter) <= 0.) return false;
+      }
+    }
+
+    return true;
+  }
+
+  Vertex collapse(Edge e) {
+    Vertex v1 = e.halfedge().tailVertex();
+    Vertex v2 = e.halfedge().tipVertex();
+    Quadric Qe(Q[v1], Q[v2]);
+    Vertex v = mm.collapseEdge(e, edgePos[e]);
+    if (v != Vertex()) Q[v] = Qe;
+    return v;
+  }
+};
+
+void simplifySerial(QuadricSimplifier& simp) {
+  ManifoldSurfaceMesh& mesh = simp.mesh;
+
+  std::vector<Edge> allEdges;
+  for (Edge e : mesh.edges()) allEdges.push_back(e);
+  simp.evaluateAll(allEdges);
+
+  // Min-heap of edges by cost, with in-place updates
+  IndexedHeap<double, std::greater<double>> heap;
+  for (Edge e : allEdges) heap.push(e.getIndex(), simp.edgeCost[e]);
+
+  // Edges which fail the safeguards stay out of the heap until their neighborhood changes
+  EdgeData<char> rejected(mesh, false);
+
+  std::vector<size_t> nearbyEdges;
+  while (!heap.empty() && !simp.done()) {
 
     // Stop when collapse becomes too expensive
-    double cost = std::get<0>(best);
-    if (cost > tol) break;
+    if (heap.topPriority() > simp.options.tol) break;
 
-    Edge e = std::get<1>(best);
-    if (!e.isDead()) {
+    Edge e(&mesh, heap.pop());
+    if (!simp.canCollapse(e)) {
+      rejected[e] = true;
+      continue;
+    }
 
+    nearbyEdges.clear();
+    for (Vertex v : {e.halfedge().tailVertex(), e.halfedge().tipVertex()}) {
+      for (Edge eN : v.adjacentEdges()) nearbyEdges.push_back(eN.getIndex());
+    }
+
+    Vertex v = simp.collapse(e);
+    if (v == Vertex()) continue;
+
+    for (size_t iE : nearbyEdges) {
+      if (Edge(&mesh, iE).isDead()) heap.remove(iE);
+    }
+
+    // Edges at the new vertex have new costs; edges around it may have become collapsible
+    for (Edge eN : v.adjacentEdges()) {
+      simp.evaluate(eN);
+      heap.push(eN.getIndex(), simp.edgeCost[eN]);
+      rejected[eN] = false;
+    }
+    for (Vertex w : v.adjacentVertices()) {
+      for (Edge eN : w.adjacentEdges()) {
+        if (!rejected[eN]) continue;
+        rejected[eN] = false;
+        heap.push(eN.getIndex(), simp.edgeCost[eN]);
+      }
+    }
+  }
+}
+
+void simplifyParallel(QuadricSimplifier& simp) {
+  ManifoldSurfaceMesh& mesh = simp.mesh;
+
+  // Each round considers this fraction of the cheapest remaining edges
+  const double roundFraction = 0.25;
+
+  std::vector<Edge> allEdges;
+  for (Edge e : mesh.edges()) allEdges.push_back(e);
+  simp.evaluateAll(allEdges);
+
+  EdgeData<char> rejected(mesh, false); // can't be collapsed until its neighborhood changes
+  VertexData<char> locked(mesh, false); // in the neighborhood of a collapse this round
+
+  std::vector<Edge> candidates;
+  std::vector<Edge> selected;
+  std::vector<char> valid;
+  std::vector<Vertex> lockedVerts;
+  std::vector<Edge> changed;
+
+  while (!simp.done()) {
+
+    // Gather the cheapest edges
+    candidates.clear();
+    for (Edge e : mesh.edges()) {
+      if (!rejected[e] && simp.edgeCost[e] <= simp.options.tol) candidates.push_back(e);
+    }
+    if (candidates.empty()) break;
+    size_t nWindow = std::max<size_t>(1, static_cast<size_t>(std::ceil(roundFraction * candidates.size())));
+    auto byCost = [&](Edge a, Edge b) {
+      return std::make_pair(simp.edgeCost[a], a.getIndex()) < std::make_pair(simp.edgeCost[b], b.getIndex());
+    };
+    std::nth_element(candidates.begin(), candidates.begin() + (nWindow - 1), candidates.end(), byCost);
+    candidates.resize(nWindow);
+    std::sort(candidates.begin(), candidates.end(), byCost);
+
+    // Greedily take non-conflicting collapses, cheapest first. A collapse only reads and writes the 1-rings of its
+    // endpoints, so collapses whose endpoints are outside of each other's 1-rings do not interact.
+    selected.clear();
+    size_t nFacesAfter = mesh.nFaces();
+    for (Edge e : candidates) {
+      if (nFacesAfter <= simp.targetFaces) break;
       Vertex v1 = e.halfedge().tailVertex();
       Vertex v2 = e.halfedge().tipVertex();
+      if (locked[v1] || locked[v2]) continue;
 
-      // Get edge quadric
-      Quadric Qe(Q[v1], Q[v2]);
-      Eigen::Vector3d q = Qe.optimalPoint();
+      selected.push_back(e);
+      nFacesAfter -= e.isBoundary() ? 1 : 2;
+      for (Vertex v : {v1, v2}) {
+        for (Vertex w : v.adjacentVertices()) {
+          locked[w] = true;
+          lockedVerts.push_back(w);
+        }
+      }
+    }
+    for (Vertex v : lockedVerts) locked[v] = false;
+    lockedVerts.clear();
 
-      // If either vertex has been collapsed since the edge was pushed
-      // onto the queue, the old cost was wrong. In that case, give up
-      if (abs(cost - Qe.cost(q)) > 1e-8) continue;
+    valid.resize(selected.size());
+    parallelFor(0, selected.size(), [&](size_t i) { valid[i] = simp.canCollapse(selected[i]); }, 64);
 
-      Vertex v = mm.collapseEdge(e, fromEigen(q));
-      if (v == Vertex()) continue;
-      Q[v] = Qe;
+    // Collapses must be applied one at a time, since mutation (and the mutation callbacks) is not thread-safe
+    changed.clear();
+    for (size_t i = 0; i < selected.size(); i++) {
+      Edge e = selected[i];
+      Vertex v = valid[i] ? simp.collapse(e) : Vertex();
+      if (v == Vertex()) {
+        rejected[e] = true;
+        continue;
+      }
 
-      for (Edge f : v.adjacentEdges()) {
-        Quadric Qf(Q[f.halfedge().tailVertex()], Q[f.halfedge().tipVertex()]);
-        Eigen::Vector3d q = Qf.optimalPoint();
-        double cost = Qf.cost(q);
-        edgesToCheck.push(std::make_tuple(cost, f));
+      // Edges at the new vertex have new costs; edges around it may have become collapsible
+      for (Edge eN : v.adjacentEdges()) changed.push_back(eN);
+      for (Vertex w : v.adjacentVertices()) {
+        for (Edge eN : w.adjacentEdges()) rejected[eN] = false;
       }
     }
+    simp.evaluateAll(changed);
+  }
+}
+
+} // namespace
+
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol) {
+  MutationManager mm(mesh, geo);
+  quadricErrorSimplify(mesh, geo, tol, mm);
+}
+
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, double tol, MutationManager& mm) {
+  QuadricSimplifyOptions options;
+  options.tol = tol;
+  quadricErrorSimplify(mesh, geo, options, mm);
+}
+
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                          const QuadricSimplifyOptions& options) {
+  MutationManager mm(mesh, geo);
+  quadricErrorSimplify(mesh, geo, options, mm);
+}
+
+void quadricErrorSimplify(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo,
+                          const QuadricSimplifyOptions& options, MutationManager& mm) {
+  {
+    QuadricSimplifier simp(mesh, geo, options, mm);
+    if (options.parallel) {
+      simplifyParallel(simp);
+    } else {
+      simplifySerial(simp);
+    }
   }
 
   mesh.compress();
-  return;
 }
+
 } // namespace surface
 } // namespace geometrycentral
@@ -0,0 +1,654 @@
+#include "geometrycentral/surface/remeshing.h"
+
+#include "geometrycentral/utilities/elementary_geometry.h"
+#include "geometrycentral/utilities/knn.h"
+#include "geometrycentral/utilities/parallel.h"
+#include "geometrycentral/utilities/voxel_hash_grid.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace geometrycentral {
+namespace surface {
+
+namespace {
+
+// Edges are split above this multiple of the target length, and collapsed below this one
+const double splitRatio = 4. / 3.;
+const double collapseRatio = 4. / 5.;
+
+// A candidate collapse or flip. It only reads and writes the mesh within `region` (vertex indices), so operations with
+// disjoint regions can be applied in any order.
+struct LocalOp {
+  Edge e;
+  double priority; // lower goes first
+  Vector3 center;
+  std::vector<size_t> region;
+  Vector3 newPos; // (collapses only)
+};
+
+// Choose a set of operations with pairwise-disjoint regions. Operations are bucketed in spatial cells, and each cell
+// greedily takes its operations in order of priority, in parallel. Operations from different cells rarely overlap
+// (only when they are long compared to the cells); those conflicts go to the cell with the lower index. Returns the
+// chosen operations in a deterministic order.
+std::vector<size_t> chooseIndependent(const std::vector<LocalOp>& ops, double cellSize, size_t nVerticesCapacity) {
+
+  std::vector<Vector3> centers(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) centers[i] = ops[i].center;
+  std::vector<std::vector<size_t>> cellOps = VoxelBuckets(centers, cellSize).members;
+
+  // Greedy within each cell
+  std::vector<std::vector<size_t>> cellChosen(cellOps.size());
+  parallelFor(0, cellOps.size(), [&](size_t iC) {
+    std::vector<size_t>& cand = cellOps[iC];
+    std::sort(cand.begin(), cand.end(), [&](size_t a, size_t b) {
+      return std::make_pair(ops[a].priority, a) < std::make_pair(ops[b].priority, b);
+    });
+    std::unordered_set<size_t> locked;
+    for (size_t i : cand) {
+      const std::vector<size_t>& region = ops[i].region;
+      bool free = std::none_of(region.begin(), region.end(), [&](size_t v) { return locked.count(v) > 0; });
+      if (!free) continue;
+      locked.insert(region.begin(), region.end());
+      cellChosen[iC].push_back(i);
+    }
+  });
+
+  // Resolve conflicts between cells: each vertex belongs to the lowest cell which claims it
+  std::vector<std::atomic<size_t>> claim(nVerticesCapacity);
+  for (std::atomic<size_t>& c : claim) c.store(INVALID_IND, std::memory_order_relaxed);
+  parallelFor(0, cellChosen.size(), [&](size_t iC) {
+    for (size_t i : cellChosen[iC]) {
+      for (size_t v : ops[i].region) {
+        size_t prev = claim[v].load(std::memory_order_relaxed);
+        while (iC < prev && !claim[v].compare_exchange_weak(prev, iC, std::memory_order_relaxed)) {
+        }
+      }
+    }
+  });
+
+  std::vector<size_t> chosen;
+  for (size_t iC = 0; iC < cellChosen.size(); iC++) {
+    for (size_t i : cellChosen[iC]) {
+      const std::vector<size_t>& region = ops[i].region;
+      if (std::all_of(region.begin(), region.end(), [&](size_t v) { return claim[v].load() == iC; })) {
+        chosen.push_back(i);
+      }
+    }
+  }
+  return chosen;
+}
+
+// Closest point to p on the triangle abc, following [Ericson 2004] "Real-Time Collision Detection", 5.1.5
+Vector3 closestPointOnTriangle(Vector3 p, Vector3 a, Vector3 b, Vector3 c) {
+  Vector3 ab = b - a;
+  Vector3 ac = c - a;
+  double d1 = dot(ab, p - a);
+  double d2 = dot(ac, p - a);
+  if (d1 <= 0. && d2 <= 0.) return a;
+  double d3 = dot(ab, p - b);
+  double d4 = dot(ac, p - b);
+  if (d3 >= 0. && d4 <= d3) return b;
+  double d5 = dot(ab, p - c);
+  double d6 = dot(ac, p - c);
+  if (d6 >= 0. && d5 <= d6) return c;
+
+  double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0. && d1 >= 0. && d3 <= 0.) return a + d1 / (d1 - d3) * ab;
+  double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0. && d2 >= 0. && d6 <= 0.) return a + d2 / (d2 - d6) * ac;
+  double va = d3 * d6 - d5 * d4;
+  if (va <= 0. && d4 - d3 >= 0. && d5 - d6 >= 0.) return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+
+  double sum = va + vb + vc;
+  if (!(sum > 0.)) {
+    // Degenerate triangle, take the closest point on its edges
+    Vector3 best = a;
+    for (std::array<Vector3, 2> s : {std::array<Vector3, 2>{{a, b}}, std::array<Vector3, 2>{{b, c}},
+                                     std::array<Vector3, 2>{{c, a}}}) {
+      Vector3 q = s[0] + pointLineSegmentNeaestLocation(p, s[0], s[1]) * (s[1] - s[0]);
+      if (norm2(q - p) < norm2(best - p)) best = q;
+    }
+    return best;
+  }
+  return a + (vb / sum) * ab + (vc / sum) * ac;
+}
+
+// Closest points on a fixed set of triangles, or of segments (stored with a repeated last corner). Candidates are found
+// through the primitive centroids: a primitive closer than the best of the few nearest centroids has its centroid
+// within that distance plus the largest centroid-to-corner distance.
+class ClosestPointFinder {
+public:
+  ClosestPointFinder(std::vector<std::array<Vector3, 3>> primitives_, bool segments_)
+      : primitives(std::move(primitives_)), segments(segments_) {
+    if (primitives.empty()) return;
+    std::vector<Vector3> centroids;
+    for (const std::array<Vector3, 3>& t : primitives) {
+      Vector3 c = (t[0] + t[1] + t[2]) / 3.;
+      if (segments) c = 0.5 * (t[0] + t[1]);
+      for (Vector3 q : t) maxRadius = std::max(maxRadius, norm(q - c));
+      centroids.push_back(c);
+    }
+    centroidFinder.reset(new NearestNeighborFinder(std::move(centroids)));
+  }
+
+  // (safe to call concurrently)
+  Vector3 closestPoint(Vector3 p) const {
+    if (primitives.empty()) return p;
+    Vector3 best = p;
+    double bestDist = std::numeric_limits<double>::infinity();
+    auto consider = [&](size_t i) {
+      Vector3 q = closestPointOn(i, p);
+      double d = norm(q - p);
+      if (d < bestDist) {
+        bestDist = d;
+        best = q;
+      }
+    };
+    for (size_t i : centroidFinder->kNearest(p, std::min<size_t>(8, primitives.size()))) consider(i);
+    for (size_t i : centroidFinder->radiusSearch(p, bestDist + maxRadius)) consider(i);
+    return best;
+  }
+
+private:
+  Vector3 closestPointOn(size_t i, Vector3 p) const {
+    const std::array<Vector3, 3>& t = primitives[i];
+    if (segments) return t[0] + pointLineSegmentNeaestLocation(p, t[0], t[1]) * (t[1] - t[0]);
+    return closestPointOnTriangle(p, t[0], t[1], t[2]);
+  }
+
+  std::vector<std::array<Vector3, 3>> primitives;
+  bool segments;
+  double maxRadius = 0.;
+  std::unique_ptr<NearestNeighborFinder> centroidFinder;
+};
+
+class Remesher {
+public:
+  Remesher(ManifoldSurfaceMesh& mesh_, VertexPositionGeometry& geo_, const RemeshOptions& options_,
+           MutationManager& mm_)
+      : mesh(mesh_), geo(geo_), pos(geo_.inputVertexPositions), options(options_), mm(mm_), target(mesh_),
+        constrained(mesh_, false), frozen(mesh_, false) {
+
+    for (Face f : mesh.faces()) {
+      if (f.degree() != 3) throw std::runtime_error("remeshing requires a triangle mesh");
+    }
+    if (mesh.nEdges() == 0) throw std::runtime_error("cannot remesh an empty mesh");
+
+    baseLength = options.targetEdgeLength;
+    if (!(baseLength > 0.)) {
+      double sum = 0.;
+      for (Edge e : mesh.edges()) sum += edgeLength(e);
+      baseLength = sum / mesh.nEdges();
+    }
+
+    // Boundary and feature edges
+    mesh.compress();
+    parallelFor(0, mesh.nEdges(), [&](size_t iE) {
+      Edge e = mesh.edge(iE);
+      if (e.isBoundary()) {
+        constrained[e] = true;
+        return;
+      }
+      Halfedge he = e.halfedge();
+      Vector3 n1 = faceNormal(he);
+      Vector3 n2 = faceNormal(he.twin());
+      double angle = std::acos(clamp(dot(n1, n2) / (norm(n1) * norm(n2)), -1., 1.));
+      constrained[e] = angle > options.featureAngle;
+    });
+
+    // Vertices which can't move: where feature lines end, meet, or turn sharply, or all of the boundary if it is fixed
+    bool fixBoundary = options.boundaryCondition == RemeshBoundaryCondition::Fixed;
+    parallelFor(0, mesh.nVertices(), [&](size_t iV) {
+      Vertex v = mesh.vertex(iV);
+      if (fixBoundary && v.isBoundary()) {
+        frozen[v] = true;
+        return;
+      }
+      std::vector<Vertex> along = constrainedNeighbors(v);
+      if (along.size() == 0) return;
+      if (along.size() != 2) {
+        frozen[v] = true;
+        return;
+      }
+      Vector3 dIn = unit(pos[v] - pos[along[0]]);
+      Vector3 dOut = unit(pos[along[1]] - pos[v]);
+      frozen[v] = std::acos(clamp(dot(dIn, dOut), -1., 1.)) > options.featureAngle;
+    });
+
+    // Relaxed vertices are projected back onto a copy of the input surface, or of its feature lines
+    std::vector<std::array<Vector3, 3>> triangles;
+    std::vector<std::array<Vector3, 3>> segments;
+    for (Face f : mesh.faces()) {
+      Halfedge he = f.halfedge();
+      triangles.push_back({{pos[he.vertex()], pos[he.next().vertex()], pos[he.next().next().vertex()]}});
+    }
+    for (Edge e : mesh.edges()) {
+      if (!constrained[e]) continue;
+      Vector3 pA = pos[e.halfedge().tailVertex()];
+      Vector3 pB = pos[e.halfedge().tipVertex()];
+      segments.push_back({{pA, pB, pB}});
+    }
+    inputSurface.reset(new ClosestPointFinder(std::move(triangles), false));
+    inputFeatures.reset(new ClosestPointFinder(std::move(segments), true));
+  }
+
+  ManifoldSurfaceMesh& mesh;
+  VertexPositionGeometry& geo;
+  VertexData<Vector3>& pos;
+  const RemeshOptions& options;
+  MutationManager& mm;
+
+  double baseLength;
+  VertexData<double> target;
+  EdgeData<char> constrained; // boundary and feature edges
+  VertexData<char> frozen;
+  std::unique_ptr<ClosestPointFinder> inputSurface;
+  std::unique_ptr<ClosestPointFinder> inputFeatures;
+
+  void run() {
+    for (size_t iIter = 0; iIter < options.maxIterations; iIter++) {
+      mesh.compress();
+      computeTargetLengths();
+      splitLongEdges();
+      collapseShortEdges();
+      flipToEvenDegrees();
+      relax();
+    }
+    mesh.compress();
+    geo.refreshQuantities();
+  }
+
+  // ======================================================
+  // ======== Helpers
+  // ======================================================
+
+  double edgeLength(Edge e) const { return norm(pos[e.halfedge().tipVertex()] - pos[e.halfedge().tailVertex()]); }
+  double edgeTarget(Edge e) const {
+    return 0.5 * (target[e.halfedge().tailVertex()] + target[e.halfedge().tipVertex()]);
+  }
+
+  // (not normalized) normal of the face of the halfedge
+  Vector3 faceNormal(Halfedge he) const {
+    Vector3 pA = pos[he.vertex()];
+    Vector3 pB = pos[he.next().vertex()];
+    Vector3 pC = pos[he.next().next().vertex()];
+    return cross(pB - pA, pC - pA);
+  }
+
+  std::vector<Vertex> constrainedNeighbors(Vertex v) const {
+    std::vector<Vertex> result;
+    for (Halfedge he : v.outgoingHalfedges()) {
+      if (constrained[he.edge()]) result.push_back(he.tipVertex());
+    }
+    return result;
+  }
+
+  size_t constraintDegree(Vertex v) const {
+    size_t n = 0;
+    for (Edge e : v.adjacentEdges()) {
+      if (constrained[e]) n++;
+    }
+    return n;
+  }
+
+  bool isCorner(Vertex v) const {
+    if (frozen[v]) return true;
+    size_t d = constraintDegree(v);
+    return d != 0 && d != 2;
+  }
+
+  // ======================================================
+  // ======== Passes
+  // ======================================================
+
+  void computeTargetLengths() {
+    if (!(options.curvatureAdaptation > 0.)) {
+      target.fill(baseLength);
+      return;
+    }
+
+    // Principal curvatures of the current mesh. These are computed on a scratch geometry, so that only they and the
+    // quantities they depend on are evaluated, rather than refreshing everything required of `geo`.
+    VertexPositionGeometry curvGeo(mesh, pos);
+    curvGeo.requireVertexMinPrincipalCurvatures();
+    curvGeo.requireVertexMaxPrincipalCurvatures();
+
+    double minLength = options.minRelativeLength * baseLength;
+    VertexData<double> raw(mesh);
+    parallelFor(0, mesh.nVertices(), [&](size_t iV) {
+      Vertex v = mesh.vertex(iV);
+      double kappa = std::max(std::abs(curvGeo.vertexMinPrincipalCurvatures[v]),
+                              std::abs(curvGeo.vertexMaxPrincipalCurvatures[v]));
+      if (!std::isfinite(kappa)) kappa = 0.; // (vertices with no area)
+      raw[v] = std::max(minLength, baseLength / (1. + options.curvatureAdaptation * baseLength * kappa));
+    });
+
+    // Curvature estimates are noisy, smooth them a bit
+    parallelFor(0, mesh.nVertices(), [&](size_t iV) {
+      Vertex v = mesh.vertex(iV);
+      double sum = raw[v];
+      double count = 1.;
+      for (Vertex w : v.adjacentVertices()) {
+        sum += raw[w];
+        count += 1.;
+      }
+      target[v] = sum / count;
+    });
+  }
+
+  void splitLongEdges() {
+    bool fixBoundary = options.boundaryCondition == RemeshBoundaryCondition::Fixed;
+
+    // Each pass at least halves the length of each long edge
+    for (int iPass = 0; iPass < 32; iPass++) {
+      std::vector<Edge> edges;
+      for (Edge e : mesh.edges()) edges.push_back(e);
+      std::vector<char> isLong(edges.size());
+      parallelFor(
+          0, edges.size(),
+          [&](size_t i) {
+            Edge e = edges[i];
+            isLong[i] = edgeLength(e) > splitRatio * edgeTarget(e) && !(fixBoundary && e.isBoundary());
+          },
+          256);
+
+      std::vector<std::pair<double, size_t>> toSplit;
+      for (size_t i = 0; i < edges.size(); i++) {
+        if (isLong[i]) toSplit.emplace_back(-edgeLength(edges[i]), edges[i].getIndex());
+      }
+      if (toSplit.empty()) break;
+      std::sort(toSplit.begin(), toSplit.end());
+
+      // Splitting one edge doesn't change any other, so these can all be split in turn
+      for (const std::pair<double, size_t>& s : toSplit) {
+        split(mesh.edge(s.second));
+      }
+    }
+  }
+
+  void split(Edge e) {
+    Vertex vA = e.halfedge().tailVertex();
+    Vertex vB = e.halfedge().tipVertex();
+    bool wasConstrained = constrained[e];
+    double newTarget = edgeTarget(e);
+
+    Halfedge he = mm.splitEdge(e, 0.5);
+    Vertex v = he.vertex();
+    target[v] = newTarget;
+    frozen[v] = false;
+    for (Halfedge heN : v.outgoingHalfedges()) {
+      Vertex w = heN.tipVertex();
+      constrained[heN.edge()] = wasConstrained && (w == vA || w == vB);
+    }
+  }
+
+  // Where to put the collapsed vertex, or false if the edge shouldn't be collapsed
+  bool planCollapse(Edge e, LocalOp& op) const {
+    if (mesh.nFaces() <= 4) return false;
+
+    Halfedge he = e.halfedge();
+    Vertex vA = he.tailVertex();
+    Vertex vB = he.tipVertex();
+    bool cornerA = isCorner(vA);
+    bool cornerB = isCorner(vB);
+    if (cornerA && cornerB) return false;
+
+    // Vertices on features and boundaries can only collapse along them, and must stay put if the other vertex isn't
+    // on them
+    Vector3 newPos = 0.5 * (pos[vA] + pos[vB]);
+    double newTarget = edgeTarget(e);
+    if (constrained[e]) {
+      // Would merge two different feature lines
+      for (Halfedge heS : {he, he.twin()}) {
+        if (heS.isInterior() && (constrained[heS.next().edge()] || constrained[heS.next().next().edge()])) {
+          return false;
+        }
+      }
+    } else {
+      size_t dA = constraintDegree(vA);
+      size_t dB = constraintDegree(vB);
+      if (dA > 0 && dB > 0) return false;
+      cornerA = cornerA || dA > 0;
+      cornerB = cornerB || dB > 0;
+    }
+    if (cornerA) {
+      newPos = pos[vA];
+      newTarget = target[vA];
+    } else if (cornerB) {
+      newPos = pos[vB];
+      newTarget = target[vB];
+    }
+
+    // Link condition: the only common neighbors of the endpoints are the tips of the adjacent triangles
+    size_t nCommon = 0;
+    for (Vertex wA : vA.adjacentVertices()) {
+      for (Vertex wB : vB.adjacentVertices()) {
+        if (wA == wB) nCommon++;
+      }
+    }
+    if (nCommon != (e.isBoundary() ? 1u : 2u)) return false;
+
+    // Don't create new long edges, or fold over any face
+    for (Vertex v : {vA, vB}) {
+      for (Halfedge heO : v.outgoingHalfedges()) {
+        Vertex w = heO.tipVertex();
+        if (w != vA && w != vB && norm(newPos - pos[w]) > splitRatio * 0.5 * (newTarget + target[w])) return false;
+
+        if (!heO.isInterior()) continue;
+        Vertex vN = heO.next().vertex();
+        Vertex vP = heO.next().next().vertex();
+        if (vN == vA || vN == vB || vP == vA || vP == vB) continue; // collapses away
+        Vector3 nBefore = faceNormal(heO);
+        Vector3 nAfter = cross(pos[vN] - newPos, pos[vP] - newPos);
+        if (dot(nBefore, nAfter) <= 0.) return false;
+      }
+    }
+
+    op.newPos = newPos;
+    return true;
+  }
+
+  bool collapse(const LocalOp& op) {
+    Edge e = op.e;
+    Vertex vA = e.halfedge().tailVertex();
+    Vertex vB = e.halfedge().tipVertex();
+
+    // The collapse deletes edges, so remember which neighbors of the new vertex are along features
+    std::vector<Vertex> along;
+    for (Vertex v : {vA, vB}) {
+      for (Vertex w : constrainedNeighbors(v)) {
+        if (w != vA && w != vB) along.push_back(w);
+      }
+    }
+    bool newFrozen = frozen[vA] || frozen[vB];
+    double newTarget = op.newPos == pos[vA] ? target[vA] : op.newPos == pos[vB] ? target[vB] : edgeTarget(e);
+
+    Vertex v = mm.collapseEdge(e, op.newPos);
+    if (v == Vertex()) return false;
+    frozen[v] = newFrozen;
+    target[v] = newTarget;
+    for (Halfedge he : v.outgoingHalfedges()) {
+      constrained[he.edge()] = std::find(along.begin(), along.end(), he.tipVertex()) != along.end();
+    }
+    return true;
+  }
+
+  void collapseShortEdges() {
+    std::vector<Edge> edges;
+    std::vector<LocalOp> ops;
+    std::vector<char> valid;
+
+    while (true) {
+      edges.clear();
+      for (Edge e : mesh.edges()) edges.push_back(e);
+      std::vector<LocalOp> allOps(edges.size());
+      valid.assign(edges.size(), false);
+      parallelFor(
+          0, edges.size(),
+          [&](size_t i) {
+            Edge e = edges[i];
+            double len = edgeLength(e);
+            if (len >= collapseRatio * edgeTarget(e)) return;
+            LocalOp& op = allOps[i];
+            if (!planCollapse(e, op)) return;
+            op.e = e;
+            op.priority = len;
+            op.center = op.newPos;
+            for (Vertex v : {e.halfedge().tailVertex(), e.halfedge().tipVertex()}) {
+              op.region.push_back(v.getIndex());
+              for (Vertex w : v.adjacentVertices()) op.region.push_back(w.getIndex());
+            }
+            valid[i] = true;
+          },
+          256);
+
+      ops.clear();
+      for (size_t i = 0; i < edges.size(); i++) {
+        if (valid[i]) ops.push_back(std::move(allOps[i]));
+      }
+      if (ops.empty()) break;
+
+      // Mutations are not thread-safe, so the chosen collapses are applied one at a time. Their neighborhoods are
+      // disjoint, so they are all still valid.
+      bool anyCollapsed = false;
+      for (size_t i : chooseIndependent(ops, 4. * baseLength, mesh.nVerticesCapacity())) {
+        if (mesh.nFaces() <= 4) break;
+        anyCollapsed = collapse(ops[i]) || anyCollapsed;
+      }
+      if (!anyCollapsed) break;
+    }
+  }
+
+  // Improvement in the squared deviation of vertex degrees from ideal by flipping this edge, or 0 if it can't be
+  // flipped
+  double flipGain(Edge e) const {
+    if (constrained[e] || e.isBoundary()) return 0.;
+
+    Halfedge he = e.halfedge();
+    Vertex vA = he.tailVertex();
+    Vertex vB = he.tipVertex();
+    Vertex vC = he.next().next().vertex();
+    Vertex vD = he.twin().next().next().vertex();
+    if (vA.degree() <= 3 || vB.degree() <= 3) return 0.;
+    for (Vertex w : vC.adjacentVertices()) {
+      if (w == vD) return 0.; // the flipped edge already exists
+    }
+
+    auto deviation = [](Vertex v, int change) {
+      double ideal = v.isBoundary() ? 4. : 6.;
+      double d = static_cast<double>(v.degree()) + change - ideal;
+      return d * d;
+    };
+    double before = deviation(vA, 0) + deviation(vB, 0) + deviation(vC, 0) + deviation(vD, 0);
+    double after = deviation(vA, -1) + deviation(vB, -1) + deviation(vC, 1) + deviation(vD, 1);
+    if (after >= before) return 0.;
+
+    // Don't flip across a crease or create an inverted face
+    Vector3 pA = pos[vA], pB = pos[vB], pC = pos[vC], pD = pos[vD];
+    Vector3 n1 = cross(pD - pA, pC - pA);
+    Vector3 n2 = cross(pC - pB, pD - pB);
+    Vector3 nOld = faceNormal(he) + faceNormal(he.twin());
+    if (dot(n1, n2) <= 0. || dot(n1, nOld) <= 0. || dot(n2, nOld) <= 0.) return 0.;
+
+    return before - after;
+  }
+
+  void flipToEvenDegrees() {
+    std::vector<Edge> edges;
+    std::vector<LocalOp> ops;
+    std::vector<double> gains;
+
+    // Each flip strictly reduces the total deviation, so this terminates; the cap just bounds the work
+    for (int iRound = 0; iRound < 100; iRound++) {
+      edges.clear();
+      for (Edge e : mesh.edges()) edges.push_back(e);
+      gains.resize(edges.size());
+      parallelFor(0, edges.size(), [&](size_t i) { gains[i] = flipGain(edges[i]); }, 256);
+
+      ops.clear();
+      for (size_t i = 0; i < edges.size(); i++) {
+        if (gains[i] <= 0.) continue;
+        Halfedge he = edges[i].halfedge();
+        LocalOp op;
+        op.e = edges[i];
+        op.priority = -gains[i];
+        op.center = 0.5 * (pos[he.tailVertex()] + pos[he.tipVertex()]);
+        op.region = {he.tailVertex().getIndex(), he.tipVertex().getIndex(), he.next().next().vertex().getIndex(),
+                     he.twin().next().next().vertex().getIndex()};
+        ops.push_back(std::move(op));
+      }
+      if (ops.empty()) break;
+
+      bool anyFlipped = false;
+      for (size_t i : chooseIndependent(ops, 4. * baseLength, mesh.nVerticesCapacity())) {
+        anyFlipped = mm.flipEdge(ops[i].e) || anyFlipped;
+      }
+      if (!anyFlipped) break;
+    }
+  }
+
+  // Move each vertex towards the average of its neighbors, within its tangent plane (or along its feature line), then
+  // back onto the input surface (or its feature lines)
+  void relax() {
+    mesh.compress();
+    VertexData<Vector3> newPos(mesh);
+    parallelFor(
+        0, mesh.nVertices(),
+        [&](size_t iV) {
+          Vertex v = mesh.vertex(iV);
+          Vector3 p = pos[v];
+          newPos[v] = p;
+          if (isCorner(v)) return;
+
+          std::vector<Vertex> along = constrainedNeighbors(v);
+          if (along.size() == 2) {
+            Vector3 t = unit(pos[along[1]] - pos[along[0]]);
+            Vector3 c = 0.5 * (pos[along[0]] + pos[along[1]]);
+            newPos[v] = inputFeatures->closestPoint(p + dot(c - p, t) * t);
+            return;
+          }
+
+          Vector3 c = Vector3::zero();
+          Vector3 n = Vector3::zero();
+          double count = 0.;
+          for (Halfedge he : v.outgoingHalfedges()) {
+            c += pos[he.tipVertex()];
+            count += 1.;
+            if (he.isInterior()) n += faceNormal(he);
+          }
+          c /= count;
+          if (norm(n) == 0.) return;
+          n = unit(n);
+          Vector3 d = c - p;
+          newPos[v] = inputSurface->closestPoint(p + d - dot(d, n) * n);
+        },
+        256);
+
+    for (Vertex v : mesh.vertices()) {
+      if (newPos[v] != pos[v]) mm.repositionVertex(v, newPos[v] - pos[v]);
+    }
+  }
+};
+
+} // namespace
+
+void remesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, const RemeshOptions& options) {
+  MutationManager mm(mesh, geo);
+  remesh(mesh, geo, options, mm);
+}
+
+void remesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, const RemeshOptions& options,
+            MutationManager& mm) {
+  Remesher remesher(mesh, geo, options, mm);
+  remesher.run();
+}
+
+} // namespace surface
+} // namespace geometrycentral
@@ -1,18 +1,25 @@
 #include "geometrycentral/surface/simple_idt.h"
 
 #include "geometrycentral/utilities/elementary_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include <deque>
 
 namespace geometrycentral {
 namespace surface {
 
+namespace {
 
-size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType flipType, double delaunayEPS) {
+// Geometric predicates shared by the serial and parallel flip routines. All of these only read edge lengths, so they
+// may be evaluated concurrently as long as nobody is modifying the mesh.
+struct DelaunayFlipHelper {
+  EdgeData<double>& edgeLengths;
+  FlipType flipType;
+  double delaunayEPS;
 
   // TODO all of these helpers are duplicated from signpost_intrinsic_triangulation
 
-  auto flippedEdgeLen = [&](Halfedge iHe) {
+  double flippedEdgeLen(Halfedge iHe) const {
     // Gather index values
     Halfedge iHeA0 = iHe;
     Halfedge iHeA1 = iHeA0.next();
@@ -51,9 +58,9 @@ size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType
     }
     }
     return -1.; // unreachable
-  };
+  }
 
-  auto area = [&](Face f) {
+  double area(Face f) const {
     Halfedge he = f.halfedge();
     double a = edgeLengths[he.edge()];
     he = he.next();
@@ -61,9 +68,9 @@ size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType
     he = he.next();
     double c = edgeLengths[he.edge()];
     return triangleArea(a, b, c);
-  };
+  }
 
-  auto halfedgeCotanWeight = [&](Halfedge heI) {
+  double halfedgeCotanWeight(Halfedge heI) const {
     if (heI.isInterior()) {
       Halfedge he = heI;
       double l_ij = edgeLengths[he.edge()];
@@ -79,14 +86,14 @@ size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType
     } else {
       return 0.;
     }
-  };
+  }
 
-  auto edgeCotanWeight = [&](Edge e) {
+  double edgeCotanWeight(Edge e) const {
     return halfedgeCotanWeight(e.halfedge()) + halfedgeCotanWeight(e.halfedge().twin());
-  };
+  }
 
 
-  auto shouldFlipEdge = [&](Edge e) {
+  bool shouldFlipEdge(Edge e) const {
     if (e.isBoundary()) return false;
 
     switch (flipType) {
@@ -114,20 +121,26 @@ size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType
     }
     }
     return false; // unreachable
-  };
+  }
+};
+
+} // namespace
+
+size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType flipType, double delaunayEPS) {
+
+  DelaunayFlipHelper helper{edgeLengths, flipType, delaunayEPS};
 
   auto flipEdgeIfNotDelaunay = [&](Edge e) {
     // Can't flip
-    //if (e.isBoundary()) return false;
-    if (e.isBoundary()) throw std::runtime_error("boundary");
+    if (e.isBoundary()) return false;
     if (!e.isManifold()) throw std::runtime_error("nonmanifold");
 
     // Don't want to flip
-    if (!shouldFlipEdge(e)) return false;
+    if (!helper.shouldFlipEdge(e)) return false;
 
     // Get geometric data
     Halfedge he = e.halfedge();
-    double newLength = flippedEdgeLen(he);
+    double newLength = helper.flippedEdgeLen(he);
 
     // If we're going to create a non-finite edge length, abort the flip
     // (only happens if you're in a bad numerical place)
@@ -188,5 +201,88 @@ size_t flipToDelaunay(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType
   return nFlips;
 }
 
+size_t flipToDelaunayParallel(SurfaceMesh& mesh, EdgeData<double>& edgeLengths, FlipType flipType,
+                              double delaunayEPS) {
+
+  DelaunayFlipHelper helper{edgeLengths, flipType, delaunayEPS};
+
+  // Edges which might be non-Delaunay, deduplicated by stamping each edge with the round it was last queued in
+  std::vector<Edge> candidates;
+  EdgeData<size_t> queuedRound(mesh, 0);
+  for (Edge e : mesh.edges()) {
+    if (!e.isManifold()) throw std::runtime_error("nonmanifold");
+    candidates.push_back(e);
+  }
+
+  std::vector<char> needsFlip;
+  std::vector<Edge> batch;
+  std::vector<double> newLengths;
+  std::vector<Edge> nextCandidates;
+  FaceData<size_t> claimedRound(mesh, 0);
+
+  size_t nFlips = 0;
+  size_t iRound = 0;
+  while (!candidates.empty()) {
+    iRound++;
+
+    // Test the Delaunay condition on all candidates concurrently
+    needsFlip.assign(candidates.size(), false);
+    parallelFor(
+        0, candidates.size(), [&](size_t i) { needsFlip[i] = helper.shouldFlipEdge(candidates[i]); }, 256);
+
+    // Greedily pick a batch of non-Delaunay edges which share no triangles. Flipping one of them only changes its own
+    // two faces, so the new lengths of the whole batch can be computed from the current state. Edges which conflict
+    // with the batch are deferred to the next round.
+    batch.clear();
+    nextCandidates.clear();
+    for (size_t i = 0; i < candidates.size(); i++) {
+      if (!needsFlip[i]) continue;
+      Edge e = candidates[i];
+      Face fA = e.halfedge().face();
+      Face fB = e.halfedge().twin().face();
+      if (claimedRound[fA] == iRound || claimedRound[fB] == iRound) {
+        nextCandidates.push_back(e);
+        queuedRound[e] = iRound;
+        continue;
+      }
+      claimedRound[fA] = iRound;
+      claimedRound[fB] = iRound;
+      batch.push_back(e);
+    }
+
+    // Compute the flipped lengths concurrently
+    newLengths.resize(batch.size());
+    parallelFor(
+        0, batch.size(), [&](size_t i) { newLengths[i] = helper.flippedEdgeLen(batch[i].halfedge()); }, 256);
+
+    // Apply the combinatorial flips. This part is serial, since flips on distinct triangles may still update the
+    // connectivity of a shared vertex.
+    for (size_t i = 0; i < batch.size(); i++) {
+      Edge e = batch[i];
+
+      // If we're going to create a non-finite edge length, skip the flip (only happens in a bad numerical place)
+      if (!std::isfinite(newLengths[i])) continue;
+      if (!mesh.flip(e, false)) continue;
+      edgeLengths[e] = newLengths[i];
+      nFlips++;
+
+      // Neighbors may need flipping now
+      Halfedge he = e.halfedge();
+      Halfedge heN = he.next();
+      Halfedge heTN = he.twin().next();
+      for (Edge nE : {heN.edge(), heN.next().edge(), heTN.edge(), heTN.next().edge()}) {
+        if (queuedRound[nE] != iRound) {
+          nextCandidates.push_back(nE);
+          queuedRound[nE] = iRound;
+        }
+      }
+    }
+
+    std::swap(candidates, nextCandidates);
+  }
+
+  return nFlips;
+}
+
 } // namespace surface
 } // namespace geometrycentral
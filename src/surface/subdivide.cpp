@@ -1,5 +1,10 @@
 #include "geometrycentral/surface/subdivide.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
+#include <array>
+#include <stdexcept>
+
 namespace geometrycentral {
 namespace surface {
 
@@ -251,5 +256,408 @@ void loopSubdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, Mutat
   geo.refreshQuantities();
 }
 
+// Declared as a friend of ManifoldSurfaceMesh, so that refined meshes can be built directly from halfedge arrays
+std::unique_ptr<ManifoldSurfaceMesh> subdivisionMeshFromArrays(const std::vector<size_t>& heNext,
+                                                               const std::vector<size_t>& heVertex,
+                                                               const std::vector<size_t>& heFace,
+                                                               const std::vector<size_t>& vHalfedge,
+                                                               const std::vector<size_t>& fHalfedge,
+                                                               size_t nBoundaryLoops) {
+  return std::unique_ptr<ManifoldSurfaceMesh>(
+      new ManifoldSurfaceMesh(heNext, heVertex, heFace, vHalfedge, fHalfedge, nBoundaryLoops));
+}
+
+namespace {
+
+// A polygon mesh as flat arrays with explicit edges; enough to evaluate stencils and to derive the next level
+struct SubdivisionLevel {
+  size_t nVertices = 0;
+  std::vector<size_t> faceStart;    // the corners of face f are [faceStart[f], faceStart[f+1])
+  std::vector<size_t> cornerVertex; //
+  std::vector<size_t> cornerFace;   //
+  std::vector<size_t> cornerEdge;   // the edge from this corner to the next one in its face
+  std::vector<std::array<size_t, 2>> edgeVertices;
+  std::vector<std::array<size_t, 2>> edgeCorners; // corners whose edge this is; the second is INVALID_IND on boundary
+  std::vector<char> edgeIsSharp;                  // boundary or crease
+  std::vector<Vector3> positions;
+
+  size_t nFaces() const { return faceStart.size() - 1; }
+  size_t nEdges() const { return edgeVertices.size(); }
+  size_t nCorners() const { return cornerVertex.size(); }
+
+  size_t next(size_t c) const {
+    size_t f = cornerFace[c];
+    return c + 1 == faceStart[f + 1] ? faceStart[f] : c + 1;
+  }
+  size_t prev(size_t c) const {
+    size_t f = cornerFace[c];
+    return c == faceStart[f] ? faceStart[f + 1] - 1 : c - 1;
+  }
+
+  // Edge e is split in two; child 2e contains its first vertex and child 2e+1 its second
+  size_t childEdge(size_t e, size_t v) const { return edgeVertices[e][0] == v ? 2 * e : 2 * e + 1; }
+
+  void resize(size_t nV, size_t nF, size_t nC, size_t nE) {
+    nVertices = nV;
+    faceStart.resize(nF + 1);
+    cornerVertex.resize(nC);
+    cornerFace.resize(nC);
+    cornerEdge.resize(nC);
+    edgeVertices.resize(nE);
+    edgeCorners.resize(nE);
+    edgeIsSharp.resize(nE);
+    positions.resize(nV);
+  }
+  void setCorner(size_t c, size_t v, size_t f, size_t e) {
+    cornerVertex[c] = v;
+    cornerFace[c] = f;
+    cornerEdge[c] = e;
+  }
+
+  // The halfedge along corner c's edge in its face; halfedge 2e runs from the first vertex of edge e to the second
+  size_t cornerHalfedge(size_t c) const {
+    size_t e = cornerEdge[c];
+    return edgeVertices[e][0] == cornerVertex[c] ? 2 * e : 2 * e + 1;
+  }
+
+  std::unique_ptr<ManifoldSurfaceMesh> buildMesh() const;
+};
+
+// Fill in the halfedge arrays directly, rather than matching up halfedges by their vertices
+std::unique_ptr<ManifoldSurfaceMesh> SubdivisionLevel::buildMesh() const {
+  size_t nF = nFaces();
+  std::vector<size_t> heNext(2 * nEdges(), INVALID_IND);
+  std::vector<size_t> heVertex(2 * nEdges());
+  std::vector<size_t> heFace(2 * nEdges(), INVALID_IND);
+  std::vector<size_t> vHalfedge(nVertices, INVALID_IND);
+  std::vector<size_t> fHalfedge(nF);
+
+  parallelFor(0, nEdges(), [&](size_t e) {
+    heVertex[2 * e] = edgeVertices[e][0];
+    heVertex[2 * e + 1] = edgeVertices[e][1];
+  });
+  parallelFor(0, nF, [&](size_t f) {
+    fHalfedge[f] = cornerHalfedge(faceStart[f]);
+    for (size_t c = faceStart[f]; c < faceStart[f + 1]; c++) {
+      size_t he = cornerHalfedge(c);
+      heNext[he] = cornerHalfedge(next(c));
+      heFace[he] = f;
+    }
+  });
+  for (size_t c = 0; c < nCorners(); c++) {
+    vHalfedge[cornerVertex[c]] = cornerHalfedge(c);
+  }
+
+  // Boundary vertices point to the interior halfedge along the boundary, and each starts one exterior halfedge
+  std::vector<size_t> boundaryHalfedges;
+  for (size_t e = 0; e < nEdges(); e++) {
+    if (edgeCorners[e][1] != INVALID_IND) continue;
+    size_t he = cornerHalfedge(edgeCorners[e][0]);
+    vHalfedge[heVertex[he]] = he;
+    boundaryHalfedges.push_back(he ^ 1);
+  }
+  std::vector<size_t> exteriorOut(nVertices, INVALID_IND);
+  for (size_t he : boundaryHalfedges) {
+    exteriorOut[heVertex[he]] = he;
+  }
+  for (size_t he : boundaryHalfedges) {
+    heNext[he] = exteriorOut[heVertex[he ^ 1]];
+  }
+
+  // Walk the boundary loops
+  for (size_t he : boundaryHalfedges) {
+    if (heFace[he] != INVALID_IND) continue;
+    size_t loop = fHalfedge.size();
+    fHalfedge.push_back(he);
+    size_t curr = he;
+    do {
+      heFace[curr] = loop;
+      curr = heNext[curr];
+    } while (curr != he);
+  }
+
+  return subdivisionMeshFromArrays(heNext, heVertex, heFace, vHalfedge, fHalfedge, fHalfedge.size() - nF);
+}
+
+SubdivisionLevel levelFromMesh(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, const EdgeData<char>& creases) {
+  VertexData<size_t> vInd = mesh.getVertexIndices();
+  EdgeData<size_t> eInd = mesh.getEdgeIndices();
+
+  SubdivisionLevel L;
+  L.nVertices = mesh.nVertices();
+  L.positions.resize(mesh.nVertices());
+  for (Vertex v : mesh.vertices()) {
+    L.positions[vInd[v]] = geo.inputVertexPositions[v];
+  }
+
+  L.edgeVertices.resize(mesh.nEdges());
+  L.edgeCorners.resize(mesh.nEdges(), {{INVALID_IND, INVALID_IND}});
+  L.edgeIsSharp.resize(mesh.nEdges());
+  for (Edge e : mesh.edges()) {
+    L.edgeVertices[eInd[e]] = {{vInd[e.halfedge().tailVertex()], vInd[e.halfedge().tipVertex()]}};
+    L.edgeIsSharp[eInd[e]] = e.isBoundary() || (creases.size() > 0 && creases[e]);
+  }
+
+  L.faceStart.push_back(0);
+  for (Face f : mesh.faces()) {
+    size_t iF = L.faceStart.size() - 1;
+    for (Halfedge he : f.adjacentHalfedges()) {
+      size_t c = L.cornerVertex.size();
+      size_t e = eInd[he.edge()];
+      L.cornerVertex.push_back(vInd[he.tailVertex()]);
+      L.cornerFace.push_back(iF);
+      L.cornerEdge.push_back(e);
+      L.edgeCorners[e][L.edgeCorners[e][0] == INVALID_IND ? 0 : 1] = c;
+    }
+    L.faceStart.push_back(L.cornerVertex.size());
+  }
+
+  return L;
+}
+
+// The halves of each parent edge, given where the corners of parent corner c land in the children: the child corner
+// starting the half at c's vertex, and the one ending at the next vertex.
+template <typename F>
+void refineEdgeHalves(const SubdivisionLevel& L, SubdivisionLevel& C, F childCorners) {
+  size_t nV = L.nVertices;
+  parallelFor(0, L.nEdges(), [&](size_t e) {
+    size_t a = L.edgeVertices[e][0];
+    size_t b = L.edgeVertices[e][1];
+    C.edgeVertices[2 * e] = {{a, nV + e}};
+    C.edgeVertices[2 * e + 1] = {{nV + e, b}};
+    C.edgeIsSharp[2 * e] = C.edgeIsSharp[2 * e + 1] = L.edgeIsSharp[e];
+    C.edgeCorners[2 * e] = C.edgeCorners[2 * e + 1] = {{INVALID_IND, INVALID_IND}};
+    for (size_t s = 0; s < 2; s++) {
+      size_t c = L.edgeCorners[e][s];
+      if (c == INVALID_IND) continue;
+      std::array<size_t, 2> children = childCorners(c);
+      C.edgeCorners[L.childEdge(e, L.cornerVertex[c])][s] = children[0];
+      C.edgeCorners[L.childEdge(e, L.cornerVertex[L.next(c)])][s] = children[1];
+    }
+  });
+}
+
+// Split each triangle into four: one child at each corner, numbered by corner, then one in the middle
+SubdivisionLevel refineTriangles(const SubdivisionLevel& L) {
+  size_t nV = L.nVertices;
+  size_t nE = L.nEdges();
+  size_t nF = L.nFaces();
+  size_t nC = L.nCorners();
+
+  SubdivisionLevel C;
+  C.resize(nV + nE, 4 * nF, 4 * nC, 2 * nE + nC);
+  parallelFor(0, 4 * nF + 1, [&](size_t f) { C.faceStart[f] = 3 * f; });
+
+  parallelFor(0, nF, [&](size_t f) {
+    size_t first = L.faceStart[f];
+    size_t fMid = nC + f;
+    for (size_t i = 0; i < 3; i++) {
+      size_t c = first + i;
+      size_t v = L.cornerVertex[c];
+      size_t eNext = L.cornerEdge[c];
+      size_t ePrev = L.cornerEdge[first + (i + 2) % 3];
+
+      // Corner child (v, E_next, E_prev); the new edge between E_next and E_prev is numbered 2nE + c
+      C.setCorner(3 * c + 0, v, c, L.childEdge(eNext, v));
+      C.setCorner(3 * c + 1, nV + eNext, c, 2 * nE + c);
+      C.setCorner(3 * c + 2, nV + ePrev, c, L.childEdge(ePrev, v));
+
+      // Middle child, whose corner i sits on E_next; its edge from there is opposite the next corner
+      C.setCorner(3 * fMid + i, nV + eNext, fMid, 2 * nE + first + (i + 1) % 3);
+
+      C.edgeVertices[2 * nE + c] = {{nV + eNext, nV + ePrev}};
+      C.edgeCorners[2 * nE + c] = {{3 * c + 1, 3 * fMid + (i + 2) % 3}};
+      C.edgeIsSharp[2 * nE + c] = false;
+    }
+  });
+
+  refineEdgeHalves(L, C, [&](size_t c) { return std::array<size_t, 2>{{3 * c, 3 * L.next(c) + 2}}; });
+  return C;
+}
+
+// Split each face into quads: one per corner, (v, E_next, F, E_prev), numbered by corner
+SubdivisionLevel refineQuads(const SubdivisionLevel& L) {
+  size_t nV = L.nVertices;
+  size_t nE = L.nEdges();
+  size_t nF = L.nFaces();
+  size_t nC = L.nCorners();
+
+  SubdivisionLevel C;
+  C.resize(nV + nE + nF, nC, 4 * nC, 2 * nE + nC);
+  parallelFor(0, nC + 1, [&](size_t f) { C.faceStart[f] = 4 * f; });
+
+  parallelFor(0, nF, [&](size_t f) {
+    for (size_t c = L.faceStart[f]; c < L.faceStart[f + 1]; c++) {
+      size_t v = L.cornerVertex[c];
+      size_t eNext = L.cornerEdge[c];
+      size_t ePrev = L.cornerEdge[L.prev(c)];
+
+      // The new edge between E_next and F is numbered 2nE + c
+      C.setCorner(4 * c + 0, v, c, L.childEdge(eNext, v));
+      C.setCorner(4 * c + 1, nV + eNext, c, 2 * nE + c);
+      C.setCorner(4 * c + 2, nV + nE + f, c, 2 * nE + L.prev(c));
+      C.setCorner(4 * c + 3, nV + ePrev, c, L.childEdge(ePrev, v));
+
+      C.edgeVertices[2 * nE + c] = {{nV + eNext, nV + nE + f}};
+      C.edgeCorners[2 * nE + c] = {{4 * c + 1, 4 * L.next(c) + 2}};
+      C.edgeIsSharp[2 * nE + c] = false;
+    }
+  });
+
+  refineEdgeHalves(L, C, [&](size_t c) { return std::array<size_t, 2>{{4 * c, 4 * L.next(c) + 3}}; });
+  return C;
+}
+
+// Incident edges of each vertex, as a compressed list
+void buildVertexEdges(const SubdivisionLevel& L, std::vector<size_t>& start, std::vector<size_t>& edges) {
+  start.assign(L.nVertices + 1, 0);
+  for (const std::array<size_t, 2>& ends : L.edgeVertices) {
+    start[ends[0] + 1]++;
+    start[ends[1] + 1]++;
+  }
+  for (size_t i = 0; i < L.nVertices; i++) {
+    start[i + 1] += start[i];
+  }
+  std::vector<size_t> fill(start.begin(), start.end() - 1);
+  edges.resize(start.back());
+  for (size_t e = 0; e < L.nEdges(); e++) {
+    edges[fill[L.edgeVertices[e][0]]++] = e;
+    edges[fill[L.edgeVertices[e][1]]++] = e;
+  }
+}
+
+// The crease rule for a vertex on sharp edges. Returns false if the smooth rule applies instead.
+bool creaseVertexRule(const SubdivisionLevel& L, size_t v, const size_t* edges, size_t n, Vector3& result) {
+  size_t nSharp = 0;
+  Vector3 sharpSum = Vector3::zero();
+  for (size_t i = 0; i < n; i++) {
+    size_t e = edges[i];
+    if (!L.edgeIsSharp[e]) continue;
+    nSharp++;
+    size_t w = L.edgeVertices[e][0] == v ? L.edgeVertices[e][1] : L.edgeVertices[e][0];
+    sharpSum += L.positions[w];
+  }
+  if (nSharp < 2) return false;
+  result = nSharp == 2 ? 0.75 * L.positions[v] + 0.125 * sharpSum : L.positions[v];
+  return true;
+}
+
+void loopPositions(const SubdivisionLevel& L, SubdivisionLevel& C) {
+  size_t nV = L.nVertices;
+  std::vector<size_t> vStart, vEdges;
+  buildVertexEdges(L, vStart, vEdges);
+
+  parallelFor(0, nV, [&](size_t v) {
+    const size_t* edges = vEdges.data() + vStart[v];
+    size_t n = vStart[v + 1] - vStart[v];
+    if (creaseVertexRule(L, v, edges, n, C.positions[v])) return;
+
+    double u = (n == 3) ? 3. / 16. : 3. / (8. * n);
+    Vector3 p = (1. - n * u) * L.positions[v];
+    for (size_t i = 0; i < n; i++) {
+      const std::array<size_t, 2>& ends = L.edgeVertices[edges[i]];
+      p += u * L.positions[ends[0] == v ? ends[1] : ends[0]];
+    }
+    C.positions[v] = p;
+  });
+
+  parallelFor(0, L.nEdges(), [&](size_t e) {
+    Vector3 mid = L.positions[L.edgeVertices[e][0]] + L.positions[L.edgeVertices[e][1]];
+    if (L.edgeIsSharp[e]) {
+      C.positions[nV + e] = mid / 2.;
+      return;
+    }
+    Vector3 sides = L.positions[L.cornerVertex[L.prev(L.edgeCorners[e][0])]] +
+                    L.positions[L.cornerVertex[L.prev(L.edgeCorners[e][1])]];
+    C.positions[nV + e] = 3. / 8. * mid + 1. / 8. * sides;
+  });
+}
+
+void catmullClarkPositions(const SubdivisionLevel& L, SubdivisionLevel& C, bool linear) {
+  size_t nV = L.nVertices;
+  size_t nE = L.nEdges();
+  const Vector3* facePoints = C.positions.data() + nV + nE;
+
+  parallelFor(0, L.nFaces(), [&](size_t f) {
+    Vector3 p = Vector3::zero();
+    for (size_t c = L.faceStart[f]; c < L.faceStart[f + 1]; c++) {
+      p += L.positions[L.cornerVertex[c]];
+    }
+    C.positions[nV + nE + f] = p / (double)(L.faceStart[f + 1] - L.faceStart[f]);
+  });
+
+  parallelFor(0, nE, [&](size_t e) {
+    Vector3 mid = L.positions[L.edgeVertices[e][0]] + L.positions[L.edgeVertices[e][1]];
+    if (linear || L.edgeIsSharp[e]) {
+      C.positions[nV + e] = mid / 2.;
+      return;
+    }
+    Vector3 faces = facePoints[L.cornerFace[L.edgeCorners[e][0]]] + facePoints[L.cornerFace[L.edgeCorners[e][1]]];
+    C.positions[nV + e] = (mid + faces) / 4.;
+  });
+
+  if (linear) {
+    parallelFor(0, nV, [&](size_t v) { C.positions[v] = L.positions[v]; });
+    return;
+  }
+
+  std::vector<size_t> vStart, vEdges;
+  buildVertexEdges(L, vStart, vEdges);
+  parallelFor(0, nV, [&](size_t v) {
+    const size_t* edges = vEdges.data() + vStart[v];
+    size_t n = vStart[v + 1] - vStart[v];
+    if (creaseVertexRule(L, v, edges, n, C.positions[v])) return;
+
+    // Away from sharp edges each incident face contains two incident edges, so summing the faces of the edges counts
+    // each face twice
+    Vector3 S = L.positions[v];
+    Vector3 Q = Vector3::zero();
+    Vector3 R = Vector3::zero();
+    for (size_t i = 0; i < n; i++) {
+      size_t e = edges[i];
+      R += L.positions[L.edgeVertices[e][0]] + L.positions[L.edgeVertices[e][1]];
+      Q += facePoints[L.cornerFace[L.edgeCorners[e][0]]] + facePoints[L.cornerFace[L.edgeCorners[e][1]]];
+    }
+    double D = (double)n;
+    Q /= 2. * D;
+    R /= 2. * D;
+    C.positions[v] = (Q + 2. * R + (D - 3.) * S) / D;
+  });
+}
+
+} // namespace
+
+std::tuple<std::unique_ptr<ManifoldSurfaceMesh>, std::unique_ptr<VertexPositionGeometry>>
+subdivide(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geo, SubdivisionScheme scheme,
+          const SubdivisionOptions& options) {
+  if (scheme == SubdivisionScheme::Loop && !mesh.isTriangular()) {
+    throw std::runtime_error("Cannot run loop subdivision on a mesh with non-triangular faces");
+  }
+  if (options.creases.size() > 0 && options.creases.getMesh() != &mesh) {
+    throw std::runtime_error("crease edges must be defined on the mesh being subdivided");
+  }
+
+  SubdivisionLevel level = levelFromMesh(mesh, geo, options.creases);
+  for (size_t iLevel = 0; iLevel < options.levels; iLevel++) {
+    SubdivisionLevel child;
+    if (scheme == SubdivisionScheme::Loop) {
+      child = refineTriangles(level);
+      loopPositions(level, child);
+    } else {
+      child = refineQuads(level);
+      catmullClarkPositions(level, child, scheme == SubdivisionScheme::Linear);
+    }
+    level = std::move(child);
+  }
+
+  std::unique_ptr<ManifoldSurfaceMesh> newMesh = level.buildMesh();
+  std::unique_ptr<VertexPositionGeometry> newGeo(new VertexPositionGeometry(*newMesh));
+  for (Vertex v : newMesh->vertices()) {
+    newGeo->inputVertexPositions[v] = level.positions[v.getIndex()];
+  }
+
+  return std::make_tuple(std::move(newMesh), std::move(newGeo));
+}
+
 } // namespace surface
 } // namespace geometrycentral
@@ -4,65 +4,50 @@
 #include "geometrycentral/surface/vector_heat_method.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
 
+#include "geometrycentral/utilities/parallel.h"
 #include "geometrycentral/utilities/utilities.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace geometrycentral {
 namespace surface {
 
+namespace {
 
-SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, const std::vector<Vertex>& vertexPts, int p) {
-  VertexData<double> dist(geom.mesh, 0.);
-  for (Vertex v : vertexPts) {
-    dist[v] += 1.;
-  }
+// The nonzero entries of a distribution, as (vertex index, value)
+typedef std::vector<std::pair<size_t, double>> DistributionSupport;
 
-  // Forward to the general version
-  return findCenter(mesh, geom, dist, p);
-}
-
-SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, VectorHeatMethodSolver& solver,
-                        const std::vector<Vertex>& vertexPts, int p) {
-  VertexData<double> dist(geom.mesh, 0.);
-  for (Vertex v : vertexPts) {
-    dist[v] += 1.;
+// The nonzero entries of a distribution. Requires vertex indices.
+DistributionSupport supportOf(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                              const VertexData<double>& distribution) {
+  DistributionSupport support;
+  for (Vertex v : mesh.vertices()) {
+    double w = distribution[v];
+    if (w != 0.) support.emplace_back(geom.vertexIndices[v], w);
   }
-
-  // Forward to the general version
-  return findCenter(mesh, geom, solver, dist, p);
-}
-
-SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, const VertexData<double>& distribution, int p) {
-  VectorHeatMethodSolver solver(geom);
-
-  // Forward to the general version
-  return findCenter(mesh, geom, solver, distribution, p);
+  return support;
 }
 
-
-SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, VectorHeatMethodSolver& solver,
-                        const VertexData<double>& distribution, int p) {
+// Weiszfeld iteration to find the center of each distribution. All of the distributions are advanced in lockstep, so
+// that log maps can be computed in blocks and geodesic steps traced in a batch.
+std::vector<SurfacePoint> findCentersOfSupports(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                                VectorHeatMethodSolver& solver,
+                                                const std::vector<DistributionSupport>& supports, int p) {
 
   if (p != 1 && p != 2) {
     throw std::logic_error("only p=1 or p=2 is supported");
   }
 
   geom.requireFaceAreas();
-  geom.requireHalfedgeVectorsInVertex();
-  geom.requireHalfedgeVectorsInFace();
 
-  SurfacePoint initialGuess;
+  size_t nDist = supports.size();
 
-  // Reasonable initial guess: the vertex with the most stuff at it
-  // double biggestVal = -std::numeric_limits<double>::infinity();
-  // for (Vertex v : mesh.vertices()) {
-  // if (distribution[v] > biggestVal) {
-  // biggestVal = distribution[v];
-  // initialGuess = SurfacePoint(v);
-  //}
-  //}
-
-  // Random initial guess
-  initialGuess = SurfacePoint(mesh.vertex(randomIndex(mesh.nVertices())));
+  // Random initial guesses
+  std::vector<SurfacePoint> currCenters(nDist);
+  for (size_t iD = 0; iD < nDist; iD++) {
+    currCenters[iD] = SurfacePoint(mesh.vertex(randomIndex(mesh.nVertices()))).inSomeFace();
+  }
 
   // Compute an approximate mesh diameter to use as parameter in the p=1 case
   double meshDiameter = 1.;
@@ -74,111 +59,202 @@ SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& g
     meshDiameter = std::sqrt(surfaceArea);
   }
 
-
   // = A few parameters
   int maxIters = 100;
   double initialStepSize = 1.0;
   double p1DistanceEps = 1e-9 * meshDiameter; // soften the fraction in p = 1 case to avoid divide by 0
   double convergeThresh = 1 / 3.;             // convergence once step is this fraction of face size
-  double faceMapThreshold = 10.;              // switch from using per-vertex maps to sub-vertex
-                                              //    accurate maps. units of local face length scale.
 
+  // Evaluate energy and update step about points[i] for distribution dists[i]. Log maps are computed a block at a
+  // time, so only a block of them is stored at once.
+  std::vector<double> evalEnergy(nDist);
+  std::vector<Vector2> evalUpdate(nDist);
+  auto evalEnergyAndUpdate = [&](const std::vector<SurfacePoint>& points, const std::vector<size_t>& dists) {
+    size_t blockSize = std::max<size_t>(1, solver.batchBlockSize);
+    for (size_t blockStart = 0; blockStart < points.size(); blockStart += blockSize) {
+      size_t B = std::min(blockSize, points.size() - blockStart);
+      std::vector<SurfacePoint> blockPoints(points.begin() + blockStart, points.begin() + blockStart + B);
+      DenseMatrix<std::complex<double>> logmaps = solver.computeLogMapBatch(blockPoints);
+
+      parallelFor(0, B, [&](size_t b) {
+        double thisEnergy = 0.;
+        Vector2 thisUpdate = Vector2::zero();
+        double updateWeightSum = 0.;
+        for (const std::pair<size_t, double>& entry : supports[dists[blockStart + b]]) {
+          Vector2 pointCoord = Vector2::fromComplex(logmaps(entry.first, b));
+          double dist2 = pointCoord.norm2();
+          double w = entry.second;
+
+          if (p == 1) {
+            double dist = std::sqrt(dist2);
+            thisEnergy += dist * w;
+            thisUpdate += w * pointCoord / (dist + p1DistanceEps);
+            updateWeightSum += w / (dist + p1DistanceEps);
+          } else {
+            thisEnergy += dist2 * w;
+            thisUpdate += w * pointCoord;
+            updateWeightSum += w;
+          }
+        }
+        thisUpdate /= updateWeightSum;
+
+        evalEnergy[blockStart + b] = thisEnergy;
+        evalUpdate[blockStart + b] = thisUpdate;
+      });
+    }
+  };
 
-  auto evalEnergyAndUpdate = [&](SurfacePoint aboutPoint) -> std::tuple<double, Vector2> {
-    // Compute the current log map
-    // Solve at the face point
-    VertexData<Vector2> logmap = solver.computeLogMap(aboutPoint);
+  GeodesicTracer tracer(geom);
 
-    // Evaluate energy and update step
-    double thisEnergy = 0.;
-    Vector2 thisUpdate = Vector2::zero();
-    double updateWeightSum = 0.;
-    for (Vertex v : mesh.vertices()) {
-      if (distribution[v] == 0.) continue;
+  // Energy and update at the current centers
+  std::vector<size_t> active(nDist);
+  for (size_t iD = 0; iD < nDist; iD++) active[iD] = iD;
+  evalEnergyAndUpdate(currCenters, active);
+  std::vector<double> energies(evalEnergy.begin(), evalEnergy.end());
+  std::vector<Vector2> updates(evalUpdate.begin(), evalUpdate.end());
 
-      Vector2 pointCoord = logmap[v];
-      double dist2 = pointCoord.norm2();
+  // === Perform Weiszfeld iterations
+  std::vector<double> stepSizes(nDist);
+  for (int i = 0; i < maxIters && !active.empty(); i++) {
 
-      if (p == 1) {
-        double dist = std::sqrt(dist2);
-        double w = distribution[v];
+    // Line search, for all distributions which have not converged
+    std::vector<size_t> searching = active;
+    for (size_t iD : searching) stepSizes[iD] = initialStepSize;
+    std::vector<size_t> stillActive;
+    for (int lineSearchIter = 0; lineSearchIter < 8 && !searching.empty(); lineSearchIter++) {
 
-        // Energy
-        thisEnergy += dist * w;
+      // Check for convergence
+      std::vector<size_t> stepping;
+      std::vector<SurfacePoint> stepStarts;
+      std::vector<Vector2> stepVecs;
+      for (size_t iD : searching) {
+        Vector2 stepVec = updates[iD] * stepSizes[iD];
+        double faceScale = std::sqrt(geom.faceAreas[currCenters[iD].face]);
+        if (stepVec.norm() < convergeThresh * faceScale) continue;
+        stepping.push_back(iD);
+        stepStarts.push_back(currCenters[iD]);
+        stepVecs.push_back(stepVec);
+      }
 
-        // Update
-        thisUpdate += w * pointCoord / (dist + p1DistanceEps);
-        updateWeightSum += w / (dist + p1DistanceEps);
+      // Try taking a step
+      std::vector<SurfacePoint> candidates = tracer.traceBatch(stepStarts, stepVecs).endPoints;
+      for (SurfacePoint& c : candidates) c = c.inSomeFace();
+      evalEnergyAndUpdate(candidates, stepping);
+
+      // Accept steps if good, otherwise decrease step size and repeat
+      searching.clear();
+      for (size_t iS = 0; iS < stepping.size(); iS++) {
+        size_t iD = stepping[iS];
+        if (evalEnergy[iS] < energies[iD]) {
+          currCenters[iD] = candidates[iS];
+          energies[iD] = evalEnergy[iS];
+          updates[iD] = evalUpdate[iS];
+          stillActive.push_back(iD);
+        } else {
+          stepSizes[iD] *= 0.5;
+          searching.push_back(iD);
+        }
+      }
+    }
 
-      } else if (p == 2) {
-        double w = distribution[v];
+    // Distributions which converged, or whose line search failed (and would fail the same way again), are done
+    std::sort(stillActive.begin(), stillActive.end());
+    active = stillActive;
+  }
 
-        // Energy
-        thisEnergy += dist2 * w;
+  geom.unrequireFaceAreas();
 
-        // Update
-        thisUpdate += w * pointCoord;
-        updateWeightSum += w;
-      }
-    }
-    thisUpdate /= updateWeightSum;
+  return currCenters;
+}
 
-    return std::make_tuple(thisEnergy, thisUpdate);
-  };
+} // namespace
 
 
-  // === Perform Weiszfeld iterations
-  SurfacePoint currCenter = initialGuess.inSomeFace();
+SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, const std::vector<Vertex>& vertexPts, int p) {
+  VertexData<double> dist(geom.mesh, 0.);
+  for (Vertex v : vertexPts) {
+    dist[v] += 1.;
+  }
 
-  bool converged = false;
-  for (int i = 0; i < maxIters; i++) {
+  // Forward to the general version
+  return findCenter(mesh, geom, dist, p);
+}
 
-    // Compute energy and update
-    double energyBefore;
-    Vector2 updateVec;
-    std::tie(energyBefore, updateVec) = evalEnergyAndUpdate(currCenter);
+SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, VectorHeatMethodSolver& solver,
+                        const std::vector<Vertex>& vertexPts, int p) {
+  VertexData<double> dist(geom.mesh, 0.);
+  for (Vertex v : vertexPts) {
+    dist[v] += 1.;
+  }
 
-    // Line search
-    double stepSize = initialStepSize;
-    for (int lineSearchIter = 0; lineSearchIter < 8; lineSearchIter++) {
+  // Forward to the general version
+  return findCenter(mesh, geom, solver, dist, p);
+}
 
-      // Try taking a step
-      Vector2 stepVec = updateVec * stepSize;
-      TraceOptions options;
-      options.includePath = true; // TODO why?
-      TraceGeodesicResult traceResult = traceGeodesic(geom, currCenter, stepVec, options);
-      SurfacePoint candidatePoint = traceResult.endPoint.inSomeFace();
+SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, const VertexData<double>& distribution, int p) {
+  VectorHeatMethodSolver solver(geom);
 
-      // Compute new energy
-      double newEnergy = std::get<0>(evalEnergyAndUpdate(candidatePoint));
+  // Forward to the general version
+  return findCenter(mesh, geom, solver, distribution, p);
+}
 
-      // Check for convergence
-      double faceScale = std::sqrt(geom.faceAreas[currCenter.inSomeFace().face]);
-      if (stepVec.norm() < convergeThresh * faceScale) {
-        converged = true;
-        break;
-      }
 
-      // Accept step if good
-      if (newEnergy < energyBefore) {
-        currCenter = candidatePoint;
-        break;
-      }
+SurfacePoint findCenter(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom, VectorHeatMethodSolver& solver,
+                        const VertexData<double>& distribution, int p) {
+  geom.requireVertexIndices();
+  std::vector<DistributionSupport> supports{supportOf(mesh, geom, distribution)};
+  geom.unrequireVertexIndices();
 
-      // Otherwise decrease step size and repeat
-      stepSize *= 0.5;
-    }
+  return findCentersOfSupports(mesh, geom, solver, supports, p)[0];
+}
+
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      const std::vector<std::vector<Vertex>>& vertexPts, int p) {
+  VectorHeatMethodSolver solver(geom);
+  return findCenters(mesh, geom, solver, vertexPts, p);
+}
 
-    if (converged) {
-      break;
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      VectorHeatMethodSolver& solver,
+                                      const std::vector<std::vector<Vertex>>& vertexPts, int p) {
+  geom.requireVertexIndices();
+
+  // Count repeated points, as findCenter() does
+  std::vector<DistributionSupport> supports(vertexPts.size());
+  parallelFor(0, vertexPts.size(), [&](size_t iD) {
+    std::vector<size_t> inds;
+    for (Vertex v : vertexPts[iD]) inds.push_back(geom.vertexIndices[v]);
+    std::sort(inds.begin(), inds.end());
+    for (size_t i : inds) {
+      if (!supports[iD].empty() && supports[iD].back().first == i) {
+        supports[iD].back().second += 1.;
+      } else {
+        supports[iD].emplace_back(i, 1.);
+      }
     }
-  }
+  });
 
-  geom.unrequireFaceAreas();
-  geom.unrequireHalfedgeVectorsInVertex();
-  geom.unrequireHalfedgeVectorsInFace();
+  geom.unrequireVertexIndices();
+  return findCentersOfSupports(mesh, geom, solver, supports, p);
+}
+
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      const std::vector<VertexData<double>>& distributions, int p) {
+  VectorHeatMethodSolver solver(geom);
+  return findCenters(mesh, geom, solver, distributions, p);
+}
+
+std::vector<SurfacePoint> findCenters(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInterface& geom,
+                                      VectorHeatMethodSolver& solver,
+                                      const std::vector<VertexData<double>>& distributions, int p) {
+  geom.requireVertexIndices();
+
+  std::vector<DistributionSupport> supports(distributions.size());
+  parallelFor(0, distributions.size(),
+              [&](size_t iD) { supports[iD] = supportOf(mesh, geom, distributions[iD]); });
 
-  return currCenter;
+  geom.unrequireVertexIndices();
+  return findCentersOfSupports(mesh, geom, solver, supports, p);
 }
 
 } // namespace surface
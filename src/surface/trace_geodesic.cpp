@@ -2,6 +2,7 @@
 
 #include "geometrycentral/surface/barycentric_coordinate_helpers.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include <Eigen/Dense>
 
@@ -100,6 +101,41 @@ inline Vector2 convertVecToEdge(Halfedge he, Vector2 halfedgeVec) {
 }
 
 
+// === Geometry access
+//
+// The tracing routines below are templated on how they read geometry, so that the same code serves both one-off traces
+// against an IntrinsicGeometryInterface, and batched traces against the flat per-face layout of a GeodesicTracer.
+
+// Reads from the quantities of an IntrinsicGeometryInterface (which must already be required)
+struct InterfaceTraceGeometry {
+  IntrinsicGeometryInterface& geom;
+
+  Vector2 halfedgeVectorInFace(Halfedge he) const { return geom.halfedgeVectorsInFace[he]; }
+  Vector2 halfedgeVectorInVertex(Halfedge he) const { return geom.halfedgeVectorsInVertex[he]; }
+  double vertexAngleSum(Vertex v) const { return geom.vertexAngleSums[v]; }
+  std::array<Vector2, 3> vertexCoordinates(Face face) const { return vertexCoordinatesInTriangle(geom, face); }
+  Vector3 cartesianToBarycentric(Face face, const std::array<Vector2, 3>& vertCoords, Vector2 faceVec) const {
+    return cartesianVectorToBarycentric(vertCoords, faceVec);
+  }
+};
+
+// Reads from the flat arrays of a GeodesicTracer
+struct FlatTraceGeometry {
+  const GeodesicTracer& tracer;
+
+  Vector2 halfedgeVectorInFace(Halfedge he) const { return tracer.halfedgeVectorsInFace[he.getIndex()]; }
+  Vector2 halfedgeVectorInVertex(Halfedge he) const { return tracer.halfedgeVectorsInVertex[he.getIndex()]; }
+  double vertexAngleSum(Vertex v) const { return tracer.vertexAngleSums[v.getIndex()]; }
+  std::array<Vector2, 3> vertexCoordinates(Face face) const { return tracer.faceLayout[face.getIndex()].vertexCoords; }
+  Vector3 cartesianToBarycentric(Face face, const std::array<Vector2, 3>& vertCoords, Vector2 faceVec) const {
+    // Same system as cartesianVectorToBarycentric(), but with the inverse precomputed
+    const std::array<double, 6>& T = tracer.faceLayout[face.getIndex()].cartesianToBary;
+    Vector3 resultBary{T[0] * faceVec.x + T[1] * faceVec.y, T[2] * faceVec.x + T[3] * faceVec.y,
+                       T[4] * faceVec.x + T[5] * faceVec.y};
+    return normalizeBarycentricDisplacement(resultBary);
+  }
+};
+
 // === Tracing subroutines
 
 
@@ -134,14 +170,13 @@ struct TraceSubResult {
 // Note that this expects to be given the trace vector in both barycentric _and_ cartesian coordinates. These are two
 // different representations of the same data! This is useful the barycentric representation is good for relilably
 // performing tracing, while the cartesian representation is good for transforming the trace vector between triangles.
-inline TraceSubResult traceInFaceBarycentric(IntrinsicGeometryInterface& geom, Face face, Vector3 startPoint,
-                                             Vector3 vecBary, Vector2 vecCartesianDir, double vecCartesianLen,
+template <typename G>
+inline TraceSubResult traceInFaceBarycentric(const G& geom, Face face, Vector3 startPoint, Vector3 vecBary,
+                                             Vector2 vecCartesianDir, double vecCartesianLen,
                                              std::array<bool, 3> edgeIsHittable, const TraceOptions& traceOptions) {
 
   // Gather values
-  std::array<Vector2, 3> vertexCoords = vertexCoordinatesInTriangle(geom, face);
-  Vector3 triangleLengths{geom.edgeLengths[face.halfedge().edge()], geom.edgeLengths[face.halfedge().next().edge()],
-                          geom.edgeLengths[face.halfedge().next().next().edge()]};
+  std::array<Vector2, 3> vertexCoords = geom.vertexCoordinates(face);
 
   if (sum(startPoint) < 0.5) {
     if (TRACE_PRINT) {
@@ -160,7 +195,8 @@ inline TraceSubResult traceInFaceBarycentric(IntrinsicGeometryInterface& geom, F
 
   if (TRACE_PRINT) {
     cout << "  vec bary  = " << vecBary << endl;
-    cout << "  reconvert = " << cartesianVectorToBarycentric(vertexCoords, vecCartesianDir) * vecCartesianLen << endl;
+    cout << "  reconvert = " << geom.cartesianToBarycentric(face, vertexCoords, vecCartesianDir) * vecCartesianLen
+         << endl;
   }
 
   // Test if the vector ends in the triangle
@@ -327,26 +363,26 @@ inline TraceSubResult traceInFaceBarycentric(IntrinsicGeometryInterface& geom, F
 // Trace within a face towards a given edge. The trace is assumed to start at the vertex opposite towardsHe.
 //   - towardsHe: the halfedge we are tracing towards (opposite the source vertex)
 //   - vecCartesian: vector to trace, in the cartesian basis of the face
-inline TraceSubResult traceInFaceTowardsEdge(IntrinsicGeometryInterface& geom, Halfedge towardsHe,
-                                             Vector2 vecCartesianDir, double vecCartesianLen,
-                                             const TraceOptions& traceOptions) {
+template <typename G>
+inline TraceSubResult traceInFaceTowardsEdge(const G& geom, Halfedge towardsHe, Vector2 vecCartesianDir,
+                                             double vecCartesianLen, const TraceOptions& traceOptions) {
 
   // Gather some values
   Face face = towardsHe.face();
   Halfedge rootHe = towardsHe.next().next();
-  std::array<Vector2, 3> vertexCoords = vertexCoordinatesInTriangle(geom, face);
+  std::array<Vector2, 3> vertexCoords = geom.vertexCoordinates(face);
 
   if (TRACE_PRINT) {
     cout << "  face trace towards edge " << towardsHe << " vec = " << vecCartesianDir << endl;
-    cout << "  wedge vec right = " << geom.halfedgeVectorsInFace[towardsHe.next().next()] << endl;
-    cout << "  wedge vec left  = " << -geom.halfedgeVectorsInFace[towardsHe.next()] << endl;
-    cout << "  wedge vec opp = " << geom.halfedgeVectorsInFace[towardsHe] << endl;
+    cout << "  wedge vec right = " << geom.halfedgeVectorInFace(towardsHe.next().next()) << endl;
+    cout << "  wedge vec left  = " << -geom.halfedgeVectorInFace(towardsHe.next()) << endl;
+    cout << "  wedge vec opp = " << geom.halfedgeVectorInFace(towardsHe) << endl;
   }
 
   // TODO do some reasonable angular projection on the cartesian vector
 
   // Convert to barycentric
-  Vector3 vecBaryCanonical = cartesianVectorToBarycentric(vertexCoords, vecCartesianDir) * vecCartesianLen;
+  Vector3 vecBaryCanonical = geom.cartesianToBarycentric(face, vertexCoords, vecCartesianDir) * vecCartesianLen;
   Vector3 vecBaryFromRoot = permuteBarycentricFromCanonical(vecBaryCanonical, towardsHe.next().next());
 
   if (TRACE_PRINT) {
@@ -390,7 +426,8 @@ inline TraceSubResult traceInFaceTowardsEdge(IntrinsicGeometryInterface& geom, H
 //   - fromHe: the halfedge we enter from along the face
 //   - tCrossFrom: t value in [0, 1] along fromHe we we enter the face
 //   - traceVecInHalfedge: vector to trace, in the basis of fromHe
-inline TraceSubResult traceInFaceFromEdge(IntrinsicGeometryInterface& geom, Halfedge fromHe, double tCrossFrom,
+template <typename G>
+inline TraceSubResult traceInFaceFromEdge(const G& geom, Halfedge fromHe, double tCrossFrom,
                                           Vector2 traceVecInHalfedgeDir, double traceVecInHalfedgeLen,
                                           const TraceOptions& traceOptions) {
 
@@ -411,7 +448,7 @@ inline TraceSubResult traceInFaceFromEdge(IntrinsicGeometryInterface& geom, Half
   // Gather some values
   Halfedge faceHe = fromHe.twin(); // the halfedge in hte face we're heading in to
   Face face = faceHe.face();
-  std::array<Vector2, 3> vertexCoords = vertexCoordinatesInTriangle(geom, face);
+  std::array<Vector2, 3> vertexCoords = geom.vertexCoordinates(face);
 
   if (TRACE_PRINT) cout << "  face trace from edge " << fromHe << " vec = " << traceVecInHalfedgeDir << endl;
 
@@ -423,12 +460,12 @@ inline TraceSubResult traceInFaceFromEdge(IntrinsicGeometryInterface& geom, Half
   if (TRACE_PRINT) cout << "    vec in face after project " << traceVecInFaceHalfedgeDir << endl;
 
   // Convert to face coordinates
-  Vector2 heDir = geom.halfedgeVectorsInFace[faceHe].normalize();
+  Vector2 heDir = geom.halfedgeVectorInFace(faceHe).normalize();
   Vector2 traceVecInFaceDir = heDir * traceVecInFaceHalfedgeDir;
   if (TRACE_PRINT) cout << "    traceVec in face " << traceVecInFaceDir << endl;
 
   // Convert to barycentric
-  Vector3 vecBaryCanonicalDir = cartesianVectorToBarycentric(vertexCoords, traceVecInFaceDir);
+  Vector3 vecBaryCanonicalDir = geom.cartesianToBarycentric(face, vertexCoords, traceVecInFaceDir);
   if (TRACE_PRINT) cout << "    vecBaryCanonical " << vecBaryCanonicalDir << endl;
   Vector3 vecBaryFromEdgeDir = permuteBarycentricFromCanonical(vecBaryCanonicalDir, faceHe);
 
@@ -472,8 +509,9 @@ inline TraceSubResult traceInFaceFromEdge(IntrinsicGeometryInterface& geom, Half
 
 
 // Trace starting from an edge
-inline TraceSubResult traceGeodesic_fromEdge(IntrinsicGeometryInterface& geom, Edge currEdge, double tEdge,
-                                             Vector2 currVecDir, double currVecLen, const TraceOptions& traceOptions) {
+template <typename G>
+inline TraceSubResult traceGeodesic_fromEdge(const G& geom, Edge currEdge, double tEdge, Vector2 currVecDir,
+                                             double currVecLen, const TraceOptions& traceOptions) {
 
   if (TRACE_PRINT) cout << "  edge trace " << currEdge << " tEdge = " << tEdge << " edge vec = " << currVecDir << endl;
 
@@ -509,12 +547,13 @@ inline TraceSubResult traceGeodesic_fromEdge(IntrinsicGeometryInterface& geom, E
 }
 
 // Trace starting from a face
-inline TraceSubResult traceGeodesic_fromFace(IntrinsicGeometryInterface& geom, Face currFace, Vector3 faceBary,
-                                             Vector2 currVecDir, double currVecLen, const TraceOptions& traceOptions) {
+template <typename G>
+inline TraceSubResult traceGeodesic_fromFace(const G& geom, Face currFace, Vector3 faceBary, Vector2 currVecDir,
+                                             double currVecLen, const TraceOptions& traceOptions) {
 
   // Convert the vector to barycentric
-  std::array<Vector2, 3> vertexCoords = vertexCoordinatesInTriangle(geom, currFace);
-  Vector3 vecBary = cartesianVectorToBarycentric(vertexCoords, currVecDir) * currVecLen;
+  std::array<Vector2, 3> vertexCoords = geom.vertexCoordinates(currFace);
+  Vector3 vecBary = geom.cartesianToBarycentric(currFace, vertexCoords, currVecDir) * currVecLen;
 
   return traceInFaceBarycentric(geom, currFace, faceBary, vecBary, currVecDir, currVecLen, {true, true, true},
                                 traceOptions);
@@ -522,7 +561,8 @@ inline TraceSubResult traceGeodesic_fromFace(IntrinsicGeometryInterface& geom, F
 
 
 // Trace starting from a vertex (with a rescaled cartesian vector)
-inline TraceSubResult traceGeodesic_fromVertex(IntrinsicGeometryInterface& geom, Vertex currVert, Vector2 currVecDir,
+template <typename G>
+inline TraceSubResult traceGeodesic_fromVertex(const G& geom, Vertex currVert, Vector2 currVecDir,
                                                double currVecLen, const TraceOptions& traceOptions) {
   if (TRACE_PRINT) cout << "  vertex trace " << currVert << " edge vec = " << currVecDir << endl;
 
@@ -549,14 +589,13 @@ inline TraceSubResult traceGeodesic_fromVertex(IntrinsicGeometryInterface& geom,
     Halfedge nextHe = currHe.next().next().twin();
 
     // The interval spanned by this edge, which we are currently testing
-    Vector2 intervalStart = geom.halfedgeVectorsInVertex[currHe].normalize();
-    Vector2 intervalEnd = geom.halfedgeVectorsInVertex[nextHe].normalize();
+    Vector2 intervalStart = geom.halfedgeVectorInVertex(currHe).normalize();
+    Vector2 intervalEnd = geom.halfedgeVectorInVertex(nextHe).normalize();
 
     if (TRACE_PRINT) {
       cout << "  testing wedge " << intervalStart << " -- " << intervalEnd << endl;
-      cout << "    testing wedge (un norm) " << geom.halfedgeVectorsInVertex[currHe] << " -- "
-           << geom.halfedgeVectorsInVertex[nextHe] << endl;
-      cout << "    corner angle " << geom.cornerAngles[currHe.corner()] << endl;
+      cout << "    testing wedge (un norm) " << geom.halfedgeVectorInVertex(currHe) << " -- "
+           << geom.halfedgeVectorInVertex(nextHe) << endl;
       cout << "    corner " << currHe.corner() << endl;
       Vector2 relAngle = intervalEnd / intervalStart;
       cout << "    wedge width " << relAngle << " radians: " << relAngle.arg() << endl;
@@ -605,16 +644,16 @@ inline TraceSubResult traceGeodesic_fromVertex(IntrinsicGeometryInterface& geom,
 
   // Need to convert from "powered" representation to flat vector in face
   double sum = currVert.isBoundary() ? M_PI : 2. * M_PI;
-  traceDirRelativeToStart = traceDirRelativeToStart.pow(geom.vertexAngleSums[currVert] / sum);
+  traceDirRelativeToStart = traceDirRelativeToStart.pow(geom.vertexAngleSum(currVert) / sum);
   traceDirRelativeToStart = traceDirRelativeToStart.normalize();
 
   // Compute the starting vector
-  Vector2 startDirInFace = geom.halfedgeVectorsInFace[wedgeHe].normalize();
+  Vector2 startDirInFace = geom.halfedgeVectorInFace(wedgeHe).normalize();
   Vector2 traceDirInFace = traceDirRelativeToStart * startDirInFace;
   if (TRACE_PRINT) {
     cout << "  starting vector" << endl;
-    cout << "    start wedge vec " << geom.halfedgeVectorsInFace[wedgeHe] << endl;
-    cout << "    start wedge vec unit " << geom.halfedgeVectorsInFace[wedgeHe].normalize() << endl;
+    cout << "    start wedge vec " << geom.halfedgeVectorInFace(wedgeHe) << endl;
+    cout << "    start wedge vec unit " << geom.halfedgeVectorInFace(wedgeHe).normalize() << endl;
     cout << "    trace dir in face " << traceDirInFace << endl;
   }
 
@@ -625,7 +664,8 @@ inline TraceSubResult traceGeodesic_fromVertex(IntrinsicGeometryInterface& geom,
 
 // Run tracing iteratively in faces, after on of the variants below has gotten it started.
 // Will internally add the point path point encoded by prevTraceEnd, don't add beforehand.
-void traceGeodesic_iterative(IntrinsicGeometryInterface& geom, TraceGeodesicResult& result, TraceSubResult prevTraceEnd,
+template <typename G>
+void traceGeodesic_iterative(const G& geom, TraceGeodesicResult& result, TraceSubResult prevTraceEnd,
                              const TraceOptions& traceOptions) {
 
   // Now, points are always in faces. Trace until termination.
@@ -676,16 +716,15 @@ void traceGeodesic_iterative(IntrinsicGeometryInterface& geom, TraceGeodesicResu
 }
 
 
-} // namespace
-
-TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, SurfacePoint startP, Vector2 traceVec,
-                                  const TraceOptions& traceOptions) {
-  geom.requireVertexAngleSums();
-  geom.requireHalfedgeVectorsInVertex();
-  geom.requireHalfedgeVectorsInFace();
+// Trace from a surface point, writing in to `result` (which is reset first, so it may be reused between calls)
+template <typename G>
+void traceGeodesic_fromSurfacePoint(const G& geom, SurfacePoint startP, Vector2 traceVec,
+                                    const TraceOptions& traceOptions, TraceGeodesicResult& result) {
 
   // The output data
-  TraceGeodesicResult result;
+  result.pathPoints.clear();
+  result.endPoint = SurfacePoint();
+  result.hitBoundary = false;
   result.hasPath = traceOptions.includePath;
   if (traceOptions.includePath) {
     result.pathPoints.push_back(startP);
@@ -695,10 +734,6 @@ TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, SurfacePoint
 
   // Quick out with a zero vector
   if (traceVec.norm2() == 0) {
-    geom.unrequireVertexAngleSums();
-    geom.unrequireHalfedgeVectorsInVertex();
-    geom.unrequireHalfedgeVectorsInFace();
-
     result.endingDir = Vector2::zero();
 
     // probably want to ensure we still return a point in a face...
@@ -706,7 +741,7 @@ TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, SurfacePoint
       throw std::runtime_error("zero vec passed to trace, do something good here");
     }
 
-    return result;
+    return;
   }
 
 
@@ -731,6 +766,18 @@ TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, SurfacePoint
 
   // Keep tracing through triangles until finished
   traceGeodesic_iterative(geom, result, prevTraceEnd, traceOptions);
+}
+
+} // namespace
+
+TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, SurfacePoint startP, Vector2 traceVec,
+                                  const TraceOptions& traceOptions) {
+  geom.requireVertexAngleSums();
+  geom.requireHalfedgeVectorsInVertex();
+  geom.requireHalfedgeVectorsInFace();
+
+  TraceGeodesicResult result;
+  traceGeodesic_fromSurfacePoint(InterfaceTraceGeometry{geom}, startP, traceVec, traceOptions, result);
 
   geom.unrequireVertexAngleSums();
   geom.unrequireHalfedgeVectorsInVertex();
@@ -784,20 +831,136 @@ TraceGeodesicResult traceGeodesic(IntrinsicGeometryInterface& geom, Face startFa
   Vector2 traceVectorCartesian = barycentricDisplacementToCartesian(vertexCoords, traceBaryVec);
 
   // Trace the first point starting inside the face
+  InterfaceTraceGeometry traceGeom{geom};
   TraceSubResult prevTraceEnd =
-      traceInFaceBarycentric(geom, startFace, startBary, traceBaryVec, unit(traceVectorCartesian),
+      traceInFaceBarycentric(traceGeom, startFace, startBary, traceBaryVec, unit(traceVectorCartesian),
                              norm(traceVectorCartesian), {true, true, true}, traceOptions);
 
   // Keep tracing through triangles until finished
-  traceGeodesic_iterative(geom, result, prevTraceEnd, traceOptions);
+  traceGeodesic_iterative(traceGeom, result, prevTraceEnd, traceOptions);
+
+  geom.unrequireVertexAngleSums();
+  geom.unrequireHalfedgeVectorsInVertex();
+  geom.unrequireHalfedgeVectorsInFace();
+
+  return result;
+}
+
+GeodesicTracer::GeodesicTracer(IntrinsicGeometryInterface& geom) : mesh(geom.mesh) {
+  geom.requireVertexAngleSums();
+  geom.requireHalfedgeVectorsInVertex();
+  geom.requireHalfedgeVectorsInFace();
+
+  halfedgeVectorsInFace.resize(mesh.nHalfedgesCapacity());
+  halfedgeVectorsInVertex.resize(mesh.nHalfedgesCapacity());
+  for (Halfedge he : mesh.halfedges()) {
+    halfedgeVectorsInFace[he.getIndex()] = geom.halfedgeVectorsInFace[he];
+    halfedgeVectorsInVertex[he.getIndex()] = geom.halfedgeVectorsInVertex[he];
+  }
+
+  vertexAngleSums.resize(mesh.nVerticesCapacity());
+  for (Vertex v : mesh.vertices()) {
+    vertexAngleSums[v.getIndex()] = geom.vertexAngleSums[v];
+  }
+
+  faceLayout.resize(mesh.nFacesCapacity());
+  for (Face f : mesh.faces()) {
+    FaceLayout& layout = faceLayout[f.getIndex()];
+    layout.vertexCoords = vertexCoordinatesInTriangle(geom, f);
+
+    // Invert the same system solved by cartesianVectorToBarycentric(); only the first two columns are needed, since the
+    // right hand side always has a zero in the last entry
+    const std::array<Vector2, 3>& c = layout.vertexCoords;
+    Eigen::Matrix3d A;
+    A << c[0].x, c[1].x, c[2].x, c[0].y, c[1].y, c[2].y, 1., 1., 1.;
+    Eigen::Matrix3d Ainv = A.inverse();
+    layout.cartesianToBary = {{Ainv(0, 0), Ainv(0, 1), Ainv(1, 0), Ainv(1, 1), Ainv(2, 0), Ainv(2, 1)}};
+  }
 
   geom.unrequireVertexAngleSums();
   geom.unrequireHalfedgeVectorsInVertex();
   geom.unrequireHalfedgeVectorsInFace();
+}
 
+void GeodesicTracer::traceInto(SurfacePoint startP, Vector2 traceVec, const TraceOptions& traceOptions,
+                               TraceGeodesicResult& result) const {
+  traceGeodesic_fromSurfacePoint(FlatTraceGeometry{*this}, startP, traceVec, traceOptions, result);
+}
+
+TraceGeodesicResult GeodesicTracer::trace(SurfacePoint startP, Vector2 traceVec,
+                                          const TraceOptions& traceOptions) const {
+  TraceGeodesicResult result;
+  traceInto(startP, traceVec, traceOptions, result);
   return result;
 }
 
+TraceGeodesicBatchResult GeodesicTracer::traceBatch(const std::vector<SurfacePoint>& startPoints,
+                                                    const std::vector<Vector2>& traceVecs,
+                                                    const TraceOptions& traceOptions) const {
+  if (startPoints.size() != traceVecs.size()) {
+    throw std::runtime_error("traceBatch(): startPoints and traceVecs must have the same size");
+  }
+  size_t N = startPoints.size();
+  bool includePath = traceOptions.includePath;
+
+  TraceGeodesicBatchResult batch;
+  batch.endPoints.resize(N);
+  batch.endingDirs.resize(N);
+  batch.hitBoundary.resize(N);
+
+  // Per-thread scratch: a result object which is reused for every trace (so its path storage is only allocated once),
+  // and a buffer accumulating the paths traced by that thread
+  size_t nThreads = getNumThreads();
+  std::vector<TraceGeodesicResult> threadResult(nThreads);
+  std::vector<std::vector<SurfacePoint>> threadPathPoints(nThreads);
+  std::vector<size_t> pathThread, pathOffset;
+  if (includePath) {
+    batch.pathStart.resize(N + 1);
+    pathThread.resize(N);
+    pathOffset.resize(N);
+  }
+
+  parallelForWithThreadIndex(
+      0, N, nThreads,
+      [&](size_t iThread, size_t i) {
+        TraceGeodesicResult& result = threadResult[iThread];
+        traceInto(startPoints[i], traceVecs[i], traceOptions, result);
+
+        batch.endPoints[i] = result.endPoint;
+        batch.endingDirs[i] = result.endingDir;
+        batch.hitBoundary[i] = result.hitBoundary;
+
+        if (includePath) {
+          std::vector<SurfacePoint>& buffer = threadPathPoints[iThread];
+          pathThread[i] = iThread;
+          pathOffset[i] = buffer.size();
+          batch.pathStart[i + 1] = result.pathPoints.size();
+          buffer.insert(buffer.end(), result.pathPoints.begin(), result.pathPoints.end());
+        }
+      },
+      64);
+
+  // Gather the per-thread paths in to a single compressed buffer
+  if (includePath) {
+    batch.pathStart[0] = 0;
+    for (size_t i = 0; i < N; i++) {
+      batch.pathStart[i + 1] += batch.pathStart[i];
+    }
+    batch.pathPoints.resize(batch.pathStart[N]);
+    parallelFor(
+        0, N,
+        [&](size_t i) {
+          const std::vector<SurfacePoint>& buffer = threadPathPoints[pathThread[i]];
+          size_t count = batch.pathStart[i + 1] - batch.pathStart[i];
+          auto srcBegin = buffer.begin() + pathOffset[i];
+          std::copy(srcBegin, srcBegin + count, batch.pathPoints.begin() + batch.pathStart[i]);
+        },
+        1024);
+  }
+
+  return batch;
+}
+
 bool trimTraceResult(TraceGeodesicResult& traceResult, Vertex targetVertex) {
 
   while (traceResult.pathPoints.size() > 1) {
@@ -70,11 +70,8 @@ VertexData<double> AttributeTransfer::transferAtoB_Pointwise(const VertexData<do
 }
 
 VertexData<double> AttributeTransfer::transferAtoB_L2(const VertexData<double>& valuesOnA) {
-  if (!AtoB_L2_Solver) {
-    SparseMatrix<double> mat = P_B.transpose() * M_CS_Galerkin * P_B;
-    AtoB_L2_Solver.reset(new SquareSolver<double>(mat));
-  }
-  Vector<double> vec = P_B.transpose() * M_CS_Galerkin * P_A * valuesOnA.toVector();
+  ensureAtoB_L2();
+  Vector<double> vec = AtoB_L2_RHS * valuesOnA.toVector();
   Vector<double> result = AtoB_L2_Solver->solve(vec);
   return VertexData<double>(cs.meshB, result);
 }
@@ -95,24 +92,173 @@ VertexData<double> AttributeTransfer::transferBtoA_Pointwise(const VertexData<do
 }
 
 VertexData<double> AttributeTransfer::transferBtoA_L2(const VertexData<double>& valuesOnB) {
-  if (!BtoA_L2_Solver) {
-    SparseMatrix<double> mat = P_A.transpose() * M_CS_Galerkin * P_A;
-    BtoA_L2_Solver.reset(new SquareSolver<double>(mat));
-  }
-  Vector<double> vec = P_A.transpose() * M_CS_Galerkin * P_B * valuesOnB.toVector();
+  ensureBtoA_L2();
+  Vector<double> vec = BtoA_L2_RHS * valuesOnB.toVector();
   Vector<double> result = BtoA_L2_Solver->solve(vec);
   return VertexData<double>(cs.meshA, result);
 }
 
+// === Batched transfer
+
+DenseMatrix<double> AttributeTransfer::transferAtoB(const DenseMatrix<double>& valuesOnA, TransferMethod method) {
+
+  switch (method) {
+  case TransferMethod::Pointwise: {
+    return transferAtoB_Pointwise(valuesOnA);
+  }
+  case TransferMethod::L2: {
+    return transferAtoB_L2(valuesOnA);
+  }
+  }
+
+  return DenseMatrix<double>(); // unreachable
+}
+
+DenseMatrix<double> AttributeTransfer::transferBtoA(const DenseMatrix<double>& valuesOnB, TransferMethod method) {
+
+  switch (method) {
+  case TransferMethod::Pointwise: {
+    return transferBtoA_Pointwise(valuesOnB);
+  }
+  case TransferMethod::L2: {
+    return transferBtoA_L2(valuesOnB);
+  }
+  }
+
+  return DenseMatrix<double>(); // unreachable
+}
+
+DenseMatrix<double> AttributeTransfer::transferAtoB_Pointwise(const DenseMatrix<double>& valuesOnA) {
+  if ((size_t)valuesOnA.rows() != cs.meshA.nVertices()) {
+    throw std::runtime_error("transferAtoB: expected one row per vertex of mesh A");
+  }
+
+  // Interpolate all channels to the common subdivision at once, then copy out the rows at vertices of B
+  DenseMatrix<double> valuesOnCS = P_A * valuesOnA;
+  VertexData<size_t> csVertInd = cs.mesh->getVertexIndices();
+  VertexData<size_t> BVertInd = cs.meshB.getVertexIndices();
+  DenseMatrix<double> result = DenseMatrix<double>::Zero(cs.meshB.nVertices(), valuesOnA.cols());
+  for (Vertex v : cs.mesh->vertices()) {
+    CommonSubdivisionPoint& p = *cs.sourcePoints[v];
+    if (p.posB.type == SurfacePointType::Vertex) {
+      result.row(BVertInd[p.posB.vertex]) = valuesOnCS.row(csVertInd[v]);
+    }
+  }
+  return result;
+}
+
+DenseMatrix<double> AttributeTransfer::transferAtoB_L2(const DenseMatrix<double>& valuesOnA) {
+  if ((size_t)valuesOnA.rows() != cs.meshA.nVertices()) {
+    throw std::runtime_error("transferAtoB: expected one row per vertex of mesh A");
+  }
+  ensureAtoB_L2();
+  DenseMatrix<double> rhs = AtoB_L2_RHS * valuesOnA;
+  return AtoB_L2_Solver->solveMultiple(rhs);
+}
+
+DenseMatrix<double> AttributeTransfer::transferBtoA_Pointwise(const DenseMatrix<double>& valuesOnB) {
+  if ((size_t)valuesOnB.rows() != cs.meshB.nVertices()) {
+    throw std::runtime_error("transferBtoA: expected one row per vertex of mesh B");
+  }
+
+  DenseMatrix<double> valuesOnCS = P_B * valuesOnB;
+  VertexData<size_t> csVertInd = cs.mesh->getVertexIndices();
+  VertexData<size_t> AVertInd = cs.meshA.getVertexIndices();
+  DenseMatrix<double> result = DenseMatrix<double>::Zero(cs.meshA.nVertices(), valuesOnB.cols());
+  for (Vertex v : cs.mesh->vertices()) {
+    CommonSubdivisionPoint& p = *cs.sourcePoints[v];
+    if (p.posA.type == SurfacePointType::Vertex) {
+      result.row(AVertInd[p.posA.vertex]) = valuesOnCS.row(csVertInd[v]);
+    }
+  }
+  return result;
+}
+
+DenseMatrix<double> AttributeTransfer::transferBtoA_L2(const DenseMatrix<double>& valuesOnB) {
+  if ((size_t)valuesOnB.rows() != cs.meshB.nVertices()) {
+    throw std::runtime_error("transferBtoA: expected one row per vertex of mesh B");
+  }
+  ensureBtoA_L2();
+  DenseMatrix<double> rhs = BtoA_L2_RHS * valuesOnB;
+  return BtoA_L2_Solver->solveMultiple(rhs);
+}
+
+namespace {
+
+// Pack vector-valued data as a |V| x D matrix, and back
+template <typename T, int D>
+DenseMatrix<double> vectorDataToMatrix(const VertexData<T>& data, SurfaceMesh& mesh) {
+  DenseMatrix<double> mat(mesh.nVertices(), D);
+  size_t i = 0;
+  for (Vertex v : mesh.vertices()) {
+    for (int j = 0; j < D; j++) {
+      mat(i, j) = data[v][j];
+    }
+    i++;
+  }
+  return mat;
+}
+
+template <typename T, int D>
+VertexData<T> matrixToVectorData(const DenseMatrix<double>& mat, SurfaceMesh& mesh) {
+  VertexData<T> data(mesh);
+  size_t i = 0;
+  for (Vertex v : mesh.vertices()) {
+    for (int j = 0; j < D; j++) {
+      data[v][j] = mat(i, j);
+    }
+    i++;
+  }
+  return data;
+}
+
+} // namespace
+
+VertexData<Vector2> AttributeTransfer::transferAtoB(const VertexData<Vector2>& valuesOnA, TransferMethod method) {
+  DenseMatrix<double> result = transferAtoB(vectorDataToMatrix<Vector2, 2>(valuesOnA, cs.meshA), method);
+  return matrixToVectorData<Vector2, 2>(result, cs.meshB);
+}
+
+VertexData<Vector2> AttributeTransfer::transferBtoA(const VertexData<Vector2>& valuesOnB, TransferMethod method) {
+  DenseMatrix<double> result = transferBtoA(vectorDataToMatrix<Vector2, 2>(valuesOnB, cs.meshB), method);
+  return matrixToVectorData<Vector2, 2>(result, cs.meshA);
+}
+
+VertexData<Vector3> AttributeTransfer::transferAtoB(const VertexData<Vector3>& valuesOnA, TransferMethod method) {
+  DenseMatrix<double> result = transferAtoB(vectorDataToMatrix<Vector3, 3>(valuesOnA, cs.meshA), method);
+  return matrixToVectorData<Vector3, 3>(result, cs.meshB);
+}
+
+VertexData<Vector3> AttributeTransfer::transferBtoA(const VertexData<Vector3>& valuesOnB, TransferMethod method) {
+  DenseMatrix<double> result = transferBtoA(vectorDataToMatrix<Vector3, 3>(valuesOnB, cs.meshB), method);
+  return matrixToVectorData<Vector3, 3>(result, cs.meshA);
+}
+
+void AttributeTransfer::ensureAtoB_L2() {
+  if (AtoB_L2_Solver) return;
+  SparseMatrix<double> lhs;
+  std::tie(lhs, AtoB_L2_RHS) = constructAtoBMatrices();
+  AtoB_L2_Solver.reset(new SquareSolver<double>(lhs));
+}
+
+void AttributeTransfer::ensureBtoA_L2() {
+  if (BtoA_L2_Solver) return;
+  SparseMatrix<double> lhs;
+  std::tie(lhs, BtoA_L2_RHS) = constructBtoAMatrices();
+  BtoA_L2_Solver.reset(new SquareSolver<double>(lhs));
+}
+
 std::pair<SparseMatrix<double>, SparseMatrix<double>> AttributeTransfer::constructAtoBMatrices() const {
-  SparseMatrix<double> lhs = P_B.transpose() * M_CS_Galerkin * P_B;
-  SparseMatrix<double> rhs = P_B.transpose() * M_CS_Galerkin * P_A;
+  SparseMatrix<double> P_Bt = P_B.transpose();
+  SparseMatrix<double> lhs = P_Bt * (M_CS_Galerkin * P_B);
+  SparseMatrix<double> rhs = P_Bt * (M_CS_Galerkin * P_A);
   return {lhs, rhs};
 }
 
 std::pair<SparseMatrix<double>, SparseMatrix<double>> AttributeTransfer::constructBtoAMatrices() const {
-  SparseMatrix<double> lhs = P_A.transpose() * M_CS_Galerkin * P_A;
-  SparseMatrix<double> rhs = P_A.transpose() * M_CS_Galerkin * P_B;
+  SparseMatrix<double> P_At = P_A.transpose();
+  SparseMatrix<double> lhs = P_At * (M_CS_Galerkin * P_A);
+  SparseMatrix<double> rhs = P_At * (M_CS_Galerkin * P_B);
   return {lhs, rhs};
 }
 
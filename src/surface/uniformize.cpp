@@ -5,6 +5,8 @@
 #include "geometrycentral/surface/edge_length_geometry.h"
 #include "geometrycentral/surface/simple_idt.h"
 
+#include <memory>
+
 
 namespace geometrycentral {
 namespace surface {
@@ -46,6 +48,12 @@ EdgeData<double> uniformizeDisk(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInte
   }
 
 
+  // With edge flips the triangulation stays Delaunay, so the interior block of the Laplacian is positive definite. Its
+  // sparsity pattern only changes when edges flip, so the symbolic factorization is usually reused from one iteration
+  // to the next. Without flips, cotan weights can go negative and the block may be indefinite, so it takes the general
+  // solver.
+  std::unique_ptr<PositiveDefiniteSolver<double>> solver;
+
   int nMaxIters = 50;
   for (int iIter = 0; iIter < nMaxIters; iIter++) {
 
@@ -71,7 +79,17 @@ EdgeData<double> uniformizeDisk(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInte
 
     // Solve problem
     Vector<double> combinedRHS = rhsValsA - decomp.AB * bcVals;
-    Vector<double> Aresult = 0.5 * solve(decomp.AA, combinedRHS);
+    Vector<double> Aresult;
+    if (withEdgeFlips) {
+      if (solver) {
+        solver->refactor(decomp.AA);
+      } else {
+        solver.reset(new PositiveDefiniteSolver<double>(decomp.AA));
+      }
+      Aresult = 0.5 * solver->solve(combinedRHS);
+    } else {
+      Aresult = 0.5 * solve(decomp.AA, combinedRHS);
+    }
 
     // Combine the two boundary conditions and interior solution to a full vector
     Vector<double> result = reassembleVector(decomp, Aresult, bcVals);
@@ -96,13 +114,12 @@ EdgeData<double> uniformizeDisk(ManifoldSurfaceMesh& mesh, IntrinsicGeometryInte
       lengthGeom.edgeLengths[e] = newLen;
     }
 
-    // TODO convergence check?
-    std::cout << " uniformize max change = " << maxRelChange << std::endl;
-
     if (withEdgeFlips) {
       flipToDelaunay(mesh, lengthGeom.edgeLengths, FlipType::Hyperbolic);
     }
     lengthGeom.refreshQuantities();
+
+    if (maxRelChange < 1e-12) break;
   }
 
   geometry.unrequireEdgeLengths();
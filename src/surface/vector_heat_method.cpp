@@ -1,8 +1,28 @@
 #include "geometrycentral/surface/vector_heat_method.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
+#include <array>
+
 namespace geometrycentral {
 namespace surface {
 
+namespace {
+
+// The vertices of a face containing the point, and its barycentric coordinates with respect to them
+void faceVertexWeights(IntrinsicGeometryInterface& geom, const SurfacePoint& point, std::array<size_t, 3>& inds,
+                       Vector3& weights) {
+  SurfacePoint facePoint = point.inSomeFace();
+  Halfedge he = facePoint.face.halfedge();
+  for (int j = 0; j < 3; j++) {
+    inds[j] = geom.vertexIndices[he.vertex()];
+    he = he.next();
+  }
+  weights = facePoint.faceCoords;
+}
+
+} // namespace
+
 VectorHeatMethodSolver::VectorHeatMethodSolver(IntrinsicGeometryInterface& geom_, double tCoef_)
     : tCoef(tCoef_), mesh(geom_.mesh), geom(geom_)
 
@@ -350,6 +370,243 @@ VertexData<Vector2> VectorHeatMethodSolver::computeLogMap(const Vertex& sourceVe
   return result;
 }
 
+// === Batched queries
+
+DenseMatrix<double> VectorHeatMethodSolver::extendScalarBatch(const std::vector<SurfacePoint>& sourcePoints,
+                                                              const DenseMatrix<double>& sourceValues) {
+  if (static_cast<size_t>(sourceValues.rows()) != sourcePoints.size()) {
+    throw std::runtime_error("sourceValues must have one row for each source point");
+  }
+  size_t N = mesh.nVertices();
+  size_t nFields = sourceValues.cols();
+  if (sourcePoints.size() == 0) {
+    return DenseMatrix<double>::Constant(N, nFields, std::numeric_limits<double>::quiet_NaN());
+  }
+
+  ensureHaveScalarHeatSolver();
+  geom.requireVertexIndices();
+
+  std::vector<std::array<size_t, 3>> sourceInds(sourcePoints.size());
+  std::vector<Vector3> sourceWeights(sourcePoints.size());
+  for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+    faceVertexWeights(geom, sourcePoints[iS], sourceInds[iS], sourceWeights[iS]);
+  }
+
+  // The indicator is shared by all of the fields
+  Vector<double> indicatorRHS = Vector<double>::Zero(N);
+  for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+    for (int j = 0; j < 3; j++) {
+      indicatorRHS[sourceInds[iS][j]] += sourceWeights[iS][j];
+    }
+  }
+  Vector<double> indicatorSol = scalarHeatSolver->solve(indicatorRHS);
+
+  DenseMatrix<double> result(N, nFields);
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < nFields; blockStart += blockSize) {
+    size_t B = std::min(blockSize, nFields - blockStart);
+
+    DenseMatrix<double> dataRHS = DenseMatrix<double>::Zero(N, B);
+    for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+      for (size_t b = 0; b < B; b++) {
+        double value = sourceValues(iS, blockStart + b);
+        for (int j = 0; j < 3; j++) {
+          dataRHS(sourceInds[iS][j], b) += sourceWeights[iS][j] * value;
+        }
+      }
+    }
+    DenseMatrix<double> dataSol = scalarHeatSolver->solveMultiple(dataRHS);
+
+    parallelFor(0, B, [&](size_t b) {
+      result.col(blockStart + b) = dataSol.col(b).array() / indicatorSol.array();
+    });
+  }
+
+  geom.unrequireVertexIndices();
+  return result;
+}
+
+DenseMatrix<std::complex<double>>
+VectorHeatMethodSolver::transportTangentVectorBatch(const std::vector<std::tuple<SurfacePoint, Vector2>>& sources) {
+  ensureHaveVectorHeatSolver();
+  geom.requireVertexIndices();
+
+  size_t N = mesh.nVertices();
+  DenseMatrix<std::complex<double>> result(N, sources.size());
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < sources.size(); blockStart += blockSize) {
+    size_t B = std::min(blockSize, sources.size() - blockStart);
+
+    DenseMatrix<std::complex<double>> dirRHS = DenseMatrix<std::complex<double>>::Zero(N, B);
+    for (size_t b = 0; b < B; b++) {
+      std::array<size_t, 3> inds;
+      Vector3 weights;
+      faceVertexWeights(geom, std::get<0>(sources[blockStart + b]), inds, weights);
+      std::complex<double> unitVec = std::get<1>(sources[blockStart + b]).normalize();
+      for (int j = 0; j < 3; j++) {
+        dirRHS(inds[j], b) += weights[j] * unitVec;
+      }
+    }
+    DenseMatrix<std::complex<double>> vecSolution = vectorHeatSolver->solveMultiple(dirRHS);
+
+    // With a single source, can just normalize and scale
+    parallelFor(0, B, [&](size_t b) {
+      double targetNorm = std::get<1>(sources[blockStart + b]).norm();
+      result.col(blockStart + b) = (vecSolution.col(b).array() / vecSolution.col(b).array().abs()) * targetNorm;
+    });
+  }
+
+  geom.unrequireVertexIndices();
+  return result;
+}
+
+DenseMatrix<std::complex<double>> VectorHeatMethodSolver::computeLogMapBatch(const std::vector<Vertex>& sourceVerts,
+                                                                             double vertexDistanceShift) {
+  geom.requireFaceAreas();
+  geom.requireEdgeLengths();
+  geom.requireCornerAngles();
+  geom.requireEdgeCotanWeights();
+  geom.requireHalfedgeVectorsInVertex();
+  geom.requireTransportVectorsAlongHalfedge();
+  geom.requireVertexIndices();
+
+  ensureHaveVectorHeatSolver();
+  ensureHavePoissonSolver();
+
+  // Gather what the divergence needs from each halfedge, once for all sources
+  size_t nHe = mesh.nHalfedges();
+  std::vector<size_t> heTail(nHe), heTip(nHe);
+  std::vector<Vector2> heTipToTail(nHe), heVec(nHe);
+  std::vector<double> heWeight(nHe);
+  size_t iHe = 0;
+  for (Halfedge he : mesh.halfedges()) {
+    heTail[iHe] = geom.vertexIndices[he.vertex()];
+    heTip[iHe] = geom.vertexIndices[he.twin().vertex()];
+    heTipToTail[iHe] = geom.transportVectorsAlongHalfedge[he.twin()];
+    heVec[iHe] = geom.halfedgeVectorsInVertex[he];
+    heWeight[iHe] = geom.edgeCotanWeights[he.edge()];
+    iHe++;
+  }
+
+  size_t N = mesh.nVertices();
+  DenseMatrix<std::complex<double>> result(N, sourceVerts.size());
+  Vector<std::complex<double>> ballRHS(N);
+  size_t blockSize = std::max<size_t>(1, batchBlockSize);
+  for (size_t blockStart = 0; blockStart < sourceVerts.size(); blockStart += blockSize) {
+    size_t B = std::min(blockSize, sourceVerts.size() - blockStart);
+
+    // All of the vector heat solves for the block at once. Columns are:
+    //   [0, B): "radial" field
+    //   [B, 2B): "horizontal" field
+    DenseMatrix<std::complex<double>> rhs = DenseMatrix<std::complex<double>>::Zero(N, 2 * B);
+    for (size_t b = 0; b < B; b++) {
+      Vertex sourceVert = sourceVerts[blockStart + b];
+      ballRHS.setZero();
+      addVertexOutwardBall(sourceVert, ballRHS);
+      rhs.col(b) = ballRHS;
+      rhs(geom.vertexIndices[sourceVert], B + b) += 1.0;
+    }
+    DenseMatrix<std::complex<double>> sol = vectorHeatSolver->solveMultiple(rhs);
+
+    // Normalize, and integrate the radial field to get distance
+    DenseMatrix<double> divergence = DenseMatrix<double>::Zero(N, B);
+    parallelFor(0, B, [&](size_t b) {
+      sol.col(b) = sol.col(b).array() / sol.col(b).array().abs();
+      sol(geom.vertexIndices[sourceVerts[blockStart + b]], b) = 0.;
+      sol.col(B + b) = sol.col(B + b).array() / sol.col(B + b).array().abs();
+
+      for (size_t i = 0; i < nHe; i++) {
+        Vector2 radAtTail = Vector2::fromComplex(sol(heTail[i], b));
+        Vector2 radTipAtTail = heTipToTail[i] * Vector2::fromComplex(sol(heTip[i], b));
+        double fieldAlongEdge = dot(0.5 * (radAtTail + radTipAtTail), heVec[i]);
+        divergence(heTail[i], b) += -heWeight[i] * fieldAlongEdge;
+      }
+    });
+    DenseMatrix<double> distance = poissonSolver->solveMultiple(divergence);
+
+    // Combine distance and angle to get cartesian result
+    parallelFor(0, B, [&](size_t b) {
+      double shift = vertexDistanceShift - distance(geom.vertexIndices[sourceVerts[blockStart + b]], b);
+      for (size_t i = 0; i < N; i++) {
+        result(i, blockStart + b) = sol(i, b) / sol(i, B + b) * (distance(i, b) + shift);
+      }
+    });
+  }
+
+  geom.unrequireFaceAreas();
+  geom.unrequireEdgeLengths();
+  geom.unrequireCornerAngles();
+  geom.unrequireEdgeCotanWeights();
+  geom.unrequireHalfedgeVectorsInVertex();
+  geom.unrequireTransportVectorsAlongHalfedge();
+  geom.unrequireVertexIndices();
+  return result;
+}
+
+DenseMatrix<std::complex<double>>
+VectorHeatMethodSolver::computeLogMapBatch(const std::vector<SurfacePoint>& sourcePoints) {
+  geom.requireHalfedgeVectorsInVertex();
+  geom.requireHalfedgeVectorsInFace();
+
+  // As in computeLogMap(), maps from edges and faces are blended from those at the adjacent vertices. Compute all of
+  // those at once.
+  VertexData<size_t> vertCol(mesh, INVALID_IND);
+  std::vector<Vertex> verts;
+  auto needVertex = [&](Vertex v) {
+    if (vertCol[v] != INVALID_IND) return;
+    vertCol[v] = verts.size();
+    verts.push_back(v);
+  };
+  for (const SurfacePoint& p : sourcePoints) {
+    switch (p.type) {
+    case SurfacePointType::Vertex:
+      needVertex(p.vertex);
+      break;
+    case SurfacePointType::Edge:
+      needVertex(p.edge.halfedge().vertex());
+      needVertex(p.edge.halfedge().twin().vertex());
+      break;
+    case SurfacePointType::Face:
+      for (Vertex v : p.face.adjacentVertices()) needVertex(v);
+      break;
+    }
+  }
+  DenseMatrix<std::complex<double>> vertLogMaps = computeLogMapBatch(verts);
+
+  DenseMatrix<std::complex<double>> result(mesh.nVertices(), sourcePoints.size());
+  parallelFor(0, sourcePoints.size(), [&](size_t iS) {
+    const SurfacePoint& p = sourcePoints[iS];
+    switch (p.type) {
+    case SurfacePointType::Vertex: {
+      result.col(iS) = vertLogMaps.col(vertCol[p.vertex]);
+      break;
+    }
+    case SurfacePointType::Edge: {
+      Halfedge he = p.edge.halfedge();
+      std::complex<double> tailRot = geom.halfedgeVectorsInVertex[he].inv().normalize();
+      std::complex<double> tipRot = -geom.halfedgeVectorsInVertex[he.twin()].inv().normalize();
+      result.col(iS) = (1. - p.tEdge) * tailRot * vertLogMaps.col(vertCol[he.vertex()]) +
+                       p.tEdge * tipRot * vertLogMaps.col(vertCol[he.twin().vertex()]);
+      break;
+    }
+    case SurfacePointType::Face: {
+      result.col(iS).setZero();
+      int iC = 0;
+      for (Halfedge he : p.face.adjacentHalfedges()) {
+        std::complex<double> rot = (geom.halfedgeVectorsInFace[he] / geom.halfedgeVectorsInVertex[he]).normalize();
+        result.col(iS) += p.faceCoords[iC] * rot * vertLogMaps.col(vertCol[he.vertex()]);
+        iC++;
+      }
+      break;
+    }
+    }
+  });
+
+  geom.unrequireHalfedgeVectorsInVertex();
+  geom.unrequireHalfedgeVectorsInFace();
+  return result;
+}
+
 VertexData<double> VectorHeatMethodSolver::scalarDiffuse(const VertexData<double>& rhs) {
   ensureHaveScalarHeatSolver();
   return VertexData<double>(mesh, scalarHeatSolver->solve(rhs.toVector()));
@@ -459,6 +716,7 @@ VertexData<Vector2> VectorHeatMethodSolver::computeLogMap(const SurfacePoint& so
     }
 
     geom.unrequireHalfedgeVectorsInVertex();
+    return resultMap;
     break;
   }
   case SurfacePointType::Face: {
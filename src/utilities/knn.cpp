@@ -1,7 +1,11 @@
 #include "geometrycentral/utilities/knn.h"
 
+#include "geometrycentral/utilities/parallel.h"
+
 #include "nanoflann/nanoflann.hpp"
 
+#include <algorithm>
+
 using std::vector;
 
 namespace geometrycentral {
@@ -30,6 +34,7 @@ public:
 
   // == Constructors
   KNNImpl(const std::vector<Vector3>& points) : data{points}, tree(3, data) { tree.buildIndex(); }
+  KNNImpl(std::vector<Vector3>&& points) : data{std::move(points)}, tree(3, data) { tree.buildIndex(); }
 
   // == Members
 
@@ -91,10 +96,111 @@ public:
 
     return outInds;
   }
+
+  // == Batch queries
+  // nanoflann queries are const, so many may run concurrently against one tree.
+
+  void kNearestNeighborsAll(size_t k, NeighborQueryResult& result) {
+    size_t N = data.rawPoints.size();
+    if ((k + 1) > N) throw std::runtime_error("k+1 is greater than number of points");
+
+    result.offsets.resize(N + 1);
+    result.indices.resize(N * k);
+    result.distancesSq.resize(N * k);
+    for (size_t i = 0; i <= N; i++) result.offsets[i] = i * k;
+
+    // Per-thread scratch for the k+1 results, which include the source point
+    size_t nThreads = getNumThreads();
+    std::vector<std::vector<size_t>> scratchInds(nThreads, std::vector<size_t>(k + 1));
+    std::vector<std::vector<double>> scratchDistSq(nThreads, std::vector<double>(k + 1));
+
+    parallelForWithThreadIndex(
+        0, N, nThreads,
+        [&](size_t iThread, size_t iP) {
+          std::vector<size_t>& inds = scratchInds[iThread];
+          std::vector<double>& distSq = scratchDistSq[iThread];
+          tree.knnSearch(&data.rawPoints[iP][0], k + 1, &inds[0], &distSq[0]);
+
+          // Copy out, skipping the source (or the farthest point, if the source did not appear due to duplicates)
+          size_t iOut = iP * k;
+          size_t nCopied = 0;
+          bool skipped = false;
+          for (size_t j = 0; j < k + 1 && nCopied < k; j++) {
+            if (!skipped && inds[j] == iP) {
+              skipped = true;
+              continue;
+            }
+            result.indices[iOut + nCopied] = inds[j];
+            result.distancesSq[iOut + nCopied] = distSq[j];
+            nCopied++;
+          }
+        },
+        256);
+  }
+
+  void kNearest(const std::vector<Vector3>& queries, size_t k, NeighborQueryResult& result) {
+    if (k > data.rawPoints.size()) throw std::runtime_error("k is greater than number of points");
+
+    size_t N = queries.size();
+    result.offsets.resize(N + 1);
+    result.indices.resize(N * k);
+    result.distancesSq.resize(N * k);
+    for (size_t i = 0; i <= N; i++) result.offsets[i] = i * k;
+
+    parallelFor(
+        0, N,
+        [&](size_t iQ) {
+          if (k == 0) return;
+          Vector3 query = queries[iQ];
+          tree.knnSearch(&query[0], k, &result.indices[iQ * k], &result.distancesSq[iQ * k]);
+        },
+        256);
+  }
+
+  void radiusSearch(const std::vector<Vector3>& queries, double rad, NeighborQueryResult& result) {
+    double radSq = rad * rad;
+    size_t N = queries.size();
+
+    // The number of results per query is not known in advance. Each block of queries gathers its results in a local
+    // buffer, then the blocks are copied into place after a prefix sum over the counts.
+    const size_t blockSize = 256;
+    size_t nBlocks = (N + blockSize - 1) / blockSize;
+    std::vector<std::vector<std::pair<size_t, double>>> blockResults(nBlocks);
+    result.offsets.assign(N + 1, 0);
+
+    parallelFor(0, nBlocks, [&](size_t iB) {
+      std::vector<std::pair<size_t, double>>& blockOut = blockResults[iB];
+      std::vector<std::pair<size_t, double>> queryOut;
+      for (size_t iQ = iB * blockSize; iQ < std::min(N, (iB + 1) * blockSize); iQ++) {
+        Vector3 query = queries[iQ];
+        tree.radiusSearch(&query[0], radSq, queryOut, nanoflann::SearchParams());
+        result.offsets[iQ + 1] = queryOut.size();
+        blockOut.insert(blockOut.end(), queryOut.begin(), queryOut.end());
+      }
+    });
+
+    for (size_t iQ = 0; iQ < N; iQ++) {
+      result.offsets[iQ + 1] += result.offsets[iQ];
+    }
+    result.indices.resize(result.offsets[N]);
+    result.distancesSq.resize(result.offsets[N]);
+
+    parallelFor(0, nBlocks, [&](size_t iB) {
+      size_t iOut = result.offsets[iB * blockSize];
+      for (const std::pair<size_t, double>& entry : blockResults[iB]) {
+        result.indices[iOut] = entry.first;
+        result.distancesSq[iOut] = entry.second;
+        iOut++;
+      }
+    });
+  }
 };
 
 
 NearestNeighborFinder::NearestNeighborFinder(const std::vector<Vector3>& points) { impl.reset(new KNNImpl(points)); }
+NearestNeighborFinder::NearestNeighborFinder(std::vector<Vector3>&& points) {
+  impl.reset(new KNNImpl(std::move(points)));
+}
 NearestNeighborFinder::~NearestNeighborFinder() = default;
 
 std::vector<size_t> NearestNeighborFinder::kNearest(Vector3 query, size_t k) { return impl->kNearest(query, k); }
@@ -106,4 +212,17 @@ std::vector<size_t> NearestNeighborFinder::radiusSearch(Vector3 query, double ra
   return impl->radiusSearch(query, rad);
 }
 
+void NearestNeighborFinder::kNearestNeighborsAll(size_t k, NeighborQueryResult& result) {
+  impl->kNearestNeighborsAll(k, result);
+}
+
+void NearestNeighborFinder::kNearest(const std::vector<Vector3>& queries, size_t k, NeighborQueryResult& result) {
+  impl->kNearest(queries, k, result);
+}
+
+void NearestNeighborFinder::radiusSearch(const std::vector<Vector3>& queries, double rad,
+                                         NeighborQueryResult& result) {
+  impl->radiusSearch(queries, rad, result);
+}
+
 } // namespace geometrycentral
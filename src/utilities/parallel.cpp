@@ -0,0 +1,29 @@
+#include "geometrycentral/utilities/parallel.h"
+
+#include <atomic>
+#include <thread>
+
+namespace geometrycentral {
+
+namespace {
+std::atomic<size_t> requestedNumThreads{0};
+} // namespace
+
+void setNumThreads(size_t n) { requestedNumThreads = n; }
+
+size_t getNumThreads() {
+  size_t n = requestedNumThreads;
+  if (n == 0) {
+    n = std::thread::hardware_concurrency();
+  }
+  return n == 0 ? 1 : n;
+}
+
+namespace detail {
+bool& inParallelRegion() {
+  static thread_local bool inRegion = false;
+  return inRegion;
+}
+} // namespace detail
+
+} // namespace geometrycentral
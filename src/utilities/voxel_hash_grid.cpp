@@ -0,0 +1,243 @@
+#include "geometrycentral/utilities/voxel_hash_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace geometrycentral {
+
+VoxelKey voxelKeyOf(Vector3 p, double voxelSize) {
+  return VoxelKey{{static_cast<int64_t>(std::floor(p.x / voxelSize)), static_cast<int64_t>(std::floor(p.y / voxelSize)),
+                   static_cast<int64_t>(std::floor(p.z / voxelSize))}};
+}
+
+VoxelBuckets::VoxelBuckets(const std::vector<Vector3>& points, double voxelSize) {
+  if (!(voxelSize > 0.)) throw std::runtime_error("voxel size must be positive");
+  for (size_t i = 0; i < points.size(); i++) {
+    VoxelKey key = voxelKeyOf(points[i], voxelSize);
+    auto it = index.emplace(key, keys.size());
+    if (it.second) {
+      keys.push_back(key);
+      members.emplace_back();
+    }
+    members[it.first->second].push_back(i);
+  }
+}
+
+size_t VoxelBuckets::find(const VoxelKey& key) const {
+  auto it = index.find(key);
+  return it == index.end() ? INVALID_IND : it->second;
+}
+
+VoxelHashGrid::VoxelHashGrid(double voxelSize_) : cellSize(voxelSize_) {
+  if (!(cellSize > 0.)) throw std::runtime_error("voxel size must be positive");
+  clear();
+}
+
+int64_t VoxelHashGrid::shellBound(const VoxelKey& center) const {
+  int64_t rMax = 0;
+  for (int j = 0; j < 3; j++) {
+    rMax = std::max(rMax, std::max(center[j] - minKey[j], maxKey[j] - center[j]));
+  }
+  return rMax;
+}
+
+int64_t VoxelHashGrid::shellStart(const VoxelKey& center) const {
+  int64_t rMin = 0;
+  for (int j = 0; j < 3; j++) {
+    rMin = std::max(rMin, std::max(minKey[j] - center[j], center[j] - maxKey[j]));
+  }
+  return rMin;
+}
+
+void VoxelHashGrid::insert(size_t id, Vector3 pos) {
+  if (id >= positions.size()) {
+    size_t newSize = std::max(id + 1, 2 * positions.size());
+    positions.resize(newSize);
+    slotInVoxel.resize(newSize, INVALID_IND);
+  }
+  if (slotInVoxel[id] != INVALID_IND) throw std::runtime_error("point is already in the grid");
+
+  VoxelKey key = keyOf(pos);
+  std::vector<size_t>& voxel = voxels[key];
+  slotInVoxel[id] = voxel.size();
+  voxel.push_back(id);
+  positions[id] = pos;
+  count++;
+
+  for (int j = 0; j < 3; j++) {
+    minKey[j] = std::min(minKey[j], key[j]);
+    maxKey[j] = std::max(maxKey[j], key[j]);
+  }
+}
+
+void VoxelHashGrid::remove(size_t id) {
+  if (!contains(id)) throw std::runtime_error("point is not in the grid");
+
+  // Swap-and-pop within the voxel
+  VoxelKey key = keyOf(positions[id]);
+  auto it = voxels.find(key);
+  std::vector<size_t>& voxel = it->second;
+  size_t slot = slotInVoxel[id];
+  voxel[slot] = voxel.back();
+  slotInVoxel[voxel[slot]] = slot;
+  voxel.pop_back();
+  if (voxel.empty()) voxels.erase(it);
+
+  slotInVoxel[id] = INVALID_IND;
+  count--;
+}
+
+void VoxelHashGrid::move(size_t id, Vector3 newPos) {
+  if (!contains(id)) throw std::runtime_error("point is not in the grid");
+  if (keyOf(newPos) == keyOf(positions[id])) {
+    positions[id] = newPos;
+    return;
+  }
+  remove(id);
+  insert(id, newPos);
+}
+
+void VoxelHashGrid::clear() {
+  voxels.clear();
+  positions.clear();
+  slotInVoxel.clear();
+  count = 0;
+  for (int j = 0; j < 3; j++) {
+    minKey[j] = std::numeric_limits<int64_t>::max();
+    maxKey[j] = std::numeric_limits<int64_t>::min();
+  }
+}
+
+bool VoxelHashGrid::contains(size_t id) const { return id < slotInVoxel.size() && slotInVoxel[id] != INVALID_IND; }
+
+template <typename F>
+void VoxelHashGrid::forEachInShell(const VoxelKey& center, int64_t r, F&& f) const {
+  auto visit = [&](int64_t i, int64_t j, int64_t k) {
+    if (i < minKey[0] || i > maxKey[0] || j < minKey[1] || j > maxKey[1] || k < minKey[2] || k > maxKey[2]) return;
+    auto it = voxels.find(VoxelKey{{i, j, k}});
+    if (it == voxels.end()) return;
+    for (size_t id : it->second) f(id);
+  };
+
+  if (r == 0) {
+    visit(center[0], center[1], center[2]);
+    return;
+  }
+
+  // Only the intersection of the shell with the occupied bounds matters
+  int64_t iMin = std::max(center[0] - r, minKey[0]), iMax = std::min(center[0] + r, maxKey[0]);
+  int64_t jMin = std::max(center[1] - r, minKey[1]), jMax = std::min(center[1] + r, maxKey[1]);
+  for (int64_t i = iMin; i <= iMax; i++) {
+    for (int64_t j = jMin; j <= jMax; j++) {
+      bool onShellIJ = std::abs(i - center[0]) == r || std::abs(j - center[1]) == r;
+      if (onShellIJ) {
+        int64_t kMin = std::max(center[2] - r, minKey[2]), kMax = std::min(center[2] + r, maxKey[2]);
+        for (int64_t k = kMin; k <= kMax; k++) visit(i, j, k);
+      } else {
+        visit(i, j, center[2] - r);
+        visit(i, j, center[2] + r);
+      }
+    }
+  }
+}
+
+template <typename F>
+void VoxelHashGrid::forEachBeyondShell(const VoxelKey& center, int64_t r, F&& f) const {
+  for (const auto& entry : voxels) {
+    const VoxelKey& key = entry.first;
+    int64_t dist = 0;
+    for (int j = 0; j < 3; j++) dist = std::max(dist, std::abs(key[j] - center[j]));
+    if (dist < r) continue;
+    for (size_t id : entry.second) f(id);
+  }
+}
+
+bool VoxelHashGrid::shellIsLarge(int64_t r) const {
+  // (a shell of radius r has 24r^2 + 2 voxels)
+  double shellSize = 24. * static_cast<double>(r) * static_cast<double>(r) + 2.;
+  return shellSize > static_cast<double>(voxels.size());
+}
+
+void VoxelHashGrid::kNearest(Vector3 query, size_t k, std::vector<size_t>& indices, std::vector<double>& distancesSq,
+                             size_t excludeId) const {
+  indices.clear();
+  distancesSq.clear();
+  if (k == 0 || count == 0) return;
+
+  // Max-heap of the best candidates so far
+  std::priority_queue<std::pair<double, size_t>> best;
+  auto consider = [&](size_t id) {
+    if (id == excludeId) return;
+    double d2 = norm2(positions[id] - query);
+    if (best.size() < k) {
+      best.emplace(d2, id);
+    } else if (d2 < best.top().first) {
+      best.pop();
+      best.emplace(d2, id);
+    }
+  };
+
+  // Search outward in shells of voxels. Once all shells up to r have been visited, any other point is at least
+  // r * cellSize away.
+  VoxelKey center = keyOf(query);
+  int64_t rMax = shellBound(center);
+  for (int64_t r = shellStart(center); r <= rMax; r++) {
+    if (shellIsLarge(r)) {
+      forEachBeyondShell(center, r, consider);
+      break;
+    }
+    forEachInShell(center, r, consider);
+    if (best.size() == k) {
+      double reach = r * cellSize;
+      if (best.top().first <= reach * reach) break;
+    }
+  }
+
+  // Copy out in increasing order
+  indices.resize(best.size());
+  distancesSq.resize(best.size());
+  for (size_t i = best.size(); i > 0; i--) {
+    distancesSq[i - 1] = best.top().first;
+    indices[i - 1] = best.top().second;
+    best.pop();
+  }
+}
+
+std::vector<size_t> VoxelHashGrid::kNearest(Vector3 query, size_t k, size_t excludeId) const {
+  std::vector<size_t> indices;
+  std::vector<double> distancesSq;
+  kNearest(query, k, indices, distancesSq, excludeId);
+  return indices;
+}
+
+void VoxelHashGrid::radiusSearch(Vector3 query, double rad, std::vector<size_t>& indices) const {
+  indices.clear();
+  if (count == 0) return;
+
+  double rad2 = rad * rad;
+  VoxelKey center = keyOf(query);
+  int64_t rMax = shellBound(center);
+  double radCells = std::ceil(rad / cellSize);
+  if (radCells < rMax) rMax = static_cast<int64_t>(radCells);
+  auto consider = [&](size_t id) {
+    if (norm2(positions[id] - query) <= rad2) indices.push_back(id);
+  };
+  for (int64_t r = shellStart(center); r <= rMax; r++) {
+    if (shellIsLarge(r)) {
+      forEachBeyondShell(center, r, consider);
+      break;
+    }
+    forEachInShell(center, r, consider);
+  }
+}
+
+std::vector<size_t> VoxelHashGrid::radiusSearch(Vector3 query, double rad) const {
+  std::vector<size_t> indices;
+  radiusSearch(query, rad, indices);
+  return indices;
+}
+
+} // namespace geometrycentral
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "geometrycentral/utilities/parallel.h"
+
+#include <cstddef>
+
+// Sets the number of threads for the rest of a scope, restoring the default afterwards (also when an assertion fails
+// and returns early)
+struct ScopedNumThreads {
+  ScopedNumThreads(size_t n) { geometrycentral::setNumThreads(n); }
+  ~ScopedNumThreads() { geometrycentral::setNumThreads(0); }
+};
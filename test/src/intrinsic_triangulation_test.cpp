@@ -3,10 +3,13 @@
 #include "geometrycentral/surface/manifold_surface_mesh.h"
 #include "geometrycentral/surface/meshio.h"
 #include "geometrycentral/surface/signpost_intrinsic_triangulation.h"
+#include "geometrycentral/surface/simple_idt.h"
 #include "geometrycentral/surface/transfer_functions.h"
 #include "geometrycentral/surface/vertex_position_geometry.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include "load_test_meshes.h"
+#include "parallel_test_helpers.h"
 
 #include "gtest/gtest.h"
 
@@ -47,6 +50,30 @@ TEST_F(IntrinsicTriangulationSuite, IntegerFlip) {
   }
 }
 
+TEST_F(IntrinsicTriangulationSuite, ParallelFlip) {
+  ScopedNumThreads threads(4);
+  for (const MeshAsset& a : {getAsset("fox.ply", true), getAsset("cat_head.obj", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& origGeometry = *a.geometry;
+
+    SignpostIntrinsicTriangulation tri(mesh, origGeometry);
+    tri.flipToDelaunayParallel();
+    EXPECT_TRUE(tri.isDelaunay());
+
+    // The plain edge-length version
+    std::unique_ptr<ManifoldSurfaceMesh> meshCopy = mesh.copy();
+    origGeometry.requireEdgeLengths();
+    EdgeData<double> lengths = origGeometry.edgeLengths.reinterpretTo(*meshCopy);
+    size_t nFlips = flipToDelaunayParallel(*meshCopy, lengths);
+    EXPECT_GT(nFlips, 0u);
+    EdgeLengthGeometry flippedGeom(*meshCopy, lengths);
+    for (Edge e : meshCopy->edges()) {
+      EXPECT_GE(flippedGeom.edgeCotanWeight(e), -1e-6);
+    }
+  }
+}
+
 TEST_F(IntrinsicTriangulationSuite, DelaunayTriangulationsAgree) {
   for (const MeshAsset& a : {getAsset("fox.ply", true), getAsset("cat_head.obj", true)}) {
     a.printThyName();
@@ -272,6 +299,23 @@ TEST_F(IntrinsicTriangulationSuite, IntegerRefine) {
   }
 }
 
+TEST_F(IntrinsicTriangulationSuite, RefineStats) {
+  for (const MeshAsset& a : {getAsset("fox.ply", true), getAsset("cat_head.obj", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& origGeometry = *a.geometry;
+
+    IntegerCoordinatesIntrinsicTriangulation tri(mesh, origGeometry);
+
+    DelaunayRefineStats stats = tri.delaunayRefine();
+    EXPECT_TRUE(tri.isDelaunay());
+    EXPECT_GE(tri.minAngleDegrees(), 25);
+
+    EXPECT_GT(stats.nInsertions, 0u);
+    EXPECT_EQ(tri.mesh.nVertices(), tri.inputMesh.nVertices() + stats.nInsertions - stats.nRemovals);
+  }
+}
+
 TEST_F(IntrinsicTriangulationSuite, SignpostCommonSubdivision) {
   for (const MeshAsset& a : {getAsset("fox.ply", true), getAsset("cat_head.obj", true)}) {
     a.printThyName();
@@ -401,6 +445,43 @@ TEST_F(IntrinsicTriangulationSuite, FunctionTransfer) {
   }
 }
 
+TEST_F(IntrinsicTriangulationSuite, BatchedFunctionTransfer) {
+  for (const MeshAsset& a : {getAsset("fox.ply", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& origGeometry = *a.geometry;
+
+    IntegerCoordinatesIntrinsicTriangulation tri(mesh, origGeometry);
+
+    tri.delaunayRefine();
+    CommonSubdivision& cs = tri.getCommonSubdivision();
+
+    AttributeTransfer transfer(cs, origGeometry);
+    DenseMatrix<double> data_B = DenseMatrix<double>::Random(tri.intrinsicMesh->nVertices(), 4);
+
+    // Each channel of the batched transfer should match transferring it alone
+    for (TransferMethod method : {TransferMethod::Pointwise, TransferMethod::L2}) {
+      DenseMatrix<double> data_A = transfer.transferBtoA(data_B, method);
+      ASSERT_EQ((size_t)data_A.rows(), mesh.nVertices());
+      ASSERT_EQ(data_A.cols(), 4);
+      for (int j = 0; j < 4; j++) {
+        Vector<double> col = data_B.col(j);
+        VertexData<double> single = transfer.transferBtoA(VertexData<double>(*tri.intrinsicMesh, col), method);
+        EXPECT_LE((single.toVector() - data_A.col(j)).norm(), 1e-8);
+      }
+    }
+
+    // Vector-valued data goes through the same path
+    VertexData<Vector3> positionsB = transfer.transferAtoB(origGeometry.vertexPositions, TransferMethod::Pointwise);
+    for (Vertex v : tri.intrinsicMesh->vertices()) {
+      if (tri.vertexLocations[v].type == SurfacePointType::Vertex) {
+        Vertex vA = tri.vertexLocations[v].vertex;
+        EXPECT_LE((positionsB[v] - origGeometry.vertexPositions[vA]).norm(), 1e-8);
+      }
+    }
+  }
+}
+
 TEST_F(IntrinsicTriangulationSuite, CommonSubdivisionGeometry) {
   for (const MeshAsset& a : {getAsset("fox.ply", true)}) {
     a.printThyName();
@@ -387,6 +387,21 @@ TEST_F(LinearAlgebraTestSuite, TestLDLTSolvers) {
     Vector<double> x3;
     solver.solve(x3, rhs);
     EXPECT_LT(residual(mat, x3, rhs), 1e-4);
+
+    // new values, same pattern: analysis is reused
+    SparseMatrix<double> mat2 = buildSPDTestMatrix<double>();
+    mat2 = mat2.topLeftCorner(100, 100);
+    EXPECT_TRUE(solver.refactor(mat2));
+    Vector<double> x4 = solver.solve(rhs);
+    EXPECT_LT(residual(mat2, x4, rhs), 1e-4);
+
+    // different pattern: factors from scratch
+    SparseMatrix<double> mat3 = buildSPDTestMatrix<double>();
+    mat3 = mat3.topLeftCorner(80, 80);
+    Vector<double> rhs3 = randomVector<double>(mat3.rows());
+    EXPECT_FALSE(solver.refactor(mat3));
+    Vector<double> x5 = solver.solve(rhs3);
+    EXPECT_LT(residual(mat3, x5, rhs3), 1e-4);
   }
 
   { // std::complex<double>
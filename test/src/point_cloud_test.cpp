@@ -1,3 +1,6 @@
+#include "geometrycentral/pointcloud/incremental_point_geometry.h"
+#include "geometrycentral/pointcloud/local_triangulation.h"
+#include "geometrycentral/pointcloud/orient_normals.h"
 #include "geometrycentral/pointcloud/point_cloud.h"
 #include "geometrycentral/pointcloud/point_cloud_heat_solver.h"
 #include "geometrycentral/pointcloud/point_cloud_io.h"
@@ -5,10 +8,20 @@
 #include "geometrycentral/pointcloud/point_position_geometry.h"
 #include "geometrycentral/pointcloud/point_position_normal_geometry.h"
 #include "geometrycentral/pointcloud/sample_cloud.h"
+#include "geometrycentral/pointcloud/tiled_point_cloud.h"
+#include "geometrycentral/surface/meshio.h"
+#include "geometrycentral/utilities/knn.h"
+#include "geometrycentral/utilities/parallel.h"
+#include "geometrycentral/utilities/voxel_hash_grid.h"
+
+#include "parallel_test_helpers.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -42,6 +55,25 @@ std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>> generateRandomCloud(
   return std::make_tuple(std::move(cloud), pos);
 }
 
+// Uniformly random points in the unit cube. Each call uses its own generator, so a test's points do not depend on which
+// other tests have run before it.
+std::vector<Vector3> randomPoints(size_t nPts, unsigned int seed) {
+  std::mt19937 localMt(seed);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<Vector3> points(nPts);
+  for (Vector3& p : points) p = Vector3{dist(localMt), dist(localMt), dist(localMt)};
+  return points;
+}
+
+// A random cloud in the unit cube, as above
+std::tuple<std::unique_ptr<PointCloud>, PointData<Vector3>> randomCloud(size_t nPts, unsigned int seed) {
+  std::vector<Vector3> points = randomPoints(nPts, seed);
+  std::unique_ptr<PointCloud> cloud(new PointCloud(nPts));
+  PointData<Vector3> pos(*cloud);
+  for (size_t i = 0; i < nPts; i++) pos[i] = points[i];
+  return std::make_tuple(std::move(cloud), pos);
+}
+
 } // namespace
 
 class PointCloudSuite : public ::testing::Test {};
@@ -90,6 +122,14 @@ TEST_F(PointCloudSuite, ContainerBasics) {
   }
 }
 
+TEST_F(PointCloudSuite, ContainerOutlivesCloud) {
+  // Data may be destroyed after its cloud; the cloud detaches it on deletion
+  std::unique_ptr<PointCloud> cloud(new PointCloud(16));
+  PointData<double> vals(*cloud, 1.);
+  cloud.reset();
+  EXPECT_EQ(vals.getMesh(), nullptr);
+}
+
 
 // ============================================================
 // =============== Geometry tests
@@ -184,7 +224,7 @@ TEST_F(PointCloudSuite, GeometryQuantity_Neighbors) {
 
   geom.requireNeighbors();
   for (Point p : cloud->points()) {
-    std::vector<Point>& neigh = geom.neighbors->neighbors[p];
+    NeighborList neigh = geom.neighbors->neighbors[p];
     size_t M = neigh.size();
     EXPECT_EQ(M, geom.kNeighborSize);
     std::unordered_set<Point> seenNeigh;
@@ -193,6 +233,62 @@ TEST_F(PointCloudSuite, GeometryQuantity_Neighbors) {
       Point pN = neigh[iN];
       EXPECT_EQ(seenNeigh.find(pN), seenNeigh.end()); // shouldn't have seen
       seenNeigh.insert(pN);
+
+      // flat storage agrees with the view, and is sorted by distance
+      EXPECT_EQ(neigh.index(iN), pN.getIndex());
+      EXPECT_NEAR(neigh.distanceSquared(iN), norm2(pos[pN] - pos[p]), 1e-9);
+      if (iN > 0) EXPECT_LE(neigh.distanceSquared(iN - 1), neigh.distanceSquared(iN));
+    }
+  }
+  EXPECT_EQ(geom.neighbors->neighborStart.back(), geom.neighbors->neighborIndices.size());
+}
+
+TEST_F(PointCloudSuite, BatchNeighborQueries) {
+  size_t N = 1000;
+  size_t k = 8;
+  std::vector<Vector3> points = randomPoints(N, 7);
+  std::vector<Vector3> queries = randomPoints(100, 8);
+
+  ScopedNumThreads threads(4);
+  NearestNeighborFinder finder(points);
+  NeighborQueryResult result;
+
+  // All-points kNN matches the one-at-a-time query
+  finder.kNearestNeighborsAll(k, result);
+  ASSERT_EQ(result.nQueries(), N);
+  for (size_t i = 0; i < N; i++) {
+    ASSERT_EQ(result.nNeighbors(i), k);
+    std::vector<size_t> single = finder.kNearestNeighbors(i, k);
+    for (size_t j = 0; j < k; j++) {
+      size_t iN = result.indices[result.offsets[i] + j];
+      EXPECT_EQ(iN, single[j]);
+      EXPECT_NEAR(result.distancesSq[result.offsets[i] + j], norm2(points[iN] - points[i]), 1e-12);
+    }
+  }
+
+  // kNN for arbitrary queries
+  finder.kNearest(queries, k, result);
+  ASSERT_EQ(result.nQueries(), queries.size());
+  for (size_t i = 0; i < queries.size(); i++) {
+    std::vector<size_t> single = finder.kNearest(queries[i], k);
+    for (size_t j = 0; j < k; j++) {
+      EXPECT_EQ(result.indices[result.offsets[i] + j], single[j]);
+    }
+  }
+
+  // Radius search returns exactly the points in the ball, sorted by distance
+  double rad = 0.15;
+  finder.radiusSearch(queries, rad, result);
+  ASSERT_EQ(result.nQueries(), queries.size());
+  for (size_t i = 0; i < queries.size(); i++) {
+    std::unordered_set<size_t> expected;
+    for (size_t iP = 0; iP < N; iP++) {
+      if (norm(points[iP] - queries[i]) <= rad) expected.insert(iP);
+    }
+    ASSERT_EQ(result.nNeighbors(i), expected.size());
+    for (size_t j = result.offsets[i]; j < result.offsets[i + 1]; j++) {
+      EXPECT_NE(expected.find(result.indices[j]), expected.end());
+      if (j > result.offsets[i]) EXPECT_LE(result.distancesSq[j - 1], result.distancesSq[j]);
     }
   }
 }
@@ -212,6 +308,53 @@ TEST_F(PointCloudSuite, GeometryQuantity_Normals) {
 }
 
 
+TEST_F(PointCloudSuite, NormalEstimationAndOrientation) {
+  // Two well-separated unit spheres
+  std::mt19937 rng(39);
+  std::normal_distribution<double> gauss;
+  size_t N = 4000;
+  std::vector<Vector3> centers{Vector3{0., 0., 0.}, Vector3{10., 0., 3.}};
+  std::unique_ptr<PointCloud> cloud(new PointCloud(N));
+  PointData<Vector3> pos(*cloud);
+  for (size_t i = 0; i < N; i++) {
+    Vector3 d{gauss(rng), gauss(rng), gauss(rng)};
+    pos[i] = centers[i % 2] + unit(d);
+  }
+  PointPositionGeometry geom(*cloud, pos);
+
+  // Unoriented normals are radial, and do not depend on the number of threads
+  ScopedNumThreads threads(1);
+  geom.requireNormals();
+  PointData<Vector3> serialNormals = geom.normals;
+  geom.unrequireNormals();
+  geom.refreshQuantities();
+  setNumThreads(4);
+  geom.requireNormals();
+  for (size_t i = 0; i < N; i++) {
+    EXPECT_EQ(geom.normals[i], serialNormals[i]);
+    EXPECT_GT(std::abs(dot(geom.normals[i], unit(pos[i] - centers[i % 2]))), 0.98);
+  }
+
+  // Oriented normals point outward on both spheres
+  PointData<Vector3> oriented = orientNormals(geom);
+  for (size_t i = 0; i < N; i++) {
+    EXPECT_NEAR(std::abs(dot(oriented[i], geom.normals[i])), 1., 1e-12);
+    EXPECT_GT(dot(oriented[i], pos[i] - centers[i % 2]), 0.);
+  }
+
+  // Any reference direction gives outward normals on a closed surface, whatever the starting signs
+  std::uniform_int_distribution<int> coin(0, 1);
+  PointData<Vector3> scrambled = oriented;
+  for (size_t i = 0; i < N; i++) {
+    if (coin(rng)) scrambled[i] *= -1.;
+  }
+  orientNormals(geom, scrambled, Vector3{1., -2., 0.5});
+  for (size_t i = 0; i < N; i++) {
+    EXPECT_EQ(scrambled[i], oriented[i]);
+  }
+}
+
+
 TEST_F(PointCloudSuite, GeometryQuantity_Basis) {
   // Make the geometry
   size_t N = 256;
@@ -239,8 +382,8 @@ TEST_F(PointCloudSuite, GeometryQuantity_TangentCoords) {
   geom.requireTangentCoordinates();
   geom.requireNeighbors();
   for (Point p : cloud->points()) {
-    std::vector<Vector2>& coords = geom.tangentCoordinates[p];
-    std::vector<Point>& neigh = geom.neighbors->neighbors[p];
+    NeighborSpan<Vector2> coords = geom.tangentCoordinates[p];
+    NeighborList neigh = geom.neighbors->neighbors[p];
     EXPECT_EQ(coords.size(), neigh.size());
     for (Vector2 c : coords) {
       EXPECT_TRUE(isfinite(c));
@@ -259,8 +402,8 @@ TEST_F(PointCloudSuite, GeometryQuantity_TangentTransport) {
   geom.requireTangentTransport();
   geom.requireNeighbors();
   for (Point p : cloud->points()) {
-    std::vector<Vector2>& trans = geom.tangentTransport[p];
-    std::vector<Point>& neigh = geom.neighbors->neighbors[p];
+    NeighborSpan<Vector2> trans = geom.tangentTransport[p];
+    NeighborList neigh = geom.neighbors->neighbors[p];
     EXPECT_EQ(trans.size(), neigh.size());
     for (Vector2 t : trans) {
       EXPECT_NEAR(t.norm(), 1.0, 1e-6);
@@ -306,6 +449,47 @@ TEST_F(PointCloudSuite, GeometryQuantity_Laplacian) {
   EXPECT_NEAR(geom.laplacian.sum(), 0., 1e-5);
 }
 
+TEST_F(PointCloudSuite, ParallelLocalTriangulationAndLaplacian) {
+  size_t N = 500;
+  std::unique_ptr<PointCloud> cloudPtr;
+  PointData<Vector3> pos;
+  std::tie(cloudPtr, pos) = randomCloud(N, 11);
+  PointCloud& cloud = *cloudPtr;
+
+  // Serial reference
+  ScopedNumThreads threads(1);
+  PointPositionGeometry geomSerial(cloud, pos);
+  LocalTriangulationResult triSerial = buildLocalTriangulationsFlat(cloud, geomSerial);
+  geomSerial.requireLaplacian();
+
+  setNumThreads(4);
+  PointPositionGeometry geom(cloud, pos);
+  LocalTriangulationResult tri = buildLocalTriangulationsFlat(cloud, geom);
+  PointData<std::vector<std::array<Point, 3>>> triNested = buildLocalTriangulations(cloud, geom);
+  geom.requireLaplacian();
+
+  // Local triangulations agree with each other, and with the nested representation
+  EXPECT_EQ(tri.triangleStart, triSerial.triangleStart);
+  EXPECT_EQ(tri.triangles, triSerial.triangles);
+  for (Point p : cloud.points()) {
+    size_t iP = p.getIndex();
+    ASSERT_EQ(triNested[p].size(), tri.triangleStart[iP + 1] - tri.triangleStart[iP]);
+    for (size_t iT = 0; iT < triNested[p].size(); iT++) {
+      const std::array<size_t, 3>& flatTri = tri.triangles[tri.triangleStart[iP] + iT];
+      EXPECT_EQ(flatTri[0], iP);
+      for (size_t j = 0; j < 3; j++) {
+        EXPECT_EQ(triNested[p][iT][j].getIndex(), flatTri[j]);
+      }
+    }
+  }
+
+  // Laplacians agree, and match the cotan Laplacian of the tufted triangulation
+  EXPECT_NEAR((geom.laplacian - geomSerial.laplacian).norm(), 0., 1e-8);
+  geom.tuftedGeom->requireCotanLaplacian();
+  EXPECT_NEAR((geom.laplacian - geom.tuftedGeom->cotanLaplacian).norm(), 0., 1e-8);
+  checkSymmetric(geom.laplacian);
+}
+
 TEST_F(PointCloudSuite, GeometryQuantity_ConnectionLaplacian) {
   // Make the geometry
   size_t N = 256;
@@ -447,6 +631,70 @@ TEST_F(PointCloudSuite, HeatSolverLogmap) {
   EXPECT_EQ(norm(logmap[pSource]), 0.);
 }
 
+TEST_F(PointCloudSuite, HeatSolverBatch) {
+  size_t N = 256;
+  std::unique_ptr<PointCloud> cloudPtr;
+  PointData<Vector3> pos;
+  std::tie(cloudPtr, pos) = randomCloud(N, 23);
+  PointCloud& cloud = *cloudPtr;
+  PointPositionGeometry geom(cloud, pos);
+
+  PointCloudHeatSolver solver(cloud, geom);
+  solver.batchBlockSize = 3; // exercise several blocks, and a partial one
+  HeatMethodDistanceSolver referenceSolver(*geom.tuftedGeom);
+
+  std::vector<Point> sources;
+  std::vector<std::tuple<Point, Vector2>> vecSources;
+  for (size_t i = 0; i < 7; i++) {
+    sources.push_back(cloud.point(11 * i));
+    vecSources.emplace_back(cloud.point(11 * i), Vector2{1. + i, 2.});
+  }
+
+  // Batched results match the one-at-a-time queries, which solve their right hand sides one by one (distance through
+  // the surface heat method on the tufted triangulation, and log maps with separate heat solves)
+  std::vector<PointData<double>> distBatch = solver.computeDistanceBatch(sources);
+  std::vector<PointData<Vector2>> transportBatch = solver.transportTangentVectorBatch(vecSources);
+  std::vector<PointData<Vector2>> logmapBatch = solver.computeLogMapBatch(sources);
+  ASSERT_EQ(distBatch.size(), sources.size());
+  ASSERT_EQ(transportBatch.size(), sources.size());
+  ASSERT_EQ(logmapBatch.size(), sources.size());
+  for (size_t iS = 0; iS < sources.size(); iS++) {
+    PointData<double> distSingle = solver.computeDistance(sources[iS]);
+    PointData<Vector2> transportSingle =
+        solver.transportTangentVector(std::get<0>(vecSources[iS]), std::get<1>(vecSources[iS]));
+    PointData<Vector2> logmapSingle = solver.computeLogMap(sources[iS]);
+    VertexData<double> distReference =
+        referenceSolver.computeDistance(geom.tuftedMesh->vertex(sources[iS].getIndex()));
+    for (Point p : cloud.points()) {
+      EXPECT_NEAR(distBatch[iS][p], distReference[p.getIndex()], 1e-8);
+      EXPECT_NEAR(distBatch[iS][p], distSingle[p], 1e-8);
+      EXPECT_NEAR(norm(transportBatch[iS][p] - transportSingle[p]), 0., 1e-8);
+      EXPECT_NEAR(norm(logmapBatch[iS][p] - logmapSingle[p]), 0., 1e-8);
+    }
+  }
+
+  // Refreshing with unchanged positions reuses every factorization
+  geom.refreshQuantities();
+  EXPECT_TRUE(solver.updateGeometry());
+
+  // After moving the points, results match a fresh solver
+  std::vector<Vector3> offsets = randomPoints(N, 24);
+  for (Point p : cloud.points()) {
+    geom.positions[p] += 1e-4 * offsets[p.getIndex()];
+  }
+  geom.refreshQuantities();
+  solver.updateGeometry();
+  PointCloudHeatSolver freshSolver(cloud, geom);
+  PointData<double> distUpdated = solver.computeDistance(sources[0]);
+  PointData<double> distFresh = freshSolver.computeDistance(sources[0]);
+  PointData<Vector2> transportUpdated = solver.transportTangentVector(sources[0], Vector2{1., 0.});
+  PointData<Vector2> transportFresh = freshSolver.transportTangentVector(sources[0], Vector2{1., 0.});
+  for (Point p : cloud.points()) {
+    EXPECT_NEAR(distUpdated[p], distFresh[p], 1e-8);
+    EXPECT_NEAR(norm(transportUpdated[p] - transportFresh[p]), 0., 1e-8);
+  }
+}
+
 // ============================================================
 // =============== Utility tests
 // ============================================================
@@ -504,3 +752,400 @@ TEST_F(PointCloudSuite, ReadWrite_obj) {
     EXPECT_NEAR(geom.positions[iP].z, newGeom->positions[iP].z, 1e-8);
   }
 }
+
+TEST_F(PointCloudSuite, ReadWrite_attributes) {
+  size_t N = 300;
+  std::unique_ptr<PointCloud> cloudPtr;
+  PointData<Vector3> pos;
+  std::tie(cloudPtr, pos) = randomCloud(N, 17);
+  PointCloud& cloud = *cloudPtr;
+  PointPositionGeometry geom(cloud, pos);
+  std::vector<Vector3> normalDirs = randomPoints(N, 18);
+  PointCloudAttributes attributes;
+  attributes.normals = PointData<Vector3>(cloud);
+  attributes.scalars["intensity"] = PointData<double>(cloud);
+  for (size_t i = 0; i < N; i++) {
+    attributes.normals[i] = unit(normalDirs[i] - Vector3{0.5, 0.5, 0.5});
+    attributes.scalars["intensity"][i] = normalDirs[i].x;
+  }
+
+  for (std::string type : {"ply", "gcpc", "obj"}) {
+    if (type == "obj") attributes.scalars.clear();
+
+    std::string filename = "test_attributes." + type;
+    writePointCloud(cloud, geom, attributes, filename);
+
+    std::unique_ptr<PointCloud> newCloud;
+    std::unique_ptr<PointPositionGeometry> newGeom;
+    PointCloudAttributes newAttributes;
+    std::tie(newCloud, newGeom, newAttributes) = readPointCloudWithAttributes(filename);
+
+    ASSERT_EQ(newCloud->nPoints(), N);
+    ASSERT_EQ(newAttributes.normals.size(), N);
+    ASSERT_EQ(newAttributes.scalars.size(), attributes.scalars.size());
+    for (size_t i = 0; i < N; i++) {
+      EXPECT_EQ(newGeom->positions[i], geom.positions[i]);
+      EXPECT_EQ(newAttributes.normals[i], attributes.normals[i]);
+      if (type != "obj") EXPECT_EQ(newAttributes.scalars["intensity"][i], attributes.scalars["intensity"][i]);
+    }
+  }
+
+  // Streaming writer, a chunk at a time
+  {
+    PointCloudWriter writer("test_stream_writer.ply", 5, false, {"label"});
+    writer.write({{0., 0., 0.}, {1., 0., 0.}}, {}, {{0., 1.}});
+    writer.write({{0., 1., 0.}, {0., 0., 1.}, {1., 1., 1.}}, {}, {{2., 3., 4.}});
+    writer.close();
+  }
+  std::unique_ptr<PointCloud> newCloud;
+  std::unique_ptr<PointPositionGeometry> newGeom;
+  PointCloudAttributes newAttributes;
+  std::tie(newCloud, newGeom, newAttributes) = readPointCloudWithAttributes("test_stream_writer.ply");
+  ASSERT_EQ(newCloud->nPoints(), 5);
+  EXPECT_EQ(newAttributes.normals.size(), 0);
+  EXPECT_EQ(newGeom->positions[2], (Vector3{0., 1., 0.}));
+  EXPECT_EQ(newAttributes.scalars["label"][4], 4.);
+
+  // Writing the wrong number of points is an error
+  PointCloudWriter badWriter("test_stream_writer.gcpc", 3);
+  badWriter.write({{0., 0., 0.}});
+  EXPECT_THROW(badWriter.close(), std::runtime_error);
+}
+
+TEST_F(PointCloudSuite, Read_asciiPLYWithLists) {
+  std::stringstream ss;
+  ss << "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty list uchar int tags\n"
+     << "property float y\nproperty float z\nproperty float confidence\nend_header\n"
+     << "1 2 7 8 2 3 0.5\n4 0 5 6 0.25\n";
+
+  std::unique_ptr<PointCloud> cloud;
+  std::unique_ptr<PointPositionGeometry> geom;
+  PointCloudAttributes attributes;
+  std::tie(cloud, geom, attributes) = readPointCloudWithAttributes(ss, "ply");
+  ASSERT_EQ(cloud->nPoints(), 2);
+  EXPECT_EQ(geom->positions[0], (Vector3{1., 2., 3.}));
+  EXPECT_EQ(geom->positions[1], (Vector3{4., 5., 6.}));
+  EXPECT_EQ(attributes.scalars.size(), 1);
+  EXPECT_EQ(attributes.scalars["confidence"][1], 0.25);
+}
+
+TEST_F(PointCloudSuite, Read_binaryPLYMixedTypes) {
+  // Big-endian records of mixed types, after an element with a list property
+  std::stringstream ss;
+  ss << "ply\nformat binary_big_endian 1.0\nelement camera 1\nproperty list uchar int ids\n"
+     << "element vertex 2\nproperty uchar red\nproperty float x\nproperty double y\nproperty short z\nend_header\n";
+  auto writeBE = [&](const void* val, size_t size) {
+    std::string bytes(static_cast<const char*>(val), size);
+    uint16_t test = 1;
+    if (*reinterpret_cast<const char*>(&test) == 1) std::reverse(bytes.begin(), bytes.end());
+    ss.write(bytes.data(), size);
+  };
+  unsigned char count = 1;
+  int32_t id = 3;
+  writeBE(&count, 1);
+  writeBE(&id, 4);
+  std::vector<Vector3> points = {{0.5, 1., -2.}, {3., 4.25, 5.}};
+  for (Vector3 p : points) {
+    unsigned char red = 200;
+    float x = p.x;
+    double y = p.y;
+    int16_t z = static_cast<int16_t>(p.z);
+    writeBE(&red, 1);
+    writeBE(&x, 4);
+    writeBE(&y, 8);
+    writeBE(&z, 2);
+  }
+
+  std::unique_ptr<PointCloud> cloud;
+  std::unique_ptr<PointPositionGeometry> geom;
+  PointCloudAttributes attributes;
+  std::tie(cloud, geom, attributes) = readPointCloudWithAttributes(ss, "ply");
+  ASSERT_EQ(cloud->nPoints(), 2);
+  EXPECT_EQ(geom->positions[0], points[0]);
+  EXPECT_EQ(geom->positions[1], points[1]);
+  EXPECT_EQ(attributes.scalars["red"][1], 200.);
+}
+
+TEST_F(PointCloudSuite, StreamPLYPoints) {
+  // A hand-written binary file, with an element before the vertices and extra vertex properties
+  std::string filename = "test_stream.ply";
+  std::vector<Vector3> points = {{0.5, 1., -2.}, {3., 4.25, 5.}, {-6., 7., 8.5}};
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << "ply\nformat binary_little_endian 1.0\ncomment test\nelement camera 1\nproperty list uchar int ids\n"
+        << "element vertex 3\nproperty uchar red\nproperty float x\nproperty double y\nproperty float z\nend_header\n";
+    unsigned char count = 2;
+    int32_t ids[2] = {5, 6};
+    out.write(reinterpret_cast<const char*>(&count), 1);
+    out.write(reinterpret_cast<const char*>(ids), 8);
+    for (Vector3 p : points) {
+      unsigned char red = 255;
+      float x = p.x, z = p.z;
+      double y = p.y;
+      out.write(reinterpret_cast<const char*>(&red), 1);
+      out.write(reinterpret_cast<const char*>(&x), 4);
+      out.write(reinterpret_cast<const char*>(&y), 8);
+      out.write(reinterpret_cast<const char*>(&z), 4);
+    }
+  }
+
+  PLYPointStream stream(filename);
+  EXPECT_EQ(stream.size(), points.size());
+  std::vector<Vector3> buffer;
+  for (int iPass = 0; iPass < 2; iPass++) {
+    stream.rewind();
+    std::vector<Vector3> readPoints;
+    while (stream.read(buffer, 2)) {
+      readPoints.insert(readPoints.end(), buffer.begin(), buffer.end());
+    }
+    ASSERT_EQ(readPoints.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      EXPECT_EQ(readPoints[i], points[i]);
+    }
+  }
+}
+
+TEST_F(PointCloudSuite, TiledProcessing) {
+  // A noisy height field, like an aerial scan
+  size_t N = 4000;
+  std::vector<Vector3> points = randomPoints(N, 13);
+  for (Vector3& p : points) {
+    p.z = 0.1 * std::sin(6. * p.x) * std::cos(4. * p.y) + 0.001 * p.z;
+  }
+
+  // Reference, all in memory
+  PointCloud cloud(N);
+  PointData<Vector3> pos(cloud);
+  for (size_t i = 0; i < N; i++) pos[i] = points[i];
+  PointPositionGeometry geom(cloud, pos);
+  geom.kNeighborSize = 10;
+  geom.requireNeighbors();
+  geom.requireNormals();
+
+  VectorPointStream stream(points);
+  TiledProcessingOptions options;
+  options.kNeighborSize = 10;
+  options.targetPointsPerTile = 500;
+  options.haloWidth = 0.1;
+  options.maxPointsInMemory = 2000; // force several passes
+  TiledGeometryResult tiled = computeGeometryTiled(stream, options);
+
+  EXPECT_EQ(tiled.stats.nPoints, N);
+  EXPECT_GT(tiled.stats.nTiles, 4);
+  EXPECT_GT(tiled.stats.nPasses, 3);
+  EXPECT_EQ(tiled.stats.nInexactNeighborhoods, 0);
+  ASSERT_EQ(tiled.neighborStart.size(), N + 1);
+
+  // Every neighborhood is exact, so everything should match
+  for (size_t iP = 0; iP < N; iP++) {
+    NeighborList neigh = geom.neighbors->neighbors[iP];
+    ASSERT_EQ(tiled.neighborStart[iP + 1] - tiled.neighborStart[iP], neigh.size());
+    std::unordered_set<size_t> expected;
+    for (size_t iN = 0; iN < neigh.size(); iN++) expected.insert(neigh.index(iN));
+    for (size_t iN = tiled.neighborStart[iP]; iN < tiled.neighborStart[iP + 1]; iN++) {
+      EXPECT_EQ(expected.count(tiled.neighborIndices[iN]), 1);
+    }
+    EXPECT_NEAR(std::abs(dot(tiled.normals[iP], geom.normals[iP])), 1., 1e-6);
+    EXPECT_NEAR(dot(tiled.tangentBasis[iP][0], tiled.normals[iP]), 0., 1e-6);
+  }
+}
+
+TEST_F(PointCloudSuite, VoxelHashGridQueries) {
+  size_t N = 500;
+  std::vector<Vector3> points = randomPoints(N, 17);
+  VoxelHashGrid grid(0.1);
+  for (size_t i = 0; i < N; i++) {
+    grid.insert(i, points[i]);
+  }
+
+  // Remove and move some points
+  std::vector<char> present(N, true);
+  for (size_t i = 0; i < N; i += 7) {
+    grid.remove(i);
+    present[i] = false;
+  }
+  std::vector<Vector3> moved = randomPoints(N, 18);
+  for (size_t i = 1; i < N; i += 5) {
+    if (!present[i]) continue;
+    points[i] = 2. * moved[i] - Vector3{0.5, 0.5, 0.5};
+    grid.move(i, points[i]);
+  }
+  EXPECT_FALSE(grid.contains(7));
+  EXPECT_TRUE(grid.contains(8));
+
+  // Compare against brute force, including queries away from the points
+  for (Vector3 q : randomPoints(50, 19)) {
+    q = 3. * q - Vector3{1., 1., 1.};
+    std::vector<std::pair<double, size_t>> all;
+    for (size_t i = 0; i < N; i++) {
+      if (present[i]) all.emplace_back(norm2(points[i] - q), i);
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(grid.size(), all.size());
+
+    std::vector<size_t> knn = grid.kNearest(q, 10);
+    ASSERT_EQ(knn.size(), 10);
+    for (size_t j = 0; j < 10; j++) {
+      EXPECT_EQ(knn[j], all[j].second);
+    }
+
+    double rad = 0.2;
+    std::vector<size_t> inRad = grid.radiusSearch(q, rad);
+    std::sort(inRad.begin(), inRad.end());
+    std::vector<size_t> expected;
+    for (auto& entry : all) {
+      if (entry.first <= rad * rad) expected.push_back(entry.second);
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(inRad, expected);
+  }
+}
+
+TEST_F(PointCloudSuite, IncrementalNeighborhoods) {
+  size_t N = 800;
+  unsigned int k = 8;
+  std::unique_ptr<PointCloud> cloudPtr;
+  PointData<Vector3> pos;
+  std::tie(cloudPtr, pos) = randomCloud(N, 19);
+  PointCloud& cloud = *cloudPtr;
+  std::vector<Vector3> newPoints = randomPoints(53, 20); // to insert along the way
+
+  ScopedNumThreads threads(4);
+  IncrementalPointGeometry geom(cloud, pos, k);
+
+  // Brute-force reference neighbor sets on the current cloud
+  auto checkAgainstScratch = [&]() {
+    std::vector<Point> pts;
+    for (Point p : cloud.points()) pts.push_back(p);
+    for (Point p : pts) {
+      std::vector<std::pair<double, size_t>> all;
+      for (Point o : pts) {
+        if (o != p) all.emplace_back(norm2(geom.positions[o] - geom.positions[p]), o.getIndex());
+      }
+      std::sort(all.begin(), all.end());
+      const std::vector<Point>& neigh = geom.neighbors[p];
+      ASSERT_EQ(neigh.size(), std::min<size_t>(k, all.size()));
+      for (size_t j = 0; j < neigh.size(); j++) {
+        EXPECT_EQ(neigh[j].getIndex(), all[j].second);
+      }
+      EXPECT_NEAR(norm(geom.normals[p]), 1., 1e-6);
+    }
+  };
+  checkAgainstScratch();
+
+  // Inserting one point only touches a neighborhood-sized set of points
+  Point pNew = geom.insertPoint(newPoints[0]);
+  EXPECT_EQ(cloud.nPoints(), N + 1);
+  EXPECT_GT(geom.nUpdatedLastTime, 1);
+  EXPECT_LT(geom.nUpdatedLastTime, 10 * k);
+  EXPECT_EQ(geom.neighbors[pNew].size(), k);
+
+  geom.insertPoints(std::vector<Vector3>(newPoints.begin() + 1, newPoints.begin() + 51));
+  checkAgainstScratch();
+
+  // A far-away outlier has a huge neighborhood, but updates elsewhere still only touch a few points
+  Point pOutlier = geom.insertPoint(Vector3{100., 100., 100.});
+  geom.insertPoint(newPoints[51]);
+  EXPECT_LT(geom.nUpdatedLastTime, 10 * k);
+  checkAgainstScratch();
+  geom.removePoint(pOutlier);
+
+  // Removal and moves
+  std::vector<Point> toRemove;
+  for (size_t i = 0; i < N; i += 9) toRemove.push_back(Point(&cloud, i));
+  geom.removePoints(toRemove);
+  EXPECT_FALSE(cloud.isCompressed());
+  EXPECT_THROW(geom.removePoint(toRemove[0]), std::runtime_error);
+  geom.movePoint(Point(&cloud, 1), Vector3{0.5, 0.5, 0.5});
+  geom.removePoint(pNew);
+  checkAgainstScratch();
+
+  // Neighbor handles survive compression, and updates keep working afterwards
+  size_t nBefore = cloud.nPoints();
+  cloud.compress();
+  EXPECT_EQ(cloud.nPoints(), nBefore);
+  checkAgainstScratch();
+  geom.insertPoint(newPoints[52]);
+  geom.removePoint(cloud.point(3));
+  checkAgainstScratch();
+
+  // Shrink down to a cloud smaller than the neighborhood size
+  std::vector<Point> rest;
+  for (Point p : cloud.points()) rest.push_back(p);
+  rest.resize(rest.size() - 5);
+  geom.removePoints(rest);
+  EXPECT_EQ(cloud.nPoints(), 5);
+  checkAgainstScratch();
+}
+
+TEST_F(PointCloudSuite, SurfaceSampling) {
+  std::unique_ptr<SurfaceMesh> mesh;
+  std::unique_ptr<VertexPositionGeometry> meshGeom;
+  std::tie(mesh, meshGeom) = readSurfaceMesh(std::string(GC_TEST_ASSETS_ABS_PATH) + "/spot.ply");
+  meshGeom->requireVertexPositions();
+
+  // Deterministic for a seed, regardless of threading
+  size_t N = 10000;
+  ScopedNumThreads threads(1);
+  std::unique_ptr<PointCloud> cloudA;
+  PointData<Vector3> posA;
+  PointData<SurfacePoint> sourcesA;
+  std::tie(cloudA, posA, sourcesA) = uniformlySamplePointsOnSurface(*mesh, *meshGeom, N, 5);
+  setNumThreads(4);
+  std::unique_ptr<PointCloud> cloudB;
+  PointData<Vector3> posB;
+  PointData<SurfacePoint> sourcesB;
+  std::tie(cloudB, posB, sourcesB) = uniformlySamplePointsOnSurface(*mesh, *meshGeom, N, 5);
+  ASSERT_EQ(cloudA->nPoints(), N);
+  for (size_t i = 0; i < N; i++) {
+    EXPECT_EQ(posA[i], posB[i]);
+    EXPECT_EQ(sourcesA[i].face, sourcesB[i].face);
+    EXPECT_NEAR(norm(sourcesA[i].interpolate(meshGeom->vertexPositions) - posA[i]), 0., 1e-9);
+    EXPECT_NEAR(sum(sourcesA[i].faceCoords), 1., 1e-9);
+  }
+
+  // Chunks of the sequence agree with the whole
+  SurfaceSampler sampler(*mesh, *meshGeom, 5);
+  std::vector<Vector3> chunk(100);
+  sampler.sample(500, 100, chunk.data(), nullptr);
+  for (size_t i = 0; i < 100; i++) {
+    EXPECT_EQ(chunk[i], posA[500 + i]);
+  }
+
+  // Samples are spread over the faces in proportion to area
+  meshGeom->requireFaceAreas();
+  meshGeom->requireFaceIndices();
+  double totalArea = sampler.totalArea();
+  double evenArea = 0.;
+  for (Face f : mesh->faces()) {
+    if (meshGeom->faceIndices[f] % 2 == 0) evenArea += meshGeom->faceAreas[f];
+  }
+  double evenCount = 0.;
+  for (size_t i = 0; i < N; i++) {
+    if (meshGeom->faceIndices[sourcesA[i].face] % 2 == 0) evenCount += 1.;
+  }
+  EXPECT_NEAR(evenCount / N, evenArea / totalArea, 0.03);
+
+  // Blue noise
+  double r = 0.05;
+  std::unique_ptr<PointCloud> diskCloud;
+  PointData<Vector3> diskPos;
+  PointData<SurfacePoint> diskSources;
+  std::tie(diskCloud, diskPos, diskSources) = poissonDiskSamplePointsOnSurface(*mesh, *meshGeom, r, 3);
+  size_t nDisk = diskCloud->nPoints();
+  EXPECT_GT(nDisk, 0.4 * totalArea / (r * r));
+  for (size_t i = 0; i < nDisk; i++) {
+    for (size_t j = i + 1; j < nDisk; j++) {
+      ASSERT_GE(norm(diskPos[i] - diskPos[j]), r);
+    }
+  }
+  setNumThreads(1);
+  PointData<Vector3> diskPos1;
+  std::tie(diskCloud, diskPos1, diskSources) = poissonDiskSamplePointsOnSurface(*mesh, *meshGeom, r, 3);
+  setNumThreads(4);
+  ASSERT_EQ(diskCloud->nPoints(), nDisk);
+  for (size_t i = 0; i < nDisk; i++) EXPECT_EQ(diskPos[i], diskPos1[i]);
+
+  // A tiny distance would need unboundedly many candidates
+  EXPECT_THROW(poissonDiskSamplePointsOnSurface(*mesh, *meshGeom, 1e-6), std::runtime_error);
+}
@@ -1,10 +1,28 @@
+#include "geometrycentral/surface/boundary_first_flattening.h"
+#include "geometrycentral/surface/direction_fields.h"
+#include "geometrycentral/surface/flip_geodesics.h"
+#include "geometrycentral/surface/geodesic_centroidal_voronoi_tessellation.h"
+#include "geometrycentral/surface/mesh_graph_algorithms.h"
+#include "geometrycentral/surface/mesh_tiling.h"
+#include "geometrycentral/surface/parameterize.h"
+#include "geometrycentral/surface/progressive_mesh.h"
+#include "geometrycentral/surface/quadric_error_simplification.h"
+#include "geometrycentral/surface/remeshing.h"
 #include "geometrycentral/surface/simple_polygon_mesh.h"
+#include "geometrycentral/surface/surface_centers.h"
+#include "geometrycentral/surface/subdivide.h"
+#include "geometrycentral/surface/trace_geodesic.h"
+#include "geometrycentral/surface/vector_heat_method.h"
+#include "geometrycentral/utilities/parallel.h"
 
 #include "load_test_meshes.h"
+#include "parallel_test_helpers.h"
 
 #include "gtest/gtest.h"
 
+#include <array>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -15,6 +33,32 @@ using std::cout;
 using std::endl;
 
 class SimplePolygonSuite : public MeshAssetSuite {};
+class FlipGeodesicsSuite : public MeshAssetSuite {};
+class TraceGeodesicSuite : public MeshAssetSuite {};
+class VectorHeatSuite : public MeshAssetSuite {};
+class QuadricSimplifySuite : public MeshAssetSuite {};
+class ProgressiveMeshSuite : public MeshAssetSuite {};
+class RemeshSuite : public MeshAssetSuite {};
+class SubdivideSuite : public MeshAssetSuite {};
+class BFFSuite : public MeshAssetSuite {};
+class ParameterizeSuite : public MeshAssetSuite {};
+class DirectionFieldSuite : public MeshAssetSuite {};
+class VoronoiSuite : public MeshAssetSuite {};
+class SurfaceCenterSuite : public MeshAssetSuite {};
+class MeshTilingSuite : public MeshAssetSuite {};
+
+// helpers
+namespace {
+double polylineLength(VertexPositionGeometry& geom, const std::vector<SurfacePoint>& polyline) {
+  double length = 0.;
+  for (size_t i = 0; i + 1 < polyline.size(); i++) {
+    Vector3 pA = polyline[i].interpolate(geom.vertexPositions);
+    Vector3 pB = polyline[i + 1].interpolate(geom.vertexPositions);
+    length += norm(pB - pA);
+  }
+  return length;
+}
+} // namespace
 
 // ============================================================
 // =============== SimplePolygonMesh tests
@@ -31,3 +75,1181 @@ TEST_F(SimplePolygonSuite, BasicTest) {
   }
 }
 
+// ============================================================
+// =============== Flip geodesics tests
+// ============================================================
+
+TEST_F(FlipGeodesicsSuite, ParallelStraighteningMatchesSerial) {
+  for (const MeshAsset& a : {getAsset("fox.ply", true), getAsset("cat_head.obj", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+
+    // A collection of overlapping Dijkstra paths, which a single network could not hold
+    std::vector<std::vector<Halfedge>> paths;
+    size_t nPaths = 12;
+    for (size_t i = 0; i < nPaths; i++) {
+      Vertex vA = mesh.vertex((i * 37) % mesh.nVertices());
+      Vertex vB = mesh.vertex((i * 91 + mesh.nVertices() / 2) % mesh.nVertices());
+      paths.push_back(shortestEdgePath(geom, vA, vB));
+    }
+    paths.push_back(std::vector<Halfedge>());
+
+    ScopedNumThreads threads(4);
+    std::vector<std::vector<SurfacePoint>> batchResult = straightenPathsInParallel(mesh, geom, paths);
+
+    ASSERT_EQ(batchResult.size(), paths.size());
+    EXPECT_TRUE(batchResult.back().empty());
+    for (size_t i = 0; i < nPaths; i++) {
+      if (paths[i].empty()) continue;
+      FlipEdgeNetwork network(mesh, geom, {paths[i]});
+      network.iterativeShorten();
+      std::vector<SurfacePoint> serialResult = network.getPathPolyline().front();
+
+      EXPECT_NEAR(polylineLength(geom, batchResult[i]), polylineLength(geom, serialResult), 1e-6);
+      EXPECT_NEAR(polylineLength(geom, batchResult[i]), network.length(), 1e-6);
+    }
+  }
+}
+
+
+// ============================================================
+// =============== Geodesic tracing tests
+// ============================================================
+
+TEST_F(TraceGeodesicSuite, BatchTraceMatchesSingleTrace) {
+  for (const MeshAsset& a : {getAsset("bob_small.ply", true), getAsset("cat_head.obj", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+    geom.requireEdgeLengths();
+    double meanEdgeLength = 0.;
+    for (Edge e : mesh.edges()) meanEdgeLength += geom.edgeLengths[e] / mesh.nEdges();
+
+    // Traces from vertices and from face interiors, in assorted directions
+    std::vector<SurfacePoint> startPoints;
+    std::vector<Vector2> traceVecs;
+    for (size_t i = 0; i < 200; i++) {
+      if (i % 2 == 0) {
+        startPoints.push_back(SurfacePoint(mesh.vertex((i * 7) % mesh.nVertices())));
+      } else {
+        startPoints.push_back(SurfacePoint(mesh.face((i * 13) % mesh.nFaces()), Vector3{0.2, 0.3, 0.5}));
+      }
+      double len = (1. + (i % 5)) * meanEdgeLength;
+      traceVecs.push_back(Vector2::fromAngle(0.1 * i) * len);
+    }
+
+    TraceOptions options;
+    options.includePath = true;
+    GeodesicTracer tracer(geom);
+    ScopedNumThreads threads(4);
+    TraceGeodesicBatchResult batch = tracer.traceBatch(startPoints, traceVecs, options);
+
+    ASSERT_EQ(batch.endPoints.size(), startPoints.size());
+    ASSERT_EQ(batch.pathStart.size(), startPoints.size() + 1);
+    EXPECT_EQ(batch.pathStart.back(), batch.pathPoints.size());
+    for (size_t i = 0; i < startPoints.size(); i++) {
+
+      // The batch agrees exactly with a single trace from the same tracer
+      TraceGeodesicResult single = tracer.trace(startPoints[i], traceVecs[i], options);
+      ASSERT_EQ(batch.pathStart[i + 1] - batch.pathStart[i], single.pathPoints.size());
+      for (size_t j = 0; j < single.pathPoints.size(); j++) {
+        EXPECT_EQ(batch.pathPoints[batch.pathStart[i] + j], single.pathPoints[j]);
+      }
+
+      // ...and with traceGeodesic() up to roundoff
+      TraceGeodesicResult reference = traceGeodesic(geom, startPoints[i], traceVecs[i], options);
+      Vector3 pBatch = batch.endPoints[i].interpolate(geom.vertexPositions);
+      Vector3 pRef = reference.endPoint.interpolate(geom.vertexPositions);
+      EXPECT_LT(norm(pBatch - pRef), 1e-6 * meanEdgeLength);
+    }
+  }
+}
+
+
+// ============================================================
+// =============== Vector heat method tests
+// ============================================================
+
+TEST_F(VectorHeatSuite, BatchQueriesMatchSingleQueries) {
+  for (const MeshAsset& a : {getAsset("bob_small.ply", true), getAsset("cat_head.obj", true)}) {
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+
+    VectorHeatMethodSolver solver(geom);
+    solver.batchBlockSize = 3; // exercise partial blocks
+
+    std::vector<Vertex> sourceVerts;
+    std::vector<SurfacePoint> sourcePoints;
+    for (size_t i = 0; i < 7; i++) {
+      sourceVerts.push_back(mesh.vertex((i * 53) % mesh.nVertices()));
+    }
+    sourcePoints.push_back(SurfacePoint(sourceVerts[0]));
+    sourcePoints.push_back(SurfacePoint(mesh.edge(17), 0.3));
+    sourcePoints.push_back(SurfacePoint(mesh.face(29), Vector3{0.2, 0.3, 0.5}));
+
+    ScopedNumThreads threads(4);
+    DenseMatrix<std::complex<double>> logMaps = solver.computeLogMapBatch(sourceVerts, 0.1);
+    DenseMatrix<std::complex<double>> pointLogMaps = solver.computeLogMapBatch(sourcePoints);
+
+    std::vector<std::tuple<SurfacePoint, Vector2>> transportSources;
+    for (size_t i = 0; i < sourceVerts.size(); i++) {
+      transportSources.emplace_back(SurfacePoint(sourceVerts[i]), Vector2::fromAngle(0.7 * i) * (1. + i));
+    }
+    DenseMatrix<std::complex<double>> transports = solver.transportTangentVectorBatch(transportSources);
+
+    DenseMatrix<double> fieldValues(sourcePoints.size(), 4);
+    for (size_t i = 0; i < sourcePoints.size(); i++) {
+      for (size_t j = 0; j < 4; j++) fieldValues(i, j) = std::sin(1. + i + 3. * j);
+    }
+    DenseMatrix<double> fields = solver.extendScalarBatch(sourcePoints, fieldValues);
+
+    ASSERT_EQ((size_t)logMaps.rows(), mesh.nVertices());
+    ASSERT_EQ((size_t)logMaps.cols(), sourceVerts.size());
+    for (size_t iS = 0; iS < sourceVerts.size(); iS++) {
+      VertexData<Vector2> single = solver.computeLogMap(sourceVerts[iS], 0.1);
+      VertexData<Vector2> singleTransport =
+          solver.transportTangentVector(sourceVerts[iS], std::get<1>(transportSources[iS]));
+      for (size_t i = 0; i < mesh.nVertices(); i++) {
+        EXPECT_NEAR(norm(Vector2::fromComplex(logMaps(i, iS)) - single[i]), 0., 1e-6);
+        EXPECT_NEAR(norm(Vector2::fromComplex(transports(i, iS)) - singleTransport[i]), 0., 1e-6);
+      }
+    }
+    for (size_t iS = 0; iS < sourcePoints.size(); iS++) {
+      VertexData<Vector2> single = solver.computeLogMap(sourcePoints[iS]);
+      for (size_t i = 0; i < mesh.nVertices(); i++) {
+        EXPECT_NEAR(norm(Vector2::fromComplex(pointLogMaps(i, iS)) - single[i]), 0., 1e-6);
+      }
+    }
+    for (size_t j = 0; j < 4; j++) {
+      std::vector<std::tuple<SurfacePoint, double>> scalarSources;
+      for (size_t i = 0; i < sourcePoints.size(); i++) scalarSources.emplace_back(sourcePoints[i], fieldValues(i, j));
+      VertexData<double> single = solver.extendScalar(scalarSources);
+      for (size_t i = 0; i < mesh.nVertices(); i++) {
+        EXPECT_NEAR(fields(i, j), single[i], 1e-8);
+      }
+    }
+  }
+}
+
+
+// ============================================================
+// =============== Quadric error simplification tests
+// ============================================================
+
+TEST_F(QuadricSimplifySuite, TargetFaceCounts) {
+  for (std::string name : {"spot.ply", "lego.ply"}) {
+    for (bool parallel : {false, true}) {
+      MeshAsset a = getAsset(name, true);
+      a.printThyName();
+      ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+      VertexPositionGeometry& geom = *a.geometry;
+      geom.requireFaceAreas();
+      double areaBefore = 0.;
+      for (Face f : mesh.faces()) areaBefore += geom.faceAreas[f];
+      geom.unrequireFaceAreas();
+
+      size_t nFacesBefore = mesh.nFaces();
+      QuadricSimplifyOptions options;
+      options.targetRatio = 0.25;
+      options.parallel = parallel;
+      options.boundaryWeight = 100.;
+      options.checkTopology = true;
+      options.preventFoldOver = true;
+      ScopedNumThreads threads(4);
+      quadricErrorSimplify(mesh, geom, options);
+
+      mesh.validateConnectivity();
+      size_t target = static_cast<size_t>(std::ceil(0.25 * nFacesBefore));
+      EXPECT_LE(mesh.nFaces(), target);
+      EXPECT_GE(mesh.nFaces() + 2, target);
+
+      // The shape is roughly preserved
+      geom.refreshQuantities();
+      geom.requireFaceAreas();
+      double areaAfter = 0.;
+      for (Face f : mesh.faces()) areaAfter += geom.faceAreas[f];
+      EXPECT_NEAR(areaAfter / areaBefore, 1., 0.05);
+      for (Vertex v : mesh.vertices()) {
+        EXPECT_TRUE(isfinite(geom.vertexPositions[v]));
+      }
+    }
+  }
+}
+
+TEST_F(QuadricSimplifySuite, ParallelIsDeterministic) {
+  std::vector<VertexData<Vector3>> results;
+  for (int nThreads : {1, 4}) {
+    MeshAsset a = getAsset("spot.ply", true);
+    QuadricSimplifyOptions options;
+    options.targetFaceCount = 1000;
+    options.parallel = true;
+    ScopedNumThreads threads(nThreads);
+    quadricErrorSimplify(*a.manifoldMesh, *a.geometry, options);
+    EXPECT_EQ(a.manifoldMesh->nFaces(), 1000u);
+    results.push_back(a.geometry->vertexPositions);
+  }
+  ASSERT_EQ(results[0].size(), results[1].size());
+  for (size_t i = 0; i < results[0].size(); i++) {
+    EXPECT_EQ(results[0][i], results[1][i]);
+  }
+}
+
+TEST_F(QuadricSimplifySuite, ErrorTolerance) {
+  MeshAsset a = getAsset("bob_small.ply", true);
+  size_t nFacesBefore = a.manifoldMesh->nFaces();
+  quadricErrorSimplify(*a.manifoldMesh, *a.geometry, 1e-4);
+  a.manifoldMesh->validateConnectivity();
+  EXPECT_LT(a.manifoldMesh->nFaces(), nFacesBefore);
+  EXPECT_GT(a.manifoldMesh->nFaces(), 0u);
+}
+
+// ============================================================
+// =============== Progressive meshes
+// ============================================================
+
+namespace {
+// The faces of a mesh as position triples, rotated to start at the least position, in sorted order
+std::vector<std::array<Vector3, 3>> faceSet(SurfaceMesh& mesh, VertexPositionGeometry& geom) {
+  auto less = [](Vector3 a, Vector3 b) { return std::make_tuple(a.x, a.y, a.z) < std::make_tuple(b.x, b.y, b.z); };
+  std::vector<std::array<Vector3, 3>> faces;
+  for (Face f : mesh.faces()) {
+    Halfedge he = f.halfedge();
+    std::array<Vector3, 3> tri{{geom.vertexPositions[he.vertex()], geom.vertexPositions[he.next().vertex()],
+                                geom.vertexPositions[he.next().next().vertex()]}};
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end(), less), tri.end());
+    faces.push_back(tri);
+  }
+  std::sort(faces.begin(), faces.end(), [&](const std::array<Vector3, 3>& a, const std::array<Vector3, 3>& b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), less);
+  });
+  return faces;
+}
+} // namespace
+
+TEST_F(ProgressiveMeshSuite, RecordAndReplay) {
+  for (std::string name : {"bob_small.ply", "lego.ply"}) {
+    MeshAsset a = getAsset(name, true);
+    a.printThyName();
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+    std::vector<std::array<Vector3, 3>> originalFaces = faceSet(mesh, geom);
+    int eulerCharacteristic = mesh.eulerCharacteristic();
+
+    // A vertex attribute, which a policy interpolates through collapses, and a corner attribute
+    VertexData<double> vertexVal(mesh);
+    CornerData<double> cornerVal(mesh);
+    for (Vertex v : mesh.vertices()) vertexVal[v] = geom.vertexPositions[v].x;
+    for (Corner c : mesh.corners()) {
+      cornerVal[c] = geom.vertexPositions[c.vertex()].y + 0.5 * geom.vertexPositions[c.halfedge().next().vertex()].z;
+    }
+
+    MutationManager mm(mesh, geom);
+    ProgressiveMeshRecorder recorder(mm, {&vertexVal}, {&cornerVal});
+    auto pre = [&](Edge e, double t) {
+      return std::make_pair(vertexVal[e.halfedge().tailVertex()], vertexVal[e.halfedge().tipVertex()]);
+    };
+    auto post = [&](Vertex v, double t, std::pair<double, double> vals) {
+      vertexVal[v] = (1. - t) * vals.first + t * vals.second;
+    };
+    mm.registerEdgeCollapseHandlers(pre, post);
+
+    QuadricSimplifyOptions options;
+    options.targetRatio = 0.1;
+    options.boundaryWeight = 100.;
+    options.checkTopology = true;
+    options.preventFoldOver = true;
+    quadricErrorSimplify(mesh, geom, options, mm);
+    EXPECT_THROW(mm.repositionVertex(mesh.vertex(0), Vector3{1., 0., 0.}), std::runtime_error);
+    ProgressiveMesh pm = recorder.finish();
+
+    // The base is the simplified mesh
+    ASSERT_EQ(pm.nBaseVertices(), mesh.nVertices());
+    EXPECT_EQ(pm.nBaseFaces(), mesh.nFaces());
+    std::vector<std::array<Vector3, 3>> baseFaces = faceSet(mesh, geom);
+    {
+      std::unique_ptr<ManifoldSurfaceMesh> lodMesh;
+      std::unique_ptr<VertexPositionGeometry> lodGeom;
+      std::tie(lodMesh, lodGeom) = pm.extractMesh();
+      EXPECT_TRUE(faceSet(*lodMesh, *lodGeom) == baseFaces);
+      VertexData<double> lodVal = pm.vertexAttribute(*lodMesh, 0);
+      for (size_t i = 0; i < mesh.nVertices(); i++) EXPECT_EQ(lodVal[i], vertexVal[i]);
+    }
+
+    // The finest level is the original mesh, with the original attributes
+    pm.setLevel(pm.nSplits());
+    {
+      std::unique_ptr<ManifoldSurfaceMesh> lodMesh;
+      std::unique_ptr<VertexPositionGeometry> lodGeom;
+      std::tie(lodMesh, lodGeom) = pm.extractMesh();
+      EXPECT_TRUE(faceSet(*lodMesh, *lodGeom) == originalFaces);
+      VertexData<double> lodVal = pm.vertexAttribute(*lodMesh, 0);
+      CornerData<double> lodCornerVal = pm.cornerAttribute(*lodMesh, 0);
+      for (Vertex v : lodMesh->vertices()) EXPECT_EQ(lodVal[v], lodGeom->vertexPositions[v].x);
+      for (Corner c : lodMesh->corners()) {
+        EXPECT_EQ(lodCornerVal[c], lodGeom->vertexPositions[c.vertex()].y +
+                                       0.5 * lodGeom->vertexPositions[c.halfedge().next().vertex()].z);
+      }
+    }
+
+    // Intermediate levels are valid meshes of the same topology
+    for (size_t nVerts : {pm.nBaseVertices() + pm.nSplits() / 3, pm.nBaseVertices() + pm.nSplits() / 2}) {
+      pm.setVertexCount(nVerts);
+      std::unique_ptr<ManifoldSurfaceMesh> lodMesh;
+      std::unique_ptr<VertexPositionGeometry> lodGeom;
+      std::tie(lodMesh, lodGeom) = pm.extractMesh();
+      lodMesh->validateConnectivity();
+      EXPECT_EQ(lodMesh->nVertices(), nVerts);
+      EXPECT_EQ(lodMesh->eulerCharacteristic(), eulerCharacteristic);
+    }
+
+    // And back down again
+    while (pm.coarsen()) {
+    }
+    std::unique_ptr<ManifoldSurfaceMesh> lodMesh;
+    std::unique_ptr<VertexPositionGeometry> lodGeom;
+    std::tie(lodMesh, lodGeom) = pm.extractMesh();
+    EXPECT_TRUE(faceSet(*lodMesh, *lodGeom) == baseFaces);
+  }
+}
+
+TEST_F(ProgressiveMeshSuite, Serialization) {
+  MeshAsset a = getAsset("bob_small.ply", true);
+  ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+  VertexPositionGeometry& geom = *a.geometry;
+  CornerData<double> cornerVal(mesh);
+  for (Corner c : mesh.corners()) cornerVal[c] = c.getIndex();
+
+  MutationManager mm(mesh, geom);
+  ProgressiveMeshRecorder recorder(mm, {}, {&cornerVal});
+  quadricErrorSimplify(mesh, geom, QuadricSimplifyOptions(), mm);
+  ProgressiveMesh pm = recorder.finish();
+  ASSERT_GT(pm.nSplits(), 10u);
+
+  // All at once
+  std::stringstream whole;
+  pm.write(whole);
+  ProgressiveMesh pmWhole = ProgressiveMesh::read(whole);
+
+  // Streamed in pieces
+  std::stringstream base, first, rest;
+  size_t nFirst = pm.nSplits() / 3;
+  pm.writeBase(base);
+  pm.writeSplits(first, 0, nFirst);
+  pm.writeSplits(rest, nFirst, pm.nSplits());
+  ProgressiveMesh pmStreamed = ProgressiveMesh::readBase(base);
+  EXPECT_EQ(pmStreamed.readSplits(first), nFirst);
+  pmStreamed.setLevel(nFirst);
+  EXPECT_EQ(pmStreamed.readSplits(rest), pm.nSplits() - nFirst);
+
+  for (size_t level : {pm.nSplits(), nFirst / 2, size_t(0)}) {
+    for (ProgressiveMesh* other : {&pmWhole, &pmStreamed}) {
+      pm.setLevel(level);
+      other->setLevel(level);
+      ASSERT_EQ(other->nVertices(), pm.nVertices());
+      ASSERT_EQ(other->nFaces(), pm.nFaces());
+      for (size_t i = 0; i < pm.nVertices(); i++) EXPECT_EQ(other->position(i), pm.position(i));
+      for (size_t i = 0; i < pm.nFaces(); i++) {
+        EXPECT_EQ(other->face(i), pm.face(i));
+        for (size_t j = 0; j < 3; j++) EXPECT_EQ(other->cornerValue(3 * i + j, 0), pm.cornerValue(3 * i + j, 0));
+      }
+    }
+  }
+
+  std::stringstream garbage("not a progressive mesh");
+  EXPECT_THROW(ProgressiveMesh::readBase(garbage), std::runtime_error);
+}
+
+// ============================================================
+// =============== Remeshing
+// ============================================================
+
+TEST_F(RemeshSuite, UniformLength) {
+  std::vector<VertexData<Vector3>> results;
+  for (int nThreads : {1, 4}) {
+    MeshAsset a = getAsset("spot.ply", true);
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+    int eulerCharacteristic = mesh.eulerCharacteristic();
+    geom.requireEdgeLengths();
+    geom.requireFaceAreas();
+    double meanLength = 0.;
+    for (Edge e : mesh.edges()) meanLength += geom.edgeLengths[e] / mesh.nEdges();
+    double areaBefore = 0.;
+    for (Face f : mesh.faces()) areaBefore += geom.faceAreas[f];
+
+    RemeshOptions options;
+    options.targetEdgeLength = 0.7 * meanLength;
+    ScopedNumThreads threads(nThreads);
+    remesh(mesh, geom, options);
+
+    mesh.validateConnectivity();
+    EXPECT_EQ(mesh.eulerCharacteristic(), eulerCharacteristic);
+    geom.refreshQuantities();
+    size_t nInRange = 0;
+    for (Edge e : mesh.edges()) {
+      double ratio = geom.edgeLengths[e] / options.targetEdgeLength;
+      if (ratio > 0.5 && ratio < 1.5) nInRange++;
+    }
+    EXPECT_GT(nInRange, 0.9 * mesh.nEdges());
+    double areaAfter = 0.;
+    for (Face f : mesh.faces()) areaAfter += geom.faceAreas[f];
+    EXPECT_NEAR(areaAfter / areaBefore, 1., 0.02);
+
+    results.push_back(geom.vertexPositions);
+  }
+
+  // Independent of the number of threads
+  ASSERT_EQ(results[0].size(), results[1].size());
+  for (size_t i = 0; i < results[0].size(); i++) {
+    EXPECT_EQ(results[0][i], results[1][i]);
+  }
+}
+
+TEST_F(RemeshSuite, CurvatureAdaptive) {
+  size_t nUniform = 0;
+  for (double adaptation : {0., 2.}) {
+    MeshAsset a = getAsset("spot.ply", true);
+    RemeshOptions options;
+    options.curvatureAdaptation = adaptation;
+    remesh(*a.manifoldMesh, *a.geometry, options);
+    a.manifoldMesh->validateConnectivity();
+    if (adaptation == 0.) {
+      nUniform = a.manifoldMesh->nVertices();
+    } else {
+      EXPECT_GT(a.manifoldMesh->nVertices(), nUniform);
+    }
+  }
+}
+
+TEST_F(RemeshSuite, PreservesFeatures) {
+  // A unit cube
+  std::vector<Vector3> corners;
+  for (int i = 0; i < 8; i++) corners.push_back(Vector3{double(i & 1), double((i >> 1) & 1), double((i >> 2) & 1)});
+  std::vector<std::vector<size_t>> quads = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                            {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  std::vector<std::vector<size_t>> tris;
+  for (const std::vector<size_t>& q : quads) {
+    tris.push_back({q[0], q[1], q[2]});
+    tris.push_back({q[0], q[2], q[3]});
+  }
+
+  for (bool withFeatures : {true, false}) {
+    ManifoldSurfaceMesh mesh(tris);
+    VertexData<Vector3> positions(mesh);
+    for (size_t i = 0; i < 8; i++) positions[i] = corners[i];
+    VertexPositionGeometry geom(mesh, positions);
+
+    RemeshOptions options;
+    options.targetEdgeLength = 0.15;
+    if (withFeatures) options.featureAngle = PI / 4.;
+    remesh(mesh, geom, options);
+    mesh.validateConnectivity();
+    EXPECT_GT(mesh.nVertices(), 100u);
+
+    // Every vertex stays on the surface of the cube, even where relaxing would round off its edges
+    size_t nCorners = 0;
+    for (Vertex v : mesh.vertices()) {
+      Vector3 p = geom.vertexPositions[v];
+      double minDist = std::min({p.x, p.y, p.z, 1. - p.x, 1. - p.y, 1. - p.z});
+      double maxDist = std::max({p.x, p.y, p.z, 1. - p.x, 1. - p.y, 1. - p.z});
+      EXPECT_NEAR(minDist, 0., 1e-9);
+      EXPECT_LE(maxDist, 1. + 1e-9);
+      if (std::find(corners.begin(), corners.end(), p) != corners.end()) nCorners++;
+    }
+    if (!withFeatures) continue;
+
+    // The corners stay put, and no face cuts across an edge of the cube
+    EXPECT_EQ(nCorners, 8u);
+    for (Face f : mesh.faces()) {
+      Vector3 c = Vector3::zero();
+      for (Vertex v : f.adjacentVertices()) c += geom.vertexPositions[v] / 3.;
+      double minDist = std::min({c.x, c.y, c.z, 1. - c.x, 1. - c.y, 1. - c.z});
+      EXPECT_NEAR(minDist, 0., 1e-9);
+    }
+  }
+}
+
+TEST_F(RemeshSuite, BoundaryConditions) {
+  for (RemeshBoundaryCondition bc : {RemeshBoundaryCondition::Fixed, RemeshBoundaryCondition::Tangential}) {
+    MeshAsset a = getAsset("lego.ply", true);
+    ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+    VertexPositionGeometry& geom = *a.geometry;
+    size_t nLoops = mesh.nBoundaryLoops();
+    std::vector<Vector3> boundaryBefore;
+    for (Vertex v : mesh.vertices()) {
+      if (v.isBoundary()) boundaryBefore.push_back(geom.vertexPositions[v]);
+    }
+
+    RemeshOptions options;
+    options.boundaryCondition = bc;
+    remesh(mesh, geom, options);
+    mesh.validateConnectivity();
+    EXPECT_EQ(mesh.nBoundaryLoops(), nLoops);
+
+    if (bc == RemeshBoundaryCondition::Fixed) {
+      std::vector<Vector3> boundaryAfter;
+      for (Vertex v : mesh.vertices()) {
+        if (v.isBoundary()) boundaryAfter.push_back(geom.vertexPositions[v]);
+      }
+      EXPECT_TRUE(boundaryAfter == boundaryBefore);
+    }
+  }
+}
+
+// ============================================================
+// =============== Subdivision
+// ============================================================
+
+TEST_F(SubdivideSuite, LoopMatchesInPlace) {
+  MeshAsset a = getAsset("bob_small.ply", true);
+  std::unique_ptr<ManifoldSurfaceMesh> mesh;
+  std::unique_ptr<VertexPositionGeometry> geom;
+  std::tie(mesh, geom) = subdivide(*a.manifoldMesh, *a.geometry, SubdivisionScheme::Loop);
+  mesh->validateConnectivity();
+
+  loopSubdivide(*a.manifoldMesh, *a.geometry);
+  ASSERT_EQ(mesh->nVertices(), a.manifoldMesh->nVertices());
+  ASSERT_EQ(mesh->nFaces(), a.manifoldMesh->nFaces());
+  for (size_t i = 0; i < mesh->nVertices(); i++) {
+    EXPECT_LT(norm(geom->inputVertexPositions[i] - a.geometry->inputVertexPositions[i]), 1e-9);
+  }
+}
+
+TEST_F(SubdivideSuite, MultipleLevels) {
+  std::vector<std::vector<Vector3>> results;
+  for (int nThreads : {1, 4}) {
+    for (SubdivisionScheme scheme : {SubdivisionScheme::CatmullClark, SubdivisionScheme::Loop}) {
+      MeshAsset a = getAsset(scheme == SubdivisionScheme::Loop ? "lego.ply" : "dodecahedron_poly.obj", true);
+      ManifoldSurfaceMesh& input = *a.manifoldMesh;
+      size_t nCorners = 0;
+      for (Face f : input.faces()) nCorners += f.degree();
+
+      SubdivisionOptions options;
+      options.levels = 2;
+      ScopedNumThreads threads(nThreads);
+      std::unique_ptr<ManifoldSurfaceMesh> mesh;
+      std::unique_ptr<VertexPositionGeometry> geom;
+      std::tie(mesh, geom) = subdivide(input, *a.geometry, scheme, options);
+
+      mesh->validateConnectivity();
+      EXPECT_EQ(mesh->eulerCharacteristic(), input.eulerCharacteristic());
+      EXPECT_EQ(mesh->nBoundaryLoops(), input.nBoundaryLoops());
+      if (scheme == SubdivisionScheme::Loop) {
+        EXPECT_EQ(mesh->nFaces(), 16 * input.nFaces());
+      } else {
+        EXPECT_EQ(mesh->nFaces(), 4 * nCorners);
+        for (Face f : mesh->faces()) EXPECT_EQ(f.degree(), 4u);
+      }
+
+      std::vector<Vector3> positions;
+      for (Vertex v : mesh->vertices()) positions.push_back(geom->inputVertexPositions[v]);
+      results.push_back(positions);
+    }
+  }
+  EXPECT_TRUE(results[0] == results[2]);
+  EXPECT_TRUE(results[1] == results[3]);
+}
+
+TEST_F(SubdivideSuite, Creases) {
+  // A unit cube, with every edge sharp
+  std::vector<std::vector<size_t>> quads = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4},
+                                            {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  ManifoldSurfaceMesh mesh(quads);
+  VertexData<Vector3> positions(mesh);
+  for (size_t i = 0; i < 8; i++) positions[i] = Vector3{double(i & 1), double((i >> 1) & 1), double((i >> 2) & 1)};
+  VertexPositionGeometry geom(mesh, positions);
+
+  SubdivisionOptions options;
+  options.levels = 3;
+  options.creases = EdgeData<char>(mesh, true);
+  std::unique_ptr<ManifoldSurfaceMesh> fine;
+  std::unique_ptr<VertexPositionGeometry> fineGeom;
+  std::tie(fine, fineGeom) = subdivide(mesh, geom, SubdivisionScheme::CatmullClark, options);
+
+  // The corners stay put, and the edges stay straight
+  for (size_t i = 0; i < 8; i++) {
+    EXPECT_EQ(fineGeom->inputVertexPositions[i], positions[i]);
+  }
+  for (Vertex v : fine->vertices()) {
+    Vector3 p = fineGeom->inputVertexPositions[v];
+    int nOnFaces = 0;
+    for (double x : {p.x, p.y, p.z}) {
+      if (std::abs(x) < 1e-12 || std::abs(x - 1.) < 1e-12) nOnFaces++;
+    }
+    if (v.getIndex() < 8 + mesh.nEdges()) EXPECT_GE(nOnFaces, 2);
+  }
+
+  // Without creases, the corners are smoothed
+  std::tie(fine, fineGeom) = subdivide(mesh, geom, SubdivisionScheme::CatmullClark);
+  EXPECT_GT(norm(fineGeom->inputVertexPositions[0] - positions[0]), 0.1);
+}
+
+// ============================================================
+// =============== Boundary first flattening
+// ============================================================
+
+TEST_F(BFFSuite, BatchedMatchesSingle) {
+  MeshAsset a = getAsset("lego.ply", true);
+  ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+  VertexPositionGeometry& geom = *a.geometry;
+  BFF bff(mesh, geom);
+
+  std::vector<VertexData<double>> scaleFactors;
+  scaleFactors.push_back(VertexData<double>(mesh, 0.));
+  scaleFactors.push_back(VertexData<double>(mesh));
+  for (Vertex v : mesh.vertices()) scaleFactors.back()[v] = 0.1 * geom.inputVertexPositions[v].z;
+
+  size_t nBoundary = mesh.nVertices() - mesh.nInteriorVertices();
+  std::vector<VertexData<double>> exteriorAngles(2, VertexData<double>(mesh, 0.));
+  for (Vertex v : mesh.vertices()) {
+    if (!v.isBoundary()) continue;
+    exteriorAngles[0][v] = 2. * PI / nBoundary;
+    exteriorAngles[1][v] = exteriorAngles[0][v] * (1. + 0.5 * std::sin(geom.inputVertexPositions[v].x));
+  }
+  double sum = 0.;
+  for (Vertex v : mesh.vertices()) sum += exteriorAngles[1][v];
+  for (Vertex v : mesh.vertices()) exteriorAngles[1][v] *= 2. * PI / sum;
+
+  std::vector<VertexData<Vector2>> batchedU = bff.flattenFromScaleFactors(scaleFactors);
+  std::vector<VertexData<Vector2>> batchedK = bff.flattenFromExteriorAngles(exteriorAngles);
+  ASSERT_EQ(batchedU.size(), 2u);
+  ASSERT_EQ(batchedK.size(), 2u);
+  for (size_t j = 0; j < 2; j++) {
+    VertexData<Vector2> singleU = bff.flattenFromScaleFactors(scaleFactors[j]);
+    VertexData<Vector2> singleK = bff.flattenFromExteriorAngles(exteriorAngles[j]);
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_LT(norm(batchedU[j][v] - singleU[v]), 1e-8);
+      EXPECT_LT(norm(batchedK[j][v] - singleK[v]), 1e-8);
+    }
+  }
+}
+
+TEST_F(BFFSuite, Charts) {
+  // Two copies of one disk and one of another, in a single mesh
+  std::vector<MeshAsset> disks;
+  disks.push_back(getAsset("lego.ply", true));
+  disks.push_back(getAsset("cat_head.obj", true));
+  std::vector<size_t> copies = {0, 1, 0};
+
+  std::vector<std::vector<size_t>> polygons;
+  std::vector<Vector3> positions;
+  for (size_t iD : copies) {
+    ManifoldSurfaceMesh& disk = *disks[iD].manifoldMesh;
+    size_t offset = positions.size();
+    for (std::vector<size_t> poly : disk.getFaceVertexList()) {
+      for (size_t& i : poly) i += offset;
+      polygons.push_back(poly);
+    }
+    for (Vertex v : disk.vertices()) positions.push_back(disks[iD].geometry->inputVertexPositions[v]);
+  }
+  ManifoldSurfaceMesh mesh(polygons);
+  VertexData<Vector3> meshPositions(mesh);
+  for (size_t i = 0; i < positions.size(); i++) meshPositions[i] = positions[i];
+  VertexPositionGeometry geom(mesh, meshPositions);
+
+  VertexData<Vector2> parm;
+  VertexData<size_t> chart;
+  std::tie(parm, chart) = parameterizeBFFCharts(mesh, geom);
+
+  size_t offset = 0;
+  for (size_t iC = 0; iC < copies.size(); iC++) {
+    MeshAsset& disk = disks[copies[iC]];
+    VertexData<Vector2> single = parameterizeBFF(*disk.manifoldMesh, *disk.geometry);
+    for (Vertex v : disk.manifoldMesh->vertices()) {
+      EXPECT_EQ(chart[offset + v.getIndex()], iC);
+      EXPECT_LT(norm(parm[offset + v.getIndex()] - single[v]), 1e-8);
+    }
+    offset += disk.manifoldMesh->nVertices();
+  }
+
+  // Charts must be disks
+  MeshAsset closed = getAsset("spot.ply", true);
+  EXPECT_THROW(parameterizeBFFCharts(*closed.manifoldMesh, *closed.geometry), std::runtime_error);
+}
+
+// ============================================================
+// =============== Parameterization
+// ============================================================
+
+TEST_F(ParameterizeSuite, IndependentCharts) {
+  // Two disjoint disks in a single mesh, which need no cuts
+  MeshAsset disk = getAsset("cat_head.obj", true);
+  ManifoldSurfaceMesh& diskMesh = *disk.manifoldMesh;
+  std::vector<std::vector<size_t>> polygons = diskMesh.getFaceVertexList();
+  for (std::vector<size_t> poly : diskMesh.getFaceVertexList()) {
+    for (size_t& i : poly) i += diskMesh.nVertices();
+    polygons.push_back(poly);
+  }
+  ManifoldSurfaceMesh mesh(polygons);
+  VertexData<Vector3> positions(mesh);
+  for (Vertex v : mesh.vertices()) {
+    positions[v] = disk.geometry->inputVertexPositions[v.getIndex() % diskMesh.nVertices()];
+  }
+  VertexPositionGeometry geom(mesh, positions);
+
+  CornerData<Vector2> coords = parameterize(mesh, geom, EdgeData<char>(mesh, false));
+  VertexData<Vector2> single = parameterizeDisk(diskMesh, *disk.geometry);
+  for (Corner c : mesh.corners()) {
+    Vector2 expected = single[c.vertex().getIndex() % diskMesh.nVertices()];
+    EXPECT_LT(norm(coords[c] - expected), 1e-8);
+  }
+}
+
+TEST_F(ParameterizeSuite, CutSphere) {
+  MeshAsset a = getAsset("sphere_small.ply", true);
+  ManifoldSurfaceMesh& mesh = *a.manifoldMesh;
+  VertexPositionGeometry& geom = *a.geometry;
+
+  // Cutting a sphere along a path leaves a disk
+  EdgeData<char> cut(mesh, false);
+  for (Halfedge he : shortestEdgePath(geom, mesh.vertex(0), mesh.vertex(mesh.nVertices() - 1))) {
+    cut[he.edge()] = true;
+  }
+  CornerData<Vector2> coords = parameterize(mesh, geom, cut);
+
+  size_t nPositive = 0;
+  for (Face f : mesh.faces()) {
+    std::vector<Vector2> p;
+    for (Corner c : f.adjacentCorners()) {
+      EXPECT_TRUE(isfinite(coords[c]));
+      p.push_back(coords[c]);
+    }
+    if (cross(p[1] - p[0], p[2] - p[0]) > 0.) nPositive++;
+  }
+  EXPECT_GT(nPositive, 0.95 * mesh.nFaces());
+
+  // Away from the cut, every corner of a vertex has the same coordinates
+  for (Vertex v : mesh.vertices()) {
+    bool onCut = false;
+    for (Edge e : v.adjacentEdges()) onCut = onCut || cut[e];
+    if (onCut) continue;
+    Vector2 first = coords[v.corner()];
+    for (Corner c : v.adjacentCorners()) EXPECT_EQ(coords[c], first);
+  }
+}
+
+// ============================================================
+// =============== Direction field solver
+// ============================================================
+
+TEST_F(DirectionFieldSuite, SmoothestMatchesFreeFunctions) {
+  auto asset = getAsset("spot.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  DirectionFieldSolver solver(geometry);
+  for (int nSym : {1, 2, 4}) {
+    // The smoothest field is only defined up to a global rotation, and both are found by inexact inverse iteration
+    VertexData<Vector2> vA = computeSmoothestVertexDirectionField(geometry, nSym);
+    VertexData<Vector2> vB = solver.smoothestVertexField(nSym);
+    Vector2 rot = vB[mesh.vertex(0)] / vA[mesh.vertex(0)];
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_NEAR(norm(vA[v] * rot - vB[v]), 0., 1e-2);
+    }
+
+    FaceData<Vector2> fA = computeSmoothestFaceDirectionField(geometry, nSym);
+    FaceData<Vector2> fB = solver.smoothestFaceField(nSym);
+    rot = fB[mesh.face(0)] / fA[mesh.face(0)];
+    for (Face f : mesh.faces()) {
+      EXPECT_NEAR(norm(fA[f] * rot - fB[f]), 0., 1e-2);
+    }
+  }
+}
+
+TEST_F(DirectionFieldSuite, BoundaryAlignedMatchesFreeFunctions) {
+  auto asset = getAsset("lego.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  DirectionFieldSolver solver(geometry);
+  for (int nSym : {1, 4}) {
+    VertexData<Vector2> vA = computeSmoothestBoundaryAlignedVertexDirectionField(geometry, nSym);
+    VertexData<Vector2> vB = solver.smoothestBoundaryAlignedVertexField(nSym);
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_NEAR(norm(vA[v] - vB[v]), 0., 1e-6);
+    }
+
+    FaceData<Vector2> fA = computeSmoothestBoundaryAlignedFaceDirectionField(geometry, nSym);
+    FaceData<Vector2> fB = solver.smoothestBoundaryAlignedFaceField(nSym);
+    for (Face f : mesh.faces()) {
+      EXPECT_NEAR(norm(fA[f] - fB[f]), 0., 1e-6);
+    }
+  }
+}
+
+TEST_F(DirectionFieldSuite, BatchedAlignment) {
+  auto asset = getAsset("spot.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Principal directions as guidance give the curvature-aligned fields
+  geometry.requireVertexPrincipalCurvatureDirections();
+  geometry.requireFacePrincipalCurvatureDirections();
+  VertexData<Vector2> vGuide = geometry.vertexPrincipalCurvatureDirections;
+  FaceData<Vector2> fGuide = geometry.facePrincipalCurvatureDirections;
+
+  // Other guidance, constrained on only some of the elements
+  VertexData<Vector2> vSparse(mesh, Vector2::zero());
+  for (Vertex v : mesh.vertices()) {
+    if (v.getIndex() % 50 == 0) vSparse[v] = Vector2::fromAngle(0.1 * v.getIndex());
+  }
+  FaceData<Vector2> fSparse(mesh, Vector2::zero());
+  for (Face f : mesh.faces()) {
+    if (f.getIndex() % 50 == 0) fSparse[f] = Vector2::fromAngle(0.1 * f.getIndex());
+  }
+
+  DirectionFieldSolver solver(geometry);
+  std::vector<VertexData<Vector2>> vFields = solver.alignedVertexFields({vGuide, vSparse}, 2);
+  std::vector<FaceData<Vector2>> fFields = solver.alignedFaceFields({fGuide, fSparse}, 2);
+  ASSERT_EQ(vFields.size(), 2);
+  ASSERT_EQ(fFields.size(), 2);
+
+  VertexData<Vector2> vCurv = computeCurvatureAlignedVertexDirectionField(geometry, 2);
+  FaceData<Vector2> fCurv = computeCurvatureAlignedFaceDirectionField(geometry, 2);
+  VertexData<Vector2> vSingle = solver.alignedVertexFields({vSparse}, 2)[0];
+  FaceData<Vector2> fSingle = solver.alignedFaceFields({fSparse}, 2)[0];
+  for (Vertex v : mesh.vertices()) {
+    EXPECT_NEAR(norm(vFields[0][v] - vCurv[v]), 0., 1e-6);
+    EXPECT_NEAR(norm(vFields[1][v] - vSingle[v]), 0., 1e-9);
+  }
+  for (Face f : mesh.faces()) {
+    EXPECT_NEAR(norm(fFields[0][f] - fCurv[f]), 0., 1e-6);
+    EXPECT_NEAR(norm(fFields[1][f] - fSingle[f]), 0., 1e-9);
+  }
+}
+
+// ============================================================
+// =============== Geodesic centroidal Voronoi tessellation
+// ============================================================
+
+TEST_F(VoronoiSuite, BatchedIterationMatchesSingleSolves) {
+  auto asset = getAsset("spot.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // More sites than one block, so blocks are exercised
+  VoronoiOptions options;
+  for (size_t i = 0; i < 40; i++) {
+    options.initialSites.push_back(SurfacePoint(mesh.face(37 * i % mesh.nFaces()), Vector3{0.5, 0.25, 0.25}));
+  }
+  options.iterations = 1;
+  options.useDelaunay = false;
+  options.computeDistributions = true;
+  VoronoiResult result = computeGeodesicCentroidalVoronoiTessellation(mesh, geometry, options);
+  ASSERT_EQ(result.siteLocations.size(), 40);
+  ASSERT_EQ(result.siteDistributions.size(), 40);
+
+  // One step of each site, one at a time
+  VectorHeatMethodSolver solver(geometry);
+  geometry.requireVertexDualAreas();
+  VertexData<double> normRHS(mesh, 0.);
+  for (const SurfacePoint& p : options.initialSites) {
+    Halfedge he = p.face.halfedge();
+    normRHS[he.vertex()] += p.faceCoords.x;
+    normRHS[he.next().vertex()] += p.faceCoords.y;
+    normRHS[he.next().next().vertex()] += p.faceCoords.z;
+  }
+  VertexData<double> normD = solver.scalarDiffuse(normRHS);
+  for (size_t iS = 0; iS < 40; iS += 7) {
+    const SurfacePoint& p = options.initialSites[iS];
+    VertexData<double> unitRHS(mesh, 0.);
+    Halfedge he = p.face.halfedge();
+    unitRHS[he.vertex()] += p.faceCoords.x;
+    unitRHS[he.next().vertex()] += p.faceCoords.y;
+    unitRHS[he.next().next().vertex()] += p.faceCoords.z;
+    VertexData<double> fracD = solver.scalarDiffuse(unitRHS);
+
+    VertexData<Vector2> logmap = solver.computeLogMap(p);
+    Vector2 updateSum = Vector2::zero();
+    double updateWSum = 0.;
+    for (Vertex v : mesh.vertices()) {
+      double weight = fracD[v] / normD[v] * geometry.vertexDualAreas[v];
+      updateSum += weight * logmap[v];
+      updateWSum += weight;
+    }
+    SurfacePoint expected = traceGeodesic(geometry, p, updateSum / updateWSum).endPoint;
+
+    EXPECT_LT(norm(expected.interpolate(geometry.vertexPositions) -
+                   result.siteLocations[iS].interpolate(geometry.vertexPositions)),
+              1e-6);
+  }
+}
+
+TEST_F(VoronoiSuite, DistributionsPartitionUnity) {
+  auto asset = getAsset("bob_small.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  VoronoiOptions options;
+  options.nSites = 50;
+  options.iterations = 3;
+  options.computeDistributions = true;
+  VoronoiResult result = computeGeodesicCentroidalVoronoiTessellation(mesh, geometry, options);
+  ASSERT_EQ(result.siteLocations.size(), 50);
+  ASSERT_EQ(result.siteDistributions.size(), 50);
+
+  // Distributions live on the intrinsic triangulation, which has the same vertices
+  for (size_t iV = 0; iV < mesh.nVertices(); iV++) {
+    double sum = 0.;
+    for (const VertexData<double>& d : result.siteDistributions) sum += d[iV];
+    EXPECT_NEAR(sum, 1., 1e-6);
+  }
+}
+
+// ============================================================
+// =============== Surface centers
+// ============================================================
+
+namespace {
+
+// A plain, one-distribution-at-a-time Weiszfeld iteration, with single log maps and geodesic traces, as a reference for
+// the batched implementation. Draws its initial guess from util_mersenne_twister like findCenters() does.
+SurfacePoint referenceCenter(ManifoldSurfaceMesh& mesh, VertexPositionGeometry& geom, VectorHeatMethodSolver& solver,
+                             const VertexData<double>& distribution, int p) {
+  geom.requireFaceAreas();
+  SurfacePoint center = SurfacePoint(mesh.vertex(randomIndex(mesh.nVertices()))).inSomeFace();
+
+  double meshDiameter = 1.;
+  if (p == 1) {
+    double surfaceArea = 0.;
+    for (Face f : mesh.faces()) surfaceArea += geom.faceAreas[f];
+    meshDiameter = std::sqrt(surfaceArea);
+  }
+  double p1DistanceEps = 1e-9 * meshDiameter;
+
+  auto evaluate = [&](SurfacePoint at, double& energy, Vector2& update) {
+    VertexData<Vector2> logmap = solver.computeLogMap(at);
+    energy = 0.;
+    update = Vector2::zero();
+    double weightSum = 0.;
+    for (Vertex v : mesh.vertices()) {
+      double w = distribution[v];
+      if (w == 0.) continue;
+      double dist2 = logmap[v].norm2();
+      if (p == 1) {
+        double dist = std::sqrt(dist2);
+        energy += w * dist;
+        update += w * logmap[v] / (dist + p1DistanceEps);
+        weightSum += w / (dist + p1DistanceEps);
+      } else {
+        energy += w * dist2;
+        update += w * logmap[v];
+        weightSum += w;
+      }
+    }
+    update /= weightSum;
+  };
+
+  double energy;
+  Vector2 update;
+  evaluate(center, energy, update);
+  for (int i = 0; i < 100; i++) {
+    bool stepped = false;
+    double stepSize = 1.;
+    for (int lineSearchIter = 0; lineSearchIter < 8; lineSearchIter++) {
+      Vector2 stepVec = update * stepSize;
+      if (stepVec.norm() < std::sqrt(geom.faceAreas[center.face]) / 3.) break;
+      SurfacePoint candidate = traceGeodesic(geom, center, stepVec).endPoint.inSomeFace();
+      double candEnergy;
+      Vector2 candUpdate;
+      evaluate(candidate, candEnergy, candUpdate);
+      if (candEnergy < energy) {
+        center = candidate;
+        energy = candEnergy;
+        update = candUpdate;
+        stepped = true;
+        break;
+      }
+      stepSize *= 0.5;
+    }
+    if (!stepped) break;
+  }
+
+  geom.unrequireFaceAreas();
+  return center;
+}
+
+} // namespace
+
+TEST_F(SurfaceCenterSuite, BatchedMatchesReference) {
+  auto asset = getAsset("spot.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Point sets: two-rings around scattered vertices, with repeats
+  std::vector<std::vector<Vertex>> pointSets;
+  std::vector<VertexData<double>> distributions;
+  for (size_t i = 0; i < 8; i++) {
+    Vertex center = mesh.vertex(353 * i % mesh.nVertices());
+    std::vector<Vertex> pts{center, center};
+    for (Vertex v : center.adjacentVertices()) {
+      for (Vertex w : v.adjacentVertices()) pts.push_back(w);
+    }
+    pointSets.push_back(pts);
+
+    VertexData<double> dist(mesh, 0.);
+    for (Vertex v : pts) dist[v] += 0.5 + 0.01 * (v.getIndex() % 7);
+    distributions.push_back(dist);
+  }
+
+  VectorHeatMethodSolver solver(geometry);
+  for (int p : {1, 2}) {
+    util_mersenne_twister.seed(17);
+    std::vector<SurfacePoint> batchPts = findCenters(mesh, geometry, solver, pointSets, p);
+    util_mersenne_twister.seed(17);
+    std::vector<SurfacePoint> batchDists = findCenters(mesh, geometry, solver, distributions, p);
+    ASSERT_EQ(batchPts.size(), pointSets.size());
+
+    // Initial guesses are drawn in the same order
+    std::vector<SurfacePoint> refPts, refDists;
+    util_mersenne_twister.seed(17);
+    for (const std::vector<Vertex>& pts : pointSets) {
+      VertexData<double> dist(mesh, 0.);
+      for (Vertex v : pts) dist[v] += 1.;
+      refPts.push_back(referenceCenter(mesh, geometry, solver, dist, p));
+    }
+    util_mersenne_twister.seed(17);
+    for (const VertexData<double>& d : distributions) refDists.push_back(referenceCenter(mesh, geometry, solver, d, p));
+
+    for (size_t i = 0; i < pointSets.size(); i++) {
+      EXPECT_LT(norm(batchPts[i].interpolate(geometry.vertexPositions) -
+                     refPts[i].interpolate(geometry.vertexPositions)),
+                1e-6);
+      EXPECT_LT(norm(batchDists[i].interpolate(geometry.vertexPositions) -
+                     refDists[i].interpolate(geometry.vertexPositions)),
+                1e-6);
+    }
+  }
+}
+
+// ============================================================
+// =============== Mesh tiling
+// ============================================================
+
+TEST_F(MeshTilingSuite, EachElementOwnedOnce) {
+  for (std::string name : {"spot.ply", "lego.ply", "bob_small.ply"}) {
+    auto asset = getAsset(name, true);
+    ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+    VertexPositionGeometry& geometry = *asset.geometry;
+
+    MeshTilingOptions options;
+    options.targetFacesPerTile = 100;
+    MeshTiling tiling(mesh, options);
+    EXPECT_GT(tiling.nTiles(), 2);
+
+    VertexData<int> vertexCount(mesh, 0);
+    EdgeData<int> edgeCount(mesh, 0);
+    FaceData<int> faceCount(mesh, 0);
+    for (size_t iTile = 0; iTile < tiling.nTiles(); iTile++) {
+      EXPECT_LE(tiling.tileFaces[iTile].size(), 100);
+      MeshTile tile = tiling.extractTile(iTile, geometry);
+      EXPECT_TRUE(tile.mesh->isManifold());
+      for (Vertex v : tile.mesh->vertices()) {
+        EXPECT_EQ(tile.geometry->vertexPositions[v], geometry.vertexPositions[mesh.vertex(tile.parentVertex[v])]);
+        if (tile.ownsVertex[v]) vertexCount[tile.parentVertex[v]]++;
+      }
+      for (Edge e : tile.mesh->edges()) {
+        if (tile.ownsEdge[e]) edgeCount[tile.parentEdge[e]]++;
+      }
+      for (Face f : tile.mesh->faces()) {
+        if (tile.ownsFace[f]) faceCount[tile.parentFace[f]]++;
+      }
+    }
+    for (Vertex v : mesh.vertices()) EXPECT_EQ(vertexCount[v], 1);
+    for (Edge e : mesh.edges()) EXPECT_EQ(edgeCount[e], 1);
+    for (Face f : mesh.faces()) EXPECT_EQ(faceCount[f], 1);
+  }
+}
+
+TEST_F(MeshTilingSuite, StitchedKernelsMatchGlobal) {
+  for (std::string name : {"spot.ply", "lego.ply", "bob_small.ply"}) {
+    auto asset = getAsset(name, true);
+    ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+    VertexPositionGeometry& geometry = *asset.geometry;
+
+    MeshTilingOptions options;
+    options.targetFacesPerTile = 100;
+    MeshTiling tiling(mesh, options);
+
+    VertexData<Vector3> normals = tiling.computeVertexData<Vector3>(geometry, [](MeshTile& tile) {
+      tile.geometry->requireVertexNormals();
+      return tile.geometry->vertexNormals;
+    });
+    VertexData<double> curvatures = tiling.computeVertexData<double>(geometry, [](MeshTile& tile) {
+      tile.geometry->requireVertexGaussianCurvatures();
+      return tile.geometry->vertexGaussianCurvatures;
+    });
+    EdgeData<double> cotanWeights = tiling.computeEdgeData<double>(geometry, [](MeshTile& tile) {
+      tile.geometry->requireEdgeCotanWeights();
+      return tile.geometry->edgeCotanWeights;
+    });
+    FaceData<double> areas = tiling.computeFaceData<double>(geometry, [](MeshTile& tile) {
+      tile.geometry->requireFaceAreas();
+      return tile.geometry->faceAreas;
+    });
+
+    geometry.requireVertexNormals();
+    geometry.requireVertexGaussianCurvatures();
+    geometry.requireEdgeCotanWeights();
+    geometry.requireFaceAreas();
+    for (Vertex v : mesh.vertices()) {
+      EXPECT_NEAR(norm(normals[v] - geometry.vertexNormals[v]), 0., 1e-12);
+      EXPECT_NEAR(curvatures[v], geometry.vertexGaussianCurvatures[v], 1e-12);
+    }
+    for (Edge e : mesh.edges()) EXPECT_NEAR(cotanWeights[e], geometry.edgeCotanWeights[e], 1e-12);
+    for (Face f : mesh.faces()) EXPECT_NEAR(areas[f], geometry.faceAreas[f], 1e-12);
+  }
+}
+
+TEST_F(MeshTilingSuite, WiderHaloForRepeatedSmoothing) {
+  auto asset = getAsset("spot.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Two steps of smoothing see two rings of neighbors
+  auto smooth = [](SurfaceMesh& m, const VertexData<Vector3>& pos) {
+    VertexData<Vector3> out(m);
+    for (Vertex v : m.vertices()) {
+      Vector3 sum = Vector3::zero();
+      for (Vertex n : v.adjacentVertices()) sum += pos[n];
+      out[v] = 0.5 * pos[v] + 0.5 * sum / v.degree();
+    }
+    return out;
+  };
+
+  MeshTilingOptions options;
+  options.targetFacesPerTile = 200;
+  options.haloRings = 2;
+  MeshTiling tiling(mesh, options);
+  VertexData<Vector3> smoothed = tiling.computeVertexData<Vector3>(geometry, [&](MeshTile& tile) {
+    return smooth(*tile.mesh, smooth(*tile.mesh, tile.geometry->vertexPositions));
+  });
+
+  VertexData<Vector3> expected = smooth(mesh, smooth(mesh, geometry.vertexPositions));
+  for (Vertex v : mesh.vertices()) {
+    EXPECT_NEAR(norm(smoothed[v] - expected[v]), 0., 1e-12);
+  }
+}
+
+TEST_F(MeshTilingSuite, GivenPartition) {
+  auto asset = getAsset("lego.ply", true);
+  ManifoldSurfaceMesh& mesh = *asset.manifoldMesh;
+  VertexPositionGeometry& geometry = *asset.geometry;
+
+  // Disconnected tiles, interleaved
+  FaceData<size_t> faceTile(mesh);
+  for (Face f : mesh.faces()) faceTile[f] = f.getIndex() % 3;
+  MeshTiling tiling(mesh, faceTile);
+  ASSERT_EQ(tiling.nTiles(), 3);
+
+  VertexData<Vector3> normals = tiling.computeVertexData<Vector3>(geometry, [](MeshTile& tile) {
+    tile.geometry->requireVertexNormals();
+    return tile.geometry->vertexNormals;
+  });
+  geometry.requireVertexNormals();
+  for (Vertex v : mesh.vertices()) {
+    EXPECT_NEAR(norm(normals[v] - geometry.vertexNormals[v]), 0., 1e-12);
+  }
+}